@@ -11,7 +11,8 @@
 
 #define ERR_BUFF_SIZE 80
 
-modbus_t *KincoDriver::ctx;
+std::unique_ptr<BusTransport> KincoDriver::bus;
+bool KincoDriver::replayingBus = false;
 std::vector<KincoDriver *> KincoDriver::connectedDrives;
 bool KincoDriver::drivesDisabled;
 
@@ -20,16 +21,47 @@ double convertSpeedIUtoRPM(int32_t speed_units);
 double convertCurrIUtoAmp(int32_t current_units);
 int32_t convertSpeedRPMtoIU(int16_t speed_rpm);
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// The libmodbus RTU link
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class ModbusRtuTransport : public BusTransport
+{
+public:
+    explicit ModbusRtuTransport(modbus_t *ctx) : ctx(ctx) {}
+    ~ModbusRtuTransport()
+    {
+        modbus_close(ctx);
+        modbus_free(ctx);
+    }
+    int readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest) override
+    {
+        modbus_set_slave(ctx, devId);
+        return modbus_read_registers(ctx, addr, n, dest);
+    }
+    int writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src) override
+    {
+        modbus_set_slave(ctx, devId);
+        if (n == 1)
+            return modbus_write_register(ctx, addr, src[0]);
+        return modbus_write_registers(ctx, addr, n, src);
+    }
+    void flush() override { modbus_flush(ctx); }
+
+private:
+    modbus_t *ctx;
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
 KincoDriver::KincoDriver(int16_t driverId)
     : driverNodeId(driverId)
 {
-    ctx = NULL;
     modbusNodeIsSet = false;
     DriveIsConnected = false;
     encoderOffset = 0;
+    kincoStatusData.ALL = 0;
+    kincoErrorData.ALL = 0;
     KincoDriver::drivesDisabled = false;
 }
 
@@ -38,7 +70,7 @@ KincoDriver::KincoDriver(int16_t driverId)
 //////////////////////////////////////////////////////////////////////////////////////////////////
 void KincoDriver::initializeRTU(const char *device, int baud, char parity, int data_bit, int stop_bit)
 {
-    ctx = modbus_new_rtu(device, baud, parity, data_bit, stop_bit);
+    modbus_t *ctx = modbus_new_rtu(device, baud, parity, data_bit, stop_bit);
 
     if (ctx == NULL)
     {
@@ -52,12 +84,64 @@ void KincoDriver::initializeRTU(const char *device, int baud, char parity, int d
         modbus_free(ctx);
         throw std::runtime_error(errBuff);
     }
-    modbus_flush(ctx);
+    bus = std::unique_ptr<BusTransport>(new ModbusRtuTransport(ctx));
+    replayingBus = false;
+    bus->flush();
 }
 
 bool KincoDriver::rtuIsActive()
 {
-    return (ctx != NULL);
+    return (bus != nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void KincoDriver::initializeReplay(const std::string &path)
+{
+    bus = std::unique_ptr<BusTransport>(new BusReplay(path));
+    replayingBus = true;
+}
+
+BusReplay *KincoDriver::getReplay()
+{
+    return dynamic_cast<BusReplay *>(bus.get());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Recording only wraps a live link, so a replay is never recorded again.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void KincoDriver::startBusRecording(const std::string &path)
+{
+    if (!rtuIsActive() || getReplay() != nullptr)
+        throw std::runtime_error("startBusRecording: the drive bus isn't connected.");
+    if (getRecorder() != nullptr)
+        return;
+    bus = std::unique_ptr<BusTransport>(new BusRecorder(std::move(bus), path));
+}
+
+void KincoDriver::stopBusRecording()
+{
+    BusRecorder *recorder = dynamic_cast<BusRecorder *>(bus.get());
+    if (recorder != nullptr)
+        bus = recorder->release();
+}
+
+const BusRecorder *KincoDriver::getRecorder()
+{
+    return dynamic_cast<const BusRecorder *>(bus.get());
+}
+
+void KincoDriver::markBus(uint16_t kind, uint8_t id, double *values, unsigned n)
+{
+    if (bus)
+        bus->mark(kind, id, values, n);
+}
+
+double KincoDriver::markBusTick(double dt)
+{
+    markBus(BUS_LOG::MARK_TICK, 0, &dt, 1);
+    return dt;
 }
 
 bool KincoDriver::driverHandshake()
@@ -70,7 +154,7 @@ bool KincoDriver::driverHandshake()
         throw std::runtime_error(errBuff);
     }
 
-    modbus_flush(ctx);
+    bus->flush();
     // Check for communications with the driver
     readDriverStatusWord();
     bool commsFound = kincoStatusData.BITS.COMMUNICATION_FOUND;
@@ -102,11 +186,7 @@ void KincoDriver::resetDriverState()
 
 bool KincoDriver::readyForModbus()
 {
-    if (ctx == NULL)
-    {
-        return false;
-    }
-    return true;
+    return (bus != nullptr);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -122,15 +202,14 @@ T KincoDriver::readDriverRegister(uint8_t devId, uint16_t modBusAddr)
         throw std::runtime_error(errBuff);
     }
 
-    modbus_set_slave(ctx, devId);
-    uint16_t result_code = 0;
+    int result_code = 0;
     constexpr uint16_t numWords = sizeof(T) / sizeof(uint16_t);
     ConversionBuffer<T> rxBuff;
 
-    result_code = modbus_read_registers(ctx, modBusAddr, numWords, rxBuff.U16_PARTS);
+    result_code = bus->readRegisters(devId, modBusAddr, numWords, rxBuff.U16_PARTS);
     if (result_code == -1)
     {
-        modbus_flush(ctx);
+        bus->flush();
         throw std::runtime_error(modbus_strerror(errno));
     }
     return static_cast<T>(rxBuff.WHOLE);
@@ -149,23 +228,15 @@ uint16_t KincoDriver::writeDriverRegisters(uint8_t devId, uint16_t modBusAddr, T
         throw std::runtime_error(errBuff);
     }
 
-    modbus_set_slave(ctx, devId);
-    uint16_t result_code = 0;
+    int result_code = 0;
     uint16_t numWords = sizeof(T) / sizeof(uint16_t);
 
     ConversionBuffer<T> txBuff;
-    if (numWords == 1)
-    {
-        result_code = modbus_write_register(ctx, modBusAddr, reg_value);
-    }
-    else
-    {
-        txBuff.WHOLE = reg_value;
-        result_code = modbus_write_registers(ctx, modBusAddr, numWords, txBuff.U16_PARTS);
-    }
+    txBuff.WHOLE = reg_value;
+    result_code = bus->writeRegisters(devId, modBusAddr, numWords, txBuff.U16_PARTS);
     if (result_code == -1)
     {
-        modbus_flush(ctx);
+        bus->flush();
         throw std::runtime_error(modbus_strerror(errno));
     }
     return result_code;
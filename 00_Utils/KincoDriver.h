@@ -3,11 +3,12 @@
 #include <cinttypes>
 #include <string>
 #include <vector>
-// #include <memory>
+#include <memory>
 
 #include "ServoInterface.h"
 #include "KincoNamespace.h"
 #include "modbus/modbus.h"
+#include "bus_log.h"
 
 /* Temporary readability macro to avoid unused variables warnings */
 #define KINCO_UNUSED(x) (void)x
@@ -45,7 +46,10 @@ namespace KINCO
 class KincoDriver : public ServoInterface
 {
 private:
-    static modbus_t *ctx;
+    // The RTU link, or a recorder/replay standing in for it
+    static std::unique_ptr<BusTransport> bus;
+    // Set while the bus is a replay; only then may a mark hand back values that aren't ours
+    static bool replayingBus;
     static bool drivesDisabled;
     bool modbusNodeIsSet;
     bool DriveIsConnected;
@@ -93,6 +97,18 @@ public:
 
     static void initializeRTU(const char *device, int baud = 19200, char parity = 'N', int data_bit = 8, int stop_bit = 1);
     static bool rtuIsActive();
+    // Answer every request from a bus log (BUS_LOG) instead of the drives
+    static void initializeReplay(const std::string &path);
+    static BusReplay *getReplay();
+    static bool isReplayingBus() { return replayingBus; }
+    // Log the traffic on the live link to a file until stopped
+    static void startBusRecording(const std::string &path);
+    static void stopBusRecording();
+    static const BusRecorder *getRecorder();
+    // Record values with the traffic; a replay overwrites them with the recorded ones
+    static void markBus(uint16_t kind, uint8_t id, double *values, unsigned n);
+    // Start of a control tick. Returns the tick period, which a replay takes from the recording.
+    static double markBusTick(double dt);
     bool driverHandshake();
 
     void drive_error_handler();
@@ -100,6 +116,9 @@ public:
 
 
     void checkIfDriverIsOkay();
+    // Words from the last status check, without going to the bus
+    uint16_t getStatusWord() const { return kincoStatusData.ALL; }
+    uint16_t getErrorWord() const { return kincoErrorData.ALL; }
     static bool drivesEnabled() {return !KincoDriver::drivesDisabled;}
 #if defined(LFAST_TERMINAL)
     void connectTerminalInterface(TerminalInterface *_cli) override;
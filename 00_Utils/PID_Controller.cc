@@ -8,10 +8,14 @@
 PID_Controller::PID_Controller(double _kp, double _ki, double _kd) : Kp(_kp),
                                                                      Ki(_ki),
                                                                      Kd(_kd),
+                                                                     Kb(0.0),
+                                                                     integratorState(0.0),
+                                                                     e_prev(0),
+                                                                     firstTime(true),
+                                                                     outputSaturatedFlag(false),
                                                                      limit_integrator(false),
                                                                      limit_output(false),
-                                                                     outputSaturatedFlag(false),
-                                                                     e_prev(0)
+                                                                     anti_windup(false)
 {
     configureCompMode();
 }
@@ -58,6 +62,17 @@ void PID_Controller::configureOutputSaturation(double ulim, double llim)
     limit_output = true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Back-calculation anti-windup: while the output is clamped by the output limits, the integrator
+/// is bled off at a rate of Kb * (saturated output - unsaturated output). Only takes effect
+/// once the output saturation has been configured.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PID_Controller::configureAntiWindup(double _kb)
+{
+    Kb = _kb;
+    anti_windup = _kb > 0.0;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +92,24 @@ void PID_Controller::resetIntegrator()
     integratorState = 0.0;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Bumpless transfer: preload the integrator so that the next output picks up from u0 (the
+/// command that was being applied before the controller took over) instead of stepping.
+/// The derivative is restarted so it doesn't kick on the first update.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PID_Controller::initializeIntegrator(double u0, double e)
+{
+    firstTime = true;
+    e_prev = e;
+
+    double state = u0;
+    if (compensationMode & DIGITAL_CONTROL::P_BIT)
+        state -= e * Kp;
+    if (limit_integrator)
+        state = saturate(state, integrator_limits.llim, integrator_limits.ulim);
+    integratorState = (compensationMode & DIGITAL_CONTROL::I_BIT) ? state : 0.0;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -135,5 +168,17 @@ void PID_Controller::update(double e, double dt, double *uC)
         output += diff_term;
     }
 
-    *uC = output;
+    output_pre_sat = output;
+    if (limit_output)
+        output_post_sat = saturate(output_pre_sat, output_limits.llim, output_limits.ulim);
+    else
+        output_post_sat = output_pre_sat;
+    outputSaturatedFlag = output_post_sat != output_pre_sat;
+
+    if (anti_windup && (compensationMode & DIGITAL_CONTROL::I_BIT))
+    {
+        integratorState += Kb * (output_post_sat - output_pre_sat) * dt;
+    }
+
+    *uC = output_post_sat;
 }
\ No newline at end of file
@@ -33,7 +33,9 @@ public:
     void configureGains(double _kp, double _ki, double _kd);
     void configureIntegratorSaturation(double ulim, double llim);
     void configureOutputSaturation(double ulim, double llim);
+    void configureAntiWindup(double _kb);
     void resetIntegrator();
+    void initializeIntegrator(double u0, double e);
     void reset();
     void update(double e, double dt, double *uC);
     bool integratorIsSaturated();
@@ -49,6 +51,7 @@ private:
     double Kp;
     double Ki;
     double Kd;
+    double Kb;
 
     double integratorState;
     double e_prev;
@@ -66,7 +69,7 @@ private:
 
     bool limit_integrator;
     bool limit_output;
+    bool anti_windup;
     uint8_t compensationMode;
     void configureCompMode();
-    // bool anti_windup;
 };
\ No newline at end of file
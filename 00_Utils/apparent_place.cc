@@ -0,0 +1,377 @@
+#include "apparent_place.h"
+#include "astro_time.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace APPARENT_PLACE;
+
+static const double DEG2RAD = M_PI / 180.0;
+static const double ARCSEC2RAD = DEG2RAD / 3600.0;
+
+// IAU 1980 nutation series (Meeus table 22.A). Multiples of D, M, M', F and Omega, then the
+// coefficients of dpsi and deps in 0.0001 arcsec and their rates per Julian century.
+struct NutationTerm
+{
+    signed char D, M, Mp, F, Om;
+    double psi, psiT, eps, epsT;
+};
+
+static const NutationTerm NUTATION_TERMS[] = {
+    {0, 0, 0, 0, 1, -171996, -174.2, 92025, 8.9},
+    {-2, 0, 0, 2, 2, -13187, -1.6, 5736, -3.1},
+    {0, 0, 0, 2, 2, -2274, -0.2, 977, -0.5},
+    {0, 0, 0, 0, 2, 2062, 0.2, -895, 0.5},
+    {0, 1, 0, 0, 0, 1426, -3.4, 54, -0.1},
+    {0, 0, 1, 0, 0, 712, 0.1, -7, 0},
+    {-2, 1, 0, 2, 2, -517, 1.2, 224, -0.6},
+    {0, 0, 0, 2, 1, -386, -0.4, 200, 0},
+    {0, 0, 1, 2, 2, -301, 0, 129, -0.1},
+    {-2, -1, 0, 2, 2, 217, -0.5, -95, 0.3},
+    {-2, 0, 1, 0, 0, -158, 0, 0, 0},
+    {-2, 0, 0, 2, 1, 129, 0.1, -70, 0},
+    {0, 0, -1, 2, 2, 123, 0, -53, 0},
+    {2, 0, 0, 0, 0, 63, 0, 0, 0},
+    {0, 0, 1, 0, 1, 63, 0.1, -33, 0},
+    {2, 0, -1, 2, 2, -59, 0, 26, 0},
+    {0, 0, -1, 0, 1, -58, -0.1, 32, 0},
+    {0, 0, 1, 2, 1, -51, 0, 27, 0},
+    {-2, 0, 2, 0, 0, 48, 0, 0, 0},
+    {0, 0, -2, 2, 1, 46, 0, -24, 0},
+    {2, 0, 0, 2, 2, -38, 0, 16, 0},
+    {0, 0, 2, 2, 2, -31, 0, 13, 0},
+    {0, 0, 2, 0, 0, 29, 0, 0, 0},
+    {-2, 0, 1, 2, 2, 29, 0, -12, 0},
+    {0, 0, 0, 2, 0, 26, 0, 0, 0},
+    {-2, 0, 0, 2, 0, -22, 0, 0, 0},
+    {0, 0, -1, 2, 1, 21, 0, -10, 0},
+    {0, 2, 0, 0, 0, 17, -0.1, 0, 0},
+    {2, 0, -1, 0, 1, 16, 0, -8, 0},
+    {-2, 2, 0, 2, 2, -16, 0.1, 7, 0},
+    {0, 1, 0, 0, 1, -15, 0, 9, 0},
+    {-2, 0, 1, 0, 1, -13, 0, 7, 0},
+    {0, -1, 0, 0, 1, -12, 0, 6, 0},
+    {0, 0, 2, -2, 0, 11, 0, 0, 0},
+    {2, 0, -1, 2, 1, -10, 0, 5, 0},
+    {2, 0, 1, 2, 2, -8, 0, 3, 0},
+    {0, 1, 0, 2, 2, 7, 0, -3, 0},
+    {-2, 1, 1, 0, 0, -7, 0, 0, 0},
+    {0, -1, 0, 2, 2, -7, 0, 3, 0},
+    {2, 0, 0, 2, 1, -7, 0, 3, 0},
+    {2, 0, 1, 0, 0, 6, 0, 0, 0},
+    {-2, 0, 2, 2, 2, 6, 0, -3, 0},
+    {-2, 0, 1, 2, 1, 6, 0, -3, 0},
+    {2, 0, -2, 0, 1, -6, 0, 3, 0},
+    {2, 0, 0, 0, 1, -6, 0, 3, 0},
+    {0, -1, 1, 0, 0, 5, 0, 0, 0},
+    {-2, -1, 0, 2, 1, -5, 0, 3, 0},
+    {-2, 0, 0, 0, 1, -5, 0, 3, 0},
+    {0, 0, 2, 2, 1, -5, 0, 3, 0},
+    {-2, 0, 2, 0, 1, 4, 0, 0, 0},
+    {-2, 1, 0, 2, 1, 4, 0, 0, 0},
+    {0, 0, 1, -2, 0, 4, 0, 0, 0},
+    {-1, 0, 1, 0, 0, -4, 0, 0, 0},
+    {-2, 1, 0, 0, 0, -4, 0, 0, 0},
+    {1, 0, 0, 0, 0, -4, 0, 0, 0},
+    {0, 0, 1, 2, 0, 3, 0, 0, 0},
+    {0, 0, -2, 2, 2, -3, 0, 0, 0},
+    {-1, -1, 1, 0, 0, -3, 0, 0, 0},
+    {0, 1, 1, 0, 0, -3, 0, 0, 0},
+    {0, -1, 1, 2, 2, -3, 0, 0, 0},
+    {2, -1, -1, 2, 2, -3, 0, 0, 0},
+    {0, 0, 3, 2, 2, -3, 0, 0, 0},
+    {2, -1, 0, 2, 2, -3, 0, 0, 0},
+};
+
+static double julianCenturies(double jd)
+{
+    return (jd - ASTRO_TIME::J2000_JD) / JULIAN_CENTURY_DAYS;
+}
+
+static void toVector(double ra_hrs, double dec_deg, double u[3])
+{
+    double ra = ra_hrs * 15.0 * DEG2RAD;
+    double dec = dec_deg * DEG2RAD;
+    u[0] = std::cos(dec) * std::cos(ra);
+    u[1] = std::cos(dec) * std::sin(ra);
+    u[2] = std::sin(dec);
+}
+
+static void fromVector(const double u[3], double *ra_hrs, double *dec_deg)
+{
+    double ra = std::atan2(u[1], u[0]) / DEG2RAD / 15.0;
+    if (ra < 0.0)
+        ra += 24.0;
+    *ra_hrs = ra;
+    *dec_deg = std::atan2(u[2], std::hypot(u[0], u[1])) / DEG2RAD;
+}
+
+static void normalize(double u[3])
+{
+    double n = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    for (int i = 0; i < 3; i++)
+        u[i] /= n;
+}
+
+// m = R(axis, angle) * m, where R rotates the coordinate frame by angle about the axis
+static void rotate(int axis, double angle, double m[3][3])
+{
+    int i = (axis + 1) % 3, j = (axis + 2) % 3;
+    double c = std::cos(angle), s = std::sin(angle);
+    for (int k = 0; k < 3; k++)
+    {
+        double a = m[i][k], b = m[j][k];
+        m[i][k] = c * a + s * b;
+        m[j][k] = -s * a + c * b;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+ApparentPlace::ApparentPlace()
+    : latitude_rad(0.0), longitude_deg(0.0),
+      conditions{DEFAULT_TEMPERATURE_C, DEFAULT_PRESSURE_HPA, 0.0, 0.0},
+      poleLatitude_rad(0.0), poleLongitude_deg(0.0), diurnalAberration_rad(DIURNAL_ABERRATION_ARCSEC * ARCSEC2RAD),
+      slowTermsValid(false), slowTermsJD(0.0), precessNutate{}, earthVelocity_c{}, eqEquinoxes_hrs(0.0),
+      targetValid(false), targetRA_hrs(0.0), targetDec_deg(0.0), targetApparent{}
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// The site is moved from the mean pole to the instantaneous pole by the IERS polar motion.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::setSite(double latitude_deg, double longitude_deg)
+{
+    this->latitude_rad = latitude_deg * DEG2RAD;
+    this->longitude_deg = longitude_deg;
+
+    double xp = conditions.polarMotionX_arcsec * ARCSEC2RAD;
+    double yp = conditions.polarMotionY_arcsec * ARCSEC2RAD;
+    double lon = longitude_deg * DEG2RAD;
+    poleLatitude_rad = latitude_rad + xp * std::cos(lon) - yp * std::sin(lon);
+    poleLongitude_deg = longitude_deg + (xp * std::sin(lon) + yp * std::cos(lon)) * std::tan(latitude_rad) / DEG2RAD;
+    diurnalAberration_rad = DIURNAL_ABERRATION_ARCSEC * ARCSEC2RAD * std::cos(poleLatitude_rad);
+}
+
+void ApparentPlace::setConditions(const ObservingConditions &conditions)
+{
+    this->conditions = conditions;
+    setSite(latitude_rad / DEG2RAD, longitude_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Meeus chapter 22
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::nutation(double jd, double *dpsi_arcsec, double *deps_arcsec)
+{
+    double T = julianCenturies(jd);
+    double D = (297.85036 + T * (445267.111480 + T * (-0.0019142 + T / 189474.0))) * DEG2RAD;
+    double M = (357.52772 + T * (35999.050340 + T * (-0.0001603 - T / 300000.0))) * DEG2RAD;
+    double Mp = (134.96298 + T * (477198.867398 + T * (0.0086972 + T / 56250.0))) * DEG2RAD;
+    double F = (93.27191 + T * (483202.017538 + T * (-0.0036825 + T / 327270.0))) * DEG2RAD;
+    double Om = (125.04452 + T * (-1934.136261 + T * (0.0020708 + T / 450000.0))) * DEG2RAD;
+
+    double dpsi = 0.0, deps = 0.0;
+    for (const NutationTerm &n : NUTATION_TERMS)
+    {
+        double arg = n.D * D + n.M * M + n.Mp * Mp + n.F * F + n.Om * Om;
+        dpsi += (n.psi + n.psiT * T) * std::sin(arg);
+        deps += (n.eps + n.epsT * T) * std::cos(arg);
+    }
+    *dpsi_arcsec = dpsi * 1e-4;
+    *deps_arcsec = deps * 1e-4;
+}
+
+double ApparentPlace::meanObliquity(double jd)
+{
+    double T = julianCenturies(jd);
+    return 23.0 + 26.0 / 60.0 + (21.448 + T * (-46.8150 + T * (-0.00059 + T * 0.001813))) / 3600.0;
+}
+
+double ApparentPlace::equationOfEquinoxes(double jd)
+{
+    double dpsi, deps;
+    nutation(jd, &dpsi, &deps);
+    double eps = meanObliquity(jd) * DEG2RAD + deps * ARCSEC2RAD;
+    return dpsi * std::cos(eps) / 3600.0 / 15.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Precession-nutation matrix (Meeus 21.3 and 22), equation of the equinoxes and the Earth's
+/// velocity in units of c (the vector form of Meeus 23.3, including the e-terms).
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::updateSlowTerms(double jd)
+{
+    if (slowTermsValid && std::fabs(jd - slowTermsJD) * ASTRO_TIME::SEC_PER_DAY < SLOW_TERMS_PERIOD_SEC)
+        return;
+
+    double T = julianCenturies(jd);
+    double zeta = T * (2306.2181 + T * (0.30188 + T * 0.017998)) * ARCSEC2RAD;
+    double z = T * (2306.2181 + T * (1.09468 + T * 0.018203)) * ARCSEC2RAD;
+    double theta = T * (2004.3109 + T * (-0.42665 - T * 0.041833)) * ARCSEC2RAD;
+
+    double dpsi, deps;
+    nutation(jd, &dpsi, &deps);
+    double eps0 = meanObliquity(jd) * DEG2RAD;
+    double eps = eps0 + deps * ARCSEC2RAD;
+
+    double m[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    rotate(2, -zeta, m);
+    rotate(1, theta, m);
+    rotate(2, -z, m);
+    rotate(0, eps0, m);
+    rotate(2, -dpsi * ARCSEC2RAD, m);
+    rotate(0, -eps, m);
+    for (int i = 0; i < 3; i++)
+        for (int k = 0; k < 3; k++)
+            precessNutate[i][k] = m[i][k];
+
+    eqEquinoxes_hrs = dpsi * std::cos(eps) / 3600.0 / 15.0;
+
+    double L0 = 280.46646 + T * (36000.76983 + T * 0.0003032);
+    double M = (357.52911 + T * (35999.05029 - T * 0.0001537)) * DEG2RAD;
+    double C = (1.914602 - T * (0.004817 + T * 0.000014)) * std::sin(M) +
+               (0.019993 - T * 0.000101) * std::sin(2.0 * M) + 0.000289 * std::sin(3.0 * M);
+    double sunLon = (L0 + C) * DEG2RAD;
+    double e = 0.016708634 - T * (0.000042037 + T * 0.0000001267);
+    double perihelion = (102.93735 + T * (1.71946 + T * 0.00046)) * DEG2RAD;
+    double kappa = ABERRATION_CONSTANT_ARCSEC * ARCSEC2RAD;
+    double vx = kappa * (std::sin(sunLon) - e * std::sin(perihelion));
+    double vy = -kappa * (std::cos(sunLon) - e * std::cos(perihelion));
+    earthVelocity_c[0] = vx;
+    earthVelocity_c[1] = vy * std::cos(eps);
+    earthVelocity_c[2] = vy * std::sin(eps);
+
+    slowTermsJD = jd;
+    slowTermsValid = true;
+    targetValid = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::catalogToOfDate(double jd, double ra_hrs, double dec_deg, double *raDate_hrs, double *decDate_deg)
+{
+    updateSlowTerms(jd);
+    double u0[3], u[3];
+    toVector(ra_hrs, dec_deg, u0);
+    for (int i = 0; i < 3; i++)
+        u[i] = precessNutate[i][0] * u0[0] + precessNutate[i][1] * u0[1] + precessNutate[i][2] * u0[2];
+    fromVector(u, raDate_hrs, decDate_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Annual aberration to first order in v/c. The second order term is under 0.01 arcsec.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::apparentDirection(double jd, double ra_hrs, double dec_deg, double u[3])
+{
+    updateSlowTerms(jd);
+    if (!targetValid || ra_hrs != targetRA_hrs || dec_deg != targetDec_deg)
+    {
+        toVector(ra_hrs, dec_deg, targetApparent);
+        for (int i = 0; i < 3; i++)
+            targetApparent[i] += earthVelocity_c[i];
+        normalize(targetApparent);
+        targetRA_hrs = ra_hrs;
+        targetDec_deg = dec_deg;
+        targetValid = true;
+    }
+    for (int i = 0; i < 3; i++)
+        u[i] = targetApparent[i];
+}
+
+void ApparentPlace::ofDateToApparent(double jd, double ra_hrs, double dec_deg, double *raApp_hrs, double *decApp_deg)
+{
+    double u[3];
+    apparentDirection(jd, ra_hrs, dec_deg, u);
+    fromVector(u, raApp_hrs, decApp_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Local apparent sidereal time [rad] on the instantaneous pole's meridian
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double ApparentPlace::apparentSiderealAngle(double jd) const
+{
+    double last_hrs = AstroClock::meanSiderealTime(jd) + eqEquinoxes_hrs + poleLongitude_deg / 15.0;
+    return last_hrs * 15.0 * DEG2RAD;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// hadec is (cos(dec)cos(H), -cos(dec)sin(H), sin(dec)). Diurnal aberration displaces the
+/// target toward the east point, then the altitude is refracted.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::topocentricToObserved(const double hadec[3], double *alt_deg, double *az_deg) const
+{
+    double sinLat = std::sin(poleLatitude_rad), cosLat = std::cos(poleLatitude_rad);
+    double north = cosLat * hadec[2] - sinLat * hadec[0];
+    double east = hadec[1] + diurnalAberration_rad;
+    double up = sinLat * hadec[2] + cosLat * hadec[0];
+
+    double alt = std::atan2(up, std::hypot(north, east)) / DEG2RAD;
+    double az = std::atan2(east, north) / DEG2RAD;
+    if (az < 0.0)
+        az += 360.0;
+    *alt_deg = alt + refraction(alt);
+    *az_deg = az;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::ofDateToObserved(double jd, double ra_hrs, double dec_deg, double *alt_deg, double *az_deg)
+{
+    double u[3];
+    apparentDirection(jd, ra_hrs, dec_deg, u);
+
+    double last = apparentSiderealAngle(jd);
+    double c = std::cos(last), s = std::sin(last);
+    double hadec[3] = {c * u[0] + s * u[1], -s * u[0] + c * u[1], u[2]};
+    topocentricToObserved(hadec, alt_deg, az_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Inverse of ofDateToObserved, to well under 0.01 arcsec above the horizon
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void ApparentPlace::observedToOfDate(double jd, double alt_deg, double az_deg, double *ra_hrs, double *dec_deg)
+{
+    updateSlowTerms(jd);
+    double alt = removeRefraction(alt_deg) * DEG2RAD;
+    double az = az_deg * DEG2RAD;
+    double north = std::cos(alt) * std::cos(az);
+    double east = std::cos(alt) * std::sin(az) - diurnalAberration_rad;
+    double up = std::sin(alt);
+
+    double sinLat = std::sin(poleLatitude_rad), cosLat = std::cos(poleLatitude_rad);
+    double hadec[3] = {cosLat * up - sinLat * north, east, sinLat * up + cosLat * north};
+
+    double last = apparentSiderealAngle(jd);
+    double c = std::cos(last), s = std::sin(last);
+    double u[3] = {c * hadec[0] - s * hadec[1], s * hadec[0] + c * hadec[1], hadec[2]};
+    normalize(u);
+    for (int i = 0; i < 3; i++)
+        u[i] -= earthVelocity_c[i];
+    fromVector(u, ra_hrs, dec_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Saemundsson's formula (Meeus 16.4, zeroed at the zenith) scaled to the site pressure and
+/// temperature. Good to a few arcseconds above 15 deg; the pointing model takes up the rest.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double ApparentPlace::refraction(double trueAlt_deg) const
+{
+    if (conditions.pressure_hPa <= 0.0)
+        return 0.0;
+    double h = std::max(trueAlt_deg, REFRACTION_MIN_ALT_DEG);
+    double R_arcmin = 1.02 / std::tan((h + 10.3 / (h + 5.11)) * DEG2RAD) + 0.0019279;
+    double scale = (conditions.pressure_hPa / 1010.0) * (283.0 / (273.0 + conditions.temperature_C));
+    return R_arcmin * scale / 60.0;
+}
+
+double ApparentPlace::removeRefraction(double observedAlt_deg) const
+{
+    double h = observedAlt_deg;
+    for (unsigned k = 0; k < REFRACTION_INVERSE_ITERATIONS; k++)
+        h = observedAlt_deg - refraction(h);
+    return h;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+namespace APPARENT_PLACE
+{
+    constexpr double JULIAN_CENTURY_DAYS = 36525.0;
+    // Precession, nutation and aberration change by under 0.001 arcsec in this time
+    constexpr double SLOW_TERMS_PERIOD_SEC = 60.0;
+    constexpr double DEFAULT_TEMPERATURE_C = 10.0;
+    constexpr double DEFAULT_PRESSURE_HPA = 1010.0;
+    // Refraction is held at its value here below this altitude (the model diverges near -5 deg)
+    constexpr double REFRACTION_MIN_ALT_DEG = -1.0;
+    constexpr unsigned REFRACTION_INVERSE_ITERATIONS = 8;
+    // Aberration constant and the diurnal aberration at the equator [arcsec]
+    constexpr double ABERRATION_CONSTANT_ARCSEC = 20.49552;
+    constexpr double DIURNAL_ABERRATION_ARCSEC = 0.3200;
+}
+
+// Site weather for refraction, and the IERS pole offsets [arcsec]. Zero pressure turns refraction off.
+struct ObservingConditions
+{
+    double temperature_C;
+    double pressure_hPa;
+    double polarMotionX_arcsec;
+    double polarMotionY_arcsec;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Catalog and equinox-of-date RA/Dec to observed alt/az, and back.
+///
+///   J2000 mean place --[precession IAU 1976, nutation IAU 1980]--> true equator of date
+///   true equator of date (INDI JNow) --[annual aberration]--> apparent place
+///   apparent place --[apparent sidereal time, polar motion, diurnal aberration]--> topocentric
+///   topocentric altitude --[refraction]--> observed altitude
+///
+/// The precession-nutation matrix, the Earth's velocity and the equation of the equinoxes only
+/// change noticeably over days, so they're computed at most once per SLOW_TERMS_PERIOD_SEC and
+/// the apparent place of the last target is cached against them. Per call only the rotation
+/// into the observer frame and the refraction are evaluated. The caches make the conversions
+/// non-const, so each thread needs its own copy.
+///
+/// INDI's equinox-of-date coordinates are taken to include precession and nutation but not
+/// aberration. Light deflection and the deflection of the vertical are left out; they are
+/// under an arcsecond away from the Sun, and constant parts go into the pointing model.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class ApparentPlace
+{
+public:
+    ApparentPlace();
+
+    void setSite(double latitude_deg, double longitude_deg);
+    void setConditions(const ObservingConditions &conditions);
+    const ObservingConditions &getConditions() const { return conditions; }
+
+    // J2000 mean place -> true equator and equinox of date [hours, deg]
+    void catalogToOfDate(double jd, double ra_hrs, double dec_deg, double *raDate_hrs, double *decDate_deg);
+    // Equinox of date -> apparent place (annual aberration) [hours, deg]
+    void ofDateToApparent(double jd, double ra_hrs, double dec_deg, double *raApp_hrs, double *decApp_deg);
+    // Equinox of date <-> observed alt/az [deg], azimuth north through east
+    void ofDateToObserved(double jd, double ra_hrs, double dec_deg, double *alt_deg, double *az_deg);
+    void observedToOfDate(double jd, double alt_deg, double az_deg, double *ra_hrs, double *dec_deg);
+
+    // Refraction [deg] to add to a true altitude, and the true altitude for an observed one
+    double refraction(double trueAlt_deg) const;
+    double removeRefraction(double observedAlt_deg) const;
+
+    // IAU 1980 nutation in longitude and obliquity [arcsec]
+    static void nutation(double jd, double *dpsi_arcsec, double *deps_arcsec);
+    // Mean obliquity of the ecliptic [deg]
+    static double meanObliquity(double jd);
+    // Apparent minus mean sidereal time [hours]
+    static double equationOfEquinoxes(double jd);
+
+private:
+    void updateSlowTerms(double jd);
+    void apparentDirection(double jd, double ra_hrs, double dec_deg, double u[3]);
+    void topocentricToObserved(const double hadec[3], double *alt_deg, double *az_deg) const;
+    double apparentSiderealAngle(double jd) const;
+
+    double latitude_rad;
+    double longitude_deg;
+    ObservingConditions conditions;
+
+    // Polar motion corrected site, and the diurnal aberration there [rad]
+    double poleLatitude_rad;
+    double poleLongitude_deg;
+    double diurnalAberration_rad;
+
+    // Slow terms
+    bool slowTermsValid;
+    double slowTermsJD;
+    double precessNutate[3][3];
+    double earthVelocity_c[3];
+    double eqEquinoxes_hrs;
+
+    // Apparent place of the last equinox-of-date target, valid for the current slow terms
+    bool targetValid;
+    double targetRA_hrs;
+    double targetDec_deg;
+    double targetApparent[3];
+};
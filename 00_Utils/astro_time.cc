@@ -0,0 +1,94 @@
+#include "astro_time.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace ASTRO_TIME;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+AstroClock::AstroClock(Clock monotonic, Clock utc)
+    : monotonicClock(monotonic), utcClock(utc), anchored(false), anchorMonotonic_s(0.0), anchorJD(0.0),
+      ctx{false, 0.0, 0.0, 0.0, 0.0, 0.0}
+{
+}
+
+double AstroClock::steadySeconds()
+{
+    auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(sinceEpoch).count();
+}
+
+double AstroClock::systemUnixSeconds()
+{
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(sinceEpoch).count();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Greenwich mean sidereal time [hours] for a UT Julian date
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double AstroClock::meanSiderealTime(double jd)
+{
+    double d = jd - J2000_JD;
+    double t = d / 36525.0;
+    double gmst_deg = 280.46061837 + 360.98564736629 * d + t * t * (0.000387933 - t / 38710000.0);
+    gmst_deg = std::fmod(gmst_deg, 360.0);
+    if (gmst_deg < 0.0)
+        gmst_deg += 360.0;
+    return gmst_deg / 15.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double AstroClock::julianDateAt(double monotonic_s) const
+{
+    return anchorJD + (monotonic_s - anchorMonotonic_s) / SEC_PER_DAY;
+}
+
+double AstroClock::julianDate() const
+{
+    double mono = monotonicClock();
+    std::lock_guard<std::mutex> lock(anchorMtx);
+    if (!anchored)
+        return UNIX_EPOCH_JD + utcClock() / SEC_PER_DAY;
+    return julianDateAt(mono);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+const AstroTimeContext &AstroClock::update(double longitude_deg)
+{
+    double mono = monotonicClock();
+    double jd;
+    {
+        std::lock_guard<std::mutex> lock(anchorMtx);
+        if (!anchored || mono - anchorMonotonic_s >= REANCHOR_PERIOD_SEC)
+        {
+            anchorJD = UNIX_EPOCH_JD + utcClock() / SEC_PER_DAY;
+            anchorMonotonic_s = mono;
+            anchored = true;
+        }
+        jd = julianDateAt(mono);
+    }
+
+    if (ctx.valid)
+    {
+        double backstep_s = (ctx.jd - jd) * SEC_PER_DAY;
+        if (backstep_s > 0.0 && backstep_s < MAX_HELD_BACKSTEP_SEC)
+            jd = ctx.jd;
+    }
+
+    ctx.valid = true;
+    ctx.jd = jd;
+    ctx.monotonic_s = mono;
+    ctx.gmst_hrs = meanSiderealTime(jd);
+    ctx.lst_hrs = std::fmod(ctx.gmst_hrs + longitude_deg / 15.0, 24.0);
+    if (ctx.lst_hrs < 0.0)
+        ctx.lst_hrs += 24.0;
+    ctx.lst_rad = ctx.lst_hrs * M_PI / 12.0;
+    return ctx;
+}
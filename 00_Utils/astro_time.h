@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+
+namespace ASTRO_TIME
+{
+    constexpr double SEC_PER_DAY = 86400.0;
+    constexpr double UNIX_EPOCH_JD = 2440587.5;
+    constexpr double J2000_JD = 2451545.0;
+    // How often the monotonic clock is re-anchored to UTC, to follow NTP corrections
+    constexpr double REANCHOR_PERIOD_SEC = 60.0;
+    // A re-anchor that moves the time back by less than this is held off rather than stepped
+    // back, so the time never runs backwards between ticks. Larger steps are real clock changes.
+    constexpr double MAX_HELD_BACKSTEP_SEC = 1.0;
+}
+
+// One consistent time for everything computed in a control tick
+struct AstroTimeContext
+{
+    bool valid;
+    double jd;           // UTC Julian date
+    double gmst_hrs;     // Greenwich mean sidereal time
+    double lst_hrs;      // Local mean sidereal time
+    double lst_rad;      // Local mean sidereal time as an angle
+    double monotonic_s;  // Steady clock reading the context was built from
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Astronomical time from a monotonic clock anchored to UTC. Reading the system clock and
+/// converting it through libnova in every function that needs the time costs several conversions
+/// per tick, and each one sees a slightly different time. Instead, update() builds one context
+/// per tick and everything in the tick reads it. Intervals come from the steady clock, so they
+/// are unaffected by system clock steps.
+///
+/// Sidereal time is the mean sidereal time (Meeus 12.4), which is what the libnova
+/// equatorial/horizontal transforms use.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class AstroClock
+{
+public:
+    // Seconds: any epoch for the monotonic clock, the Unix epoch for the UTC clock
+    typedef std::function<double()> Clock;
+
+    AstroClock(Clock monotonic = steadySeconds, Clock utc = systemUnixSeconds);
+    virtual ~AstroClock() {}
+
+    // Builds the context for this tick at the given (east positive) longitude
+    const AstroTimeContext &update(double longitude_deg);
+    // Most recent context from update()
+    const AstroTimeContext &now() const { return ctx; }
+    // Current Julian date on the same time base, without building a context. Thread safe.
+    double julianDate() const;
+
+    static double meanSiderealTime(double jd);
+    static double steadySeconds();
+    static double systemUnixSeconds();
+
+private:
+    double julianDateAt(double monotonic_s) const;
+
+    Clock monotonicClock;
+    Clock utcClock;
+    mutable std::mutex anchorMtx;
+    bool anchored;
+    double anchorMonotonic_s;
+    double anchorJD;
+    AstroTimeContext ctx;
+};
@@ -0,0 +1,263 @@
+#include "batch_controller.h"
+#include "math_util.h"
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BatchPID_Controller::BatchPID_Controller(std::size_t numLanes)
+    : Kp(numLanes, 0.0),
+      Ki(numLanes, 0.0),
+      Kd(numLanes, 0.0),
+      Kb(numLanes, 0.0),
+      integratorState(numLanes, 0.0),
+      e_prev(numLanes, 0.0),
+      intULim(numLanes, DIGITAL_CONTROL::pos_inf),
+      intLLim(numLanes, DIGITAL_CONTROL::neg_inf),
+      outULim(numLanes, DIGITAL_CONTROL::pos_inf),
+      outLLim(numLanes, DIGITAL_CONTROL::neg_inf),
+      firstTime(numLanes, 1),
+      laneFlags(numLanes, 0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::setLaneFlag(std::size_t idx, uint32_t flag, bool value)
+{
+    if (value)
+        laneFlags.at(idx) |= flag;
+    else
+        laneFlags.at(idx) &= ~flag;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::configureGains(std::size_t idx, double _kp, double _ki, double _kd)
+{
+    Kp.at(idx) = _kp;
+    Ki.at(idx) = _ki;
+    Kd.at(idx) = _kd;
+
+    setLaneFlag(idx, DIGITAL_CONTROL::P_BIT, _kp != 0);
+    setLaneFlag(idx, DIGITAL_CONTROL::I_BIT, _ki != 0);
+    setLaneFlag(idx, DIGITAL_CONTROL::D_BIT, _kd != 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::configureIntegratorSaturation(std::size_t idx, double ulim, double llim)
+{
+    intULim.at(idx) = ulim;
+    intLLim.at(idx) = llim;
+    setLaneFlag(idx, DIGITAL_CONTROL::LIMIT_INTEGRATOR_BIT, true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::configureOutputSaturation(std::size_t idx, double ulim, double llim)
+{
+    outULim.at(idx) = ulim;
+    outLLim.at(idx) = llim;
+    setLaneFlag(idx, DIGITAL_CONTROL::LIMIT_OUTPUT_BIT, true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::configureAntiWindup(std::size_t idx, double _kb)
+{
+    Kb.at(idx) = _kb;
+    setLaneFlag(idx, DIGITAL_CONTROL::ANTI_WINDUP_BIT, _kb > 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Same as PID_Controller::initializeIntegrator()
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::initializeIntegrator(std::size_t idx, double u0, double e)
+{
+    firstTime.at(idx) = 1;
+    e_prev.at(idx) = e;
+
+    double state = u0;
+    if (laneFlags[idx] & DIGITAL_CONTROL::P_BIT)
+        state -= e * Kp[idx];
+    if (laneFlags[idx] & DIGITAL_CONTROL::LIMIT_INTEGRATOR_BIT)
+        state = saturate(state, intLLim[idx], intULim[idx]);
+    integratorState[idx] = (laneFlags[idx] & DIGITAL_CONTROL::I_BIT) ? state : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::reset(std::size_t idx)
+{
+    firstTime.at(idx) = 1;
+    e_prev.at(idx) = 0.0;
+    integratorState.at(idx) = 0.0;
+}
+
+void BatchPID_Controller::resetAll()
+{
+    std::fill(firstTime.begin(), firstTime.end(), 1);
+    std::fill(e_prev.begin(), e_prev.end(), 0.0);
+    std::fill(integratorState.begin(), integratorState.end(), 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Mirrors PID_Controller::update() operation for operation. The branches are replaced by
+/// selects so the loop body is straight-line code. The arrays are passed as restrict-qualified
+/// arguments so that GCC doesn't give up on the runtime alias checks.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static void batchPidKernel(std::size_t n, double dt,
+                           const double *__restrict e,
+                           double *__restrict uC,
+                           const double *__restrict kp,
+                           const double *__restrict ki,
+                           const double *__restrict kd,
+                           const double *__restrict kb,
+                           const double *__restrict iul,
+                           const double *__restrict ill,
+                           const double *__restrict oul,
+                           const double *__restrict oll,
+                           const uint32_t *__restrict flags,
+                           double *__restrict iState,
+                           double *__restrict ePrev,
+                           uint32_t *__restrict first)
+{
+    for (std::size_t ii = 0; ii < n; ii++)
+    {
+        const double e_ii = e[ii];
+        const uint32_t f = flags[ii];
+        const bool pOn = (f & DIGITAL_CONTROL::P_BIT) != 0;
+        const bool iOn = (f & DIGITAL_CONTROL::I_BIT) != 0;
+        const bool dOn = (f & DIGITAL_CONTROL::D_BIT) != 0;
+        const bool limInt = (f & DIGITAL_CONTROL::LIMIT_INTEGRATOR_BIT) != 0;
+        const bool limOut = (f & DIGITAL_CONTROL::LIMIT_OUTPUT_BIT) != 0;
+        const bool bleed = iOn && (f & DIGITAL_CONTROL::ANTI_WINDUP_BIT) != 0;
+
+        // Every term is computed unconditionally and then selected
+        double prop_term = e_ii * kp[ii];
+        double newState = iState[ii] + e_ii * ki[ii] * dt;
+        double state = iOn ? newState : iState[ii];
+        double satState = saturate(state, ill[ii], iul[ii]);
+        double int_term = limInt ? satState : state;
+        double rawDiff = (e_ii - ePrev[ii]) / dt;
+        double diff = first[ii] ? 0.0 : rawDiff;
+        double diff_term = diff * kd[ii];
+
+        double output = 0.0;
+        double out_p = output + prop_term;
+        output = pOn ? out_p : output;
+        double out_i = output + int_term;
+        output = iOn ? out_i : output;
+        double out_d = output + diff_term;
+        output = dOn ? out_d : output;
+
+        double satOutput = saturate(output, oll[ii], oul[ii]);
+        double output_post_sat = limOut ? satOutput : output;
+        double bleedState = state + kb[ii] * (output_post_sat - output) * dt;
+        state = bleed ? bleedState : state;
+
+        iState[ii] = state;
+        ePrev[ii] = dOn ? e_ii : ePrev[ii];
+        first[ii] = dOn ? 0 : first[ii];
+        uC[ii] = output_post_sat;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchPID_Controller::update(const double *e, double dt, double *uC)
+{
+    batchPidKernel(size(), dt, e, uC,
+                   Kp.data(), Ki.data(), Kd.data(), Kb.data(),
+                   intULim.data(), intLLim.data(), outULim.data(), outLLim.data(),
+                   laneFlags.data(),
+                   integratorState.data(), e_prev.data(), firstTime.data());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BatchBiquadFilter::BatchBiquadFilter(std::size_t numLanes)
+    : b0(numLanes, 1.0),
+      b1(numLanes, 0.0),
+      b2(numLanes, 0.0),
+      a1(numLanes, 0.0),
+      a2(numLanes, 0.0),
+      v1(numLanes, 0.0),
+      v2(numLanes, 0.0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchBiquadFilter::setCoefficients(std::size_t idx, const DIGITAL_CONTROL::BiquadCoeffs &c)
+{
+    b0.at(idx) = c.b0;
+    b1.at(idx) = c.b1;
+    b2.at(idx) = c.b2;
+    a1.at(idx) = c.a1;
+    a2.at(idx) = c.a2;
+}
+
+void BatchBiquadFilter::reset(std::size_t idx)
+{
+    v1.at(idx) = 0.0;
+    v2.at(idx) = 0.0;
+}
+
+void BatchBiquadFilter::resetAll()
+{
+    std::fill(v1.begin(), v1.end(), 0.0);
+    std::fill(v2.begin(), v2.end(), 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Mirrors BiquadFilter::update() operation for operation.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static void batchBiquadKernel(std::size_t n,
+                              const double *__restrict x,
+                              double *__restrict y,
+                              const double *__restrict b0,
+                              const double *__restrict b1,
+                              const double *__restrict b2,
+                              const double *__restrict a1,
+                              const double *__restrict a2,
+                              double *__restrict v1,
+                              double *__restrict v2)
+{
+    for (std::size_t ii = 0; ii < n; ii++)
+    {
+        double v_n = x[ii];
+        v_n -= a1[ii] * v1[ii];
+        v_n -= a2[ii] * v2[ii];
+
+        double y_n = 0.0;
+        y_n += b0[ii] * v_n;
+        y_n += b1[ii] * v1[ii];
+        y_n += b2[ii] * v2[ii];
+
+        v2[ii] = v1[ii];
+        v1[ii] = v_n;
+        y[ii] = y_n;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BatchBiquadFilter::update(const double *x, double *y)
+{
+    batchBiquadKernel(size(), x, y,
+                      b0.data(), b1.data(), b2.data(), a1.data(), a2.data(),
+                      v1.data(), v2.data());
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "PID_Controller.h"
+#include "biquad_filter.h"
+
+namespace DIGITAL_CONTROL
+{
+    // Per-lane configuration flags for BatchPID_Controller (the low bits are the P/I/D bits)
+    const uint32_t LIMIT_INTEGRATOR_BIT = 0b001000;
+    const uint32_t LIMIT_OUTPUT_BIT = 0b010000;
+    const uint32_t ANTI_WINDUP_BIT = 0b100000;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Structure-of-arrays bank of PID controllers. Each lane behaves exactly like a PID_Controller
+/// (results are bit-identical), but all lanes are updated in one branch-free pass over contiguous
+/// arrays so the compiler can vectorize it.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BatchPID_Controller
+{
+public:
+    BatchPID_Controller(std::size_t numLanes);
+    virtual ~BatchPID_Controller() {}
+
+    std::size_t size() const { return Kp.size(); }
+    void configureGains(std::size_t idx, double _kp, double _ki, double _kd);
+    void configureIntegratorSaturation(std::size_t idx, double ulim, double llim);
+    void configureOutputSaturation(std::size_t idx, double ulim, double llim);
+    void configureAntiWindup(std::size_t idx, double _kb);
+    void initializeIntegrator(std::size_t idx, double u0, double e);
+    void reset(std::size_t idx);
+    void resetAll();
+    // e and uC must each point to size() values and must not overlap
+    void update(const double *e, double dt, double *uC);
+
+private:
+    std::vector<double> Kp;
+    std::vector<double> Ki;
+    std::vector<double> Kd;
+    std::vector<double> Kb;
+    std::vector<double> integratorState;
+    std::vector<double> e_prev;
+    std::vector<double> intULim;
+    std::vector<double> intLLim;
+    std::vector<double> outULim;
+    std::vector<double> outLLim;
+    // 32 bit lane flags: SSE2 has no 64 bit integer compare, which would block vectorization
+    std::vector<uint32_t> firstTime;
+    std::vector<uint32_t> laneFlags;
+    void setLaneFlag(std::size_t idx, uint32_t flag, bool value);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Structure-of-arrays bank of second order sections, bit-identical to BiquadFilter per lane.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BatchBiquadFilter
+{
+public:
+    BatchBiquadFilter(std::size_t numLanes);
+    virtual ~BatchBiquadFilter() {}
+
+    std::size_t size() const { return b0.size(); }
+    void setCoefficients(std::size_t idx, const DIGITAL_CONTROL::BiquadCoeffs &c);
+    void reset(std::size_t idx);
+    void resetAll();
+    // x and y must each point to size() values and must not overlap
+    void update(const double *x, double *y);
+
+private:
+    std::vector<double> b0;
+    std::vector<double> b1;
+    std::vector<double> b2;
+    std::vector<double> a1;
+    std::vector<double> a2;
+    std::vector<double> v1;
+    std::vector<double> v2;
+};
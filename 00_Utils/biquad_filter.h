@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cinttypes>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "math_util.h"
+
+namespace DIGITAL_CONTROL
+{
+    // Notches deeper than this are realized as a true (infinite depth) notch
+    constexpr double NOTCH_MAX_DEPTH_DB = 120.0;
+    constexpr double BUTTERWORTH_Q = M_SQRT1_2;
+
+    // Second order section, normalized so that a0 == 1
+    struct BiquadCoeffs
+    {
+        double b0;
+        double b1;
+        double b2;
+        double a1;
+        double a2;
+    };
+
+    inline BiquadCoeffs passthroughBiquad()
+    {
+        return BiquadCoeffs{1.0, 0.0, 0.0, 0.0, 0.0};
+    }
+
+    inline void checkBiquadFrequency(double fc_Hz, double fs_Hz)
+    {
+        if (fs_Hz <= 0.0)
+            throw std::runtime_error("Biquad design: sample rate must be positive.");
+        if (fc_Hz <= 0.0 || fc_Hz >= 0.5 * fs_Hz)
+            throw std::runtime_error("Biquad design: frequency must be between 0 and Nyquist.");
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Notch with finite depth (RBJ peaking EQ with negative gain). Unity gain at DC and Nyquist,
+    /// -depth_dB at fc_Hz, with width_Hz being the bandwidth of the notch.
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    inline BiquadCoeffs designNotch(double fc_Hz, double depth_dB, double width_Hz, double fs_Hz)
+    {
+        checkBiquadFrequency(fc_Hz, fs_Hz);
+        if (width_Hz <= 0.0)
+            throw std::runtime_error("Notch design: width must be positive.");
+        if (depth_dB <= 0.0)
+            return passthroughBiquad();
+
+        double w0 = 2.0 * M_PI * fc_Hz / fs_Hz;
+        double cw0 = std::cos(w0);
+        double alpha = std::sin(w0) * width_Hz / (2.0 * fc_Hz);
+
+        double b0, b1, b2, a0, a1, a2;
+        if (depth_dB >= NOTCH_MAX_DEPTH_DB)
+        {
+            b0 = 1.0;
+            b1 = -2.0 * cw0;
+            b2 = 1.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cw0;
+            a2 = 1.0 - alpha;
+        }
+        else
+        {
+            double A = std::pow(10.0, -depth_dB / 40.0);
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cw0;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cw0;
+            a2 = 1.0 - alpha / A;
+        }
+        return BiquadCoeffs{b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Second order low-pass (RBJ). Defaults to a Butterworth response.
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    inline BiquadCoeffs designLowPass(double fc_Hz, double fs_Hz, double q = BUTTERWORTH_Q)
+    {
+        checkBiquadFrequency(fc_Hz, fs_Hz);
+        if (q <= 0.0)
+            throw std::runtime_error("Low-pass design: Q must be positive.");
+
+        double w0 = 2.0 * M_PI * fc_Hz / fs_Hz;
+        double cw0 = std::cos(w0);
+        double alpha = std::sin(w0) / (2.0 * q);
+
+        double a0 = 1.0 + alpha;
+        double b1 = 1.0 - cw0;
+        double b0 = 0.5 * b1;
+        return BiquadCoeffs{b0 / a0, b1 / a0, b0 / a0, -2.0 * cw0 / a0, (1.0 - alpha) / a0};
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Direct form II second order section. Same structure as DF2_IIR, but the coefficients can be
+/// swapped at runtime without disturbing the filter state.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BiquadFilter
+{
+public:
+    BiquadFilter() : coeffs(DIGITAL_CONTROL::passthroughBiquad()) { reset(); }
+    BiquadFilter(const DIGITAL_CONTROL::BiquadCoeffs &c) : coeffs(c) { reset(); }
+    virtual ~BiquadFilter() {}
+
+    void setCoefficients(const DIGITAL_CONTROL::BiquadCoeffs &c) { coeffs = c; }
+    const DIGITAL_CONTROL::BiquadCoeffs &getCoefficients() const { return coeffs; }
+
+    void reset()
+    {
+        v1 = 0.0;
+        v2 = 0.0;
+    }
+
+    double update(double x_n)
+    {
+        double v_n = x_n;
+        v_n -= coeffs.a1 * v1;
+        v_n -= coeffs.a2 * v2;
+
+        double y_n = 0.0;
+        y_n += coeffs.b0 * v_n;
+        y_n += coeffs.b1 * v1;
+        y_n += coeffs.b2 * v2;
+
+        v2 = v1;
+        v1 = v_n;
+        return y_n;
+    }
+
+    // Magnitude of the frequency response at f_Hz
+    double gainAt(double f_Hz, double fs_Hz) const
+    {
+        double w = 2.0 * M_PI * f_Hz / fs_Hz;
+        double c1 = std::cos(w), s1 = std::sin(w);
+        double c2 = std::cos(2.0 * w), s2 = std::sin(2.0 * w);
+        double numRe = coeffs.b0 + coeffs.b1 * c1 + coeffs.b2 * c2;
+        double numIm = -(coeffs.b1 * s1 + coeffs.b2 * s2);
+        double denRe = 1.0 + coeffs.a1 * c1 + coeffs.a2 * c2;
+        double denIm = -(coeffs.a1 * s1 + coeffs.a2 * s2);
+        return std::sqrt((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+    }
+
+private:
+    DIGITAL_CONTROL::BiquadCoeffs coeffs;
+    double v1;
+    double v2;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed number of biquad stages run in series. Unconfigured stages pass the signal through.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BiquadCascade
+{
+public:
+    BiquadCascade(unsigned numStages) : stages(numStages) {}
+    virtual ~BiquadCascade() {}
+
+    unsigned numStages() const { return stages.size(); }
+
+    void setStage(unsigned idx, const DIGITAL_CONTROL::BiquadCoeffs &c)
+    {
+        stages.at(idx).setCoefficients(c);
+    }
+
+    void bypassStage(unsigned idx)
+    {
+        stages.at(idx).setCoefficients(DIGITAL_CONTROL::passthroughBiquad());
+    }
+
+    void reset()
+    {
+        for (auto &stage : stages)
+            stage.reset();
+    }
+
+    double update(double x_n)
+    {
+        double y_n = x_n;
+        for (auto &stage : stages)
+            y_n = stage.update(y_n);
+        return y_n;
+    }
+
+    double gainAt(double f_Hz, double fs_Hz) const
+    {
+        double gain = 1.0;
+        for (auto &stage : stages)
+            gain *= stage.gainAt(f_Hz, fs_Hz);
+        return gain;
+    }
+
+private:
+    std::vector<BiquadFilter> stages;
+};
@@ -0,0 +1,401 @@
+#include "bus_log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+using namespace BUS_LOG;
+
+namespace
+{
+    constexpr uint8_t FLAG_FAILED = 0x01;
+
+    double unixNow()
+    {
+        return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    void putVarint(std::vector<uint8_t> &buf, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            buf.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        buf.push_back((uint8_t)v);
+    }
+
+    template <typename T>
+    void put(std::vector<uint8_t> &buf, T v)
+    {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+}
+
+void busMarkPack(const double *values, unsigned n, uint16_t *words)
+{
+    std::memcpy(words, values, n * sizeof(double));
+}
+
+void busMarkUnpack(const uint16_t *words, unsigned n, double *values)
+{
+    std::memcpy(values, words, n * sizeof(double));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BusLogWriter::BusLogWriter(const std::string &path)
+    : path(path), fp(nullptr), prev_us(0), stopRequested(false), written(0)
+{
+    fp = std::fopen(path.c_str(), "wb");
+    if (!fp)
+    {
+        std::stringstream ss;
+        ss << "BusLogWriter: can't create " << path << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    const uint32_t header[2] = {VERSION, 0};
+    const double start = unixNow();
+    std::fwrite(MAGIC, sizeof(MAGIC), 1, fp);
+    std::fwrite(header, sizeof(header), 1, fp);
+    std::fwrite(&start, sizeof(start), 1, fp);
+    worker = std::thread(&BusLogWriter::workerLoop, this);
+}
+
+BusLogWriter::~BusLogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopRequested = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+    std::fclose(fp);
+}
+
+uint64_t BusLogWriter::getWritten() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return written;
+}
+
+std::string BusLogWriter::getError() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return error;
+}
+
+void BusLogWriter::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopRequested)
+    {
+        lock.unlock();
+        drain();
+        lock.lock();
+        cv.wait_for(lock, std::chrono::duration<double>(DRAIN_PERIOD_SEC),
+                    [this]()
+                    { return stopRequested; });
+    }
+    lock.unlock();
+    // The producer has stopped by now; write out the rest
+    drain();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Record: varint time delta [us], op, node, address (2 bytes), word count, flags, then the words,
+/// or for a failure the errno (4 bytes) instead.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void BusLogWriter::drain()
+{
+    BusLogEntry e;
+    uint64_t n = 0;
+    buffer.clear();
+    while (ring.pop(e))
+    {
+        const uint64_t t_us = (uint64_t)std::llround(std::max(0.0, e.t_s) * 1e6);
+        putVarint(buffer, t_us > prev_us ? t_us - prev_us : 0);
+        prev_us = std::max(prev_us, t_us);
+        const bool failed = e.result < 0;
+        buffer.push_back(e.op);
+        buffer.push_back(e.devId);
+        put<uint16_t>(buffer, e.addr);
+        buffer.push_back(e.numWords);
+        buffer.push_back(failed ? FLAG_FAILED : 0);
+        if (failed)
+            put<int32_t>(buffer, e.errnum);
+        else
+            for (unsigned k = 0; k < e.numWords; k++)
+                put<uint16_t>(buffer, e.words[k]);
+        n++;
+    }
+    if (n == 0)
+        return;
+    const bool ok = std::fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size() && std::fflush(fp) == 0;
+    std::lock_guard<std::mutex> lock(mtx);
+    if (ok)
+        written += n;
+    else
+        error = std::string("write failed: ") + std::strerror(errno);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BusLogReader::BusLogReader(const std::string &path)
+    : fp(std::fopen(path.c_str(), "rb")), startUnix(0.0), t_us(0)
+{
+    if (!fp)
+    {
+        std::stringstream ss;
+        ss << "BusLogReader: can't open " << path << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    char magic[sizeof(MAGIC)];
+    uint32_t header[2];
+    if (std::fread(magic, sizeof(magic), 1, fp) != 1 || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        std::fread(header, sizeof(header), 1, fp) != 1 || std::fread(&startUnix, sizeof(startUnix), 1, fp) != 1)
+    {
+        std::fclose(fp);
+        throw std::runtime_error("BusLogReader: " + path + " is not a bus log.");
+    }
+    if (header[0] != VERSION)
+    {
+        std::fclose(fp);
+        std::stringstream ss;
+        ss << "BusLogReader: " << path << " is version " << header[0] << ", expected " << VERSION << ".";
+        throw std::runtime_error(ss.str());
+    }
+}
+
+BusLogReader::~BusLogReader()
+{
+    std::fclose(fp);
+}
+
+bool BusLogReader::next(BusLogEntry &e)
+{
+    uint64_t delta = 0;
+    for (unsigned shift = 0;; shift += 7)
+    {
+        const int c = std::fgetc(fp);
+        if (c == EOF || shift > 63)
+            return false;
+        delta |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            break;
+    }
+    uint8_t fields[6];
+    if (std::fread(fields, sizeof(fields), 1, fp) != 1)
+        return false;
+    e.op = fields[0];
+    e.devId = fields[1];
+    std::memcpy(&e.addr, fields + 2, sizeof(e.addr));
+    e.numWords = fields[4];
+    if (e.numWords > MAX_WORDS)
+        return false;
+    if (fields[5] & FLAG_FAILED)
+    {
+        e.result = -1;
+        if (std::fread(&e.errnum, sizeof(e.errnum), 1, fp) != 1)
+            return false;
+    }
+    else
+    {
+        e.result = e.numWords;
+        e.errnum = 0;
+        if (e.numWords > 0 && std::fread(e.words, sizeof(uint16_t), e.numWords, fp) != e.numWords)
+            return false;
+    }
+    t_us += delta;
+    e.t_s = t_us * 1e-6;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BusRecorder::BusRecorder(std::unique_ptr<BusTransport> inner, const std::string &path)
+    : inner(std::move(inner)), writer(new BusLogWriter(path)), start(std::chrono::steady_clock::now())
+{
+}
+
+std::unique_ptr<BusTransport> BusRecorder::release()
+{
+    writer.reset();
+    return std::move(inner);
+}
+
+void BusRecorder::log(uint8_t op, uint8_t devId, uint16_t addr, int n, const uint16_t *words, int result, int errnum)
+{
+    BusLogEntry e;
+    e.t_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    e.op = op;
+    e.devId = devId;
+    e.addr = addr;
+    e.numWords = (uint8_t)std::min<int>(std::max(n, 0), MAX_WORDS);
+    e.result = result;
+    e.errnum = errnum;
+    if (result >= 0)
+        std::memcpy(e.words, words, e.numWords * sizeof(uint16_t));
+    writer->push(e);
+}
+
+int BusRecorder::readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest)
+{
+    const int result = inner->readRegisters(devId, addr, n, dest);
+    const int errnum = errno;
+    log(BUS_OP_READ, devId, addr, n, dest, result, errnum);
+    errno = errnum;
+    return result;
+}
+
+int BusRecorder::writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src)
+{
+    const int result = inner->writeRegisters(devId, addr, n, src);
+    const int errnum = errno;
+    log(BUS_OP_WRITE, devId, addr, n, src, result, errnum);
+    errno = errnum;
+    return result;
+}
+
+void BusRecorder::mark(uint16_t kind, uint8_t id, double *values, unsigned n)
+{
+    n = std::min(n, MAX_MARK_VALUES);
+    uint16_t words[MAX_WORDS];
+    busMarkPack(values, n, words);
+    log(BUS_OP_MARK, id, kind, 4 * n, words, 4 * n, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+BusReplay::BusReplay(const std::string &path)
+    : reader(path), haveNextTick(false), finished(false), tickTime_s(0.0), stats{0, 0, 0, 0, 0, 0, 0}
+{
+    loadTick();
+}
+
+void BusReplay::loadTick()
+{
+    tick.clear();
+    haveNextTick = false;
+    BusLogEntry e;
+    while (reader.next(e))
+    {
+        if (e.op == BUS_OP_MARK && e.addr == MARK_TICK)
+        {
+            nextTickMark = e;
+            haveNextTick = true;
+            break;
+        }
+        tick.push_back(e);
+    }
+    used.assign(tick.size(), false);
+}
+
+BusLogEntry *BusReplay::match(uint8_t op, uint8_t devId, uint16_t addr, int n)
+{
+    for (size_t k = 0; k < tick.size(); k++)
+    {
+        BusLogEntry &e = tick[k];
+        if (!used[k] && e.op == op && e.devId == devId && e.addr == addr && e.numWords == n)
+        {
+            used[k] = true;
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<BusLogEntry> BusReplay::pendingMarks(uint16_t kind) const
+{
+    std::vector<BusLogEntry> marks;
+    for (size_t k = 0; k < tick.size(); k++)
+        if (!used[k] && tick[k].op == BUS_OP_MARK && tick[k].addr == kind)
+            marks.push_back(tick[k]);
+    return marks;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+int BusReplay::readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest)
+{
+    BusLogEntry *e = match(BUS_OP_READ, devId, addr, n);
+    if (!e)
+    {
+        stats.missing++;
+        errno = EIO;
+        return -1;
+    }
+    stats.served++;
+    if (e->result < 0)
+    {
+        stats.failures++;
+        errno = e->errnum;
+        return -1;
+    }
+    std::memcpy(dest, e->words, n * sizeof(uint16_t));
+    return e->result;
+}
+
+int BusReplay::writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src)
+{
+    BusLogEntry *e = match(BUS_OP_WRITE, devId, addr, n);
+    if (!e)
+    {
+        stats.missing++;
+        errno = EIO;
+        return -1;
+    }
+    stats.served++;
+    if (e->result < 0)
+    {
+        stats.failures++;
+        errno = e->errnum;
+        return -1;
+    }
+    if (std::memcmp(src, e->words, n * sizeof(uint16_t)) != 0)
+        stats.writeMismatches++;
+    return e->result;
+}
+
+void BusReplay::mark(uint16_t kind, uint8_t id, double *values, unsigned n)
+{
+    n = std::min(n, MAX_MARK_VALUES);
+    if (kind == MARK_TICK)
+    {
+        stats.skipped += std::count(used.begin(), used.end(), false);
+        if (!haveNextTick)
+        {
+            tick.clear();
+            used.clear();
+            finished = true;
+            return;
+        }
+        busMarkUnpack(nextTickMark.words, std::min<unsigned>(n, nextTickMark.numWords / 4), values);
+        tickTime_s = nextTickMark.t_s;
+        stats.ticks++;
+        loadTick();
+        return;
+    }
+
+    BusLogEntry *e = match(BUS_OP_MARK, id, kind, 4 * n);
+    if (!e)
+    {
+        stats.missing++;
+        return;
+    }
+    uint16_t words[MAX_WORDS];
+    busMarkPack(values, n, words);
+    if (std::memcmp(words, e->words, 4 * n * sizeof(uint16_t)) != 0)
+        stats.markMismatches++;
+    busMarkUnpack(e->words, n, values);
+}
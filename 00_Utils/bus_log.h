@@ -0,0 +1,205 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+namespace BUS_LOG
+{
+    constexpr char MAGIC[8] = {'L', 'F', 'B', 'U', 'S', 'L', 'O', 'G'};
+    constexpr uint32_t VERSION = 1;
+    constexpr const char *FILE_PREFIX = "bus_";
+    constexpr const char *FILE_SUFFIX = ".lfbus";
+    // Registers per transaction. Marks carry doubles, four words each.
+    constexpr unsigned MAX_WORDS = 40;
+    constexpr unsigned MAX_MARK_VALUES = MAX_WORDS / 4;
+    // Several seconds of traffic at the 50 Hz control loop
+    constexpr size_t RING_ENTRIES = 4096;
+    constexpr double DRAIN_PERIOD_SEC = 0.2;
+
+    // Mark kinds. A tick mark starts each control tick; a replay matches requests within a tick.
+    constexpr uint16_t MARK_TICK = 1;
+    constexpr uint16_t MARK_AXIS_INPUTS = 2;
+}
+
+typedef enum
+{
+    BUS_OP_READ = 1,
+    BUS_OP_WRITE,
+    BUS_OP_MARK
+} BusOp_t;
+
+struct BusLogEntry
+{
+    double t_s;       // Monotonic time since the recording started (microsecond resolution)
+    uint8_t op;       // BusOp_t
+    uint8_t devId;    // Modbus node, or the id given with a mark
+    uint16_t addr;    // Register address, or the mark kind
+    uint8_t numWords;
+    int32_t result;   // Registers transferred, or -1
+    int32_t errnum;   // errno when result is -1
+    uint16_t words[BUS_LOG::MAX_WORDS]; // Read response, write payload or mark values
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Register traffic to the drives. The calls follow libmodbus: they return the number of
+/// registers transferred, or -1 with errno set.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BusTransport
+{
+public:
+    virtual ~BusTransport() {}
+    virtual int readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest) = 0;
+    virtual int writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src) = 0;
+    virtual void flush() {}
+    // Values recorded alongside the traffic (ticks, control inputs). A replay hands back the
+    // recorded values in their place.
+    virtual void mark(uint16_t /*kind*/, uint8_t /*id*/, double * /*values*/, unsigned /*n*/) {}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Bus log file: a header, then one variable-length record per entry with the time as a varint
+/// microsecond delta from the previous one.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BusLogWriter
+{
+public:
+    // The file is created here; entries are written by a worker thread
+    explicit BusLogWriter(const std::string &path);
+    ~BusLogWriter();
+    BusLogWriter(const BusLogWriter &) = delete;
+    BusLogWriter &operator=(const BusLogWriter &) = delete;
+
+    // Caller's thread only; never blocks
+    bool push(const BusLogEntry &e) { return ring.push(e); }
+
+    uint64_t getDropped() const { return ring.getDropped(); }
+    uint64_t getWritten() const;
+    std::string getError() const;
+    const std::string &getPath() const { return path; }
+
+private:
+    const std::string path;
+    FILE *fp;
+    SpscRing<BusLogEntry, BUS_LOG::RING_ENTRIES> ring;
+    uint64_t prev_us;
+    std::vector<uint8_t> buffer;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stopRequested;
+    uint64_t written;
+    std::string error;
+
+    void workerLoop();
+    void drain();
+};
+
+class BusLogReader
+{
+public:
+    explicit BusLogReader(const std::string &path);
+    ~BusLogReader();
+    BusLogReader(const BusLogReader &) = delete;
+    BusLogReader &operator=(const BusLogReader &) = delete;
+
+    // False at the end of the file (a truncated last record is treated as the end)
+    bool next(BusLogEntry &e);
+    // Wall clock (Unix seconds) when the recording started
+    double getStartUnix() const { return startUnix; }
+
+private:
+    FILE *fp;
+    double startUnix;
+    uint64_t t_us;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Passes traffic through to another transport and logs every request and response.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BusRecorder : public BusTransport
+{
+public:
+    BusRecorder(std::unique_ptr<BusTransport> inner, const std::string &path);
+
+    int readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest) override;
+    int writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src) override;
+    void flush() override { inner->flush(); }
+    void mark(uint16_t kind, uint8_t id, double *values, unsigned n) override;
+
+    // Stops recording and hands back the wrapped transport
+    std::unique_ptr<BusTransport> release();
+    const BusLogWriter &getWriter() const { return *writer; }
+
+private:
+    std::unique_ptr<BusTransport> inner;
+    std::unique_ptr<BusLogWriter> writer;
+    const std::chrono::steady_clock::time_point start;
+
+    void log(uint8_t op, uint8_t devId, uint16_t addr, int n, const uint16_t *words, int result, int errnum);
+};
+
+struct BusReplayStats
+{
+    uint64_t ticks;
+    uint64_t served;          // Requests answered from the recording
+    uint64_t failures;        // of which replayed a recorded failure
+    uint64_t missing;         // Requests with no match in their tick
+    uint64_t skipped;         // Recorded requests that were never made
+    uint64_t writeMismatches; // Writes whose values differ from the recording
+    uint64_t markMismatches;  // Marks whose values differ from the recording
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Answers requests from a bus log instead of the drives. Each request is matched with the first
+/// unused recorded request of the same kind, node, address and length in the current tick (the
+/// entries up to the next tick mark), so the same code replays exactly, in order, and code that
+/// makes its requests differently still finds its responses. A tick mark moves on to the next
+/// tick. Recorded failures come back as failures with the recorded errno; a request with no match
+/// fails with EIO.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class BusReplay : public BusTransport
+{
+public:
+    explicit BusReplay(const std::string &path);
+
+    int readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest) override;
+    int writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src) override;
+    void mark(uint16_t kind, uint8_t id, double *values, unsigned n) override;
+
+    // The unused marks of a kind in the current tick
+    std::vector<BusLogEntry> pendingMarks(uint16_t kind) const;
+    // True once the last tick has been reached
+    bool isFinished() const { return finished; }
+    // Recording time of the current tick
+    double getTime() const { return tickTime_s; }
+    double getStartUnix() const { return reader.getStartUnix(); }
+    const BusReplayStats &getStats() const { return stats; }
+
+private:
+    BusLogReader reader;
+    std::deque<BusLogEntry> tick;
+    std::vector<bool> used;
+    BusLogEntry nextTickMark;
+    bool haveNextTick;
+    bool finished;
+    double tickTime_s;
+    BusReplayStats stats;
+
+    void loadTick();
+    BusLogEntry *match(uint8_t op, uint8_t devId, uint16_t addr, int n);
+};
+
+// Copies doubles to and from mark words
+void busMarkPack(const double *values, unsigned n, uint16_t *words);
+void busMarkUnpack(const uint16_t *words, unsigned n, double *values);
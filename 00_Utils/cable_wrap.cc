@@ -0,0 +1,81 @@
+#include "cable_wrap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace CABLE_WRAP;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+CableWrap::CableWrap(double minAz_deg, double maxAz_deg)
+{
+    setLimits(minAz_deg, maxAz_deg);
+}
+
+void CableWrap::setLimits(double minAz_deg, double maxAz_deg)
+{
+    if (!(maxAz_deg - minAz_deg >= 360.0))
+        throw std::runtime_error("CableWrap: the azimuth limits must be at least 360 deg apart.");
+    minAz = minAz_deg;
+    maxAz = maxAz_deg;
+}
+
+double CableWrap::unwrapNear(double az_deg, double reference_deg)
+{
+    double d = az_deg - reference_deg;
+    d -= 360.0 * std::floor((d + 180.0) / 360.0);
+    return reference_deg + d;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+CableWrapChoice CableWrap::chooseGoto(double currentAz_deg, double targetAz_deg, const std::vector<double> &pathTravel,
+                                      double azSlewRate_dps, double minSlewTime_s) const
+{
+    const double duration_s = pathTravel.empty() ? 0.0 : (pathTravel.size() - 1) * PATH_STEP_SEC;
+
+    // Every copy of the target azimuth inside the limits, lowest first
+    double first = targetAz_deg - 360.0 * std::floor((targetAz_deg - minAz) / 360.0);
+    bool haveChoice = false;
+    CableWrapChoice best{0, 0, 0, false};
+    for (double az = first; az <= maxAz; az += 360.0)
+    {
+        CableWrapChoice c;
+        c.az_deg = az;
+        c.slewTime_s = std::max(std::fabs(az - currentAz_deg) / azSlewRate_dps, minSlewTime_s);
+        c.trackTime_s = duration_s;
+        for (size_t k = 0; k < pathTravel.size(); k++)
+        {
+            if (!isInside(az + pathTravel[k]))
+            {
+                // Back to the last sample inside
+                c.trackTime_s = k == 0 ? 0.0 : (k - 1) * PATH_STEP_SEC;
+                break;
+            }
+        }
+        c.fullTrack = c.trackTime_s >= duration_s;
+
+        bool better;
+        if (!haveChoice)
+            better = true;
+        else if (c.fullTrack != best.fullTrack)
+            better = c.fullTrack;
+        else if (c.fullTrack)
+            // Quickest to reach; between equally quick ones (the altitude slew dominates), the
+            // one furthest from the limits
+            better = c.slewTime_s < best.slewTime_s ||
+                     (c.slewTime_s == best.slewTime_s && std::fabs(az - getCentre()) < std::fabs(best.az_deg - getCentre()));
+        else
+            better = c.trackTime_s > best.trackTime_s ||
+                     (c.trackTime_s == best.trackTime_s && c.slewTime_s < best.slewTime_s);
+        if (better)
+        {
+            best = c;
+            haveChoice = true;
+        }
+    }
+    return best;
+}
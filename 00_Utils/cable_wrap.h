@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+namespace CABLE_WRAP
+{
+    // Target path sampling for the goto choice
+    constexpr double PATH_STEP_SEC = 60.0;
+}
+
+// The goto destination chosen for a target, in unwrapped azimuth
+struct CableWrapChoice
+{
+    double az_deg;
+    double slewTime_s;
+    // How long the target can be tracked from there before it reaches a limit, up to the
+    // requested duration
+    double trackTime_s;
+    bool fullTrack;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Azimuth soft limits on the unwrapped (multi-turn) axis position. A target azimuth has a copy
+/// every 360 deg; for a goto the copy inside the limits that can be reached soonest while still
+/// leaving room to follow the target for the requested time is chosen, and while tracking each
+/// command is the copy nearest the previous one, so the axis never takes a shortcut through the
+/// wrap.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class CableWrap
+{
+public:
+    CableWrap(double minAz_deg, double maxAz_deg);
+
+    void setLimits(double minAz_deg, double maxAz_deg);
+    double getMin() const { return minAz; }
+    double getMax() const { return maxAz; }
+    double getCentre() const { return 0.5 * (minAz + maxAz); }
+    bool isInside(double az_deg) const { return az_deg >= minAz && az_deg <= maxAz; }
+
+    // The copy of az (any turn) nearest reference
+    static double unwrapNear(double az_deg, double reference_deg);
+
+    // Goto destination for a target now at targetAz. pathTravel holds the target's unwrapped
+    // azimuth travel from now, one value every CABLE_WRAP::PATH_STEP_SEC over the duration that
+    // should be trackable. The slew time is the azimuth travel at azSlewRate, or minSlewTime if
+    // that's longer (the altitude axis). When no copy can be tracked for the whole path the one
+    // that can be tracked longest is returned with fullTrack false.
+    CableWrapChoice chooseGoto(double currentAz_deg, double targetAz_deg, const std::vector<double> &pathTravel,
+                               double azSlewRate_dps, double minSlewTime_s = 0.0) const;
+
+private:
+    double minAz;
+    double maxAz;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "math_util.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Chebyshev series on x in [-1, 1]. Fit from samples at the Chebyshev nodes, then evaluated
+/// (with its first and second derivatives) by Clenshaw recurrence. The derivative series are
+/// worked out once at fit time so evaluation never allocates.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class ChebyshevSeries
+{
+public:
+    ChebyshevSeries() {}
+    virtual ~ChebyshevSeries() {}
+
+    // Nodes for an n-point fit: x_k = cos(pi * (k + 0.5) / n)
+    static std::vector<double> nodes(unsigned n)
+    {
+        std::vector<double> x(n);
+        for (unsigned k = 0; k < n; k++)
+            x[k] = std::cos(M_PI * (k + 0.5) / n);
+        return x;
+    }
+
+    // nodeValues[k] is the function sampled at nodes(nodeValues.size())[k]
+    void fit(const std::vector<double> &nodeValues)
+    {
+        const unsigned n = nodeValues.size();
+        if (n == 0)
+            throw std::runtime_error("ChebyshevSeries::fit: no samples.");
+
+        c.assign(n, 0.0);
+        for (unsigned j = 0; j < n; j++)
+        {
+            double sum = 0.0;
+            for (unsigned k = 0; k < n; k++)
+                sum += nodeValues[k] * std::cos(M_PI * j * (k + 0.5) / n);
+            c[j] = 2.0 * sum / n;
+        }
+        // Store c0 already halved so every term is evaluated the same way
+        c[0] *= 0.5;
+        derivativeCoeffs(c, dc);
+        derivativeCoeffs(dc, d2c);
+    }
+
+    unsigned order() const { return c.empty() ? 0 : c.size() - 1; }
+    bool isFit() const { return !c.empty(); }
+
+    double value(double x) const { return clenshaw(c, x); }
+    double derivative(double x) const { return clenshaw(dc, x); }
+    double secondDerivative(double x) const { return clenshaw(d2c, x); }
+
+private:
+    std::vector<double> c;
+    std::vector<double> dc;
+    std::vector<double> d2c;
+
+    // sum(a_j * T_j(x))
+    static double clenshaw(const std::vector<double> &a, double x)
+    {
+        if (a.empty())
+            return 0.0;
+        double b1 = 0.0, b2 = 0.0;
+        for (int j = (int)a.size() - 1; j >= 1; j--)
+        {
+            double b0 = 2.0 * x * b1 - b2 + a[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        return x * b1 - b2 + a[0];
+    }
+
+    // Coefficients of d/dx of a series (with a[0] stored halved, as above)
+    static void derivativeCoeffs(const std::vector<double> &a, std::vector<double> &da)
+    {
+        const int n = a.size();
+        da.assign(n > 1 ? n - 1 : 1, 0.0);
+        if (n < 2)
+            return;
+        // Standard recurrence: d_{j-1} = d_{j+1} + 2 j a_j
+        std::vector<double> d(n + 1, 0.0);
+        for (int j = n - 1; j >= 1; j--)
+            d[j - 1] = d[j + 1] + 2.0 * j * a[j];
+        d[0] *= 0.5;
+        for (int j = 0; j < n - 1; j++)
+            da[j] = d[j];
+    }
+};
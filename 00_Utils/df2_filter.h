@@ -4,26 +4,95 @@
 #include <cstring>
 #include <cstdlib>
 #include <stdexcept>
+#include <array>
 #include <deque>
+#include <utility>
 #include <vector>
 
 namespace DIGITAL_CONTROL
 {
-    const double lpf_30_b[] = {0.294199221645671, 0.588398443291342, 0.294199221645671};
-    const double lpf_30_a[] = {1.000000000000000, -0.074015770272151, 0.250821930289187};
+    constexpr double lpf_30_b[] = {0.294199221645671, 0.588398443291342, 0.294199221645671};
+    constexpr double lpf_30_a[] = {1.000000000000000, -0.074015770272151, 0.250821930289187};
 
-    const double lpf_10_b[] = {0.066876672401120, 0.133753344802241, 0.066876672401121};
-    const double lpf_10_a[] = {1.000000000000000, -1.221537977599278, 0.489063633504805};
+    constexpr double lpf_10_b[] = {0.066876672401120, 0.133753344802241, 0.066876672401121};
+    constexpr double lpf_10_a[] = {1.000000000000000, -1.221537977599278, 0.489063633504805};
 
-    const double lpf_3_b[] = {0.007916873853898, 0.015833747707795, 0.007916873853898};
-    const double lpf_3_a[] = {1.000000000000000, -1.766729129140695, 0.798396874103547};
+    constexpr double lpf_3_b[] = {0.007916873853898, 0.015833747707795, 0.007916873853898};
+    constexpr double lpf_3_a[] = {1.000000000000000, -1.766729129140695, 0.798396874103547};
 
-    const double bldiff_30_b[] = {58.839844329134230, 0.000000000000011, -58.839844329134309};
-    const double bldiff_30_a[] = {1.000000000000000, -0.074015770272151, 0.250821930289187};
+    constexpr double bldiff_30_b[] = {58.839844329134230, 0.000000000000011, -58.839844329134309};
+    constexpr double bldiff_30_a[] = {1.000000000000000, -0.074015770272151, 0.250821930289187};
+
+    // Order argument selecting the runtime-sized DF2_IIR
+    constexpr int DYNAMIC_ORDER = -1;
 }
 
-template <typename T>
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed order filter. State lives in std::arrays and all loops have compile-time trip counts so
+/// update() is allocation free and unrolled by the compiler. Can be built at compile time from the
+/// coefficient tables above, e.g.
+///     constexpr DF2_IIR<double, 2> lpf(DIGITAL_CONTROL::lpf_3_b, DIGITAL_CONTROL::lpf_3_a);
+//////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T, int Order = DIGITAL_CONTROL::DYNAMIC_ORDER>
 class DF2_IIR
+{
+    static_assert(Order > 0, "DF2_IIR order must be positive");
+
+public:
+    constexpr DF2_IIR(const T (&_b)[Order + 1], const T (&_a)[Order + 1])
+        : DF2_IIR(_b, _a, std::make_index_sequence<Order + 1>{})
+    {
+    }
+
+    T update(T x_n);
+    void reset() { v.fill(0); }
+    constexpr int order() const { return Order; }
+
+private:
+    template <std::size_t... I>
+    constexpr DF2_IIR(const T (&_b)[Order + 1], const T (&_a)[Order + 1], std::index_sequence<I...>)
+        : a{{_a[I]...}}, b{{_b[I]...}}, v{}
+    {
+        if (_a[0] != 1)
+            throw std::runtime_error("invalid poles");
+    }
+
+    std::array<T, Order + 1> a;
+    std::array<T, Order + 1> b;
+    std::array<T, Order + 1> v;
+};
+
+template <typename T, int Order>
+T DF2_IIR<T, Order>::update(T x_n)
+{
+    // Shift register, newest state at v[0]
+    for (int ii = Order; ii > 0; ii--)
+    {
+        v[ii] = v[ii - 1];
+    }
+
+    T &v_n = v[0];
+    v_n = x_n;
+
+    for (int ii = 1; ii < Order + 1; ii++)
+    {
+        v_n -= a[ii] * v[ii];
+    }
+
+    T y_n = 0;
+    for (int ii = 0; ii < Order + 1; ii++)
+    {
+        y_n += b[ii] * v[ii];
+    }
+
+    return y_n;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Runtime order filter, for coefficients designed on the fly.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class DF2_IIR<T, DIGITAL_CONTROL::DYNAMIC_ORDER>
 {
 public:
     DF2_IIR(const T *_b, const T *_a, uint8_t _order) : order(_order)
@@ -50,6 +119,7 @@ public:
     virtual ~DF2_IIR() {}
 
     T update(T x_n);
+    void reset() { std::fill(v.begin(), v.end(), 0); }
 
 private:
     uint8_t order;
@@ -59,7 +129,7 @@ private:
 };
 
 template <typename T>
-T DF2_IIR<T>::update(T x_n)
+T DF2_IIR<T, DIGITAL_CONTROL::DYNAMIC_ORDER>::update(T x_n)
 {
     v.push_front(0);
     v.pop_back();
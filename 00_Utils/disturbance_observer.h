@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+
+#include "math_util.h"
+
+namespace DIGITAL_CONTROL
+{
+    // Rigid-body model of one axis, with everything referred to the axis side of the gear train.
+    // Rates are in deg/s to match the rest of the control loop.
+    struct AxisPlantModel
+    {
+        double torquePerAmp_Nm;            // Motor torque constant * gear ratio * efficiency
+        double inertia_NmPerDps2;          // Axis inertia [N*m / (deg/s^2)]
+        double damping_NmPerDps;           // Viscous friction [N*m / (deg/s)]
+        double rateLoopStiffness_NmPerDps; // Drive velocity loop stiffness [N*m / (deg/s) of rate error]
+    };
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Estimates the external load torque (wind, imbalance) on an axis:
+///
+///     tau_d = Kt * i - J * d(w_cmd)/dt - B * w_cmd
+///
+/// passed through a first order low-pass at the observer bandwidth. The drive's velocity loop
+/// lets the axis lag by tau_d / stiffness under load, so getCompensatingRate() returns the rate
+/// offset that cancels that droop. A bandwidth of zero disables the observer.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class DisturbanceObserver
+{
+public:
+    DisturbanceObserver(const DIGITAL_CONTROL::AxisPlantModel &model) : plant(model), bandwidth_Hz(0.0)
+    {
+        if (model.rateLoopStiffness_NmPerDps <= 0.0)
+            throw std::runtime_error("DisturbanceObserver: rate loop stiffness must be positive.");
+        reset();
+    }
+    virtual ~DisturbanceObserver() {}
+
+    void setBandwidth(double bw_Hz)
+    {
+        bandwidth_Hz = bw_Hz > 0.0 ? bw_Hz : 0.0;
+        if (!isEnabled())
+            reset();
+    }
+    double getBandwidth() const { return bandwidth_Hz; }
+    bool isEnabled() const { return bandwidth_Hz > 0.0; }
+
+    void reset()
+    {
+        firstTime = true;
+        prevRateCmd_dps = 0.0;
+        disturbance_Nm = 0.0;
+    }
+
+    // current_A is the sum of the motor currents driving the axis
+    double update(double current_A, double rateCmd_dps, double dt)
+    {
+        if (!isEnabled() || dt <= 0.0)
+            return disturbance_Nm;
+
+        double accelCmd_dps2 = firstTime ? 0.0 : (rateCmd_dps - prevRateCmd_dps) / dt;
+        prevRateCmd_dps = rateCmd_dps;
+
+        double rawDisturbance_Nm = plant.torquePerAmp_Nm * current_A -
+                                   plant.inertia_NmPerDps2 * accelCmd_dps2 -
+                                   plant.damping_NmPerDps * rateCmd_dps;
+        if (firstTime)
+        {
+            // Start from the first measurement rather than ramping up from zero
+            disturbance_Nm = rawDisturbance_Nm;
+            firstTime = false;
+        }
+        else
+        {
+            double alpha = 1.0 - std::exp(-2.0 * M_PI * bandwidth_Hz * dt);
+            disturbance_Nm += alpha * (rawDisturbance_Nm - disturbance_Nm);
+        }
+        return disturbance_Nm;
+    }
+
+    double getDisturbanceEstimate() const { return disturbance_Nm; }
+    double getCompensatingRate() const { return disturbance_Nm / plant.rateLoopStiffness_NmPerDps; }
+
+    // Motor current the plant model needs for a given rate command and load (for simulation)
+    double modelCurrent(double accelCmd_dps2, double rateCmd_dps, double disturbance_Nm) const
+    {
+        return (plant.inertia_NmPerDps2 * accelCmd_dps2 +
+                plant.damping_NmPerDps * rateCmd_dps +
+                disturbance_Nm) /
+               plant.torquePerAmp_Nm;
+    }
+
+private:
+    DIGITAL_CONTROL::AxisPlantModel plant;
+    double bandwidth_Hz;
+    bool firstTime;
+    double prevRateCmd_dps;
+    double disturbance_Nm;
+};
@@ -0,0 +1,131 @@
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace FLIGHT_RECORDER;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+FlightRecorder::FlightRecorder(double periodSec, double historySec, double postTriggerSec)
+    : ring(std::max(1u, (unsigned)std::ceil(historySec / periodSec))), count(0),
+      postRecords((unsigned)std::ceil(postTriggerSec / periodSec)), armed(false), postRemaining(0),
+      lastReason_s(0.0)
+{
+    pending.triggerJd = 0.0;
+    taken.triggerJd = 0.0;
+    taken.records.resize(ring.size());
+    taken.first = 0;
+    taken.numRecords = 0;
+}
+
+bool FlightRecorder::record(const TelemetryRecord &r)
+{
+    ring[count % ring.size()] = r;
+    count++;
+    if (!armed)
+        return false;
+    if (postRemaining > 0)
+        postRemaining--;
+    return postRemaining == 0;
+}
+
+bool FlightRecorder::trigger(const std::string &reason, double now_s)
+{
+    const bool repeat = reason == lastReason && now_s - lastReason_s < REPEAT_HOLDOFF_SEC;
+    lastReason = reason;
+    lastReason_s = now_s;
+    if (repeat)
+        return false;
+    if (armed)
+    {
+        pending.reason += "; " + reason;
+        return false;
+    }
+    armed = true;
+    postRemaining = postRecords;
+    pending.reason = reason;
+    pending.triggerJd = count ? ring[(count - 1) % ring.size()].jd : 0.0;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Swaps the filled ring with the one the last dump was written from, so recording starts over in
+/// that one.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+const FlightRecorderDump &FlightRecorder::takeDump()
+{
+    taken.reason.swap(pending.reason);
+    pending.reason.clear();
+    taken.triggerJd = pending.triggerJd;
+    taken.records.swap(ring);
+    taken.numRecords = (unsigned)std::min<uint64_t>(count, taken.records.size());
+    taken.first = count > taken.records.size() ? count % taken.records.size() : 0;
+    count = 0;
+    armed = false;
+    return taken;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+std::string FlightRecorder::writeDump(const std::string &dir, const FlightRecorderDump &dump)
+{
+    if (dump.size() == 0)
+        throw std::runtime_error("Flight recorder: nothing recorded yet.");
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        std::stringstream ss;
+        ss << "Flight recorder: can't create " << dir << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+
+    // Faults in the same second get a counter
+    std::string base;
+    struct stat st;
+    for (unsigned k = 0; k == 0 || ::stat((base + TELEMETRY::FILE_SUFFIX).c_str(), &st) == 0; k++)
+    {
+        std::stringstream ss;
+        ss << dir << "/" << FILE_PREFIX << telemetryFileStamp(dump.triggerJd);
+        if (k > 0)
+            ss << "_" << k;
+        base = ss.str();
+    }
+    const std::string path = base + TELEMETRY::FILE_SUFFIX;
+    const std::string notePath = base + NOTE_SUFFIX;
+    const std::string tmpPath = path + ".tmp";
+
+    {
+        TelemetryFile file(tmpPath, dump.size());
+        for (unsigned i = 0; i < dump.size(); i++)
+            file.append(dump[i]);
+        file.flush();
+    }
+    {
+        std::ofstream note(notePath);
+        note.precision(12);
+        note << "reason: " << dump.reason << std::endl
+             << "trigger_jd: " << dump.triggerJd << std::endl
+             << "records: " << dump.size() << std::endl
+             << "first_jd: " << dump[0].jd << std::endl
+             << "last_jd: " << dump[dump.size() - 1].jd << std::endl;
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::stringstream ss;
+        ss << "Flight recorder: can't rename " << tmpPath << ": " << std::strerror(errno);
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error(ss.str());
+    }
+    return path;
+}
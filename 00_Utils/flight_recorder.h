@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace FLIGHT_RECORDER
+{
+    constexpr double HISTORY_SEC = 30.0;
+    // Kept after the trigger, to see how the axes came to rest
+    constexpr double POST_TRIGGER_SEC = 2.0;
+    // The same fault reported again within this long of the last report doesn't dump again
+    constexpr double REPEAT_HOLDOFF_SEC = 60.0;
+    constexpr const char *FILE_PREFIX = "flight_";
+    constexpr const char *NOTE_SUFFIX = ".txt";
+}
+
+struct FlightRecorderDump
+{
+    std::string reason;
+    double triggerJd;
+    // A ring buffer handed over from the recorder, oldest record at index first
+    std::vector<TelemetryRecord> records;
+    unsigned first;
+    unsigned numRecords;
+
+    // Oldest record first
+    const TelemetryRecord &operator[](unsigned i) const { return records[(first + i) % records.size()]; }
+    unsigned size() const { return numRecords; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Always-on black box: the last HISTORY_SEC of telemetry records in a preallocated ring. A
+/// trigger (fault, abort, E-stop) arms a dump that closes POST_TRIGGER_SEC later; record() then
+/// returns true and takeDump() hands the ring itself over for writeDump() to put in a telemetry
+/// file off the control thread, and carries on in a second preallocated ring. Triggers that arrive
+/// while a dump is armed are added to its reason, and a fault that keeps being reported only dumps
+/// once. Control thread only, apart from writeDump().
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class FlightRecorder
+{
+public:
+    explicit FlightRecorder(double periodSec, double historySec = FLIGHT_RECORDER::HISTORY_SEC,
+                            double postTriggerSec = FLIGHT_RECORDER::POST_TRIGGER_SEC);
+
+    // True once an armed dump is complete and waiting for takeDump()
+    bool record(const TelemetryRecord &r);
+    // now_s is any monotonic time; returns true if this armed a new dump
+    bool trigger(const std::string &reason, double now_s);
+    // The dump stays valid until the next takeDump(), which mustn't be called until the last
+    // writeDump() has returned: the two swap buffers, nothing is allocated or copied.
+    const FlightRecorderDump &takeDump();
+
+    bool isArmed() const { return armed; }
+    unsigned getCapacity() const { return ring.size(); }
+
+    // Writes the dump to dir as a telemetry file (plus a note with the reason) under a temporary
+    // name and renames it into place, so a file with the final name is always complete. Returns
+    // the path. Throws std::runtime_error.
+    static std::string writeDump(const std::string &dir, const FlightRecorderDump &dump);
+
+private:
+    std::vector<TelemetryRecord> ring;
+    uint64_t count;
+    const unsigned postRecords;
+    bool armed;
+    unsigned postRemaining;
+    FlightRecorderDump pending;
+    FlightRecorderDump taken;
+    std::string lastReason;
+    double lastReason_s;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+
+#include "math_util.h"
+
+namespace KINEMATICS
+{
+    // Inside this zenith distance the azimuth derivatives are evaluated as if the target were this
+    // far from the zenith (they go to infinity at the zenith itself)
+    constexpr double DEFAULT_MIN_ZENITH_DIST_RAD = 0.1 * M_PI / 180.0;
+}
+
+// Angles in radians, rates in rad/s, accelerations in rad/s^2. Azimuth is measured from north
+// through east, in [0, 2*pi).
+struct HorizontalKinematics
+{
+    double alt;
+    double az;
+    double altRate;
+    double azRate;
+    double altAccel;
+    double azAccel;
+    bool nearZenith;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Exact alt/az position, rate and acceleration of an equatorial target whose hour angle advances
+/// at haRate (the sidereal rate for a fixed star). Works from the horizon-frame unit vector
+///
+///     x (north) =  cos(lat) sin(dec) - sin(lat) cos(dec) cos(H)
+///     y (east)  = -cos(dec) sin(H)
+///     z (up)    =  sin(lat) sin(dec) + cos(lat) cos(dec) cos(H)
+///
+/// and its H derivatives, with alt = asin(z), az = atan2(y, x).
+//////////////////////////////////////////////////////////////////////////////////////////////////
+inline HorizontalKinematics computeHorizontalKinematics(double ha_rad, double dec_rad, double lat_rad,
+                                                        double haRate_radps,
+                                                        double minZenithDist_rad = KINEMATICS::DEFAULT_MIN_ZENITH_DIST_RAD)
+{
+    const double sH = std::sin(ha_rad), cH = std::cos(ha_rad);
+    const double sD = std::sin(dec_rad), cD = std::cos(dec_rad);
+    const double sL = std::sin(lat_rad), cL = std::cos(lat_rad);
+
+    const double x = cL * sD - sL * cD * cH;
+    const double y = -cD * sH;
+    const double z = sL * sD + cL * cD * cH;
+    // First and second derivatives with respect to H
+    const double dx = sL * cD * sH, d2x = sL * cD * cH;
+    const double dy = -cD * cH, d2y = cD * sH;
+    const double dz = -cL * cD * sH, d2z = -cL * cD * cH;
+
+    HorizontalKinematics hk;
+    const double rhoExact = std::sqrt(x * x + y * y);
+    const double rhoMin = std::sin(minZenithDist_rad);
+    hk.nearZenith = rhoExact < rhoMin;
+    const double rho = hk.nearZenith ? rhoMin : rhoExact;
+    const double rho2 = rho * rho;
+
+    hk.alt = std::atan2(z, rhoExact);
+    hk.az = std::atan2(y, x);
+    if (hk.az < 0.0)
+        hk.az += 2.0 * M_PI;
+
+    const double cross = x * dy - y * dx; // rho^2 * d(az)/dH
+    const double dot = x * dx + y * dy;   // rho * d(rho)/dH
+    const double dRho = dot / rho;
+
+    const double w = haRate_radps;
+    hk.altRate = w * dz / rho;
+    hk.altAccel = w * w * (d2z / rho - dz * dRho / rho2);
+    hk.azRate = w * cross / rho2;
+    hk.azAccel = w * w * ((x * d2y - y * d2x) / rho2 - 2.0 * cross * dot / (rho2 * rho2));
+    return hk;
+}
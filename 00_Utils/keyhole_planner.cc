@@ -0,0 +1,198 @@
+#include "keyhole_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace KEYHOLE;
+
+static const double DEG2RAD = M_PI / 180.0;
+
+static double wrapAzimuth(double az)
+{
+    az = std::fmod(az, 360.0);
+    return az < 0.0 ? az + 360.0 : az;
+}
+
+// Azimuth turned from az1 to az2 going in direction dir (+1 or -1), in [0, 360)
+static double turnedThrough(double az1, double az2, double dir)
+{
+    return wrapAzimuth(dir * (az2 - az1));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+KeyholePlan::KeyholePlan()
+    : valid(false), jdStart(0), jdEnd(0), jdTransit(0), azStart_deg(0), azRate_dps(0), minZenithDist_deg(0),
+      peakTargetAzRate_dps(0), maxError_arcsec(0), timeOutside_s(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Scans the window for altitude maxima above MIN_TRANSIT_ALT_DEG, refines each transit, and plans
+/// the first one whose peak azimuth rate is over the limit and that isn't already over.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+KeyholePlan KeyholePlan::plan(const TrackingEphemeris::Sampler &sampler, double jdNow, const KeyholeLimits &limits)
+{
+    KeyholePlan p;
+    double values[NUM_EPHEM_CHANNELS];
+    bool sampleFailed = false;
+    auto sample = [&](double jd, double &alt, double &az)
+    {
+        if (!sampler(jd, values))
+        {
+            sampleFailed = true;
+            alt = az = 0.0;
+            return;
+        }
+        alt = values[EPHEM_ALT];
+        az = values[EPHEM_AZ];
+    };
+    auto altitudeAt = [&](double jd)
+    {
+        double alt, az;
+        sample(jd, alt, az);
+        return alt;
+    };
+
+    const double step = SCAN_STEP_SEC / SEC_PER_DAY;
+    const double jdScanStart = jdNow - LOOKBEHIND_SEC / SEC_PER_DAY;
+    const unsigned numSteps = (unsigned)((LOOKBEHIND_SEC + LOOKAHEAD_SEC) / SCAN_STEP_SEC);
+    std::vector<double> alts(numSteps + 1);
+    for (unsigned k = 0; k <= numSteps; k++)
+        alts[k] = altitudeAt(jdScanStart + k * step);
+    if (sampleFailed)
+    {
+        p.error = "target position unavailable";
+        return p;
+    }
+
+    const double V = limits.maxAzRate_dps;
+    for (unsigned k = 1; k < numSteps; k++)
+    {
+        if (alts[k] < MIN_TRANSIT_ALT_DEG || alts[k] < alts[k - 1] || alts[k] < alts[k + 1])
+            continue;
+
+        // Golden section search for the transit
+        const double g = 0.5 * (std::sqrt(5.0) - 1.0);
+        double a = jdScanStart + (k - 1) * step, b = jdScanStart + (k + 1) * step;
+        double c = b - g * (b - a), d = a + g * (b - a);
+        double fc = altitudeAt(c), fd = altitudeAt(d);
+        while ((b - a) * SEC_PER_DAY > TRANSIT_RESOLUTION_SEC)
+        {
+            if (fc > fd)
+            {
+                b = d;
+                d = c;
+                fd = fc;
+                c = b - g * (b - a);
+                fc = altitudeAt(c);
+            }
+            else
+            {
+                a = c;
+                c = d;
+                fc = fd;
+                d = a + g * (b - a);
+                fd = altitudeAt(d);
+            }
+        }
+        const double jdT = 0.5 * (a + b);
+        double altT, azT;
+        sample(jdT, altT, azT);
+
+        // Peak azimuth rate, at the transit
+        const double hPeak = 0.5 * PROFILE_STEP_SEC / SEC_PER_DAY;
+        double alt0, az0, alt1, az1;
+        sample(jdT - hPeak, alt0, az0);
+        sample(jdT + hPeak, alt1, az1);
+        if (sampleFailed)
+        {
+            p.error = "target position unavailable";
+            return p;
+        }
+        double dAz = az1 - az0;
+        dAz -= 360.0 * std::floor((dAz + 180.0) / 360.0);
+        double peakRate = dAz / PROFILE_STEP_SEC;
+        if (std::fabs(peakRate) <= V)
+            continue;
+        const double dir = peakRate > 0.0 ? 1.0 : -1.0;
+
+        // Half width h of the chord with slope V: turned(h) = 2 V h. The target turns faster
+        // than V near the transit, so the chord is longer than 2 V h for small h.
+        auto chordExcess = [&](double h_s)
+        {
+            double altA, azA, altB, azB;
+            sample(jdT - h_s / SEC_PER_DAY, altA, azA);
+            sample(jdT + h_s / SEC_PER_DAY, altB, azB);
+            return turnedThrough(azA, azB, dir) - 2.0 * V * h_s;
+        };
+        double lo = 0.5 * PROFILE_STEP_SEC, hi = lo;
+        while (chordExcess(hi) > 0.0)
+        {
+            lo = hi;
+            hi *= 2.0;
+            if (hi > MAX_TRANSIT_HALF_WIDTH_SEC)
+            {
+                p.error = "zenith transit is too slow to plan";
+                return p;
+            }
+        }
+        for (unsigned n = 0; n < BISECTION_ITERATIONS && hi - lo > TRANSIT_RESOLUTION_SEC; n++)
+        {
+            double mid = 0.5 * (lo + hi);
+            if (chordExcess(mid) > 0.0)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        const double h_s = hi;
+        if (jdT + h_s / SEC_PER_DAY < jdNow)
+            continue;
+
+        p.jdTransit = jdT;
+        p.jdStart = jdT - h_s / SEC_PER_DAY;
+        p.jdEnd = jdT + h_s / SEC_PER_DAY;
+        double altS;
+        sample(p.jdStart, altS, p.azStart_deg);
+        p.azRate_dps = dir * V;
+        p.minZenithDist_deg = 90.0 - altT;
+        p.peakTargetAzRate_dps = peakRate;
+
+        // Predicted error: the mount follows the altitude, so the error is the azimuth difference
+        // scaled down by the target's distance from the zenith
+        for (double t_s = 0.0; t_s <= 2.0 * h_s; t_s += PROFILE_STEP_SEC)
+        {
+            double alt, az;
+            sample(p.jdStart + t_s / SEC_PER_DAY, alt, az);
+            double azCmd = p.azStart_deg + p.azRate_dps * t_s;
+            double sep = 2.0 * std::asin(std::min(1.0, std::fabs(std::cos(alt * DEG2RAD) *
+                                                                  std::sin(0.5 * (azCmd - az) * DEG2RAD))));
+            double err = sep / DEG2RAD * 3600.0;
+            p.maxError_arcsec = std::max(p.maxError_arcsec, err);
+            if (err > limits.tolerance_arcsec)
+                p.timeOutside_s += PROFILE_STEP_SEC;
+        }
+        if (sampleFailed)
+        {
+            p.error = "target position unavailable";
+            return p;
+        }
+        p.valid = true;
+        return p;
+    }
+    return p;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool KeyholePlan::evaluate(double jd, double &az, double &azRate) const
+{
+    if (!valid || jd < jdStart || jd > jdEnd)
+        return false;
+    az = wrapAzimuth(azStart_deg + azRate_dps * (jd - jdStart) * SEC_PER_DAY);
+    azRate = azRate_dps;
+    return true;
+}
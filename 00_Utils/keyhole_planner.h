@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+#include "tracking_ephemeris.h"
+
+namespace KEYHOLE
+{
+    constexpr double SEC_PER_DAY = 86400.0;
+    // Zenith passes are looked for this far ahead, and this far back so that a transit already in
+    // progress is still found
+    constexpr double LOOKAHEAD_SEC = 1800.0;
+    constexpr double LOOKBEHIND_SEC = 300.0;
+    constexpr double SCAN_STEP_SEC = 10.0;
+    // Transit time resolution, and the step used for the target's peak rate and the error profile
+    constexpr double TRANSIT_RESOLUTION_SEC = 1.0e-3;
+    constexpr double PROFILE_STEP_SEC = 0.1;
+    // Targets that stay further than this from the zenith never need more than a few sidereal
+    // rates in azimuth, so they aren't checked
+    constexpr double MIN_TRANSIT_ALT_DEG = 80.0;
+    constexpr double MAX_TRANSIT_HALF_WIDTH_SEC = 1200.0;
+    constexpr unsigned BISECTION_ITERATIONS = 50;
+}
+
+struct KeyholeLimits
+{
+    double maxAzRate_dps;
+    // On-sky error budget for the transit report
+    double tolerance_arcsec;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Azimuth plan for a target that passes too close to the zenith for the azimuth drive to follow.
+/// The target's azimuth turns by nearly 180 deg around the transit; instead of clipping the rate
+/// and falling behind, the mount leaves the target early and turns at the rate limit, ahead of it
+/// before the transit and behind it after, rejoining it as soon as the rate limit allows. An
+/// azimuth error costs only sin(zenith distance) of it on the sky, so the error stays small
+/// through the transit, where it's largest in azimuth.
+///
+/// The constant-rate segment is the chord of the target's azimuth path centred on the transit
+/// whose slope is the rate limit. The altitude is followed as usual.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class KeyholePlan
+{
+public:
+    KeyholePlan();
+
+    // Looks for the next zenith transit the azimuth drive can't follow. Returns an invalid plan if
+    // there isn't one in the window. The sampler fills values[EPHEM_ALT] and values[EPHEM_AZ].
+    static KeyholePlan plan(const TrackingEphemeris::Sampler &sampler, double jdStart,
+                            const KeyholeLimits &limits);
+
+    bool isValid() const { return valid; }
+    const std::string &getError() const { return error; }
+    double getStart() const { return jdStart; }
+    double getEnd() const { return jdEnd; }
+    double getTransit() const { return jdTransit; }
+    double getMinZenithDistance() const { return minZenithDist_deg; }
+    double getPeakTargetAzRate() const { return peakTargetAzRate_dps; }
+    double getAzRate() const { return azRate_dps; }
+    // Predicted on-sky error of the plan
+    double getMaxError() const { return maxError_arcsec; }
+    double getTimeOutsideTolerance() const { return timeOutside_s; }
+
+    // Azimuth command [deg, 0 to 360) and rate [deg/s] inside [start, end]; false outside it
+    bool evaluate(double jd, double &az, double &azRate) const;
+
+private:
+    bool valid;
+    std::string error;
+    double jdStart;
+    double jdEnd;
+    double jdTransit;
+    double azStart_deg;
+    double azRate_dps;
+    double minZenithDist_deg;
+    double peakTargetAzRate_dps;
+    double maxError_arcsec;
+    double timeOutside_s;
+};
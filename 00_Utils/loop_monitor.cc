@@ -0,0 +1,98 @@
+#include "loop_monitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace LOOP_MONITOR;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+LoopMonitor::LoopMonitor(double nominalPeriod_s)
+    : nominal(nominalPeriod_s), window(WINDOW_TICKS)
+{
+    reset();
+}
+
+void LoopMonitor::reset()
+{
+    setNominalPeriod(nominal);
+    degraded = false;
+}
+
+void LoopMonitor::setNominalPeriod(double nominalPeriod_s)
+{
+    nominal = nominalPeriod_s;
+    std::fill(histogram, histogram + NUM_BINS, 0);
+    ticks = 0;
+    overruns = 0;
+    sum_s = 0.0;
+    sumSqDev_s2 = 0.0;
+    max_s = 0.0;
+    std::fill(window.begin(), window.end(), false);
+    windowIdx = 0;
+    recentOverruns = 0;
+    healthy_s = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+LoopModeChange_t LoopMonitor::update(double period_s, double exec_s)
+{
+    if (!(period_s > 0.0))
+        return LOOP_MODE_UNCHANGED;
+
+    const double ratio = period_s / nominal;
+    histogram[std::upper_bound(HISTOGRAM_EDGES, HISTOGRAM_EDGES + NUM_BINS - 1, ratio) - HISTOGRAM_EDGES]++;
+    ticks++;
+    sum_s += period_s;
+    sumSqDev_s2 += (period_s - nominal) * (period_s - nominal);
+    max_s = std::max(max_s, period_s);
+
+    const bool overrun = ratio > OVERRUN_FACTOR;
+    if (overrun)
+        overruns++;
+    recentOverruns += (unsigned)overrun - (unsigned)window[windowIdx];
+    window[windowIdx] = overrun;
+    windowIdx = (windowIdx + 1) % WINDOW_TICKS;
+
+    if (!degraded)
+    {
+        if (recentOverruns >= DEGRADE_OVERRUNS)
+        {
+            degraded = true;
+            healthy_s = 0.0;
+            return LOOP_MODE_DEGRADED;
+        }
+        return LOOP_MODE_UNCHANGED;
+    }
+
+    if (overrun || exec_s > RECOVER_LOAD_FRACTION * nominal)
+        healthy_s = 0.0;
+    else
+        healthy_s += period_s;
+    if (healthy_s >= RECOVER_SEC)
+    {
+        degraded = false;
+        // Start counting afresh so the overruns that caused this don't immediately bring it back
+        std::fill(window.begin(), window.end(), false);
+        recentOverruns = 0;
+        return LOOP_MODE_RECOVERED;
+    }
+    return LOOP_MODE_UNCHANGED;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+LoopPeriodStats LoopMonitor::getStats() const
+{
+    LoopPeriodStats s{ticks, overruns, 0.0, max_s, 0.0};
+    if (ticks > 0)
+    {
+        s.mean_s = sum_s / ticks;
+        s.jitterRms_s = std::sqrt(sumSqDev_s2 / ticks);
+    }
+    return s;
+}
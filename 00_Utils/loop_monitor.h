@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace LOOP_MONITOR
+{
+    // Tick period histogram bin edges, as multiples of the nominal period. The first bin is
+    // everything below the first edge and the last everything above the last.
+    constexpr double HISTOGRAM_EDGES[] = {0.5, 0.8, 0.9, 0.95, 1.05, 1.1, 1.2, 1.5, 2.0, 3.0};
+    constexpr unsigned NUM_BINS = sizeof(HISTOGRAM_EDGES) / sizeof(double) + 1;
+    // A tick whose period is this much longer than nominal is an overrun
+    constexpr double OVERRUN_FACTOR = 1.5;
+    // Degraded mode starts when this many of the last WINDOW_TICKS ticks overran (2 s at 50 Hz)
+    constexpr unsigned WINDOW_TICKS = 100;
+    constexpr unsigned DEGRADE_OVERRUNS = 10;
+    // and ends after this long without an overrun, with each tick taking less than this fraction
+    // of the nominal period to run
+    constexpr double RECOVER_SEC = 30.0;
+    constexpr double RECOVER_LOAD_FRACTION = 0.5;
+}
+
+typedef enum
+{
+    LOOP_MODE_UNCHANGED,
+    LOOP_MODE_DEGRADED,
+    LOOP_MODE_RECOVERED
+} LoopModeChange_t;
+
+struct LoopPeriodStats
+{
+    uint64_t ticks;
+    uint64_t overruns;
+    double mean_s;
+    double max_s;
+    // RMS deviation from the nominal period
+    double jitterRms_s;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Watches the control tick timing. Each tick's period (time since the previous tick) goes into a
+/// histogram and is counted as an overrun when it's well over the nominal period. Overruns that
+/// persist put the monitor into degraded mode, which the caller uses to shed load; it leaves
+/// degraded mode once the ticks have been on time, with plenty of headroom, for a while.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class LoopMonitor
+{
+public:
+    explicit LoopMonitor(double nominalPeriod_s);
+    // Clears the statistics but stays in (or out of) degraded mode
+    void setNominalPeriod(double nominalPeriod_s);
+
+    // period: since the previous tick (ignored if not positive, as on the first tick)
+    // exec: how long the previous tick took to run
+    LoopModeChange_t update(double period_s, double exec_s);
+    void reset();
+
+    bool isDegraded() const { return degraded; }
+    double getNominalPeriod() const { return nominal; }
+    // Overruns among the last WINDOW_TICKS ticks
+    unsigned getRecentOverruns() const { return recentOverruns; }
+    LoopPeriodStats getStats() const;
+    const uint64_t *getHistogram() const { return histogram; }
+    // Bin edges in seconds; bin k is [edge(k-1), edge(k)), with the outer bins open
+    double getBinEdge(unsigned k) const { return LOOP_MONITOR::HISTOGRAM_EDGES[k] * nominal; }
+
+private:
+    double nominal;
+    uint64_t histogram[LOOP_MONITOR::NUM_BINS];
+    uint64_t ticks;
+    uint64_t overruns;
+    double sum_s;
+    double sumSqDev_s2;
+    double max_s;
+
+    std::vector<bool> window;
+    unsigned windowIdx;
+    unsigned recentOverruns;
+
+    bool degraded;
+    double healthy_s;
+};
@@ -17,6 +17,10 @@
 #define M_SQRT2 1.4142135623730950488016887
 #endif
 
+#ifndef M_SQRT1_2
+#define M_SQRT1_2 0.70710678118654752440 /* 1/sqrt(2) */
+#endif
+
 #ifndef M_E
 #define M_E 2.71828182845904523536028747135266249775724709369995
 #endif
@@ -0,0 +1,309 @@
+#include "pointing_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace POINTING_MODEL;
+
+static const double DEG2RAD = M_PI / 180.0;
+
+static const char *const TERM_NAMES[NUM_POINTING_TERMS] = {
+    "IA", "IE", "CA", "NPAE", "AN", "AW", "TF", "ACEC", "ACES", "ECES"};
+
+// Azimuth difference wrapped to [-180, 180) [deg]
+static double wrapDelta(double dAz)
+{
+    return dAz - 360.0 * std::floor((dAz + 180.0) / 360.0);
+}
+
+static double wrapAzimuth(double az)
+{
+    az = std::fmod(az, 360.0);
+    return az < 0.0 ? az + 360.0 : az;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+PointingModel::PointingModel()
+{
+    clear();
+}
+
+void PointingModel::clear()
+{
+    std::fill(coeffs, coeffs + NUM_POINTING_TERMS, 0.0);
+}
+
+const char *PointingModel::termName(unsigned term)
+{
+    return term < NUM_POINTING_TERMS ? TERM_NAMES[term] : "?";
+}
+
+unsigned PointingModel::termFromName(const std::string &name)
+{
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        if (name == TERM_NAMES[k])
+            return k;
+    return NUM_POINTING_TERMS;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Offsets [arcsec] per arcsec of each coefficient
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PointingModel::basis(double alt, double az, double dAz[NUM_POINTING_TERMS], double dAlt[NUM_POINTING_TERMS])
+{
+    double E = alt * DEG2RAD, A = az * DEG2RAD;
+    double Et = std::min(alt, MAX_MODEL_ALT_DEG) * DEG2RAD;
+    double sinA = std::sin(A), cosA = std::cos(A);
+    double tanE = std::tan(Et), secE = 1.0 / std::cos(Et);
+
+    std::fill(dAz, dAz + NUM_POINTING_TERMS, 0.0);
+    std::fill(dAlt, dAlt + NUM_POINTING_TERMS, 0.0);
+    dAz[PM_IA] = -1.0;
+    dAlt[PM_IE] = 1.0;
+    dAz[PM_CA] = -secE;
+    dAz[PM_NPAE] = -tanE;
+    dAz[PM_AN] = -sinA * tanE;
+    dAlt[PM_AN] = -cosA;
+    dAz[PM_AW] = -cosA * tanE;
+    dAlt[PM_AW] = sinA;
+    dAlt[PM_TF] = -std::cos(E);
+    dAz[PM_ACEC] = cosA;
+    dAz[PM_ACES] = sinA;
+    dAlt[PM_ECES] = std::sin(E);
+}
+
+void PointingModel::offsets(double alt, double az, double *dAlt, double *dAz) const
+{
+    double bAz[NUM_POINTING_TERMS], bAlt[NUM_POINTING_TERMS];
+    basis(alt, az, bAz, bAlt);
+    *dAlt = *dAz = 0.0;
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+    {
+        *dAz += coeffs[k] * bAz[k];
+        *dAlt += coeffs[k] * bAlt[k];
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PointingModel::skyToMount(double alt, double az, double *mountAlt, double *mountAz) const
+{
+    double dAlt, dAz;
+    offsets(alt, az, &dAlt, &dAz);
+    *mountAlt = alt + dAlt / 3600.0;
+    *mountAz = wrapAzimuth(az + dAz / 3600.0);
+}
+
+void PointingModel::mountToSky(double mountAlt, double mountAz, double *alt, double *az) const
+{
+    double skyAlt = mountAlt, skyAz = mountAz;
+    for (unsigned k = 0; k < MOUNT_TO_SKY_ITERATIONS; k++)
+    {
+        double dAlt, dAz;
+        offsets(skyAlt, skyAz, &dAlt, &dAz);
+        skyAlt = mountAlt - dAlt / 3600.0;
+        skyAz = mountAz - dAz / 3600.0;
+    }
+    *alt = skyAlt;
+    *az = wrapAzimuth(skyAz);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Mount rates from sky rates through the model's Jacobian
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PointingModel::skyRateToMount(double alt, double az, double altRate, double azRate,
+                                   double *mountAltRate, double *mountAzRate) const
+{
+    double E = alt * DEG2RAD, A = az * DEG2RAD;
+    bool clamped = alt > MAX_MODEL_ALT_DEG;
+    double Et = std::min(alt, MAX_MODEL_ALT_DEG) * DEG2RAD;
+    double sinA = std::sin(A), cosA = std::cos(A);
+    double tanE = std::tan(Et), secE = 1.0 / std::cos(Et);
+    const double *c = coeffs;
+
+    // [arcsec/rad]
+    double dAz_dA = (-c[PM_AN] * cosA + c[PM_AW] * sinA) * tanE - c[PM_ACEC] * sinA + c[PM_ACES] * cosA;
+    double dAz_dE = clamped ? 0.0
+                            : -c[PM_CA] * secE * tanE - (c[PM_NPAE] + c[PM_AN] * sinA + c[PM_AW] * cosA) * secE * secE;
+    double dAlt_dA = c[PM_AN] * sinA + c[PM_AW] * cosA;
+    double dAlt_dE = c[PM_TF] * std::sin(E) + c[PM_ECES] * std::cos(E);
+
+    *mountAzRate = azRate + (dAz_dA * azRate + dAz_dE * altRate) * DEG2RAD / 3600.0;
+    *mountAltRate = altRate + (dAlt_dA * azRate + dAlt_dE * altRate) * DEG2RAD / 3600.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+PointingFitter::PointingFitter()
+{
+    clear();
+}
+
+void PointingFitter::clear()
+{
+    numPoints = 0;
+    sumSq = 0.0;
+    std::fill(&normal[0][0], &normal[0][0] + NUM_POINTING_TERMS * NUM_POINTING_TERMS, 0.0);
+    std::fill(rhs, rhs + NUM_POINTING_TERMS, 0.0);
+}
+
+void PointingFitter::add(const PointingObservation &obs)
+{
+    double bAz[NUM_POINTING_TERMS], bAlt[NUM_POINTING_TERMS];
+    PointingModel::basis(obs.skyAlt, obs.skyAz, bAz, bAlt);
+    double cosE = std::cos(obs.skyAlt * DEG2RAD);
+    double yAz = wrapDelta(obs.mountAz - obs.skyAz) * 3600.0 * cosE;
+    double yAlt = (obs.mountAlt - obs.skyAlt) * 3600.0;
+
+    for (unsigned i = 0; i < NUM_POINTING_TERMS; i++)
+    {
+        double ai = bAz[i] * cosE;
+        for (unsigned j = 0; j < NUM_POINTING_TERMS; j++)
+            normal[i][j] += ai * bAz[j] * cosE + bAlt[i] * bAlt[j];
+        rhs[i] += ai * yAz + bAlt[i] * yAlt;
+    }
+    sumSq += yAz * yAz + yAlt * yAlt;
+    numPoints++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Cholesky solve of the normal equations restricted to the masked terms
+//////////////////////////////////////////////////////////////////////////////////////////////////
+PointingFitResult PointingFitter::solve(unsigned termMask, PointingModel &model) const
+{
+    PointingFitResult result;
+    result.ok = false;
+    result.numPoints = numPoints;
+    result.termMask = termMask & PM_ALL_TERMS;
+    result.rms_arcsec = 0.0;
+    std::fill(result.sigma_arcsec, result.sigma_arcsec + NUM_POINTING_TERMS, 0.0);
+
+    unsigned idx[NUM_POINTING_TERMS];
+    unsigned k = 0;
+    for (unsigned t = 0; t < NUM_POINTING_TERMS; t++)
+        if (result.termMask & PM_TERM_BIT(t))
+            idx[k++] = t;
+
+    std::stringstream ss;
+    if (k == 0)
+    {
+        result.error = "no terms selected";
+        return result;
+    }
+    if (2 * numPoints <= k)
+    {
+        ss << numPoints << " points can't determine " << k << " terms";
+        result.error = ss.str();
+        return result;
+    }
+
+    // L L^T = N
+    double L[NUM_POINTING_TERMS][NUM_POINTING_TERMS] = {};
+    for (unsigned i = 0; i < k; i++)
+    {
+        for (unsigned j = 0; j <= i; j++)
+        {
+            double s = normal[idx[i]][idx[j]];
+            for (unsigned m = 0; m < j; m++)
+                s -= L[i][m] * L[j][m];
+            if (i == j)
+            {
+                if (s <= SINGULAR_PIVOT_RATIO * normal[idx[i]][idx[i]])
+                {
+                    ss << "term " << PointingModel::termName(idx[i])
+                       << " isn't determined by the points (add points over more of the sky)";
+                    result.error = ss.str();
+                    return result;
+                }
+                L[i][i] = std::sqrt(s);
+            }
+            else
+                L[i][j] = s / L[j][j];
+        }
+    }
+
+    // Solves L L^T x = b in place
+    auto cholSolve = [&](double *x)
+    {
+        for (unsigned i = 0; i < k; i++)
+        {
+            for (unsigned m = 0; m < i; m++)
+                x[i] -= L[i][m] * x[m];
+            x[i] /= L[i][i];
+        }
+        for (unsigned i = k; i-- > 0;)
+        {
+            for (unsigned m = i + 1; m < k; m++)
+                x[i] -= L[m][i] * x[m];
+            x[i] /= L[i][i];
+        }
+    };
+
+    double x[NUM_POINTING_TERMS];
+    for (unsigned i = 0; i < k; i++)
+        x[i] = rhs[idx[i]];
+    cholSolve(x);
+
+    // Residual sum of squares from the accumulated sums
+    double ssr = sumSq;
+    for (unsigned i = 0; i < k; i++)
+    {
+        ssr -= 2.0 * x[i] * rhs[idx[i]];
+        for (unsigned j = 0; j < k; j++)
+            ssr += x[i] * normal[idx[i]][idx[j]] * x[j];
+    }
+    ssr = std::max(ssr, 0.0);
+    result.rms_arcsec = std::sqrt(ssr / numPoints);
+
+    double variance = ssr / (2 * numPoints - k);
+    for (unsigned i = 0; i < k; i++)
+    {
+        double e[NUM_POINTING_TERMS] = {};
+        e[i] = 1.0;
+        cholSolve(e);
+        result.sigma_arcsec[idx[i]] = std::sqrt(variance * e[i]);
+    }
+
+    model.clear();
+    for (unsigned i = 0; i < k; i++)
+        model.setCoefficient(idx[i], x[i]);
+    result.ok = true;
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double PointingFitter::residual(const PointingModel &model, const PointingObservation &obs)
+{
+    double dAlt, dAz;
+    model.offsets(obs.skyAlt, obs.skyAz, &dAlt, &dAz);
+    double rAz = (wrapDelta(obs.mountAz - obs.skyAz) * 3600.0 - dAz) * std::cos(obs.skyAlt * DEG2RAD);
+    double rAlt = (obs.mountAlt - obs.skyAlt) * 3600.0 - dAlt;
+    return std::hypot(rAz, rAlt);
+}
+
+bool PointingFitter::parseObservation(const std::string &line, PointingObservation &obs)
+{
+    std::string data = line.substr(0, line.find('#'));
+    std::istringstream in(data);
+    PointingObservation o;
+    if (!(in >> o.skyAz >> o.skyAlt >> o.mountAz >> o.mountAlt))
+        return false;
+    obs = o;
+    return true;
+}
+
+std::string PointingFitter::formatObservation(const PointingObservation &obs)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(6) << obs.skyAz << " " << obs.skyAlt << " "
+       << obs.mountAz << " " << obs.mountAlt;
+    return ss.str();
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace POINTING_MODEL
+{
+    // The sec(E) and tan(E) terms are held at their value here closer to the zenith
+    constexpr double MAX_MODEL_ALT_DEG = 87.0;
+    constexpr unsigned MOUNT_TO_SKY_ITERATIONS = 3;
+    // Cholesky pivots below this fraction of the term's own diagonal mean the data don't determine it
+    constexpr double SINGULAR_PIVOT_RATIO = 1e-10;
+}
+
+// TPOINT alt-az terms. All coefficients are in arcsec.
+enum PointingTerm_t
+{
+    PM_IA,   // azimuth index:                dA = -IA
+    PM_IE,   // elevation index:              dE = +IE
+    PM_CA,   // collimation:                  dA = -CA sec(E)
+    PM_NPAE, // axis non-perpendicularity:    dA = -NPAE tan(E)
+    PM_AN,   // azimuth axis tilt north:      dA = -AN sin(A) tan(E),  dE = -AN cos(A)
+    PM_AW,   // azimuth axis tilt west:       dA = -AW cos(A) tan(E),  dE = +AW sin(A)
+    PM_TF,   // tube flexure:                 dE = -TF cos(E)  (also the cos(E) part of elevation centering)
+    PM_ACEC, // azimuth encoder centering:    dA = +ACEC cos(A)
+    PM_ACES, //                               dA = +ACES sin(A)
+    PM_ECES, // elevation encoder centering:  dE = +ECES sin(E)
+    NUM_POINTING_TERMS
+};
+
+constexpr unsigned PM_TERM_BIT(unsigned term) { return 1u << term; }
+constexpr unsigned PM_ALL_TERMS = (1u << NUM_POINTING_TERMS) - 1;
+constexpr unsigned PM_BASIC_TERMS = PM_TERM_BIT(PM_IA) | PM_TERM_BIT(PM_IE) | PM_TERM_BIT(PM_CA) |
+                                    PM_TERM_BIT(PM_NPAE) | PM_TERM_BIT(PM_AN) | PM_TERM_BIT(PM_AW);
+
+// One sync: where the star was (observed alt/az) and where the encoders were [deg]
+struct PointingObservation
+{
+    double skyAlt;
+    double skyAz;
+    double mountAlt;
+    double mountAz;
+};
+
+struct PointingFitResult
+{
+    bool ok;
+    std::string error;
+    unsigned numPoints;
+    unsigned termMask;
+    double rms_arcsec;                       // on-sky residual per point
+    double sigma_arcsec[NUM_POINTING_TERMS]; // formal errors (0 for terms not fitted)
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Parametric alt-az pointing model: mount (encoder) position = sky position + the sum of the
+/// terms above evaluated at the sky position. Evaluating it is a handful of trig functions, so
+/// it runs every tick, along with its Jacobian for the rate feedforward.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class PointingModel
+{
+public:
+    PointingModel();
+
+    static const char *termName(unsigned term);
+    // Term from its TPOINT name, or NUM_POINTING_TERMS if there's no such term
+    static unsigned termFromName(const std::string &name);
+
+    double getCoefficient(unsigned term) const { return coeffs[term]; }
+    void setCoefficient(unsigned term, double value_arcsec) { coeffs[term] = value_arcsec; }
+    void clear();
+
+    // [deg] and [deg/s]
+    void skyToMount(double alt, double az, double *mountAlt, double *mountAz) const;
+    void skyRateToMount(double alt, double az, double altRate, double azRate,
+                        double *mountAltRate, double *mountAzRate) const;
+    void mountToSky(double mountAlt, double mountAz, double *alt, double *az) const;
+
+    // Model offsets [arcsec] at a sky position, and the basis functions the fit uses
+    void offsets(double alt, double az, double *dAlt, double *dAz) const;
+    static void basis(double alt, double az, double dAz[NUM_POINTING_TERMS], double dAlt[NUM_POINTING_TERMS]);
+
+private:
+    double coeffs[NUM_POINTING_TERMS];
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Least-squares fit of the model terms. Observations are folded into the normal equations as
+/// they're added, so memory and solve time don't depend on the number of points. Azimuth
+/// residuals are weighted by cos(E) so that both axes are fitted in arcsec on the sky.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class PointingFitter
+{
+public:
+    PointingFitter();
+
+    void add(const PointingObservation &obs);
+    void clear();
+    unsigned size() const { return numPoints; }
+
+    // Fits the terms in termMask and writes them to the model (the other terms are zeroed).
+    // The model is left alone if the fit fails.
+    PointingFitResult solve(unsigned termMask, PointingModel &model) const;
+
+    // On-sky residual [arcsec] of one observation against a model
+    static double residual(const PointingModel &model, const PointingObservation &obs);
+    // "skyAz skyAlt mountAz mountAlt" in degrees. False for blank/comment lines or bad input.
+    static bool parseObservation(const std::string &line, PointingObservation &obs);
+    static std::string formatObservation(const PointingObservation &obs);
+
+private:
+    unsigned numPoints;
+    double normal[NUM_POINTING_TERMS][NUM_POINTING_TERMS];
+    double rhs[NUM_POINTING_TERMS];
+    double sumSq;
+};
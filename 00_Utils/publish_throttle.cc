@@ -0,0 +1,110 @@
+#include "publish_throttle.h"
+
+#include <cmath>
+#include <stdexcept>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+PublishThrottle::PublishThrottle(unsigned numChannels, unsigned maxPerFlush)
+    : channels(numChannels), maxPerFlush(maxPerFlush), cursor(0)
+{
+}
+
+void PublishThrottle::configure(unsigned channel, double maxRate_hz, double deadband, std::function<void()> publish)
+{
+    if (channel >= channels.size())
+        throw std::runtime_error("PublishThrottle: no such channel.");
+    channels[channel].publish = publish;
+    setLimits(channel, maxRate_hz, deadband);
+}
+
+void PublishThrottle::setLimits(unsigned channel, double maxRate_hz, double deadband)
+{
+    channels[channel].minInterval_s = maxRate_hz > 0.0 ? 1.0 / maxRate_hz : 0.0;
+    channels[channel].deadband = deadband;
+}
+
+void PublishThrottle::reset()
+{
+    for (Channel &c : channels)
+    {
+        c.hasLast = false;
+        c.everPublished = false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Values are compared with the last published ones rather than the previous update, so a slow
+/// drift is published once it adds up to more than the deadband.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void PublishThrottle::update(unsigned channel, const double *values, size_t n, int state)
+{
+    Channel &c = channels[channel];
+    bool changed = !c.hasLast || n != c.lastValues.size() || state != c.lastState;
+    for (size_t i = 0; i < n && !changed; i++)
+        changed = std::abs(values[i] - c.lastValues[i]) > c.deadband;
+
+    if (!changed)
+    {
+        // Back inside the deadband, so whatever was pending no longer needs to go out
+        if (c.pending && !c.urgent)
+            c.pending = false;
+        c.suppressed++;
+        return;
+    }
+    if (c.pending)
+        c.suppressed++;
+    c.pendingValues.assign(values, values + n);
+    c.pendingState = state;
+    c.urgent = c.urgent || !c.hasLast || state != c.lastState;
+    c.pending = true;
+}
+
+void PublishThrottle::request(unsigned channel)
+{
+    Channel &c = channels[channel];
+    if (c.pending)
+        c.suppressed++;
+    c.pending = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+unsigned PublishThrottle::flush(double now_s)
+{
+    const unsigned n = channels.size();
+    if (n == 0)
+        return 0;
+    unsigned count = 0;
+    unsigned budget = maxPerFlush;
+    unsigned next = cursor;
+    for (unsigned k = 0; k < n; k++)
+    {
+        const unsigned idx = (cursor + k) % n;
+        Channel &c = channels[idx];
+        if (!c.pending || !c.publish)
+            continue;
+        const bool due = !c.everPublished || now_s - c.lastPublish_s >= c.minInterval_s;
+        if (!c.urgent && (!due || budget == 0))
+            continue;
+
+        c.publish();
+        c.lastValues = c.pendingValues;
+        c.lastState = c.pendingState;
+        c.hasLast = true;
+        c.pending = false;
+        c.urgent = false;
+        c.everPublished = true;
+        c.lastPublish_s = now_s;
+        c.published++;
+        count++;
+        if (budget > 0)
+            budget--;
+        next = idx + 1;
+    }
+    // The next flush starts after the last channel published, so no channel is starved
+    cursor = next % n;
+    return count;
+}
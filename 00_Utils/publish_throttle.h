@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Rate limits and deadbands for property updates sent to clients. Each channel (usually one
+/// property) is given its maximum rate, a deadband and the function that publishes it. update()
+/// offers the channel's newest values; they're only published when one has moved more than the
+/// deadband since the last publish or the state has changed, and updates that arrive faster than
+/// the rate allows are coalesced into the next publish, which sends whatever is newest then.
+/// Nothing is published until flush(), which sends the channels that are due, at most maxPerFlush
+/// of them per call (round robin) unless their state changed. State changes skip the rate limit.
+/// Single-threaded.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class PublishThrottle
+{
+public:
+    PublishThrottle(unsigned numChannels, unsigned maxPerFlush);
+
+    // A rate of zero leaves the channel unlimited
+    void configure(unsigned channel, double maxRate_hz, double deadband, std::function<void()> publish);
+    void setLimits(unsigned channel, double maxRate_hz, double deadband);
+
+    void update(unsigned channel, const double *values, size_t n, int state = 0);
+    // Publish at the next opportunity, whatever the values
+    void request(unsigned channel);
+    // Returns the number of channels published
+    unsigned flush(double now_s);
+    // Forget what was published, so every channel goes out again on its next update
+    void reset();
+
+    bool isPending(unsigned channel) const { return channels[channel].pending; }
+    uint64_t getPublished(unsigned channel) const { return channels[channel].published; }
+    // Updates that were folded into a later publish or fell inside the deadband
+    uint64_t getSuppressed(unsigned channel) const { return channels[channel].suppressed; }
+
+private:
+    struct Channel
+    {
+        double minInterval_s{0};
+        double deadband{0};
+        std::function<void()> publish;
+        std::vector<double> lastValues;
+        std::vector<double> pendingValues;
+        bool hasLast{false};
+        int lastState{0};
+        int pendingState{0};
+        bool pending{false};
+        bool urgent{false};
+        bool everPublished{false};
+        double lastPublish_s{0};
+        uint64_t published{0};
+        uint64_t suppressed{0};
+    };
+
+    std::vector<Channel> channels;
+    const unsigned maxPerFlush;
+    unsigned cursor;
+};
@@ -0,0 +1,132 @@
+#include "satellite_pass.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace SATELLITE;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+SatellitePass::SatellitePass()
+    : jdAOS(0.0), jdLOS(0.0), sample_s(PASS_SAMPLE_PERIOD_SEC), feasible(false),
+      maxAlt_deg(0.0), peakAltRate_dps(0.0), peakAzRate_dps(0.0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Narrows a horizon crossing in [lo, hi] down to PASS_EDGE_RESOLUTION_SEC. On return lo is on
+/// the same side of the limit as it started and hi on the other.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename AboveFcn>
+static void bisectCrossing(AboveFcn above, double &lo, double &hi)
+{
+    bool aboveLo = above(lo);
+    while ((hi - lo) * SEC_PER_DAY > PASS_EDGE_RESOLUTION_SEC)
+    {
+        double mid = 0.5 * (lo + hi);
+        if (above(mid) == aboveLo)
+            lo = mid;
+        else
+            hi = mid;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+SatellitePass SatellitePass::plan(const SGP4Propagator &sgp4, double jdSearchStart, double lat_deg,
+                                  double lon_deg, double height_m, const SatellitePassLimits &limits)
+{
+    auto above = [&](double jd)
+    { return sgp4.look(jd, lat_deg, lon_deg, height_m).alt >= limits.minAlt_deg; };
+    const double step_d = PASS_SEARCH_STEP_SEC / SEC_PER_DAY;
+
+    SatellitePass pass;
+    pass.jdAOS = jdSearchStart;
+    if (!above(jdSearchStart))
+    {
+        double jd = jdSearchStart;
+        const double jdSearchEnd = jdSearchStart + PASS_SEARCH_WINDOW_SEC / SEC_PER_DAY;
+        while (!above(jd + step_d))
+        {
+            jd += step_d;
+            if (jd > jdSearchEnd)
+                return SatellitePass();
+        }
+        double hi = jd + step_d;
+        bisectCrossing(above, jd, hi);
+        pass.jdAOS = hi;
+    }
+
+    double jd = pass.jdAOS;
+    const double jdMaxLOS = pass.jdAOS + MAX_PASS_DURATION_SEC / SEC_PER_DAY;
+    while (above(jd + step_d) && jd < jdMaxLOS)
+        jd += step_d;
+    double hi = jd + step_d;
+    bisectCrossing(above, jd, hi);
+    pass.jdLOS = jd;
+
+    // Tabulate at (close to) the nominal spacing so the last sample lands on LOS
+    double duration_s = (pass.jdLOS - pass.jdAOS) * SEC_PER_DAY;
+    unsigned numIntervals = std::max(1u, (unsigned)std::ceil(duration_s / PASS_SAMPLE_PERIOD_SEC));
+    pass.sample_s = std::max(duration_s, PASS_EDGE_RESOLUTION_SEC) / numIntervals;
+    pass.samples.reserve(numIntervals + 1);
+    for (unsigned k = 0; k <= numIntervals; k++)
+    {
+        SatelliteLook lk = sgp4.look(pass.jdAOS + k * pass.sample_s / SEC_PER_DAY, lat_deg, lon_deg, height_m);
+        if (k > 0)
+            lk.az -= 360.0 * std::round((lk.az - pass.samples.back().az) / 360.0);
+        pass.samples.push_back(lk);
+
+        pass.maxAlt_deg = std::max(pass.maxAlt_deg, lk.alt);
+        pass.peakAltRate_dps = std::max(pass.peakAltRate_dps, std::fabs(lk.altRate));
+        pass.peakAzRate_dps = std::max(pass.peakAzRate_dps, std::fabs(lk.azRate));
+    }
+
+    std::stringstream ss;
+    if (pass.maxAlt_deg > limits.maxAlt_deg)
+        ss << "peak altitude " << pass.maxAlt_deg << " deg is above the " << limits.maxAlt_deg << " deg limit";
+    else if (pass.peakAzRate_dps > limits.maxRate_dps)
+        ss << "peak azimuth rate " << pass.peakAzRate_dps << " deg/s exceeds " << limits.maxRate_dps << " deg/s";
+    else if (pass.peakAltRate_dps > limits.maxRate_dps)
+        ss << "peak altitude rate " << pass.peakAltRate_dps << " deg/s exceeds " << limits.maxRate_dps << " deg/s";
+    pass.infeasibleReason = ss.str();
+    pass.feasible = pass.infeasibleReason.empty();
+    return pass;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool SatellitePass::evaluate(double jd, SatelliteTrackPoint &pt) const
+{
+    if (samples.size() < 2 || jd < jdAOS || jd > jdLOS)
+        return false;
+
+    double s = (jd - jdAOS) * SEC_PER_DAY / sample_s;
+    size_t k = std::min((size_t)std::max(s, 0.0), samples.size() - 2);
+    double u = s - k;
+    const SatelliteLook &p0 = samples[k];
+    const SatelliteLook &p1 = samples[k + 1];
+    const double h = sample_s;
+
+    // Cubic Hermite basis functions and their first and second derivatives in u
+    double u2 = u * u, u3 = u2 * u;
+    double h00 = 2 * u3 - 3 * u2 + 1, h10 = u3 - 2 * u2 + u, h01 = -2 * u3 + 3 * u2, h11 = u3 - u2;
+    double d00 = 6 * u2 - 6 * u, d10 = 3 * u2 - 4 * u + 1, d01 = -6 * u2 + 6 * u, d11 = 3 * u2 - 2 * u;
+    double a00 = 12 * u - 6, a10 = 6 * u - 4, a01 = -12 * u + 6, a11 = 6 * u - 2;
+
+    pt.alt = h00 * p0.alt + h10 * h * p0.altRate + h01 * p1.alt + h11 * h * p1.altRate;
+    pt.altRate = (d00 * p0.alt + d01 * p1.alt) / h + d10 * p0.altRate + d11 * p1.altRate;
+    pt.altAccel = (a00 * p0.alt + a01 * p1.alt) / (h * h) + (a10 * p0.altRate + a11 * p1.altRate) / h;
+
+    double az = h00 * p0.az + h10 * h * p0.azRate + h01 * p1.az + h11 * h * p1.azRate;
+    pt.azRate = (d00 * p0.az + d01 * p1.az) / h + d10 * p0.azRate + d11 * p1.azRate;
+    pt.azAccel = (a00 * p0.az + a01 * p1.az) / (h * h) + (a10 * p0.azRate + a11 * p1.azRate) / h;
+    pt.az = std::fmod(az, 360.0);
+    if (pt.az < 0.0)
+        pt.az += 360.0;
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "sgp4.h"
+
+namespace SATELLITE
+{
+    constexpr double SEC_PER_DAY = 86400.0;
+    // Pass table spacing. Cubic Hermite on position and rate keeps the interpolation error under
+    // an arcsecond for LEO passes that are feasible for the mount.
+    constexpr double PASS_SAMPLE_PERIOD_SEC = 1.0;
+    // Coarse step when searching for the next rise. Passes shorter than this can be missed.
+    constexpr double PASS_SEARCH_STEP_SEC = 10.0;
+    constexpr double PASS_SEARCH_WINDOW_SEC = 86400.0;
+    constexpr double PASS_EDGE_RESOLUTION_SEC = 0.01;
+    constexpr double MAX_PASS_DURATION_SEC = 3600.0;
+}
+
+// Limits a pass has to stay inside for the mount to follow it
+struct SatellitePassLimits
+{
+    double minAlt_deg;
+    double maxAlt_deg;
+    double maxRate_dps;
+};
+
+// Interpolated alt/az [deg], rates [deg/s] and accelerations [deg/s^2]
+struct SatelliteTrackPoint
+{
+    double alt;
+    double az;
+    double altRate;
+    double azRate;
+    double altAccel;
+    double azAccel;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// One pass of a satellite over the site, tabulated from SGP4 ahead of time so the control tick
+/// only has to interpolate. Position and rate are sampled at every table point and interpolated
+/// with cubic Hermite polynomials, which also give the acceleration for the feedforward.
+/// Azimuth is stored unwrapped so it stays continuous through north.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class SatellitePass
+{
+public:
+    SatellitePass();
+
+    // Finds the pass in progress at jdSearchStart, or else the next one within the search window,
+    // and checks it against the limits. Returns an invalid pass if there isn't one. Throws
+    // std::runtime_error if the propagation fails.
+    static SatellitePass plan(const SGP4Propagator &sgp4, double jdSearchStart, double lat_deg,
+                              double lon_deg, double height_m, const SatellitePassLimits &limits);
+
+    bool isValid() const { return !samples.empty(); }
+    bool isFeasible() const { return feasible; }
+    const std::string &getInfeasibleReason() const { return infeasibleReason; }
+    double getAOS() const { return jdAOS; }
+    double getLOS() const { return jdLOS; }
+    double getMaxAltitude() const { return maxAlt_deg; }
+    double getPeakAltRate() const { return peakAltRate_dps; }
+    double getPeakAzRate() const { return peakAzRate_dps; }
+
+    // False outside [AOS, LOS]
+    bool evaluate(double jd, SatelliteTrackPoint &pt) const;
+
+private:
+    double jdAOS;
+    double jdLOS;
+    double sample_s;
+    std::vector<SatelliteLook> samples;
+
+    bool feasible;
+    std::string infeasibleReason;
+    double maxAlt_deg;
+    double peakAltRate_dps;
+    double peakAzRate_dps;
+};
@@ -0,0 +1,393 @@
+#include "sgp4.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+#include "math_util.h"
+
+using namespace SGP4;
+
+static const double TWO_PI = 2.0 * M_PI;
+static const double X2O3 = 2.0 / 3.0;
+static const double XKE = 60.0 / std::sqrt(EARTH_RADIUS_KM * EARTH_RADIUS_KM * EARTH_RADIUS_KM / MU_KM3PS2);
+static const double J3OJ2 = J3 / J2;
+static const double XPDOTP = MIN_PER_DAY / TWO_PI; // rev/day per rad/min
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// TLE field helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static void checkTLELine(const std::string &line, char lineNum)
+{
+    if (line.size() < 69 || line[0] != lineNum)
+    {
+        std::stringstream ss;
+        ss << "SGP4Propagator::parseTLE() Error: line " << lineNum << " is malformed.";
+        throw std::runtime_error(ss.str());
+    }
+    int sum = 0;
+    for (int ii = 0; ii < 68; ii++)
+    {
+        if (line[ii] >= '0' && line[ii] <= '9')
+            sum += line[ii] - '0';
+        else if (line[ii] == '-')
+            sum += 1;
+    }
+    if (line[68] - '0' != sum % 10)
+    {
+        std::stringstream ss;
+        ss << "SGP4Propagator::parseTLE() Error: line " << lineNum << " fails its checksum.";
+        throw std::runtime_error(ss.str());
+    }
+}
+
+// Columns are 1-based and inclusive, as in the format definition
+static double field(const std::string &line, int firstCol, int lastCol)
+{
+    return std::atof(line.substr(firstCol - 1, lastCol - firstCol + 1).c_str());
+}
+
+// Implied leading decimal point with exponent, e.g. " 28098-4" = 0.28098e-4
+static double exponentField(const std::string &line, int firstCol, int lastCol)
+{
+    std::string f = line.substr(firstCol - 1, lastCol - firstCol + 1);
+    size_t start = f.find_first_not_of(' ');
+    if (start == std::string::npos)
+        return 0.0;
+    f = f.substr(start);
+    double sign = 1.0;
+    if (f[0] == '-' || f[0] == '+')
+    {
+        sign = f[0] == '-' ? -1.0 : 1.0;
+        f = f.substr(1);
+    }
+    size_t expPos = f.find_last_of("+-");
+    if (expPos == std::string::npos || expPos == 0)
+        return sign * std::atof(("0." + f).c_str());
+    double mantissa = std::atof(("0." + f.substr(0, expPos)).c_str());
+    int exponent = std::atoi(f.substr(expPos).c_str());
+    return sign * mantissa * std::pow(10.0, exponent);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TwoLineElement SGP4Propagator::parseTLE(const std::string &line1, const std::string &line2)
+{
+    checkTLELine(line1, '1');
+    checkTLELine(line2, '2');
+
+    TwoLineElement el;
+    el.satnum = line1.substr(2, 5);
+    if (line2.substr(2, 5) != el.satnum)
+        throw std::runtime_error("SGP4Propagator::parseTLE() Error: lines are for different satellites.");
+
+    // Epoch: two digit year (57-99 -> 1900s) and fractional day of year
+    int year = (int)field(line1, 19, 20);
+    year += year < 57 ? 2000 : 1900;
+    double epochDays = field(line1, 21, 32);
+    double jdJan0 = 367.0 * year - std::floor(7.0 * year / 4.0) + 30.0 + 1721013.5;
+    el.epochJD = jdJan0 + epochDays;
+
+    el.ndot = field(line1, 34, 43) / (XPDOTP * MIN_PER_DAY);
+    el.nddot = exponentField(line1, 45, 52) / (XPDOTP * MIN_PER_DAY * MIN_PER_DAY);
+    el.bstar = exponentField(line1, 54, 61);
+
+    el.inclination = deg2rad(field(line2, 9, 16));
+    el.raan = deg2rad(field(line2, 18, 25));
+    el.eccentricity = std::atof(("0." + line2.substr(26, 7)).c_str());
+    el.argPerigee = deg2rad(field(line2, 35, 42));
+    el.meanAnomaly = deg2rad(field(line2, 44, 51));
+    el.meanMotion = field(line2, 53, 63) / XPDOTP;
+    return el;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// IAU-82 Greenwich mean sidereal time [rad], as used to rotate TEME into the Earth-fixed frame
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double SGP4Propagator::greenwichSiderealTime(double jdUT1)
+{
+    double tut1 = (jdUT1 - 2451545.0) / 36525.0;
+    double gst_s = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1 +
+                   (876600.0 * 3600.0 + 8640184.812866) * tut1 + 67310.54841;
+    double gst = std::fmod(deg2rad(gst_s / 240.0), TWO_PI);
+    return gst < 0.0 ? gst + TWO_PI : gst;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Initialization (sgp4init, near-earth branch)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+SGP4Propagator::SGP4Propagator(const TwoLineElement &elements) : tle(elements)
+{
+    const double ecco = tle.eccentricity;
+    const double inclo = tle.inclination;
+    if (ecco < 0.0 || ecco >= 1.0 || tle.meanMotion <= 0.0)
+        throw std::runtime_error("SGP4Propagator() Error: invalid elements.");
+
+    // Recover the original mean motion and semi-major axis from the Kozai mean motion
+    double ak = std::pow(XKE / tle.meanMotion, X2O3);
+    double eccsq = ecco * ecco;
+    double omeosq = 1.0 - eccsq;
+    double rteosq = std::sqrt(omeosq);
+    double cosio = std::cos(inclo);
+    double cosio2 = cosio * cosio;
+    double d1 = 0.75 * J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    no_unkozai = tle.meanMotion / (1.0 + del);
+
+    if (TWO_PI / no_unkozai >= DEEP_SPACE_PERIOD_MIN)
+        throw std::runtime_error("SGP4Propagator() Error: deep-space orbits (period >= 225 min) are not supported.");
+
+    ao = std::pow(XKE / no_unkozai, X2O3);
+    double sinio = std::sin(inclo);
+    double po = ao * omeosq;
+    double con42 = 1.0 - 5.0 * cosio2;
+    con41 = -con42 - cosio2 - cosio2;
+    double posq = po * po;
+    double rp = ao * (1.0 - ecco);
+
+    // Perigees below 220 km use the simplified drag terms
+    isimp = rp < (220.0 / EARTH_RADIUS_KM + 1.0);
+
+    double sfour = 78.0 / EARTH_RADIUS_KM + 1.0;
+    double qzms24 = std::pow((120.0 - 78.0) / EARTH_RADIUS_KM, 4);
+    double perige = (rp - 1.0) * EARTH_RADIUS_KM;
+    if (perige < 156.0)
+    {
+        sfour = perige < 98.0 ? 20.0 : perige - 78.0;
+        qzms24 = std::pow((120.0 - sfour) / EARTH_RADIUS_KM, 4);
+        sfour = sfour / EARTH_RADIUS_KM + 1.0;
+    }
+    double pinvsq = 1.0 / posq;
+
+    double tsi = 1.0 / (ao - sfour);
+    eta = ao * ecco * tsi;
+    double etasq = eta * eta;
+    double eeta = ecco * eta;
+    double psisq = std::fabs(1.0 - etasq);
+    double coef = qzms24 * std::pow(tsi, 4);
+    double coef1 = coef / std::pow(psisq, 3.5);
+    double cc2 = coef1 * no_unkozai *
+                 (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
+                  0.375 * J2 * tsi / psisq * con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+    cc1 = tle.bstar * cc2;
+    double cc3 = ecco > 1.0e-4 ? -2.0 * coef * tsi * J3OJ2 * no_unkozai * sinio / ecco : 0.0;
+    x1mth2 = 1.0 - cosio2;
+    cc4 = 2.0 * no_unkozai * coef1 * ao * omeosq *
+          (eta * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq) -
+           J2 * tsi / (ao * psisq) *
+               (-3.0 * con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+                0.75 * x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos(2.0 * tle.argPerigee)));
+    cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    double cosio4 = cosio2 * cosio2;
+    double temp1 = 1.5 * J2 * pinvsq * no_unkozai;
+    double temp2 = 0.5 * temp1 * J2 * pinvsq;
+    double temp3 = -0.46875 * J4 * pinvsq * pinvsq * no_unkozai;
+    mdot = no_unkozai + 0.5 * temp1 * rteosq * con41 +
+           0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+    argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+              temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+    double xhdot1 = -temp1 * cosio;
+    nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+    omgcof = tle.bstar * cc3 * std::cos(tle.argPerigee);
+    xmcof = ecco > 1.0e-4 ? -X2O3 * coef * tle.bstar / eeta : 0.0;
+    nodecf = 3.5 * omeosq * xhdot1 * cc1;
+    t2cof = 1.5 * cc1;
+    // Avoid the divide by zero for 180 deg inclination
+    double opcosio = std::fabs(cosio + 1.0) > 1.5e-12 ? 1.0 + cosio : 1.5e-12;
+    xlcof = -0.25 * J3OJ2 * sinio * (3.0 + 5.0 * cosio) / opcosio;
+    aycof = -0.5 * J3OJ2 * sinio;
+    delmo = std::pow(1.0 + eta * std::cos(tle.meanAnomaly), 3);
+    sinmao = std::sin(tle.meanAnomaly);
+    x7thm1 = 7.0 * cosio2 - 1.0;
+
+    d2 = d3 = d4 = t3cof = t4cof = t5cof = 0.0;
+    if (!isimp)
+    {
+        double cc1sq = cc1 * cc1;
+        d2 = 4.0 * ao * tsi * cc1sq;
+        double temp = d2 * tsi * cc1 / 3.0;
+        d3 = (17.0 * ao + sfour) * temp;
+        d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * cc1;
+        t3cof = d2 + 2.0 * cc1sq;
+        t4cof = 0.25 * (3.0 * d3 + cc1 * (12.0 * d2 + 10.0 * cc1sq));
+        t5cof = 0.2 * (3.0 * d4 + 12.0 * cc1 * d3 + 6.0 * d2 * d2 + 15.0 * cc1sq * (2.0 * d2 + cc1sq));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Propagation (sgp4, near-earth branch)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SGP4Propagator::propagate(double t, double r_km[3], double v_kmps[3]) const
+{
+    // Secular gravity and atmospheric drag
+    double xmdf = tle.meanAnomaly + mdot * t;
+    double argpdf = tle.argPerigee + argpdot * t;
+    double nodedf = tle.raan + nodedot * t;
+    double argpm = argpdf;
+    double mm = xmdf;
+    double t2 = t * t;
+    double nodem = nodedf + nodecf * t2;
+    double tempa = 1.0 - cc1 * t;
+    double tempe = tle.bstar * cc4 * t;
+    double templ = t2cof * t2;
+
+    if (!isimp)
+    {
+        double delomg = omgcof * t;
+        double delm = xmcof * (std::pow(1.0 + eta * std::cos(xmdf), 3) - delmo);
+        mm = xmdf + delomg + delm;
+        argpm = argpdf - delomg - delm;
+        double t3 = t2 * t;
+        double t4 = t3 * t;
+        tempa = tempa - d2 * t2 - d3 * t3 - d4 * t4;
+        tempe = tempe + tle.bstar * cc5 * (std::sin(mm) - sinmao);
+        templ = templ + t3cof * t3 + t4 * (t4cof + t * t5cof);
+    }
+
+    double am = std::pow(XKE / no_unkozai, X2O3) * tempa * tempa;
+    double nm = XKE / std::pow(am, 1.5);
+    double em = tle.eccentricity - tempe;
+    if (em >= 1.0 || em < -0.001 || am < 0.95)
+        throw std::runtime_error("SGP4Propagator::propagate() Error: elements have gone invalid (decayed?).");
+    if (em < 1.0e-6)
+        em = 1.0e-6;
+    mm = mm + no_unkozai * templ;
+    double xlm = mm + argpm + nodem;
+
+    nodem = std::fmod(nodem, TWO_PI);
+    argpm = std::fmod(argpm, TWO_PI);
+    xlm = std::fmod(xlm, TWO_PI);
+    mm = std::fmod(xlm - argpm - nodem, TWO_PI);
+
+    double sinip = std::sin(tle.inclination);
+    double cosip = std::cos(tle.inclination);
+
+    // Long period periodics
+    double axnl = em * std::cos(argpm);
+    double temp = 1.0 / (am * (1.0 - em * em));
+    double aynl = em * std::sin(argpm) + temp * aycof;
+    double xl = mm + argpm + nodem + temp * xlcof * axnl;
+
+    // Kepler's equation
+    double u = std::fmod(xl - nodem, TWO_PI);
+    double eo1 = u;
+    double tem5 = 9999.9;
+    double sineo1 = 0.0, coseo1 = 0.0;
+    for (int ktr = 1; std::fabs(tem5) >= 1.0e-12 && ktr <= 10; ktr++)
+    {
+        sineo1 = std::sin(eo1);
+        coseo1 = std::cos(eo1);
+        tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+        if (std::fabs(tem5) >= 0.95)
+            tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+        eo1 = eo1 + tem5;
+    }
+
+    // Short period preliminary quantities
+    double ecose = axnl * coseo1 + aynl * sineo1;
+    double esine = axnl * sineo1 - aynl * coseo1;
+    double el2 = axnl * axnl + aynl * aynl;
+    double pl = am * (1.0 - el2);
+    if (pl < 0.0)
+        throw std::runtime_error("SGP4Propagator::propagate() Error: semi-latus rectum < 0.");
+
+    double rl = am * (1.0 - ecose);
+    double rdotl = std::sqrt(am) * esine / rl;
+    double rvdotl = std::sqrt(pl) / rl;
+    double betal = std::sqrt(1.0 - el2);
+    temp = esine / (1.0 + betal);
+    double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = std::atan2(sinu, cosu);
+    double sin2u = (cosu + cosu) * sinu;
+    double cos2u = 1.0 - 2.0 * sinu * sinu;
+    temp = 1.0 / pl;
+    double temp1 = 0.5 * J2 * temp;
+    double temp2 = temp1 * temp;
+
+    // Short period periodics
+    double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41) + 0.5 * temp1 * x1mth2 * cos2u;
+    su = su - 0.25 * temp2 * x7thm1 * sin2u;
+    double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+    double xinc = tle.inclination + 1.5 * temp2 * cosip * sinip * cos2u;
+    double mvt = rdotl - nm * temp1 * x1mth2 * sin2u / XKE;
+    double rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u + 1.5 * con41) / XKE;
+
+    // Orientation vectors
+    double sinsu = std::sin(su), cossu = std::cos(su);
+    double snod = std::sin(xnode), cnod = std::cos(xnode);
+    double sini = std::sin(xinc), cosi = std::cos(xinc);
+    double xmx = -snod * cosi;
+    double xmy = cnod * cosi;
+    double ux = xmx * sinsu + cnod * cossu;
+    double uy = xmy * sinsu + snod * cossu;
+    double uz = sini * sinsu;
+    double vx = xmx * cossu - cnod * sinsu;
+    double vy = xmy * cossu - snod * sinsu;
+    double vz = sini * cossu;
+
+    if (mrt < 1.0)
+        throw std::runtime_error("SGP4Propagator::propagate() Error: satellite has decayed.");
+
+    const double vkmpersec = EARTH_RADIUS_KM * XKE / 60.0;
+    r_km[0] = mrt * ux * EARTH_RADIUS_KM;
+    r_km[1] = mrt * uy * EARTH_RADIUS_KM;
+    r_km[2] = mrt * uz * EARTH_RADIUS_KM;
+    v_kmps[0] = (mvt * ux + rvdot * vx) * vkmpersec;
+    v_kmps[1] = (mvt * uy + rvdot * vy) * vkmpersec;
+    v_kmps[2] = (mvt * uz + rvdot * vz) * vkmpersec;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// TEME -> Earth-fixed (GMST rotation, polar motion ignored) -> local east/north/up
+//////////////////////////////////////////////////////////////////////////////////////////////////
+SatelliteLook SGP4Propagator::look(double jd, double lat_deg, double lon_deg, double height_m) const
+{
+    double r[3], v[3];
+    propagate((jd - tle.epochJD) * MIN_PER_DAY, r, v);
+
+    double gst = greenwichSiderealTime(jd);
+    double cg = std::cos(gst), sg = std::sin(gst);
+    double rf[3] = {cg * r[0] + sg * r[1], -sg * r[0] + cg * r[1], r[2]};
+    double vf[3] = {cg * v[0] + sg * v[1] + EARTH_ROTATION_RADPS * rf[1],
+                    -sg * v[0] + cg * v[1] - EARTH_ROTATION_RADPS * rf[0],
+                    v[2]};
+
+    double lat = deg2rad(lat_deg), lon = deg2rad(lon_deg);
+    double sLat = std::sin(lat), cLat = std::cos(lat);
+    double sLon = std::sin(lon), cLon = std::cos(lon);
+    double e2 = WGS84_F * (2.0 - WGS84_F);
+    double N = WGS84_A_KM / std::sqrt(1.0 - e2 * sLat * sLat);
+    double h = height_m * 1.0e-3;
+    double obs[3] = {(N + h) * cLat * cLon, (N + h) * cLat * sLon, (N * (1.0 - e2) + h) * sLat};
+
+    double rho[3] = {rf[0] - obs[0], rf[1] - obs[1], rf[2] - obs[2]};
+    double E = -sLon * rho[0] + cLon * rho[1];
+    double Nn = -sLat * cLon * rho[0] - sLat * sLon * rho[1] + cLat * rho[2];
+    double U = cLat * cLon * rho[0] + cLat * sLon * rho[1] + sLat * rho[2];
+    double dE = -sLon * vf[0] + cLon * vf[1];
+    double dN = -sLat * cLon * vf[0] - sLat * sLon * vf[1] + cLat * vf[2];
+    double dU = cLat * cLon * vf[0] + cLat * sLon * vf[1] + sLat * vf[2];
+
+    double horiz2 = E * E + Nn * Nn;
+    double horiz = std::sqrt(horiz2);
+    double range2 = horiz2 + U * U;
+
+    SatelliteLook lk;
+    lk.range = std::sqrt(range2);
+    lk.rangeRate = (E * dE + Nn * dN + U * dU) / lk.range;
+    lk.alt = rad2deg(std::atan2(U, horiz));
+    lk.az = rad2deg(std::atan2(E, Nn));
+    if (lk.az < 0.0)
+        lk.az += 360.0;
+    double dHoriz = (E * dE + Nn * dN) / horiz;
+    lk.altRate = rad2deg((dU * horiz - U * dHoriz) / range2);
+    lk.azRate = rad2deg((Nn * dE - E * dN) / horiz2);
+    return lk;
+}
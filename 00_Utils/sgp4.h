@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+
+namespace SGP4
+{
+    // WGS-72 constants, which the TLE mean elements are fitted against
+    constexpr double MU_KM3PS2 = 398600.8;
+    constexpr double EARTH_RADIUS_KM = 6378.135;
+    constexpr double J2 = 0.001082616;
+    constexpr double J3 = -0.00000253881;
+    constexpr double J4 = -0.00000165597;
+    constexpr double MIN_PER_DAY = 1440.0;
+    // Orbits with periods at or above this need the deep-space (SDP4) terms, which aren't implemented
+    constexpr double DEEP_SPACE_PERIOD_MIN = 225.0;
+
+    // WGS-84 ellipsoid for the observer, and the Earth's rotation rate
+    constexpr double WGS84_A_KM = 6378.137;
+    constexpr double WGS84_F = 1.0 / 298.257223563;
+    constexpr double EARTH_ROTATION_RADPS = 7.29211514670698e-5;
+}
+
+// Mean elements from a NORAD two-line element set (angles in radians, mean motion in rad/min)
+struct TwoLineElement
+{
+    std::string satnum;
+    double epochJD;
+    double bstar;
+    double ndot;
+    double nddot;
+    double inclination;
+    double raan;
+    double eccentricity;
+    double argPerigee;
+    double meanAnomaly;
+    double meanMotion;
+};
+
+// Observed position of a satellite [deg, deg/s, km, km/s]
+struct SatelliteLook
+{
+    double alt;
+    double az;
+    double altRate;
+    double azRate;
+    double range;
+    double rangeRate;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Near-earth SGP4 propagator (Hoots & Roehrich, Spacetrack Report #3, as revised by Vallado et
+/// al. 2006). Positions and velocities are in the TEME frame, in km and km/s. Deep-space orbits
+/// (period of 225 min or more) are rejected.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class SGP4Propagator
+{
+public:
+    // Throws std::runtime_error if the lines are malformed or fail their checksum
+    static TwoLineElement parseTLE(const std::string &line1, const std::string &line2);
+    static double greenwichSiderealTime(double jdUT1);
+
+    SGP4Propagator(const TwoLineElement &elements);
+    virtual ~SGP4Propagator() {}
+
+    double getEpochJD() const { return tle.epochJD; }
+    const std::string &getSatnum() const { return tle.satnum; }
+
+    // Throws std::runtime_error if the orbit has decayed or the elements have gone invalid
+    void propagate(double tsince_min, double r_km[3], double v_kmps[3]) const;
+    // Topocentric alt/az (north through east) and rates for a geodetic observer
+    SatelliteLook look(double jd, double lat_deg, double lon_deg, double height_m) const;
+
+private:
+    TwoLineElement tle;
+    bool isimp;
+    double no_unkozai;
+    double ao, con41, x1mth2, x7thm1, eta;
+    double cc1, cc4, cc5, d2, d3, d4, delmo, sinmao;
+    double mdot, argpdot, nodedot, omgcof, xmcof, nodecf, t2cof, t3cof, t4cof, t5cof;
+    double xlcof, aycof;
+};
@@ -0,0 +1,204 @@
+#include "sky_grid.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SKY_GRID;
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+static std::runtime_error gridError(const std::string &path, const std::string &what)
+{
+    std::stringstream ss;
+    ss << "Sky grid " << path << ": " << what;
+    return std::runtime_error(ss.str());
+}
+
+// Catmull-Rom weights for the four taps around t in [0, 1), and their derivatives
+static void catmullRom(double t, double w[4], double dw[4])
+{
+    double t2 = t * t, t3 = t2 * t;
+    w[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+    w[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+    w[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+    w[3] = 0.5 * (t3 - t2);
+    dw[0] = 0.5 * (-3.0 * t2 + 4.0 * t - 1.0);
+    dw[1] = 0.5 * (9.0 * t2 - 10.0 * t);
+    dw[2] = 0.5 * (-9.0 * t2 + 8.0 * t + 1.0);
+    dw[3] = 0.5 * (3.0 * t2 - 2.0 * t);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+SkyGrid::SkyGrid(const std::string &p)
+    : path(p), map(MAP_FAILED), mapSize(0), header(nullptr), values(nullptr), altStep(0), azStep(0), maxAbs(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw gridError(path, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SkyGridHeader))
+    {
+        close(fd);
+        throw gridError(path, "too short for a grid header");
+    }
+    mapSize = st.st_size;
+    map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw gridError(path, strerror(errno));
+
+    header = static_cast<const SkyGridHeader *>(map);
+    values = reinterpret_cast<const float *>(header + 1);
+    try
+    {
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw gridError(path, "not a sky grid file");
+        if (header->version != VERSION)
+            throw gridError(path, "unsupported version " + std::to_string(header->version));
+        if (header->nAlt < MIN_ALT_NODES || header->nAz < MIN_AZ_NODES)
+            throw gridError(path, "too few grid nodes");
+        if (!(header->altMax_deg > header->altMin_deg) || header->altMin_deg < -90.0 || header->altMax_deg > 90.0)
+            throw gridError(path, "bad altitude range");
+        size_t count = (size_t)header->nAlt * header->nAz * 2;
+        if (mapSize != sizeof(SkyGridHeader) + count * sizeof(float))
+            throw gridError(path, "size doesn't match the header");
+
+        for (size_t k = 0; k < count; k++)
+        {
+            if (!std::isfinite(values[k]) || std::fabs(values[k]) > MAX_CORRECTION_ARCSEC)
+                throw gridError(path, "bad correction value");
+            maxAbs = std::max(maxAbs, (double)std::fabs(values[k]));
+        }
+    }
+    catch (...)
+    {
+        munmap(map, mapSize);
+        throw;
+    }
+
+    altStep = (header->altMax_deg - header->altMin_deg) / (header->nAlt - 1);
+    azStep = 360.0 / header->nAz;
+}
+
+SkyGrid::~SkyGrid()
+{
+    if (map != MAP_FAILED)
+        munmap(map, mapSize);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Columns wrap in azimuth. Beyond the altitude range the value at the edge is held.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SkyGrid::evaluate(double alt, double az, SkyGridSample &s) const
+{
+    const int nAlt = header->nAlt, nAz = header->nAz;
+
+    bool altClamped = alt <= header->altMin_deg || alt >= header->altMax_deg;
+    double u = (std::min(std::max(alt, header->altMin_deg), header->altMax_deg) - header->altMin_deg) / altStep;
+    int i = std::min((int)u, nAlt - 2);
+    double tAlt = u - i;
+
+    double v = std::fmod(az, 360.0);
+    if (v < 0.0)
+        v += 360.0;
+    v /= azStep;
+    int j = std::min((int)v, nAz - 1);
+    double tAz = v - j;
+
+    double wAlt[4], dwAlt[4], wAz[4], dwAz[4];
+    catmullRom(tAlt, wAlt, dwAlt);
+    catmullRom(tAz, wAz, dwAz);
+
+    int cols[4];
+    for (int n = 0; n < 4; n++)
+        cols[n] = (j - 1 + n + nAz) % nAz;
+
+    double acc[6] = {0, 0, 0, 0, 0, 0};
+    for (int m = 0; m < 4; m++)
+    {
+        // The rows outside the grid are extrapolated linearly from the edge, so the first and
+        // last intervals are as accurate as the rest
+        int row = i - 1 + m;
+        int edge = row < 0 ? 0 : nAlt - 1;
+        bool ghost = row < 0 || row > nAlt - 1;
+        const float *r = values + (size_t)(ghost ? edge : row) * nAz * 2;
+        const float *inner = values + (size_t)(row < 0 ? 1 : nAlt - 2) * nAz * 2;
+        double rowAlt = 0, rowAz = 0, rowAlt_dAz = 0, rowAz_dAz = 0;
+        for (int n = 0; n < 4; n++)
+        {
+            const float *c = r + cols[n] * 2;
+            double cAlt = c[0], cAz = c[1];
+            if (ghost)
+            {
+                cAlt = 2.0 * c[0] - inner[cols[n] * 2];
+                cAz = 2.0 * c[1] - inner[cols[n] * 2 + 1];
+            }
+            rowAlt += wAz[n] * cAlt;
+            rowAz += wAz[n] * cAz;
+            rowAlt_dAz += dwAz[n] * cAlt;
+            rowAz_dAz += dwAz[n] * cAz;
+        }
+        acc[0] += wAlt[m] * rowAlt;
+        acc[1] += wAlt[m] * rowAz;
+        acc[2] += dwAlt[m] * rowAlt;
+        acc[3] += wAlt[m] * rowAlt_dAz;
+        acc[4] += dwAlt[m] * rowAz;
+        acc[5] += wAlt[m] * rowAz_dAz;
+    }
+
+    s.dAlt = acc[0];
+    s.dAz = acc[1];
+    s.dAlt_dAlt = altClamped ? 0.0 : acc[2] / altStep;
+    s.dAlt_dAz = acc[3] / azStep;
+    s.dAz_dAlt = altClamped ? 0.0 : acc[4] / altStep;
+    s.dAz_dAz = acc[5] / azStep;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SkyGrid::write(const std::string &path, unsigned nAlt, unsigned nAz, double altMin_deg,
+                    double altMax_deg, const std::vector<float> &vals)
+{
+    if (nAlt < MIN_ALT_NODES || nAz < MIN_AZ_NODES || vals.size() != (size_t)nAlt * nAz * 2)
+        throw gridError(path, "grid size and values don't match");
+
+    SkyGridHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.nAlt = nAlt;
+    h.nAz = nAz;
+    h.altMin_deg = altMin_deg;
+    h.altMax_deg = altMax_deg;
+
+    // Written beside the target and renamed over it: a driver that has the old file mapped keeps
+    // its pages, where truncating the file in place would fault it
+    std::string tmpPath = path + ".tmp";
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr)
+        throw gridError(tmpPath, strerror(errno));
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+              fwrite(vals.data(), sizeof(float), vals.size(), fp) == vals.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+        throw gridError(path, "write failed");
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SKY_GRID
+{
+    constexpr char MAGIC[8] = {'L', 'F', 'S', 'K', 'Y', 'G', 'R', 'D'};
+    constexpr uint32_t VERSION = 1;
+    constexpr unsigned MIN_ALT_NODES = 2;
+    constexpr unsigned MIN_AZ_NODES = 4;
+    // Loose sanity limit on the stored corrections [arcsec]
+    constexpr float MAX_CORRECTION_ARCSEC = 3600.0f;
+    // Fixed-point passes when taking the grid back out of a mount position
+    constexpr unsigned INVERSE_ITERATIONS = 2;
+}
+
+// File layout: this header, then nAlt * nAz (dAlt, dAz) float pairs [arcsec], azimuth fastest.
+// Altitude nodes run from altMin to altMax inclusive; azimuth nodes are at k * 360 / nAz and wrap.
+struct SkyGridHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nAlt;
+    uint32_t nAz;
+    uint32_t reserved;
+    double altMin_deg;
+    double altMax_deg;
+};
+
+// Correction at a sky position [arcsec] and its derivatives [arcsec/deg] for the rate feedforward
+struct SkyGridSample
+{
+    double dAlt;
+    double dAz;
+    double dAlt_dAlt;
+    double dAlt_dAz;
+    double dAz_dAlt;
+    double dAz_dAz;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Dense alt/az correction table for the residuals the parametric pointing model doesn't
+/// capture. The file is memory-mapped read-only and interpolated bicubically (Catmull-Rom), so a
+/// lookup is 16 taps whatever the grid size. Above and below the altitude range the edge row is
+/// used. The constructor checks the whole file, which also faults its pages in, so the first
+/// lookups on the control thread don't hit the disk.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class SkyGrid
+{
+public:
+    explicit SkyGrid(const std::string &path);
+    ~SkyGrid();
+    SkyGrid(const SkyGrid &) = delete;
+    SkyGrid &operator=(const SkyGrid &) = delete;
+
+    void evaluate(double alt, double az, SkyGridSample &s) const;
+
+    unsigned numAlt() const { return header->nAlt; }
+    unsigned numAz() const { return header->nAz; }
+    double altMin() const { return header->altMin_deg; }
+    double altMax() const { return header->altMax_deg; }
+    // Largest correction in the table [arcsec]
+    double maxCorrection() const { return maxAbs; }
+    const std::string &getPath() const { return path; }
+
+    // values holds nAlt * nAz (dAlt, dAz) pairs in file order. The file is replaced atomically.
+    // Throws on bad sizes or I/O errors.
+    static void write(const std::string &path, unsigned nAlt, unsigned nAz, double altMin_deg,
+                      double altMax_deg, const std::vector<float> &values);
+
+private:
+    std::string path;
+    void *map;
+    size_t mapSize;
+    const SkyGridHeader *header;
+    const float *values;
+    double altStep;
+    double azStep;
+    double maxAbs;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace SPSC_RING
+{
+    // Keeps the producer and consumer indices on separate cache lines
+    constexpr size_t CACHE_LINE_BYTES = 64;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed-size single-producer single-consumer ring of trivially copyable items. push() and pop()
+/// never block, lock or allocate, so the control thread can hand records to a writer thread
+/// without waiting on it. When the ring is full push() drops the item and counts it.
+/// N must be a power of two.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0), dropped(0) {}
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    // Producer side
+    bool push(const T &item)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buffer[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        item = buffer[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return N; }
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    T buffer[N];
+    std::atomic<size_t> head;
+    char headPadding[SPSC_RING::CACHE_LINE_BYTES];
+    std::atomic<size_t> tail;
+    char tailPadding[SPSC_RING::CACHE_LINE_BYTES];
+    std::atomic<uint64_t> dropped;
+};
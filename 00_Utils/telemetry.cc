@@ -0,0 +1,311 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace TELEMETRY;
+
+static const TelemetryChannelInfo channelInfo[NUM_TELEMETRY_CHANNELS] = {
+#define TELEMETRY_INFO(name, units) {#name, units},
+    TELEMETRY_CHANNELS(TELEMETRY_INFO)
+#undef TELEMETRY_INFO
+};
+
+const TelemetryChannelInfo *telemetryChannels()
+{
+    return channelInfo;
+}
+
+std::string telemetryFileStamp(double jd)
+{
+    std::time_t t = (std::time_t)((jd - UNIX_EPOCH_JD) * SEC_PER_DAY);
+    std::tm utc;
+    gmtime_r(&t, &utc);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", &utc);
+    return stamp;
+}
+
+static std::runtime_error fileError(const std::string &path, const std::string &what)
+{
+    std::stringstream ss;
+    ss << "Telemetry file " << path << ": " << what;
+    return std::runtime_error(ss.str());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TelemetryFile::chunkBytesFor(unsigned chunkRecords)
+{
+    return sizeof(TelemetryChunkHeader) + NUM_TELEMETRY_CHANNELS * sizeof(TelemetryChannelStats) +
+           (size_t)NUM_TELEMETRY_CHANNELS * chunkRecords * sizeof(double);
+}
+
+TelemetryFile::TelemetryFile(const std::string &filePath, unsigned chunkRecs)
+    : path(filePath), chunkRecords(chunkRecs), chunkBytes(chunkBytesFor(chunkRecs)), fd(-1), chunkIndex(0),
+      flushedRecords(0), columns((size_t)NUM_TELEMETRY_CHANNELS * chunkRecs)
+{
+    if (chunkRecords == 0)
+        throw fileError(path, "chunks must hold at least one record");
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw fileError(path, std::strerror(errno));
+
+    TelemetryFileHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, MAGIC, sizeof(hdr.magic));
+    hdr.version = VERSION;
+    hdr.numChannels = NUM_TELEMETRY_CHANNELS;
+    hdr.chunkRecords = chunkRecords;
+    try
+    {
+        writeAt(&hdr, sizeof(hdr), 0);
+        writeAt(channelInfo, sizeof(channelInfo), sizeof(hdr));
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    startChunk();
+}
+
+TelemetryFile::~TelemetryFile()
+{
+    try
+    {
+        flush();
+    }
+    catch (const std::exception &)
+    {
+    }
+    ::close(fd);
+}
+
+void TelemetryFile::startChunk()
+{
+    std::memset(&chunk, 0, sizeof(chunk));
+    for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+        stats[c] = TelemetryChannelStats{0, 0, 0, 0};
+    flushedRecords = 0;
+}
+
+void TelemetryFile::writeAt(const void *data, size_t bytes, size_t offset)
+{
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0)
+    {
+        ssize_t n = ::pwrite(fd, p, bytes, offset);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw fileError(path, std::strerror(errno));
+        }
+        p += n;
+        bytes -= n;
+        offset += n;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryFile::append(const TelemetryRecord &r)
+{
+    if (isChunkFull())
+    {
+        flush();
+        chunkIndex++;
+        startChunk();
+    }
+    const double *values = &r.jd;
+    const unsigned row = chunk.numRecords;
+    for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+    {
+        const double v = values[c];
+        columns[(size_t)c * chunkRecords + row] = v;
+        TelemetryChannelStats &s = stats[c];
+        s.min = row == 0 ? v : std::min(s.min, v);
+        s.max = row == 0 ? v : std::max(s.max, v);
+        s.sum += v;
+        s.sumSq += v * v;
+    }
+    if (row == 0)
+        chunk.jdFirst = r.jd;
+    chunk.jdLast = r.jd;
+    chunk.numRecords++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// The header goes last, so a reader never sees a record count ahead of the column data.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryFile::flush()
+{
+    if (chunk.numRecords == flushedRecords)
+        return;
+    const size_t base = chunkOffset(chunkIndex);
+    const size_t columnsOffset = base + sizeof(TelemetryChunkHeader) + sizeof(stats);
+    const unsigned n = chunk.numRecords - flushedRecords;
+    for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+    {
+        size_t first = (size_t)c * chunkRecords + flushedRecords;
+        writeAt(&columns[first], n * sizeof(double), columnsOffset + first * sizeof(double));
+    }
+    writeAt(stats, sizeof(stats), base + sizeof(TelemetryChunkHeader));
+    writeAt(&chunk, sizeof(chunk), base);
+    flushedRecords = chunk.numRecords;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TelemetryWriter::TelemetryWriter(const std::string &directory, size_t maxFileBytes, unsigned maxFiles,
+                                 unsigned chunkRecords)
+    : dir(directory), maxBytes(maxFileBytes), maxFiles(maxFiles), chunkRecords(chunkRecords), stampRepeats(0),
+      stopRequested(false), written(0)
+{
+    if (dir.empty())
+        throw std::runtime_error("TelemetryWriter: no output directory.");
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        std::stringstream ss;
+        ss << "TelemetryWriter: can't create " << dir << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    worker = std::thread(&TelemetryWriter::workerLoop, this);
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopRequested = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+uint64_t TelemetryWriter::getWritten() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return written;
+}
+
+std::string TelemetryWriter::getCurrentFile() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return currentFile;
+}
+
+std::string TelemetryWriter::getError() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return error;
+}
+
+void TelemetryWriter::setError(const std::string &what)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    error = what;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryWriter::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopRequested)
+    {
+        lock.unlock();
+        drain();
+        lock.lock();
+        cv.wait_for(lock, std::chrono::duration<double>(DRAIN_PERIOD_SEC),
+                    [this]()
+                    { return stopRequested; });
+    }
+    lock.unlock();
+    // The producer has stopped by now; write out the rest
+    drain();
+    file.reset();
+}
+
+void TelemetryWriter::drain()
+{
+    TelemetryRecord r;
+    uint64_t n = 0;
+    try
+    {
+        while (ring.pop(r))
+        {
+            if (file && file->isChunkFull() && file->getBytes() + file->getChunkBytes() > maxBytes)
+                file.reset();
+            if (!file && !openFile(r.jd))
+                continue;
+            file->append(r);
+            n++;
+        }
+        if (file)
+            file->flush();
+    }
+    catch (const std::exception &e)
+    {
+        // Start a fresh file with the next record
+        setError(e.what());
+        file.reset();
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    written += n;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Files are named after the UTC time of their first record.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool TelemetryWriter::openFile(double jd)
+{
+    const std::string stamp = telemetryFileStamp(jd);
+    std::stringstream ss;
+    ss << dir << "/" << FILE_PREFIX << stamp;
+    // Another file started in the same second gets a counter
+    if (stamp == lastStamp)
+        ss << "_" << ++stampRepeats;
+    else
+        stampRepeats = 0;
+    lastStamp = stamp;
+    ss << FILE_SUFFIX;
+    const std::string path = ss.str();
+
+    try
+    {
+        file = std::unique_ptr<TelemetryFile>(new TelemetryFile(path, chunkRecords));
+    }
+    catch (const std::exception &e)
+    {
+        setError(e.what());
+        return false;
+    }
+
+    files.push_back(path);
+    while (maxFiles > 0 && files.size() > maxFiles)
+    {
+        std::remove(files.front().c_str());
+        files.pop_front();
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    currentFile = path;
+    error.clear();
+    return true;
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+namespace TELEMETRY
+{
+    constexpr char MAGIC[8] = {'L', 'F', 'T', 'E', 'L', 'E', 'M', 'R'};
+    constexpr uint32_t VERSION = 2;
+    constexpr size_t CHANNEL_NAME_LEN = 32;
+    constexpr size_t CHANNEL_UNITS_LEN = 16;
+    // One minute of records at the 50 Hz control loop
+    constexpr unsigned CHUNK_RECORDS = 3000;
+    // About 80 s of records at the 50 Hz control loop, so a slow disk doesn't drop anything
+    constexpr size_t RING_RECORDS = 4096;
+    constexpr double DRAIN_PERIOD_SEC = 0.2;
+    constexpr size_t DEFAULT_FILE_BYTES = 256u * 1024u * 1024u;
+    constexpr unsigned DEFAULT_MAX_FILES = 20;
+    constexpr const char *FILE_PREFIX = "telemetry_";
+    constexpr const char *FILE_SUFFIX = ".lftm";
+    constexpr double SEC_PER_DAY = 86400.0;
+    constexpr double UNIX_EPOCH_JD = 2440587.5;
+}
+
+// One row per control tick: X(name, units). All channels are doubles, so the record has no
+// padding and every column has the same type. Append new channels at the end. The drive status
+// channels hold the drive's status word, with its error word in the upper 16 bits. The phase
+// channels are the previous tick's TICK_PHASES times, in the same order (zero unless the driver
+// was built with LFAST_PROFILING). loop_degraded is 1 while the loop monitor has the driver in
+// degraded mode.
+#define TELEMETRY_CHANNELS(X)          \
+    X(jd, "day")                       \
+    X(monotonic_s, "s")                \
+    X(dt_s, "s")                       \
+    X(tick_exec_s, "s")                \
+    X(track_state, "")                 \
+    X(alt_mode, "")                    \
+    X(az_mode, "")                     \
+    X(alt_posn_cmd_deg, "deg")         \
+    X(az_posn_cmd_deg, "deg")          \
+    X(alt_posn_fb_deg, "deg")          \
+    X(az_posn_fb_deg, "deg")           \
+    X(alt_posn_err_deg, "deg")         \
+    X(az_posn_err_deg, "deg")          \
+    X(alt_rate_cmd_dps, "deg/s")       \
+    X(az_rate_cmd_dps, "deg/s")        \
+    X(alt_rate_fb_dps, "deg/s")        \
+    X(az_rate_fb_dps, "deg/s")         \
+    X(alt_current_a, "A")              \
+    X(az_current_a, "A")               \
+    X(alt_dob_load_nm, "Nm")           \
+    X(az_dob_load_nm, "Nm")            \
+    X(alt_dob_comp_dps, "deg/s")       \
+    X(az_dob_comp_dps, "deg/s")        \
+    X(alt_drive_a_status, "")          \
+    X(alt_drive_b_status, "")          \
+    X(az_drive_a_status, "")           \
+    X(az_drive_b_status, "")           \
+    X(phase_timer_hit_s, "s")          \
+    X(phase_read_scope_status_s, "s")  \
+    X(phase_axis_feedback_s, "s")      \
+    X(phase_coord_transform_s, "s")    \
+    X(phase_publish_s, "s")            \
+    X(phase_track_target_s, "s")       \
+    X(phase_control_loops_s, "s")      \
+    X(phase_current_feedback_s, "s")   \
+    X(phase_drive_command_s, "s")      \
+    X(phase_telemetry_s, "s")          \
+    X(loop_degraded, "")
+
+typedef enum
+{
+#define TELEMETRY_ENUM(name, units) TM_##name,
+    TELEMETRY_CHANNELS(TELEMETRY_ENUM)
+#undef TELEMETRY_ENUM
+    NUM_TELEMETRY_CHANNELS
+} TelemetryChannel_t;
+
+struct TelemetryRecord
+{
+#define TELEMETRY_FIELD(name, units) double name;
+    TELEMETRY_CHANNELS(TELEMETRY_FIELD)
+#undef TELEMETRY_FIELD
+};
+static_assert(sizeof(TelemetryRecord) == NUM_TELEMETRY_CHANNELS * sizeof(double), "TelemetryRecord is padded");
+
+// File layout: this header, numChannels channel descriptors, then fixed-size chunks of up to
+// chunkRecords records. Each chunk is a TelemetryChunkHeader, one TelemetryChannelStats per
+// channel, then one column of chunkRecords doubles per channel (only numRecords of them valid).
+// Chunks are in time order, so their headers double as the time index: chunk k is at a known
+// offset and a reader can binary search them without touching the columns.
+struct TelemetryFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numChannels;
+    uint32_t chunkRecords;
+    uint32_t reserved;
+};
+
+struct TelemetryChannelInfo
+{
+    char name[TELEMETRY::CHANNEL_NAME_LEN];
+    char units[TELEMETRY::CHANNEL_UNITS_LEN];
+};
+
+struct TelemetryChunkHeader
+{
+    uint32_t numRecords;
+    uint32_t reserved;
+    double jdFirst;
+    double jdLast;
+};
+
+struct TelemetryChannelStats
+{
+    double min;
+    double max;
+    double sum;
+    double sumSq;
+};
+
+// Descriptors of the compiled-in channels, in record order
+const TelemetryChannelInfo *telemetryChannels();
+// UTC time for file names, e.g. 20250301T043000Z
+std::string telemetryFileStamp(double jd);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Writes one columnar telemetry file. Records are collected into the current chunk in memory;
+/// flush() writes out what was appended since the last flush (the new part of each column, then
+/// the chunk header), so a file that is cut off is still readable up to its last flush. Throws
+/// std::runtime_error on I/O errors.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TelemetryFile
+{
+public:
+    explicit TelemetryFile(const std::string &path, unsigned chunkRecords = TELEMETRY::CHUNK_RECORDS);
+    // Flushes (errors are lost; call flush() first to see them)
+    ~TelemetryFile();
+    TelemetryFile(const TelemetryFile &) = delete;
+    TelemetryFile &operator=(const TelemetryFile &) = delete;
+
+    void append(const TelemetryRecord &r);
+    void flush();
+
+    const std::string &getPath() const { return path; }
+    bool isChunkFull() const { return chunk.numRecords == chunkRecords; }
+    // File size through the end of the current chunk
+    size_t getBytes() const { return chunkOffset(chunkIndex) + chunkBytes; }
+    size_t getChunkBytes() const { return chunkBytes; }
+
+    static size_t headerBytes() { return sizeof(TelemetryFileHeader) + NUM_TELEMETRY_CHANNELS * sizeof(TelemetryChannelInfo); }
+    static size_t chunkBytesFor(unsigned chunkRecords);
+
+private:
+    const std::string path;
+    const unsigned chunkRecords;
+    const size_t chunkBytes;
+    int fd;
+    unsigned chunkIndex;
+    unsigned flushedRecords;
+    TelemetryChunkHeader chunk;
+    TelemetryChannelStats stats[NUM_TELEMETRY_CHANNELS];
+    // Channel-major: columns[c * chunkRecords + row]
+    std::vector<double> columns;
+
+    size_t chunkOffset(unsigned k) const { return headerBytes() + (size_t)k * chunkBytes; }
+    void startChunk();
+    void writeAt(const void *data, size_t bytes, size_t offset);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Full-rate binary telemetry. The control tick push()es one fixed-size record into a lock-free
+/// ring; a background thread drains it every DRAIN_PERIOD_SEC into columnar files in the output
+/// directory, starting a new file when the next chunk would take it past maxFileBytes and
+/// deleting the oldest beyond maxFiles. Records that don't fit in the ring are dropped (and
+/// counted) rather than stalling the tick.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TelemetryWriter
+{
+public:
+    explicit TelemetryWriter(const std::string &directory, size_t maxFileBytes = TELEMETRY::DEFAULT_FILE_BYTES,
+                             unsigned maxFiles = TELEMETRY::DEFAULT_MAX_FILES,
+                             unsigned chunkRecords = TELEMETRY::CHUNK_RECORDS);
+    // Writes out whatever is still queued
+    ~TelemetryWriter();
+    TelemetryWriter(const TelemetryWriter &) = delete;
+    TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+
+    // Control thread only
+    bool push(const TelemetryRecord &r) { return ring.push(r); }
+
+    uint64_t getDropped() const { return ring.getDropped(); }
+    uint64_t getWritten() const;
+    std::string getCurrentFile() const;
+    // Last file error; empty while writing normally
+    std::string getError() const;
+
+private:
+    const std::string dir;
+    const size_t maxBytes;
+    const unsigned maxFiles;
+    const unsigned chunkRecords;
+    SpscRing<TelemetryRecord, TELEMETRY::RING_RECORDS> ring;
+
+    // Worker thread state
+    std::unique_ptr<TelemetryFile> file;
+    std::deque<std::string> files;
+    std::string lastStamp;
+    unsigned stampRepeats;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stopRequested;
+    uint64_t written;
+    std::string currentFile;
+    std::string error;
+
+    void workerLoop();
+    void drain();
+    bool openFile(double jd);
+    void setError(const std::string &what);
+};
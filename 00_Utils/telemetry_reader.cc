@@ -0,0 +1,240 @@
+#include "telemetry_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace TELEMETRY;
+
+static std::runtime_error readerError(const std::string &path, const std::string &what)
+{
+    std::stringstream ss;
+    ss << "Telemetry file " << path << ": " << what;
+    return std::runtime_error(ss.str());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryStats::add(double v)
+{
+    min = count ? std::min(min, v) : v;
+    max = count ? std::max(max, v) : v;
+    sum += v;
+    sumSq += v * v;
+    count++;
+}
+
+void TelemetryStats::merge(uint64_t n, const TelemetryChannelStats &s)
+{
+    if (n == 0)
+        return;
+    min = count ? std::min(min, s.min) : s.min;
+    max = count ? std::max(max, s.max) : s.max;
+    sum += s.sum;
+    sumSq += s.sumSq;
+    count += n;
+}
+
+void TelemetryStats::merge(const TelemetryStats &s)
+{
+    TelemetryChannelStats cs{s.min, s.max, s.sum, s.sumSq};
+    merge(s.count, cs);
+}
+
+double TelemetryStats::rms() const
+{
+    return count ? std::sqrt(sumSq / count) : 0.0;
+}
+
+double TelemetryStats::stdDev() const
+{
+    if (!count)
+        return 0.0;
+    double m = mean();
+    return std::sqrt(std::max(0.0, sumSq / count - m * m));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Checks the header and walks the chunk headers to find how much of the file is complete.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TelemetryReader::TelemetryReader(const std::string &filePath)
+    : path(filePath), map(MAP_FAILED), mapSize(0), header(nullptr), channels(nullptr), chunkBytes(0), nChunks(0),
+      nRecords(0), jdChannel(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw readerError(path, strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw readerError(path, strerror(errno));
+    }
+    mapSize = st.st_size;
+    if (mapSize < sizeof(TelemetryFileHeader))
+    {
+        close(fd);
+        throw readerError(path, "too short for a telemetry file");
+    }
+    map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw readerError(path, strerror(errno));
+
+    header = static_cast<const TelemetryFileHeader *>(map);
+    try
+    {
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw readerError(path, "not a telemetry file");
+        if (header->version != VERSION)
+            throw readerError(path, "unsupported version " + std::to_string(header->version));
+        if (header->numChannels == 0 || header->chunkRecords == 0)
+            throw readerError(path, "bad header");
+        const size_t dataOffset = sizeof(TelemetryFileHeader) + header->numChannels * sizeof(TelemetryChannelInfo);
+        if (mapSize < dataOffset)
+            throw readerError(path, "channel table is cut off");
+        channels = reinterpret_cast<const TelemetryChannelInfo *>(header + 1);
+        int jd = findChannel("jd");
+        if (jd < 0)
+            throw readerError(path, "no jd channel");
+        jdChannel = jd;
+
+        chunkBytes = sizeof(TelemetryChunkHeader) + header->numChannels * sizeof(TelemetryChannelStats) +
+                     (size_t)header->numChannels * header->chunkRecords * sizeof(double);
+        const size_t statsBytes = header->numChannels * sizeof(TelemetryChannelStats);
+        for (size_t base = dataOffset; base + sizeof(TelemetryChunkHeader) + statsBytes <= mapSize; base += chunkBytes)
+        {
+            const TelemetryChunkHeader *c = reinterpret_cast<const TelemetryChunkHeader *>(static_cast<const char *>(map) + base);
+            if (c->numRecords == 0)
+                break;
+            if (c->numRecords > header->chunkRecords)
+                throw readerError(path, "bad chunk record count");
+            // The last column ends furthest into the chunk
+            size_t end = base + sizeof(TelemetryChunkHeader) + statsBytes +
+                         ((size_t)(header->numChannels - 1) * header->chunkRecords + c->numRecords) * sizeof(double);
+            if (end > mapSize)
+                break;
+            nChunks++;
+            nRecords += c->numRecords;
+        }
+    }
+    catch (...)
+    {
+        munmap(map, mapSize);
+        throw;
+    }
+}
+
+TelemetryReader::~TelemetryReader()
+{
+    if (map != MAP_FAILED)
+        munmap(map, mapSize);
+}
+
+int TelemetryReader::findChannel(const std::string &name) const
+{
+    for (unsigned c = 0; c < header->numChannels; c++)
+    {
+        if (std::strncmp(channels[c].name, name.c_str(), CHANNEL_NAME_LEN) == 0)
+            return c;
+    }
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+const char *TelemetryReader::chunkBase(unsigned k) const
+{
+    return reinterpret_cast<const char *>(channels + header->numChannels) + (size_t)k * chunkBytes;
+}
+
+const TelemetryChunkHeader &TelemetryReader::chunk(unsigned k) const
+{
+    return *reinterpret_cast<const TelemetryChunkHeader *>(chunkBase(k));
+}
+
+const TelemetryChannelStats &TelemetryReader::chunkStats(unsigned k, unsigned c) const
+{
+    return reinterpret_cast<const TelemetryChannelStats *>(chunkBase(k) + sizeof(TelemetryChunkHeader))[c];
+}
+
+const double *TelemetryReader::column(unsigned k, unsigned c) const
+{
+    const char *columns = chunkBase(k) + sizeof(TelemetryChunkHeader) + header->numChannels * sizeof(TelemetryChannelStats);
+    return reinterpret_cast<const double *>(columns) + (size_t)c * header->chunkRecords;
+}
+
+double TelemetryReader::firstJd() const
+{
+    return nChunks ? chunk(0).jdFirst : 0.0;
+}
+
+double TelemetryReader::lastJd() const
+{
+    return nChunks ? chunk(nChunks - 1).jdLast : 0.0;
+}
+
+unsigned TelemetryReader::findChunk(double jd) const
+{
+    unsigned lo = 0, hi = nChunks;
+    while (lo < hi)
+    {
+        unsigned mid = (lo + hi) / 2;
+        if (chunk(mid).jdLast < jd)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+unsigned TelemetryReader::findRow(unsigned k, double jd) const
+{
+    const double *t = column(k, jdChannel);
+    return std::lower_bound(t, t + chunk(k).numRecords, jd) - t;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryReader::forEachRecord(double jdFrom, double jdTo, const std::function<void(unsigned, unsigned)> &fn) const
+{
+    for (unsigned k = findChunk(jdFrom); k < nChunks && chunk(k).jdFirst <= jdTo; k++)
+    {
+        const double *t = column(k, jdChannel);
+        const unsigned n = chunk(k).numRecords;
+        for (unsigned row = findRow(k, jdFrom); row < n && t[row] <= jdTo; row++)
+            fn(k, row);
+    }
+}
+
+TelemetryStats TelemetryReader::summarize(unsigned c, double jdFrom, double jdTo) const
+{
+    TelemetryStats s;
+    if (c >= header->numChannels)
+        return s;
+    for (unsigned k = findChunk(jdFrom); k < nChunks && chunk(k).jdFirst <= jdTo; k++)
+    {
+        const TelemetryChunkHeader &h = chunk(k);
+        if (h.jdFirst >= jdFrom && h.jdLast <= jdTo)
+        {
+            s.merge(h.numRecords, chunkStats(k, c));
+            continue;
+        }
+        const double *t = column(k, jdChannel);
+        const double *v = column(k, c);
+        for (unsigned row = findRow(k, jdFrom); row < h.numRecords && t[row] <= jdTo; row++)
+            s.add(v[row]);
+    }
+    return s;
+}
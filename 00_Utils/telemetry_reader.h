@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "telemetry.h"
+
+// Running statistics of one channel; chunks merge their stored sums
+struct TelemetryStats
+{
+    uint64_t count;
+    double min;
+    double max;
+    double sum;
+    double sumSq;
+
+    TelemetryStats() : count(0), min(0), max(0), sum(0), sumSq(0) {}
+    void add(double v);
+    void merge(uint64_t n, const TelemetryChannelStats &s);
+    void merge(const TelemetryStats &s);
+    double mean() const { return count ? sum / count : 0.0; }
+    double rms() const;
+    double stdDev() const;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Read-only view of a columnar telemetry file (see TelemetryFile). The file is memory-mapped and
+/// nothing is read up front: a time range is found by binary search over the chunk headers, and
+/// only the columns asked for are touched. Summaries use the per-chunk statistics for chunks that
+/// are wholly inside the range and only scan the chunks at its ends. A file that is still being
+/// written (or was cut off) is read up to the last complete flush seen when it was opened.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TelemetryReader
+{
+public:
+    explicit TelemetryReader(const std::string &path);
+    ~TelemetryReader();
+    TelemetryReader(const TelemetryReader &) = delete;
+    TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+    const std::string &getPath() const { return path; }
+    unsigned numChannels() const { return header->numChannels; }
+    const TelemetryChannelInfo &channel(unsigned c) const { return channels[c]; }
+    // Channel index by name, or -1
+    int findChannel(const std::string &name) const;
+
+    unsigned numChunks() const { return nChunks; }
+    const TelemetryChunkHeader &chunk(unsigned k) const;
+    const TelemetryChannelStats &chunkStats(unsigned k, unsigned c) const;
+    const double *column(unsigned k, unsigned c) const;
+    uint64_t numRecords() const { return nRecords; }
+    double firstJd() const;
+    double lastJd() const;
+
+    // Calls fn(chunk, row) for every record with jdFrom <= jd <= jdTo, in time order
+    void forEachRecord(double jdFrom, double jdTo, const std::function<void(unsigned, unsigned)> &fn) const;
+    TelemetryStats summarize(unsigned c, double jdFrom, double jdTo) const;
+
+private:
+    std::string path;
+    void *map;
+    size_t mapSize;
+    const TelemetryFileHeader *header;
+    const TelemetryChannelInfo *channels;
+    size_t chunkBytes;
+    unsigned nChunks;
+    uint64_t nRecords;
+    unsigned jdChannel;
+
+    const char *chunkBase(unsigned k) const;
+    // First chunk whose last record is at or after jd (numChunks() if none)
+    unsigned findChunk(double jd) const;
+    // First row of chunk k at or after jd
+    unsigned findRow(unsigned k, double jd) const;
+};
@@ -0,0 +1,176 @@
+#include "telemetry_shm.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace TELEMETRY;
+
+static std::runtime_error shmError(const std::string &name, const std::string &what)
+{
+    std::stringstream ss;
+    ss << "Telemetry feed " << name << ": " << what;
+    return std::runtime_error(ss.str());
+}
+
+static size_t slotsOffsetBytes()
+{
+    size_t bytes = sizeof(TelemetryShmHeader) + NUM_TELEMETRY_CHANNELS * sizeof(TelemetryChannelInfo);
+    return (bytes + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Replaces any segment left behind under the same name by a publisher that didn't exit cleanly.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TelemetryShmPublisher::TelemetryShmPublisher(const std::string &shmName, unsigned capacityRecords, double periodSec)
+    : name(shmName), capacity(capacityRecords), mapSize(0), header(nullptr), slots(nullptr)
+{
+    if (capacity == 0)
+        throw shmError(name, "the ring must hold at least one record");
+    mapSize = slotsOffsetBytes() + (size_t)capacity * sizeof(TelemetryRecord);
+
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+        throw shmError(name, std::strerror(errno));
+    void *map = MAP_FAILED;
+    if (::ftruncate(fd, mapSize) == 0)
+        map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        ::shm_unlink(name.c_str());
+        throw shmError(name, std::strerror(err));
+    }
+
+    // The new segment is zero filled
+    header = static_cast<TelemetryShmHeader *>(map);
+    slots = reinterpret_cast<TelemetryRecord *>(static_cast<char *>(map) + slotsOffsetBytes());
+    header->version = SHM_VERSION;
+    header->numChannels = NUM_TELEMETRY_CHANNELS;
+    header->recordBytes = sizeof(TelemetryRecord);
+    header->capacity = capacity;
+    header->slotsOffset = slotsOffsetBytes();
+    header->pid = ::getpid();
+    header->periodSec = periodSec;
+    header->seq.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    std::memcpy(reinterpret_cast<TelemetryChannelInfo *>(header + 1), telemetryChannels(), NUM_TELEMETRY_CHANNELS * sizeof(TelemetryChannelInfo));
+    // Readers check the magic, so it goes in last
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SHM_MAGIC, sizeof(header->magic));
+}
+
+TelemetryShmPublisher::~TelemetryShmPublisher()
+{
+    header->closed.store(1, std::memory_order_release);
+    ::munmap(header, mapSize);
+    ::shm_unlink(name.c_str());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Seqlock write: seq goes odd, the slot is overwritten, seq goes even again.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TelemetryShmPublisher::publish(const TelemetryRecord &r)
+{
+    const uint64_t s = header->seq.load(std::memory_order_relaxed);
+    header->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slots[(s / 2) % capacity], &r, sizeof(r));
+    header->seq.store(s + 2, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TelemetryShmReader::TelemetryShmReader(const std::string &shmName)
+    : name(shmName), mapSize(0), header(nullptr), slots(nullptr), next(0), missed(0)
+{
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw shmError(name, std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        const int err = errno;
+        ::close(fd);
+        throw shmError(name, std::strerror(err));
+    }
+    mapSize = st.st_size;
+    if (mapSize < sizeof(TelemetryShmHeader))
+    {
+        ::close(fd);
+        throw shmError(name, "segment too small");
+    }
+    void *map = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (map == MAP_FAILED)
+        throw shmError(name, std::strerror(err));
+
+    header = static_cast<const TelemetryShmHeader *>(map);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::string problem;
+    if (std::memcmp(header->magic, SHM_MAGIC, sizeof(SHM_MAGIC)) != 0)
+        problem = "not a telemetry feed (or not ready yet)";
+    else if (header->version != SHM_VERSION)
+        problem = "unsupported version " + std::to_string(header->version);
+    else if (header->numChannels != NUM_TELEMETRY_CHANNELS || header->recordBytes != sizeof(TelemetryRecord))
+        problem = "channel list differs from this build";
+    else if (header->capacity == 0 || mapSize < header->slotsOffset + (size_t)header->capacity * header->recordBytes)
+        problem = "segment too small";
+    if (!problem.empty())
+    {
+        ::munmap(map, mapSize);
+        throw shmError(name, problem);
+    }
+    slots = reinterpret_cast<const TelemetryRecord *>(static_cast<const char *>(map) + header->slotsOffset);
+    // Start with whatever the ring holds now
+    const uint64_t head = header->seq.load(std::memory_order_acquire) / 2;
+    next = head > header->capacity ? head - header->capacity : 0;
+}
+
+TelemetryShmReader::~TelemetryShmReader()
+{
+    ::munmap(const_cast<TelemetryShmHeader *>(header), mapSize);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Seqlock read. Copies the published records we haven't seen, then re-reads seq: anything the
+/// publisher could have started overwriting in the meantime is thrown away rather than retried,
+/// since the publisher never waits and a retry could lose the race again.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TelemetryShmReader::poll(std::vector<TelemetryRecord> &out)
+{
+    const uint64_t cap = header->capacity;
+    const uint64_t head = header->seq.load(std::memory_order_acquire) / 2;
+    uint64_t from = std::max(next, head > cap ? head - cap : 0);
+    const size_t first = out.size();
+    out.resize(first + (head - from));
+    for (uint64_t i = from; i < head; i++)
+        std::memcpy(&out[first + (i - from)], &slots[i % cap], sizeof(TelemetryRecord));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Every record up to and including the one being written now may have been overwritten
+    const uint64_t started = (header->seq.load(std::memory_order_relaxed) + 1) / 2;
+    const uint64_t oldestIntact = started > cap ? started - cap : 0;
+    if (oldestIntact > from)
+    {
+        const uint64_t torn = std::min(oldestIntact, head) - from;
+        out.erase(out.begin() + first, out.begin() + first + torn);
+        from += torn;
+    }
+
+    if (from > next)
+        missed += from - next;
+    next = head;
+    return head - from;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace TELEMETRY
+{
+    constexpr char SHM_MAGIC[8] = {'L', 'F', 'T', 'E', 'L', 'E', 'M', 'S'};
+    constexpr uint32_t SHM_VERSION = 1;
+    constexpr const char *SHM_DEFAULT_NAME = "/lfast_telemetry";
+    // Slots start on their own cache line, away from the sequence counter
+    constexpr size_t SHM_ALIGN = 64;
+}
+
+// Segment layout: this header, numChannels TelemetryChannelInfo, then capacity record slots
+// starting at slotsOffset. Record i (counting from 0 since the publisher started) is in slot
+// i % capacity. seq is twice the number of records published, plus one while the next record is
+// being written, so a reader that copies slots between two reads of seq can tell which of them
+// the publisher may have overwritten meanwhile. All fields but seq and closed are fixed once the
+// segment exists.
+struct TelemetryShmHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numChannels;
+    uint32_t recordBytes;
+    uint32_t capacity;
+    uint32_t slotsOffset;
+    uint32_t pid;
+    // Nominal time between records
+    double periodSec;
+    std::atomic<uint64_t> seq;
+    // Set when the publisher stops; the name may by then refer to a new segment
+    std::atomic<uint32_t> closed;
+};
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "shared memory counters must be lock-free");
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Publishes every telemetry record into a POSIX shared-memory ring holding the newest
+/// `capacity` records, for local plotters and scripts to watch at the full loop rate. publish()
+/// is a copy and two stores: it never waits on readers, who can't slow the control thread and
+/// only ever map the segment read-only. The segment is unlinked when the publisher goes away.
+/// Throws std::runtime_error if the segment can't be created.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TelemetryShmPublisher
+{
+public:
+    TelemetryShmPublisher(const std::string &name, unsigned capacity, double periodSec);
+    ~TelemetryShmPublisher();
+    TelemetryShmPublisher(const TelemetryShmPublisher &) = delete;
+    TelemetryShmPublisher &operator=(const TelemetryShmPublisher &) = delete;
+
+    // Control thread only
+    void publish(const TelemetryRecord &r);
+
+    const std::string &getName() const { return name; }
+    unsigned getCapacity() const { return capacity; }
+    uint64_t getPublished() const { return header->seq.load(std::memory_order_relaxed) / 2; }
+
+private:
+    const std::string name;
+    const unsigned capacity;
+    size_t mapSize;
+    TelemetryShmHeader *header;
+    TelemetryRecord *slots;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Read-only attachment to a TelemetryShmPublisher's segment. The first poll() returns what the
+/// ring held on attaching, later ones the records published since; if the reader fell more than a
+/// ring behind, the oldest are lost and counted in getMissed().
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TelemetryShmReader
+{
+public:
+    explicit TelemetryShmReader(const std::string &name = TELEMETRY::SHM_DEFAULT_NAME);
+    ~TelemetryShmReader();
+    TelemetryShmReader(const TelemetryShmReader &) = delete;
+    TelemetryShmReader &operator=(const TelemetryShmReader &) = delete;
+
+    // Appends new records to out and returns how many
+    size_t poll(std::vector<TelemetryRecord> &out);
+
+    unsigned getCapacity() const { return header->capacity; }
+    double getPeriod() const { return header->periodSec; }
+    uint64_t getMissed() const { return missed; }
+    // True once the publisher has stopped; attach again to follow a restarted one
+    bool isClosed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+private:
+    const std::string name;
+    size_t mapSize;
+    const TelemetryShmHeader *header;
+    const TelemetryRecord *slots;
+    uint64_t next;
+    uint64_t missed;
+};
@@ -0,0 +1,87 @@
+#include "tick_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const char *phaseNames[NUM_TICK_PHASES] = {
+#define TICK_PHASE_NAME(name, label) #name,
+    TICK_PHASES(TICK_PHASE_NAME)
+#undef TICK_PHASE_NAME
+};
+
+static const char *phaseLabels[NUM_TICK_PHASES] = {
+#define TICK_PHASE_LABEL(name, label) label,
+    TICK_PHASES(TICK_PHASE_LABEL)
+#undef TICK_PHASE_LABEL
+};
+
+TickProfiler &tickProfiler()
+{
+    static TickProfiler profiler;
+    return profiler;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TickProfiler::TickProfiler(unsigned windowTicks)
+    : window(std::max(1u, windowTicks)), samples((size_t)NUM_TICK_PHASES * window)
+{
+    reset();
+}
+
+void TickProfiler::reset()
+{
+    for (unsigned p = 0; p < NUM_TICK_PHASES; p++)
+    {
+        tickTotal[p] = 0.0;
+        tickRan[p] = false;
+        lastTotal[p] = 0.0;
+        count[p] = 0;
+    }
+}
+
+void TickProfiler::endTick()
+{
+    for (unsigned p = 0; p < NUM_TICK_PHASES; p++)
+    {
+        lastTotal[p] = tickTotal[p];
+        if (tickRan[p])
+            samples[(size_t)p * window + count[p]++ % window] = tickTotal[p];
+        tickTotal[p] = 0.0;
+        tickRan[p] = false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TickPhaseStats TickProfiler::getStats(TickPhase_t phase) const
+{
+    TickPhaseStats s{0, 0.0, 0.0, 0.0};
+    s.count = std::min<unsigned long>(count[phase], window);
+    if (s.count == 0)
+        return s;
+
+    std::vector<double> v(samples.begin() + (size_t)phase * window, samples.begin() + (size_t)phase * window + s.count);
+    double sum = 0.0;
+    for (double x : v)
+        sum += x;
+    s.mean = sum / s.count;
+    s.min = *std::min_element(v.begin(), v.end());
+    // Nearest rank
+    size_t rank = (size_t)std::ceil(TICK_PROFILER::P99_FRACTION * s.count) - 1;
+    std::nth_element(v.begin(), v.begin() + rank, v.end());
+    s.p99 = v[rank];
+    return s;
+}
+
+const char *TickProfiler::phaseName(TickPhase_t phase)
+{
+    return phaseNames[phase];
+}
+
+const char *TickProfiler::phaseLabel(TickPhase_t phase)
+{
+    return phaseLabels[phase];
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace TICK_PROFILER
+{
+#if defined(LFAST_PROFILING)
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+    // Ten seconds of the 50 Hz control loop
+    constexpr unsigned WINDOW_TICKS = 500;
+    constexpr double P99_FRACTION = 0.99;
+}
+
+// Timed phases of the control tick: X(name, label). Phases nest, and a phase's time includes the
+// phases run inside it:
+//   timer_hit
+//     read_scope_status
+//       axis_feedback
+//       coord_transform
+//     track_target
+//     control_loops (both axes)
+//       current_feedback, drive_command
+//     telemetry
+//     publish (the property updates that are due, see PublishThrottle)
+// The Modbus traffic is in axis_feedback, current_feedback and drive_command. The telemetry
+// stream has one phase_<name>_s channel per phase, in this order.
+#define TICK_PHASES(X)                              \
+    X(timer_hit, "TimerHit")                        \
+    X(read_scope_status, "ReadScopeStatus")         \
+    X(axis_feedback, "Axis Feedback (bus)")         \
+    X(coord_transform, "Coordinate Transforms")     \
+    X(publish, "Property Publishing")               \
+    X(track_target, "Track Target")                 \
+    X(control_loops, "Control Loops")               \
+    X(current_feedback, "Current Feedback (bus)")   \
+    X(drive_command, "Drive Commands (bus)")        \
+    X(telemetry, "Telemetry")
+
+typedef enum
+{
+#define TICK_PHASE_ENUM(name, label) TICK_PHASE_##name,
+    TICK_PHASES(TICK_PHASE_ENUM)
+#undef TICK_PHASE_ENUM
+    NUM_TICK_PHASES
+} TickPhase_t;
+
+struct TickPhaseStats
+{
+    unsigned count;
+    double min;
+    double mean;
+    double p99;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Per-phase execution times of the control tick. Time spent in a phase is summed over the tick
+/// (a phase may run more than once, e.g. once per axis); endTick() then adds each phase that ran
+/// to its rolling window of the last windowTicks ticks, from which getStats() works out min, mean
+/// and 99th percentile. add() and endTick() don't allocate; getStats() sorts a copy of the window,
+/// so it's meant for the publishing rate rather than every tick. Single-threaded.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TickProfiler
+{
+public:
+    explicit TickProfiler(unsigned windowTicks = TICK_PROFILER::WINDOW_TICKS);
+
+    void add(TickPhase_t phase, double seconds)
+    {
+        tickTotal[phase] += seconds;
+        tickRan[phase] = true;
+    }
+    void endTick();
+
+    // Total for the last completed tick; zero if the phase didn't run
+    double lastTick(TickPhase_t phase) const { return lastTotal[phase]; }
+    TickPhaseStats getStats(TickPhase_t phase) const;
+    void reset();
+
+    static const char *phaseName(TickPhase_t phase);
+    static const char *phaseLabel(TickPhase_t phase);
+
+private:
+    const unsigned window;
+    double tickTotal[NUM_TICK_PHASES];
+    bool tickRan[NUM_TICK_PHASES];
+    double lastTotal[NUM_TICK_PHASES];
+    // window samples per phase, phase-major
+    std::vector<double> samples;
+    unsigned long count[NUM_TICK_PHASES];
+};
+
+// The instance the LFAST_PROFILE_* macros feed
+TickProfiler &tickProfiler();
+
+// Times its own lifetime into a phase
+class TickProfileScope
+{
+public:
+    explicit TickProfileScope(TickPhase_t p) : phase(p), start(std::chrono::steady_clock::now()) {}
+    ~TickProfileScope()
+    {
+        tickProfiler().add(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    TickProfileScope(const TickProfileScope &) = delete;
+    TickProfileScope &operator=(const TickProfileScope &) = delete;
+
+private:
+    const TickPhase_t phase;
+    const std::chrono::steady_clock::time_point start;
+};
+
+// The timers cost two clock reads each, so they are only compiled in when LFAST_PROFILING is
+// defined (set LFAST_PROFILING in the top-level CMakeLists.txt)
+#if defined(LFAST_PROFILING)
+#define LFAST_PROFILE_CONCAT_(a, b) a##b
+#define LFAST_PROFILE_CONCAT(a, b) LFAST_PROFILE_CONCAT_(a, b)
+#define LFAST_PROFILE_SCOPE(phase) TickProfileScope LFAST_PROFILE_CONCAT(tickProfileScope_, __LINE__)(phase)
+#define LFAST_PROFILE_END_TICK() tickProfiler().endTick()
+#else
+#define LFAST_PROFILE_SCOPE(phase) ((void)0)
+#define LFAST_PROFILE_END_TICK() ((void)0)
+#endif
@@ -0,0 +1,231 @@
+#include "tracking_ephemeris.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace EPHEMERIS;
+
+// Wrap period of each channel (0 = not an angle that wraps), and its scale to degrees for the
+// fit tolerance
+static const double CHANNEL_WRAP[NUM_EPHEM_CHANNELS] = {0.0, 360.0, 24.0, 0.0};
+static const double CHANNEL_TO_DEG[NUM_EPHEM_CHANNELS] = {1.0, 1.0, 15.0, 1.0};
+
+static double wrapChannel(unsigned ch, double value)
+{
+    if (CHANNEL_WRAP[ch] == 0.0)
+        return value;
+    double wrapped = std::fmod(value, CHANNEL_WRAP[ch]);
+    return wrapped < 0.0 ? wrapped + CHANNEL_WRAP[ch] : wrapped;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TrackingEphemeris::TrackingEphemeris(Clock clk)
+    : clock(clk), generation(0), jdFillFrom(0.0), stopRequested(false), refillRequested(false)
+{
+}
+
+TrackingEphemeris::~TrackingEphemeris()
+{
+    stop();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double TrackingEphemeris::systemJulianDate()
+{
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    double sec = std::chrono::duration<double>(sinceEpoch).count();
+    return UNIX_EPOCH_JD + sec / SEC_PER_DAY;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TrackingEphemeris::start()
+{
+    if (worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopRequested = false;
+    }
+    worker = std::thread(&TrackingEphemeris::workerLoop, this);
+}
+
+void TrackingEphemeris::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopRequested = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+void TrackingEphemeris::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopRequested)
+    {
+        refillRequested = false;
+        lock.unlock();
+        refill();
+        lock.lock();
+        cv.wait_for(lock, std::chrono::duration<double>(WORKER_PERIOD_SEC),
+                    [this]()
+                    { return stopRequested || refillRequested; });
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TrackingEphemeris::setTarget(const Sampler &s, double jdStart)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        sampler = s;
+        generation++;
+        segments.clear();
+        jdFillFrom = jdStart;
+        refillRequested = true;
+    }
+    cv.notify_all();
+}
+
+void TrackingEphemeris::clearTarget()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    sampler = nullptr;
+    generation++;
+    segments.clear();
+}
+
+double TrackingEphemeris::coveredUntil() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return segments.empty() ? 0.0 : segments.back().jdEnd();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool TrackingEphemeris::evaluate(double jd, EphemerisState &state) const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto &seg : segments)
+    {
+        if (jd < seg.jdStart || jd > seg.jdEnd())
+            continue;
+
+        double x = 2.0 * (jd - seg.jdStart) * SEC_PER_DAY / seg.span_s - 1.0;
+        double scale = 2.0 / seg.span_s;
+        for (unsigned ch = 0; ch < NUM_EPHEM_CHANNELS; ch++)
+        {
+            state.position[ch] = wrapChannel(ch, seg.series[ch].value(x));
+            state.rate[ch] = seg.series[ch].derivative(x) * scale;
+            state.accel[ch] = seg.series[ch].secondDerivative(x) * scale * scale;
+        }
+        return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TrackingEphemeris::refill()
+{
+    for (;;)
+    {
+        Sampler s;
+        unsigned gen;
+        double jdFrom;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!sampler)
+                return;
+            double jdNow = clock();
+            while (!segments.empty() && segments.front().jdEnd() < jdNow)
+                segments.pop_front();
+            // If the chain ran dry, restart it just behind the clock rather than refitting the past
+            jdFrom = segments.empty() ? std::max(jdFillFrom, jdNow - 1.0 / SEC_PER_DAY)
+                                      : segments.back().jdEnd();
+            if ((jdFrom - jdNow) * SEC_PER_DAY >= REFILL_LEAD_SEC)
+                return;
+            s = sampler;
+            gen = generation;
+        }
+
+        // Sample and fit without holding the lock so the control tick is never blocked on it
+        Segment seg;
+        double span_s = SEGMENT_SPAN_SEC;
+        double maxErr = 0.0;
+        bool ok;
+        while ((ok = fitSegment(s, jdFrom, span_s, seg, maxErr)) &&
+               maxErr > FIT_TOLERANCE_DEG && span_s * 0.5 >= MIN_SEGMENT_SPAN_SEC)
+            span_s *= 0.5;
+        if (!ok)
+            return;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (gen != generation)
+            continue;
+        if (!segments.empty() && segments.back().jdEnd() != jdFrom)
+            continue;
+        segments.push_back(std::move(seg));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fits one segment on the Chebyshev nodes and reports the worst error at the points halfway
+/// between the nodes (and at the segment ends), which is where the interpolation error peaks.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool TrackingEphemeris::fitSegment(const Sampler &s, double jdStart, double span_s, Segment &seg, double &maxErr)
+{
+    const unsigned n = CHEBYSHEV_ORDER + 1;
+    const double halfSpan_d = 0.5 * span_s / SEC_PER_DAY;
+    std::vector<double> x = ChebyshevSeries::nodes(n);
+    std::vector<double> vals[NUM_EPHEM_CHANNELS];
+    double sample[NUM_EPHEM_CHANNELS];
+
+    for (unsigned k = 0; k < n; k++)
+    {
+        if (!s(jdStart + (x[k] + 1.0) * halfSpan_d, sample))
+            return false;
+        for (unsigned ch = 0; ch < NUM_EPHEM_CHANNELS; ch++)
+        {
+            // Keep azimuth and RA continuous across their wrap points
+            if (k > 0 && CHANNEL_WRAP[ch] != 0.0)
+                sample[ch] -= CHANNEL_WRAP[ch] * std::round((sample[ch] - vals[ch].back()) / CHANNEL_WRAP[ch]);
+            vals[ch].push_back(sample[ch]);
+        }
+    }
+
+    seg.jdStart = jdStart;
+    seg.span_s = span_s;
+    for (unsigned ch = 0; ch < NUM_EPHEM_CHANNELS; ch++)
+        seg.series[ch].fit(vals[ch]);
+
+    maxErr = 0.0;
+    for (unsigned k = 0; k <= n; k++)
+    {
+        double xc = std::cos(M_PI * k / n);
+        if (!s(jdStart + (xc + 1.0) * halfSpan_d, sample))
+            return false;
+        for (unsigned ch = 0; ch < NUM_EPHEM_CHANNELS; ch++)
+        {
+            double err = seg.series[ch].value(xc) - sample[ch];
+            if (CHANNEL_WRAP[ch] != 0.0)
+                err = std::remainder(err, CHANNEL_WRAP[ch]);
+            maxErr = std::max(maxErr, std::fabs(err) * CHANNEL_TO_DEG[ch]);
+        }
+    }
+    return true;
+}
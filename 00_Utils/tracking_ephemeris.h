@@ -0,0 +1,102 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "chebyshev.h"
+
+namespace EPHEMERIS
+{
+    constexpr unsigned CHEBYSHEV_ORDER = 10;
+    constexpr double SEGMENT_SPAN_SEC = 60.0;
+    // Segments are halved down to this length until the fit meets FIT_TOLERANCE_DEG (near zenith
+    // the azimuth changes too quickly for a 60 s segment)
+    constexpr double MIN_SEGMENT_SPAN_SEC = 3.75;
+    constexpr double FIT_TOLERANCE_DEG = 1.0e-6;
+    // The worker keeps at least this much fitted ephemeris ahead of the current time
+    constexpr double REFILL_LEAD_SEC = 30.0;
+    constexpr double WORKER_PERIOD_SEC = 0.5;
+    constexpr double SEC_PER_DAY = 86400.0;
+    constexpr double UNIX_EPOCH_JD = 2440587.5;
+}
+
+typedef enum
+{
+    EPHEM_ALT,
+    EPHEM_AZ,
+    EPHEM_RA,
+    EPHEM_DEC,
+    NUM_EPHEM_CHANNELS
+} EphemerisChannel_t;
+
+// Target position, rate [/s] and acceleration [/s^2]. Angles are in degrees, except RA which is in
+// hours. Azimuth is in [0, 360) and RA in [0, 24).
+struct EphemerisState
+{
+    double position[NUM_EPHEM_CHANNELS];
+    double rate[NUM_EPHEM_CHANNELS];
+    double accel[NUM_EPHEM_CHANNELS];
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Caches the alt/az path of the tracking target as a chain of short Chebyshev segments.
+/// A background worker samples the (expensive) coordinate transform at the Chebyshev nodes and
+/// keeps the chain filled REFILL_LEAD_SEC ahead of the clock; the control tick then only
+/// evaluates a polynomial, and gets rate and acceleration that are exact derivatives of the
+/// position it is commanding.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TrackingEphemeris
+{
+public:
+    // Fills values[0 .. NUM_EPHEM_CHANNELS-1] for the given Julian date. Returns false on failure.
+    typedef std::function<bool(double jd, double *values)> Sampler;
+    typedef std::function<double()> Clock;
+
+    TrackingEphemeris(Clock clk = systemJulianDate);
+    virtual ~TrackingEphemeris();
+
+    void start();
+    void stop();
+    bool isRunning() const { return worker.joinable(); }
+
+    // Drops the cached segments and refits for a new target starting at jdStart
+    void setTarget(const Sampler &s, double jdStart);
+    void clearTarget();
+
+    // Returns false if jd isn't covered yet (the caller should fall back to the direct transform)
+    bool evaluate(double jd, EphemerisState &state) const;
+    // Julian date up to which the ephemeris is fitted (0 when empty)
+    double coveredUntil() const;
+
+    // One pass of the refill work. Called by the worker, or directly when no worker is running.
+    void refill();
+
+    static double systemJulianDate();
+
+private:
+    struct Segment
+    {
+        double jdStart;
+        double span_s;
+        ChebyshevSeries series[NUM_EPHEM_CHANNELS];
+        double jdEnd() const { return jdStart + span_s / EPHEMERIS::SEC_PER_DAY; }
+    };
+
+    Clock clock;
+    Sampler sampler;
+    unsigned generation;
+    double jdFillFrom;
+    std::deque<Segment> segments;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stopRequested;
+    bool refillRequested;
+
+    void workerLoop();
+    static bool fitSegment(const Sampler &s, double jdStart, double span_s, Segment &seg, double &maxErr);
+};
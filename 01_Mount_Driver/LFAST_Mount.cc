@@ -15,10 +15,15 @@
 #include "config.h"
 
 #include <libnova/julian_day.h>
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <exception>
+#include <fstream>
+#include <functional>
 
 #include "../00_Utils/math_util.h"
+#include "../00_Utils/horizontal_kinematics.h"
 #include "slew_drive.h"
 #include "lfast_constants.h"
 
@@ -39,18 +44,18 @@ namespace ALIGNMENT = INDI::AlignmentSubsystem;
             | TELESCOPE_HAS_LOCATION \
             | TELESCOPE_CAN_ABORT   \
             | TELESCOPE_CAN_SYNC    \
+            | TELESCOPE_HAS_TRACK_MODE \
+            | TELESCOPE_HAS_TRACK_RATE \
             )
 /* | TELESCOPE_CAN_CONTROL_TRACK 
    | TELESCOPE_HAS_TIME 
-   | TELESCOPE_HAS_TRACK_MODE
-   | TELESCOPE_HAS_TRACK_RATE
    | TELESCOPE_HAS_PIER_SIDE */
 // clang-format on
 
 /* Preset Slew Speeds */
 const double constexpr default_park_posn_az = 00.0;
 const double constexpr default_park_posn_alt = -10.0;
-const unsigned int defaultPollingPeriod_ms = 20;
+const unsigned int defaultPollingPeriod_ms = SLEWDRIVE::CONTROL_LOOP_PERIOD_MS;
 
 // We declare an auto pointer to LFAST_Mount.
 std::unique_ptr<LFAST_Mount> lfast_mount(new LFAST_Mount());
@@ -66,7 +71,11 @@ const char altLabel[] = "Altitutde";
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
 LFAST_Mount::LFAST_Mount()
-    : TM_LOG(INDI::Logger::getInstance().addDebugLevel("Mount Telemetry", "TELEMETRY"))
+    : TM_LOG(INDI::Logger::getInstance().addDebugLevel("Mount Telemetry", "TELEMETRY")),
+      cableWrap(SLEWDRIVE::AZ_WRAP_DEFAULT_MIN_DEG, SLEWDRIVE::AZ_WRAP_DEFAULT_MAX_DEG),
+      flightRecorder(1.0 / SLEWDRIVE::CONTROL_LOOP_RATE_HZ),
+      loopMonitor(SLEWDRIVE::CONTROL_LOOP_PERIOD_MS / 1000.0),
+      publisher(NUM_PUB_CHANNELS, LFAST_CONSTANTS::PUBLISH_MAX_PER_TICK)
 {
     homingRoutineActive = false;
     // Set up the basic configuration for the mount
@@ -86,6 +95,25 @@ LFAST_Mount::LFAST_Mount()
             LFAST_CONSTANTS::ALTITUDE_MOTOR_A_ID,
             LFAST_CONSTANTS::ALTITUDE_MOTOR_B_ID));
 
+    // The coordinate limits are set by applyPublishLimits()
+    publisher.configure(PUB_EQ, 0, 0, [this]()
+                        { NewRaDec(m_SkyCurrentRADE.rightascension, m_SkyCurrentRADE.declination); });
+    publisher.configure(PUB_AZ_ALT, 0, 0, [this]()
+                        { AzAltCoordsNP.apply(); });
+    publisher.configure(PUB_AZ_WRAP, 0, 0, [this]()
+                        { AzWrapStatusNP.apply(); });
+    publisher.configure(PUB_DISTURBANCE, LFAST_CONSTANTS::PUBLISH_STATS_RATE_HZ, 0, [this]()
+                        { DisturbanceEstimateNP.apply(); });
+    publisher.configure(PUB_TICK_PROFILE, LFAST_CONSTANTS::PUBLISH_STATS_RATE_HZ, 0, [this]()
+                        { publishTickProfile(); });
+    publisher.configure(PUB_LOOP_TIMING, LFAST_CONSTANTS::PUBLISH_STATS_RATE_HZ, 0, [this]()
+                        { publishLoopTiming(); });
+
+    trackingEphemeris = std::unique_ptr<TrackingEphemeris>(new TrackingEphemeris(
+        [this]()
+        { return astroClock.julianDate(); }));
+    refreshAstroTime();
+
     initializeTimers();
 
     // Set the driver interface to indicate that we can also do pulse guiding
@@ -171,10 +199,191 @@ bool LFAST_Mount::initProperties()
 
     TrackState = SCOPE_IDLE;
 
+    // Order has to match INDI's TelescopeTrackMode, then TRACK_PLANET
+    AddTrackMode("TRACK_SIDEREAL", "Sidereal", true);
+    AddTrackMode("TRACK_SOLAR", "Solar");
+    AddTrackMode("TRACK_LUNAR", "Lunar");
+    AddTrackMode("TRACK_CUSTOM", "Custom");
+    AddTrackMode("TRACK_PLANET", "Planet");
+
     TelemetryDownsampleNP[0].fill("TELEMETRY_DOWNSAMPLE_NUM", "Telemetry Downsample", "%d", 1, 100, 1, DEFAULT_TM_TICKS_PER_UPDATE);
     TelemetryDownsampleNP.fill(getDeviceName(), "TELEMETRY_DOWNSAMPLE", "Telemetry Downsample", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
     defineProperty(TelemetryDownsampleNP);
 
+    TelemetryRecordSP[TELEMETRY_RECORD_ON].fill("TELEMETRY_RECORD_ON", "Record", ISS_OFF);
+    TelemetryRecordSP[TELEMETRY_RECORD_OFF].fill("TELEMETRY_RECORD_OFF", "Off", ISS_ON);
+    TelemetryRecordSP.fill(getDeviceName(), "TELEMETRY_RECORD", "Binary Telemetry", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(TelemetryRecordSP);
+
+    TelemetryDirTP[0].fill("TELEMETRY_DIR_PATH", "Directory", LFAST_CONSTANTS::TELEMETRY_DEFAULT_DIR);
+    TelemetryDirTP.fill(getDeviceName(), "TELEMETRY_DIR", "Telemetry Files", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+    defineProperty(TelemetryDirTP);
+
+    BusRecordSP[BUS_RECORD_ON].fill("BUS_RECORD_ON", "Record", ISS_OFF);
+    BusRecordSP[BUS_RECORD_OFF].fill("BUS_RECORD_OFF", "Off", ISS_ON);
+    BusRecordSP.fill(getDeviceName(), "BUS_RECORD", "Drive Bus Log", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(BusRecordSP);
+
+    TelemetryLiveSP[TELEMETRY_LIVE_ON].fill("TELEMETRY_LIVE_ON", "On", ISS_OFF);
+    TelemetryLiveSP[TELEMETRY_LIVE_OFF].fill("TELEMETRY_LIVE_OFF", "Off", ISS_ON);
+    TelemetryLiveSP.fill(getDeviceName(), "TELEMETRY_LIVE", "Live Telemetry", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(TelemetryLiveSP);
+
+    TelemetryLiveNP[0].fill("TELEMETRY_LIVE_SEC", "Feed Length [s]", "%.0f", 1, 600, 10, LFAST_CONSTANTS::TELEMETRY_LIVE_DEFAULT_SEC);
+    TelemetryLiveNP.fill(getDeviceName(), "TELEMETRY_LIVE_LENGTH", "Live Telemetry", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(TelemetryLiveNP);
+
+    PublishLimitsNP[PUBLISH_COORDS_RATE].fill("PUBLISH_COORDS_RATE", "Coords Max Rate [Hz]", "%.1f", 0.1, 50, 1,
+                                              LFAST_CONSTANTS::PUBLISH_COORDS_DEFAULT_RATE_HZ);
+    PublishLimitsNP[PUBLISH_COORDS_DEADBAND].fill("PUBLISH_COORDS_DEADBAND", "Coords Deadband [arcsec]", "%.2f", 0, 60, 0.1,
+                                                  LFAST_CONSTANTS::PUBLISH_COORDS_DEFAULT_DEADBAND_ARCSEC);
+    PublishLimitsNP.fill(getDeviceName(), "PUBLISH_LIMITS", "Client Updates", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(PublishLimitsNP);
+    applyPublishLimits();
+
+    FlightRecorderSP[0].fill("FLIGHT_RECORDER_DUMP", "Dump Now", ISS_OFF);
+    FlightRecorderSP.fill(getDeviceName(), "FLIGHT_RECORDER", "Flight Recorder", OPTIONS_TAB, IP_RW, ISR_ATMOST1, 60, IPS_IDLE);
+    defineProperty(FlightRecorderSP);
+
+    ApparentPlaceNP[APPARENT_PLACE_TEMPERATURE].fill("TEMPERATURE", "Temperature [C]", "%5.1f", -40, 40, 1, APPARENT_PLACE::DEFAULT_TEMPERATURE_C);
+    ApparentPlaceNP[APPARENT_PLACE_PRESSURE].fill("PRESSURE", "Pressure [hPa] (0=no refraction)", "%6.1f", 0, 1100, 1, APPARENT_PLACE::DEFAULT_PRESSURE_HPA);
+    ApparentPlaceNP[APPARENT_PLACE_POLAR_X].fill("POLAR_X", "Polar Motion x [arcsec]", "%6.4f", -1, 1, 0.001, 0);
+    ApparentPlaceNP[APPARENT_PLACE_POLAR_Y].fill("POLAR_Y", "Polar Motion y [arcsec]", "%6.4f", -1, 1, 0.001, 0);
+    ApparentPlaceNP.fill(getDeviceName(), "APPARENT_PLACE", "Apparent Place", SITE_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(ApparentPlaceNP);
+
+    initRateFilterProperty(AltRateFilterNP, "ALT_RATE_FILTER", "Alt Rate Filter");
+    initRateFilterProperty(AzRateFilterNP, "AZ_RATE_FILTER", "Az Rate Filter");
+
+    DisturbanceObserverNP[DOB_BANDWIDTH].fill("DOB_BANDWIDTH", "Bandwidth [Hz] (0=off)", "%5.2f", 0, 500.0 / getCurrentPollingPeriod(), 0.1, SLEWDRIVE::DOB_DEFAULT_BANDWIDTH_HZ);
+    DisturbanceObserverNP[DOB_GAIN].fill("DOB_GAIN", "Compensation Gain", "%4.2f", 0, 1, 0.05, SLEWDRIVE::DOB_DEFAULT_GAIN);
+    DisturbanceObserverNP.fill(getDeviceName(), "DISTURBANCE_OBSERVER", "Disturbance Observer", CONTROL_LOOP_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(DisturbanceObserverNP);
+
+    DisturbanceEstimateNP[DOB_ALT_TORQUE].fill("DOB_ALT_TORQUE", "Alt Load [N*m]", "%8.1f", -1e6, 1e6, 0, 0);
+    DisturbanceEstimateNP[DOB_AZ_TORQUE].fill("DOB_AZ_TORQUE", "Az Load [N*m]", "%8.1f", -1e6, 1e6, 0, 0);
+    DisturbanceEstimateNP[DOB_ALT_COMP_RATE].fill("DOB_ALT_COMP_RATE", "Alt Compensation [arcsec/s]", "%6.3f", -1e6, 1e6, 0, 0);
+    DisturbanceEstimateNP[DOB_AZ_COMP_RATE].fill("DOB_AZ_COMP_RATE", "Az Compensation [arcsec/s]", "%6.3f", -1e6, 1e6, 0, 0);
+    DisturbanceEstimateNP.fill(getDeviceName(), "DISTURBANCE_ESTIMATE", "Disturbance Estimate", CONTROL_LOOP_TAB, IP_RO, 0, IPS_IDLE);
+
+    static const char *tickStatNames[NUM_TICK_PROFILE_STATS] = {"MIN", "MEAN", "P99"};
+    static const char *tickStatLabels[NUM_TICK_PROFILE_STATS] = {"min", "mean", "p99"};
+    for (unsigned p = 0; p < NUM_TICK_PHASES; p++)
+    {
+        for (unsigned k = 0; k < NUM_TICK_PROFILE_STATS; k++)
+        {
+            std::string name = TickProfiler::phaseName((TickPhase_t)p);
+            std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+            name += std::string("_") + tickStatNames[k];
+            std::string label = std::string(TickProfiler::phaseLabel((TickPhase_t)p)) + " " + tickStatLabels[k] + " [ms]";
+            TickProfileNP[p * NUM_TICK_PROFILE_STATS + k].fill(name.c_str(), label.c_str(), "%7.3f", 0, 1e6, 0, 0);
+        }
+    }
+    TickProfileNP.fill(getDeviceName(), "TICK_PROFILE", "Tick Profile", CONTROL_LOOP_TAB, IP_RO, 0, IPS_IDLE);
+
+    LoopTimingNP[LOOP_PERIOD_MEAN].fill("LOOP_PERIOD_MEAN", "Mean Period [ms]", "%7.3f", 0, 1e6, 0, 0);
+    LoopTimingNP[LOOP_PERIOD_MAX].fill("LOOP_PERIOD_MAX", "Max Period [ms]", "%7.3f", 0, 1e6, 0, 0);
+    LoopTimingNP[LOOP_JITTER_RMS].fill("LOOP_JITTER_RMS", "RMS Jitter [ms]", "%7.3f", 0, 1e6, 0, 0);
+    LoopTimingNP[LOOP_OVERRUNS].fill("LOOP_OVERRUNS", "Overruns", "%.0f", 0, 1e12, 0, 0);
+    LoopTimingNP[LOOP_DEGRADED].fill("LOOP_DEGRADED", "Degraded Mode", "%.0f", 0, 1, 0, 0);
+    // Histogram bins are labelled in multiples of the nominal period
+    for (unsigned k = 0; k < LOOP_MONITOR::NUM_BINS; k++)
+    {
+        char name[32], label[32];
+        snprintf(name, sizeof(name), "LOOP_HIST_%u", k);
+        if (k == 0)
+            snprintf(label, sizeof(label), "Period < %.2gx", LOOP_MONITOR::HISTOGRAM_EDGES[0]);
+        else if (k == LOOP_MONITOR::NUM_BINS - 1)
+            snprintf(label, sizeof(label), "Period > %.2gx", LOOP_MONITOR::HISTOGRAM_EDGES[k - 1]);
+        else
+            snprintf(label, sizeof(label), "Period %.2g-%.2gx", LOOP_MONITOR::HISTOGRAM_EDGES[k - 1], LOOP_MONITOR::HISTOGRAM_EDGES[k]);
+        LoopTimingNP[LOOP_HIST_FIRST + k].fill(name, label, "%.0f", 0, 1e12, 0, 0);
+    }
+    LoopTimingNP.fill(getDeviceName(), "LOOP_TIMING", "Loop Timing", CONTROL_LOOP_TAB, IP_RO, 0, IPS_IDLE);
+
+    SatelliteTLETP[SAT_TLE_LINE1].fill("TLE_LINE1", "TLE Line 1", "");
+    SatelliteTLETP[SAT_TLE_LINE2].fill("TLE_LINE2", "TLE Line 2", "");
+    SatelliteTLETP.fill(getDeviceName(), "SAT_TLE_TEXT", "Orbit Params", SATELLITE_TAB, IP_RW, 60, IPS_IDLE);
+    defineProperty(SatelliteTLETP);
+
+    SatelliteTrackSP[SAT_TRACK].fill("SAT_TRACK", "Track", ISS_OFF);
+    SatelliteTrackSP[SAT_HALT].fill("SAT_HALT", "Halt", ISS_ON);
+    SatelliteTrackSP.fill(getDeviceName(), "SAT_TRACKING_STAT", "Sat Tracking", SATELLITE_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    SatellitePassTP[SAT_PASS_AOS].fill("SAT_PASS_AOS", "AOS [UTC]", "");
+    SatellitePassTP[SAT_PASS_LOS].fill("SAT_PASS_LOS", "LOS [UTC]", "");
+    SatellitePassTP[SAT_PASS_MAX_ALT].fill("SAT_PASS_MAX_ALT", "Peak Alt [deg]", "");
+    SatellitePassTP[SAT_PASS_STATUS].fill("SAT_PASS_STATUS", "Status", "Idle");
+    SatellitePassTP.fill(getDeviceName(), "SAT_PASS", "Pass", SATELLITE_TAB, IP_RO, 60, IPS_IDLE);
+
+    KeyholeToleranceNP[0].fill("KEYHOLE_TOLERANCE_ARCSEC", "Tolerance [arcsec]", "%6.1f", 0, 3600,
+                               1, SLEWDRIVE::KEYHOLE_DEFAULT_TOLERANCE_ARCSEC);
+    KeyholeToleranceNP.fill(getDeviceName(), "KEYHOLE_TOLERANCE", "Keyhole", MOTION_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(KeyholeToleranceNP);
+
+    KeyholeTP[KEYHOLE_START].fill("KEYHOLE_START", "Start [UTC]", "");
+    KeyholeTP[KEYHOLE_END].fill("KEYHOLE_END", "End [UTC]", "");
+    KeyholeTP[KEYHOLE_MIN_ZD].fill("KEYHOLE_MIN_ZD", "Min Zenith Dist [deg]", "");
+    KeyholeTP[KEYHOLE_PREDICTION].fill("KEYHOLE_PREDICTION", "Prediction", "None");
+    KeyholeTP.fill(getDeviceName(), "KEYHOLE", "Zenith Keyhole", MOTION_TAB, IP_RO, 60, IPS_IDLE);
+
+    AzWrapSP[AZ_WRAP_ENABLE].fill("AZ_WRAP_ENABLE", "Enable", ISS_OFF);
+    AzWrapSP[AZ_WRAP_DISABLE].fill("AZ_WRAP_DISABLE", "Disable", ISS_ON);
+    AzWrapSP.fill(getDeviceName(), "AZ_CABLE_WRAP_MODE", "Cable Wrap", MOTION_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(AzWrapSP);
+
+    AzWrapNP[AZ_WRAP_MIN].fill("AZ_WRAP_MIN", "Min Az [deg]", "%6.1f", -720, 0, 1, SLEWDRIVE::AZ_WRAP_DEFAULT_MIN_DEG);
+    AzWrapNP[AZ_WRAP_MAX].fill("AZ_WRAP_MAX", "Max Az [deg]", "%6.1f", 0, 720, 1, SLEWDRIVE::AZ_WRAP_DEFAULT_MAX_DEG);
+    AzWrapNP[AZ_WRAP_TRACK_HOURS].fill("AZ_WRAP_TRACK_HOURS", "Track Room [h]", "%4.1f", 0, 12, 0.5,
+                                       SLEWDRIVE::AZ_WRAP_DEFAULT_TRACK_HOURS);
+    AzWrapNP.fill(getDeviceName(), "AZ_CABLE_WRAP", "Cable Wrap", MOTION_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(AzWrapNP);
+
+    AzWrapStatusNP[AZ_WRAP_POSN].fill("AZ_WRAP_POSN", "Unwrapped Az [deg]", "%7.2f", -720, 720, 0, 0);
+    AzWrapStatusNP[AZ_WRAP_ROOM_CW].fill("AZ_WRAP_ROOM_CW", "Room CW [deg]", "%6.1f", 0, 1440, 0, 0);
+    AzWrapStatusNP[AZ_WRAP_ROOM_CCW].fill("AZ_WRAP_ROOM_CCW", "Room CCW [deg]", "%6.1f", 0, 1440, 0, 0);
+    AzWrapStatusNP.fill(getDeviceName(), "AZ_CABLE_WRAP_STATUS", "Cable Wrap", MOTION_TAB, IP_RO, 0, IPS_IDLE);
+
+    PointingModelSP[PM_MODEL_ENABLE].fill("PM_MODEL_ENABLE", "Enable", ISS_OFF);
+    PointingModelSP[PM_MODEL_DISABLE].fill("PM_MODEL_DISABLE", "Disable", ISS_ON);
+    PointingModelSP.fill(getDeviceName(), "POINTING_MODEL", "Pointing Model", POINTING_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(PointingModelSP);
+
+    PointingSyncSP[PM_SYNC_AXES].fill("PM_SYNC_AXES", "Sync Axes", ISS_ON);
+    PointingSyncSP[PM_SYNC_RECORD].fill("PM_SYNC_RECORD", "Record Point", ISS_OFF);
+    PointingSyncSP.fill(getDeviceName(), "POINTING_SYNC_MODE", "Sync Action", POINTING_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(PointingSyncSP);
+
+    PointingActionSP[PM_ACTION_FIT].fill("PM_ACTION_FIT", "Fit Model", ISS_OFF);
+    PointingActionSP[PM_ACTION_CLEAR].fill("PM_ACTION_CLEAR", "Clear Points", ISS_OFF);
+    PointingActionSP.fill(getDeviceName(), "POINTING_ACTION", "Points", POINTING_TAB, IP_RW, ISR_ATMOST1, 60, IPS_IDLE);
+    defineProperty(PointingActionSP);
+
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+    {
+        char label[32];
+        snprintf(label, sizeof(label), "%s [arcsec]", PointingModel::termName(k));
+        PointingTermsNP[k].fill(PointingModel::termName(k), label, "%8.2f", -36000, 36000, 0.01, 0);
+    }
+    PointingTermsNP.fill(getDeviceName(), "POINTING_MODEL_TERMS", "Model Terms", POINTING_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(PointingTermsNP);
+
+    PointingFitNP[PM_FIT_POINTS].fill("PM_FIT_POINTS", "Points", "%4.0f", 0, 1e6, 0, 0);
+    PointingFitNP[PM_FIT_RMS].fill("PM_FIT_RMS", "Fit RMS [arcsec]", "%6.2f", 0, 1e6, 0, 0);
+    PointingFitNP.fill(getDeviceName(), "POINTING_FIT", "Fit", POINTING_TAB, IP_RO, 0, IPS_IDLE);
+
+    PointingFileTP[0].fill("PM_FILE_PATH", "Append Points To", "");
+    PointingFileTP.fill(getDeviceName(), "POINTING_FILE", "Point Log", POINTING_TAB, IP_RW, 60, IPS_IDLE);
+    defineProperty(PointingFileTP);
+
+    SkyGridSP[SKY_GRID_ENABLE].fill("SKY_GRID_ENABLE", "Enable", ISS_OFF);
+    SkyGridSP[SKY_GRID_DISABLE].fill("SKY_GRID_DISABLE", "Disable", ISS_ON);
+    SkyGridSP.fill(getDeviceName(), "SKY_GRID", "Sky Grid", POINTING_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(SkyGridSP);
+
+    SkyGridTP[0].fill("SKY_GRID_PATH", "Grid File", "");
+    SkyGridTP.fill(getDeviceName(), "SKY_GRID_FILE", "Sky Grid", POINTING_TAB, IP_RW, 60, IPS_IDLE);
+    defineProperty(SkyGridTP);
 
     // Set up parking info
     SetParkDataType(PARK_AZ_ALT);
@@ -188,9 +397,10 @@ bool LFAST_Mount::initProperties()
         LOG_INFO("Parking data found.");
         m_MountAltAz.altitude = ParkPositionN[AXIS_ALT].value;
         m_MountAltAz.azimuth = ParkPositionN[AXIS_AZ].value;
-        INDI::IEquatorialCoordinates EquatorialCoordinates{0, 0};
-        INDI::HorizontalToEquatorial(&m_MountAltAz, &m_Location, ln_get_julian_from_sys(), &EquatorialCoordinates);
-        Sync(EquatorialCoordinates.rightascension, EquatorialCoordinates.declination);
+        double parkRA, parkDec;
+        apparentPlace.observedToOfDate(refreshAstroTime().jd, m_MountAltAz.altitude, m_MountAltAz.azimuth,
+                                       &parkRA, &parkDec);
+        Sync(parkRA, parkDec);
     }
     else
     {
@@ -262,6 +472,10 @@ bool LFAST_Mount::initProperties()
     ModbusCommPortTP.fill(getDeviceName(), "MODBUS_COMM_DEV", "Modbus", CONNECTION_TAB, IP_RW, 60, IPS_IDLE);
     defineProperty(ModbusCommPortTP);
 
+    BusReplayTP[0].fill("BUS_REPLAY_PATH", "Bus Log", "");
+    BusReplayTP.fill(getDeviceName(), "BUS_REPLAY", "Replay", CONNECTION_TAB, IP_RW, 60, IPS_IDLE);
+    defineProperty(BusReplayTP);
+
     AzAltCoordsNP[AXIS_AZ].fill("AZ_COORDINATE", "Az Posn [deg]", "%6.4f", 0, 360, 0.001, m_MountAltAz.azimuth);
     AzAltCoordsNP[AXIS_ALT].fill("ALT_COORDINATE", "Alt Posn [deg]", "%6.4f", -90, 90, 0.001, m_MountAltAz.altitude);
     AzAltCoordsNP[AXIS_AZ_VEL].fill("AZ_VEL_COORDINATE", "Az Rate [deg/s]", "%6.4f", 0, 10000, 0.0001, 0);
@@ -302,12 +516,217 @@ bool LFAST_Mount::initProperties()
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::initRateFilterProperty(INDI::PropertyNumber &filterNP, const char *propName, const char *propLabel)
+{
+    double nyquist_Hz = 500.0 / getCurrentPollingPeriod();
+    filterNP[RATE_FILTER_NOTCH1_FREQ].fill("NOTCH1_FREQ", "Notch 1 Freq [Hz]", "%5.2f", 0, nyquist_Hz, 0.1, 0);
+    filterNP[RATE_FILTER_NOTCH1_DEPTH].fill("NOTCH1_DEPTH", "Notch 1 Depth [dB]", "%5.1f", 0, DIGITAL_CONTROL::NOTCH_MAX_DEPTH_DB, 1, SLEWDRIVE::RATE_NOTCH_DEFAULT_DEPTH_DB);
+    filterNP[RATE_FILTER_NOTCH1_WIDTH].fill("NOTCH1_WIDTH", "Notch 1 Width [Hz]", "%5.2f", 0.01, nyquist_Hz, 0.1, SLEWDRIVE::RATE_NOTCH_DEFAULT_WIDTH_HZ);
+    filterNP[RATE_FILTER_NOTCH2_FREQ].fill("NOTCH2_FREQ", "Notch 2 Freq [Hz]", "%5.2f", 0, nyquist_Hz, 0.1, 0);
+    filterNP[RATE_FILTER_NOTCH2_DEPTH].fill("NOTCH2_DEPTH", "Notch 2 Depth [dB]", "%5.1f", 0, DIGITAL_CONTROL::NOTCH_MAX_DEPTH_DB, 1, SLEWDRIVE::RATE_NOTCH_DEFAULT_DEPTH_DB);
+    filterNP[RATE_FILTER_NOTCH2_WIDTH].fill("NOTCH2_WIDTH", "Notch 2 Width [Hz]", "%5.2f", 0.01, nyquist_Hz, 0.1, SLEWDRIVE::RATE_NOTCH_DEFAULT_WIDTH_HZ);
+    filterNP[RATE_FILTER_LPF_FREQ].fill("LPF_FREQ", "Low-pass Freq [Hz]", "%5.2f", 0, nyquist_Hz, 0.1, 0);
+    filterNP.fill(getDeviceName(), propName, propLabel, CONTROL_LOOP_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(filterNP);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Caps the filter frequencies at a new Nyquist frequency. Stages tuned at or above it are turned
+/// off, since they can't be designed at the new rate.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::limitRateFilterProperty(INDI::PropertyNumber &filterNP, double nyquist_Hz)
+{
+    const int freqFields[] = {RATE_FILTER_NOTCH1_FREQ, RATE_FILTER_NOTCH2_FREQ, RATE_FILTER_LPF_FREQ};
+    for (int field : freqFields)
+    {
+        filterNP[field].setMax(nyquist_Hz);
+        if (filterNP[field].getValue() >= nyquist_Hz)
+        {
+            LOGF_WARN("%s %s is above the %.2f Hz Nyquist frequency, turning it off.",
+                      filterNP.getName(), filterNP[field].getName(), nyquist_Hz);
+            filterNP[field].setValue(0);
+        }
+    }
+    const int widthFields[] = {RATE_FILTER_NOTCH1_WIDTH, RATE_FILTER_NOTCH2_WIDTH};
+    for (int field : widthFields)
+    {
+        filterNP[field].setMax(nyquist_Hz);
+        if (filterNP[field].getValue() > nyquist_Hz)
+            filterNP[field].setValue(nyquist_Hz);
+    }
+    filterNP.updateMinMax();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Redesigns the rate filters and the disturbance observer for a new tick rate, e.g. after the
+/// client changed the polling period.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::applyControlRate(double rate_Hz)
+{
+    const double nyquist_Hz = 0.5 * rate_Hz;
+    AltitudeAxis->setControlRate(rate_Hz);
+    AzimuthAxis->setControlRate(rate_Hz);
+
+    limitRateFilterProperty(AltRateFilterNP, nyquist_Hz);
+    AltRateFilterNP.setState(applyRateFilterSettings(AltitudeAxis.get(), AltRateFilterNP) ? IPS_OK : IPS_ALERT);
+    AltRateFilterNP.apply();
+    limitRateFilterProperty(AzRateFilterNP, nyquist_Hz);
+    AzRateFilterNP.setState(applyRateFilterSettings(AzimuthAxis.get(), AzRateFilterNP) ? IPS_OK : IPS_ALERT);
+    AzRateFilterNP.apply();
+
+    DisturbanceObserverNP[DOB_BANDWIDTH].setMax(nyquist_Hz);
+    if (DisturbanceObserverNP[DOB_BANDWIDTH].getValue() >= nyquist_Hz)
+    {
+        LOGF_WARN("%s %s is above the %.2f Hz Nyquist frequency, turning it off.",
+                  DisturbanceObserverNP.getName(), DisturbanceObserverNP[DOB_BANDWIDTH].getName(), nyquist_Hz);
+        DisturbanceObserverNP[DOB_BANDWIDTH].setValue(0);
+    }
+    DisturbanceObserverNP.updateMinMax();
+    DisturbanceObserverNP.setState(applyDisturbanceObserverSettings() ? IPS_OK : IPS_ALERT);
+    DisturbanceObserverNP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Recompute the rate command filter coefficients. Safe to call while tracking.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::applyRateFilterSettings(SlewDrive *axis, INDI::PropertyNumber &filterNP)
+{
+    try
+    {
+        axis->configureRateNotch(RATE_NOTCH_1,
+                                 filterNP[RATE_FILTER_NOTCH1_FREQ].getValue(),
+                                 filterNP[RATE_FILTER_NOTCH1_DEPTH].getValue(),
+                                 filterNP[RATE_FILTER_NOTCH1_WIDTH].getValue());
+        axis->configureRateNotch(RATE_NOTCH_2,
+                                 filterNP[RATE_FILTER_NOTCH2_FREQ].getValue(),
+                                 filterNP[RATE_FILTER_NOTCH2_DEPTH].getValue(),
+                                 filterNP[RATE_FILTER_NOTCH2_WIDTH].getValue());
+        axis->configureRateLowPass(filterNP[RATE_FILTER_LPF_FREQ].getValue());
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Rate Filter Error: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// The same observer tuning is used on both axes.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::applyDisturbanceObserverSettings()
+{
+    try
+    {
+        double bandwidth_Hz = DisturbanceObserverNP[DOB_BANDWIDTH].getValue();
+        double gain = DisturbanceObserverNP[DOB_GAIN].getValue();
+        AltitudeAxis->configureDisturbanceObserver(bandwidth_Hz, gain);
+        AzimuthAxis->configureDisturbanceObserver(bandwidth_Hz, gain);
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Disturbance Observer Error: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Rolling per-phase times from the tick profiler, in ms
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::publishTickProfile()
+{
+    for (unsigned p = 0; p < NUM_TICK_PHASES; p++)
+    {
+        TickPhaseStats stats = tickProfiler().getStats((TickPhase_t)p);
+        TickProfileNP[p * NUM_TICK_PROFILE_STATS + TICK_PROFILE_MIN].setValue(stats.min * 1e3);
+        TickProfileNP[p * NUM_TICK_PROFILE_STATS + TICK_PROFILE_MEAN].setValue(stats.mean * 1e3);
+        TickProfileNP[p * NUM_TICK_PROFILE_STATS + TICK_PROFILE_P99].setValue(stats.p99 * 1e3);
+    }
+    TickProfileNP.setState(IPS_OK);
+    TickProfileNP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Tick period statistics, in ms, and histogram counts
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::publishLoopTiming()
+{
+    LoopPeriodStats stats = loopMonitor.getStats();
+    LoopTimingNP[LOOP_PERIOD_MEAN].setValue(stats.mean_s * 1e3);
+    LoopTimingNP[LOOP_PERIOD_MAX].setValue(stats.max_s * 1e3);
+    LoopTimingNP[LOOP_JITTER_RMS].setValue(stats.jitterRms_s * 1e3);
+    LoopTimingNP[LOOP_OVERRUNS].setValue(stats.overruns);
+    LoopTimingNP[LOOP_DEGRADED].setValue(loopMonitor.isDegraded() ? 1 : 0);
+    const uint64_t *hist = loopMonitor.getHistogram();
+    for (unsigned k = 0; k < LOOP_MONITOR::NUM_BINS; k++)
+        LoopTimingNP[LOOP_HIST_FIRST + k].setValue(hist[k]);
+    LoopTimingNP.setState(loopMonitor.isDegraded() ? IPS_ALERT : IPS_OK);
+    LoopTimingNP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// The pointing coordinates are compared in degrees (RA too), so the deadband is an angle on the
+/// sky in declination and in hour angle.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::applyPublishLimits()
+{
+    const double rate_hz = PublishLimitsNP[PUBLISH_COORDS_RATE].getValue();
+    const double deadband_deg = PublishLimitsNP[PUBLISH_COORDS_DEADBAND].getValue() / 3600.0;
+    publisher.setLimits(PUB_EQ, rate_hz, deadband_deg);
+    publisher.setLimits(PUB_AZ_ALT, rate_hz, deadband_deg);
+    publisher.setLimits(PUB_AZ_WRAP, rate_hz, deadband_deg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Enters or leaves degraded mode. While degraded the mount coordinates are only transformed and
+/// published every DEGRADED_STATUS_DIVISOR ticks (the axis feedback and control loops still run
+/// every tick) and slews are capped, to give the loop its time back.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::applyLoopMode(LoopModeChange_t change)
+{
+    const double period_ms = loopMonitor.getNominalPeriod() * 1e3;
+    if (change == LOOP_MODE_DEGRADED)
+    {
+        LOGF_WARN("Control loop overrunning: %u of the last %u ticks over %.0f ms (longest %.1f ms). "
+                  "Entering degraded mode: status every %u ticks, property updates suppressed, slews capped at %.0fx sidereal.",
+                  loopMonitor.getRecentOverruns(), LOOP_MONITOR::WINDOW_TICKS, LOOP_MONITOR::OVERRUN_FACTOR * period_ms,
+                  loopMonitor.getStats().max_s * 1e3, SLEWDRIVE::DEGRADED_STATUS_DIVISOR, SLEWDRIVE::DEGRADED_MAX_SLEW_MULT);
+        triggerFlightRecorder("Control loop overruns");
+    }
+    else if (change == LOOP_MODE_RECOVERED)
+    {
+        LOGF_INFO("Control loop back on time for %.0f s. Leaving degraded mode.", LOOP_MONITOR::RECOVER_SEC);
+    }
+    degradedTickCount = 0;
+    SetSlewRate(IUFindOnSwitchIndex(&SlewRateSP));
+    publishLoopTiming();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::updateDisturbanceEstimate()
+{
+    DisturbanceEstimateNP[DOB_ALT_TORQUE].setValue(AltitudeAxis->getDisturbanceEstimate());
+    DisturbanceEstimateNP[DOB_AZ_TORQUE].setValue(AzimuthAxis->getDisturbanceEstimate());
+    DisturbanceEstimateNP[DOB_ALT_COMP_RATE].setValue(AltitudeAxis->getDisturbanceCompensation() * 3600.0);
+    DisturbanceEstimateNP[DOB_AZ_COMP_RATE].setValue(AzimuthAxis->getDisturbanceCompensation() * 3600.0);
+    DisturbanceEstimateNP.setState(IPS_OK);
+    publisher.request(PUB_DISTURBANCE);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
 bool LFAST_Mount::updateProperties()
 {
     INDI::Telescope::updateProperties();
+    // Everything goes out afresh on its next update
+    publisher.reset();
 
     if (isConnected())
     {
@@ -317,6 +736,15 @@ bool LFAST_Mount::updateProperties()
         // defineProperty(&TrackStateSP);
         defineProperty(HomeSP);
         defineProperty(AzAltCoordsNP);
+        defineProperty(DisturbanceEstimateNP);
+        if (TICK_PROFILER::ENABLED)
+            defineProperty(TickProfileNP);
+        defineProperty(LoopTimingNP);
+        defineProperty(SatelliteTrackSP);
+        defineProperty(SatellitePassTP);
+        defineProperty(KeyholeTP);
+        defineProperty(AzWrapStatusNP);
+        defineProperty(PointingFitNP);
 
         defineProperty(&AbortSP);
 
@@ -336,6 +764,15 @@ bool LFAST_Mount::updateProperties()
         // deleteProperty(TrackStateSP.getName());
         deleteProperty(HomeSP.getName());
         deleteProperty(AzAltCoordsNP.getName());
+        deleteProperty(DisturbanceEstimateNP.getName());
+        if (TICK_PROFILER::ENABLED)
+            deleteProperty(TickProfileNP.getName());
+        deleteProperty(LoopTimingNP.getName());
+        deleteProperty(SatelliteTrackSP.getName());
+        deleteProperty(SatellitePassTP.getName());
+        deleteProperty(KeyholeTP.getName());
+        deleteProperty(AzWrapStatusNP.getName());
+        deleteProperty(PointingFitNP.getName());
     }
     return true;
 }
@@ -347,6 +784,9 @@ bool LFAST_Mount::Connect()
 {
     LOG_INFO("Connect()");
     SetTimer(getCurrentPollingPeriod());
+    // The first tick starts the interval timing afresh
+    tickStart_s = 0;
+    trackingEphemeris->start();
 
     if (isSimulation())
     {
@@ -357,6 +797,9 @@ bool LFAST_Mount::Connect()
         LOG_INFO("Fake connection established.");
         return true;
     }
+    // There's no port to open for a replay
+    if (isBusReplay())
+        return Handshake();
     return INDI::Telescope::Connect();
     // return true;
 }
@@ -367,6 +810,7 @@ bool LFAST_Mount::Connect()
 bool LFAST_Mount::Disconnect()
 {
     LOG_INFO("Disconnect()");
+    trackingEphemeris->stop();
     return INDI::Telescope::Disconnect();
     // return true;
 }
@@ -377,10 +821,21 @@ bool LFAST_Mount::Handshake()
     // LOG_WARN("Handshake not implemented yet.");
 
     auto devPath = ModbusCommPortTP[0].getText();
-    LOGF_INFO("Connecting to modbus comm port: %s...", devPath);
     try
     {
-        SlewDrive::initializeDriverBus(devPath);
+        if (isBusReplay())
+        {
+            LOGF_INFO("Replaying drive traffic from %s...", BusReplayTP[0].getText());
+            SlewDrive::initializeDriverReplay(BusReplayTP[0].getText());
+        }
+        else
+        {
+            LOGF_INFO("Connecting to modbus comm port: %s...", devPath);
+            SlewDrive::initializeDriverBus(devPath);
+            // Record from the handshake on, so a replay starts from the same drive state
+            if (BusRecordSP.findOnSwitchIndex() == BUS_RECORD_ON)
+                startBusRecording();
+        }
         AltitudeAxis->connectToDrivers();
         AzimuthAxis->connectToDrivers();
         // Zeros the encoders (probably will need to remove this!!)
@@ -406,6 +861,9 @@ bool LFAST_Mount::Goto(double ra, double dec)
     bool success = true;
 
     LOGF_TM("Goto: [RA: %.6f], [DEC: %.6f]", ra, dec);
+    refreshAstroTime();
+    if (satTrackPhase != SAT_TRACK_OFF)
+        stopSatelliteTracking("Halted (goto)");
 
     updateTrackingTarget(ra, dec);
 
@@ -413,8 +871,9 @@ bool LFAST_Mount::Goto(double ra, double dec)
     try
     {
         altAzTgtPosn = getTrackingTargetAltAzPosition();
+        applyPointingModel(altAzTgtPosn, nullptr);
         AltitudeAxis->updateTrackCommands(altAzTgtPosn.altitude);
-        AzimuthAxis->updateTrackCommands(altAzTgtPosn.azimuth);
+        AzimuthAxis->updateTrackCommands(planAzimuthGoto(altAzTgtPosn));
     }
     catch(const std::exception& e)
     {
@@ -463,30 +922,377 @@ void LFAST_Mount::updateTrackingTarget(double ra, double dec)
         fs_sexa(DecStr, dec, 2, 3600);
         m_SkyTrackingTarget.rightascension = ra;
         m_SkyTrackingTarget.declination = dec;
+        restartTrackingEphemeris(m_Location);
     }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Refits the tracking ephemeris for the current target. The sampler only uses copies of the
+/// target and site, since it runs on the ephemeris worker thread.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::restartTrackingEphemeris(const INDI::IGeographicCoordinates &location)
+{
+    double jd0 = astroClock.now().jd;
+    m_TrackTarget = makeTrackTarget(jd0);
+    m_TrackTargetRADec = m_TrackTarget.equatorialAt(jd0, location);
+
+    const TrackTarget target = m_TrackTarget;
+    const INDI::IGeographicCoordinates site = location;
+    ApparentPlace place = apparentPlace;
+    place.setSite(site.latitude, site.longitude);
+    trackingSampler = [target, site, place](double jd, double *values) mutable
+    {
+        INDI::IEquatorialCoordinates eq = target.equatorialAt(jd, site);
+        double alt, az;
+        place.ofDateToObserved(jd, eq.rightascension, eq.declination, &alt, &az);
+        values[EPHEM_ALT] = alt;
+        values[EPHEM_AZ] = az;
+        values[EPHEM_RA] = eq.rightascension;
+        values[EPHEM_DEC] = eq.declination;
+        return !(std::isnan(alt) || std::isnan(az));
+    };
+    trackingEphemeris->setTarget(trackingSampler, jd0);
+
+    // The keyhole plan belongs to the old target; plan again on the next tick
+    keyholeGeneration++;
+    keyholePlan = KeyholePlan();
+    keyholeReplanJd = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Builds the target's sky path for the current track mode, anchored at the goto position.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TrackTarget LFAST_Mount::makeTrackTarget(double jd0)
+{
+    switch (m_TrackMode)
+    {
+    case TRACK_SOLAR:
+        return TrackTarget::body(TRACK_BODY_SUN, m_SkyTrackingTarget, jd0);
+    case TRACK_LUNAR:
+        return TrackTarget::body(TRACK_BODY_MOON, m_SkyTrackingTarget, jd0);
+    case TRACK_CUSTOM:
+        return TrackTarget::customRate(m_SkyTrackingTarget, jd0, m_CustomRaRate_arcsecps, m_CustomDecRate_arcsecps);
+    case TRACK_PLANET:
+    {
+        double sep_deg = 0.0;
+        TrackBody_t planet = TrackTarget::nearestPlanet(m_SkyTrackingTarget, jd0, &sep_deg);
+        if (sep_deg <= LFAST_CONSTANTS::PLANET_MATCH_RADIUS_DEG)
+        {
+            LOGF_INFO("Tracking %s (%.3f deg from the goto position).", TrackTarget::bodyName(planet), sep_deg);
+            return TrackTarget::body(planet, m_SkyTrackingTarget, jd0);
+        }
+        LOGF_WARN("No planet within %.1f deg of the target (%s is %.1f deg away). Tracking at the sidereal rate.",
+                  LFAST_CONSTANTS::PLANET_MATCH_RADIUS_DEG, TrackTarget::bodyName(planet), sep_deg);
+        return TrackTarget::sidereal(m_SkyTrackingTarget);
+    }
+    default:
+        return TrackTarget::sidereal(m_SkyTrackingTarget);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Re-anchors the tracking target at wherever it is now, so a mode or rate change takes over
+/// smoothly from the current position instead of jumping back to the original goto position.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::retargetCurrentPosition()
+{
+    m_SkyTrackingTarget = m_TrackTarget.geocentricAt(astroClock.now().jd);
+    restartTrackingEphemeris(m_Location);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Current (topocentric) RA/Dec of the tracking target. Comes from the ephemeris, so
+/// non-sidereal targets don't need libnova in the control tick. Until the worker has filled the
+/// first segment, the target is held where it was when tracking started (a few ticks at most).
+//////////////////////////////////////////////////////////////////////////////////////////////////
+INDI::IEquatorialCoordinates LFAST_Mount::getTrackingTargetRADec()
+{
+    EphemerisState ephem;
+    if (trackingEphemeris->evaluate(astroClock.now().jd, ephem))
+    {
+        m_TrackTargetRADec.rightascension = ephem.position[EPHEM_RA];
+        m_TrackTargetRADec.declination = ephem.position[EPHEM_DEC];
+    }
+    return m_TrackTargetRADec;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::SetTrackMode(uint8_t mode)
+{
+    if (mode > TRACK_PLANET)
+        return false;
+    LOGF_TM("SetTrackMode: %d", mode);
+    refreshAstroTime();
+    m_TrackMode = mode;
+    if (TrackState == SCOPE_TRACKING || TrackState == SCOPE_SLEWING)
+        retargetCurrentPosition();
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::SetTrackRate(double raRate, double deRate)
+{
+    LOGF_TM("SetTrackRate: [RA: %.4f arcsec/s], [DEC: %.4f arcsec/s]", raRate, deRate);
+    refreshAstroTime();
+    m_CustomRaRate_arcsecps = raRate;
+    m_CustomDecRate_arcsecps = deRate;
+    if (m_TrackMode == TRACK_CUSTOM && (TrackState == SCOPE_TRACKING || TrackState == SCOPE_SLEWING))
+        retargetCurrentPosition();
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Builds the time context for the current tick (or INDI request) at the site longitude.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+const AstroTimeContext &LFAST_Mount::refreshAstroTime()
+{
+    return astroClock.update(m_Location.longitude);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Takes the refraction weather and polar motion from the property. A running ephemeris is
+/// refitted, since its sampler has its own copy of the apparent place settings.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::applyApparentPlaceSettings()
+{
+    ObservingConditions conditions{ApparentPlaceNP[APPARENT_PLACE_TEMPERATURE].getValue(),
+                                   ApparentPlaceNP[APPARENT_PLACE_PRESSURE].getValue(),
+                                   ApparentPlaceNP[APPARENT_PLACE_POLAR_X].getValue(),
+                                   ApparentPlaceNP[APPARENT_PLACE_POLAR_Y].getValue()};
+    apparentPlace.setConditions(conditions);
+    LOGF_INFO("Apparent place: %.1f C, %.1f hPa, polar motion (%.4f, %.4f) arcsec.", conditions.temperature_C,
+              conditions.pressure_hPa, conditions.polarMotionX_arcsec, conditions.polarMotionY_arcsec);
+    if (TrackState == SCOPE_TRACKING || TrackState == SCOPE_SLEWING)
+    {
+        refreshAstroTime();
+        restartTrackingEphemeris(m_Location);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Sky alt/az (and rate) commands to encoder commands. The rate goes through the model's
+/// Jacobian at the sky position, so it has to be converted before the position.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::applyPointingModel(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates *rate)
+{
+    if (!pointingModelEnabled)
+        return;
+
+    SkyGridSample grid{0, 0, 0, 0, 0, 0};
+    if (skyGridEnabled && skyGrid)
+        skyGrid->evaluate(posn.altitude, posn.azimuth, grid);
+
+    if (rate != nullptr)
+    {
+        double altRate = rate->altitude, azRate = rate->azimuth;
+        pointingModel.skyRateToMount(posn.altitude, posn.azimuth, altRate, azRate, &rate->altitude, &rate->azimuth);
+        rate->altitude += (grid.dAlt_dAlt * altRate + grid.dAlt_dAz * azRate) / 3600.0;
+        rate->azimuth += (grid.dAz_dAlt * altRate + grid.dAz_dAz * azRate) / 3600.0;
+    }
+    pointingModel.skyToMount(posn.altitude, posn.azimuth, &posn.altitude, &posn.azimuth);
+    posn.altitude += grid.dAlt / 3600.0;
+    posn.azimuth += grid.dAz / 3600.0;
+    if (posn.azimuth < 0.0)
+        posn.azimuth += 360.0;
+    else if (posn.azimuth >= 360.0)
+        posn.azimuth -= 360.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Encoder position to sky alt/az: the inverse of applyPointingModel().
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::removePointingModel(const INDI::IHorizontalCoordinates &mount, INDI::IHorizontalCoordinates &sky)
+{
+    pointingModel.mountToSky(mount.altitude, mount.azimuth, &sky.altitude, &sky.azimuth);
+    if (!skyGridEnabled || !skyGrid)
+        return;
+    for (unsigned k = 0; k < SKY_GRID::INVERSE_ITERATIONS; k++)
+    {
+        SkyGridSample grid;
+        skyGrid->evaluate(sky.altitude, sky.azimuth, grid);
+        pointingModel.mountToSky(mount.altitude - grid.dAlt / 3600.0, mount.azimuth - grid.dAz / 3600.0,
+                                 &sky.altitude, &sky.azimuth);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Maps and checks the grid named in SKY_GRID_FILE on a worker thread. The grid in use stays in
+/// use until serviceSkyGridLoad() swaps the new one in; an empty path unloads it.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::startSkyGridLoad()
+{
+    if (skyGridLoad.valid() ||
+        (skyGridRelease.valid() && skyGridRelease.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+    {
+        LOG_WARN("A sky grid is still loading; try again when it's done.");
+        return false;
+    }
+
+    std::string path = SkyGridTP[0].getText() ? SkyGridTP[0].getText() : "";
+    if (path.empty())
+    {
+        if (skyGrid)
+            LOG_INFO("Sky grid unloaded.");
+        releaseSkyGrid();
+        SkyGridTP.setState(IPS_IDLE);
+        return true;
+    }
+
+    skyGridLoad = std::async(std::launch::async,
+                             [path]()
+                             {
+                                 return std::unique_ptr<SkyGrid>(new SkyGrid(path));
+                             });
+    SkyGridTP.setState(IPS_BUSY);
+    return true;
+}
+
+void LFAST_Mount::serviceSkyGridLoad()
+{
+    if (!skyGridLoad.valid() || skyGridLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    try
+    {
+        std::unique_ptr<SkyGrid> loaded = skyGridLoad.get();
+        releaseSkyGrid();
+        skyGrid = std::move(loaded);
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Sky grid not loaded: %s", e.what());
+        SkyGridTP.setState(IPS_ALERT);
+        SkyGridTP.apply();
+        return;
+    }
+
+    LOGF_INFO("Sky grid %s loaded: %u x %u nodes, %.0f to %.0f deg altitude, up to %.1f arcsec.",
+              skyGrid->getPath().c_str(), skyGrid->numAlt(), skyGrid->numAz(), skyGrid->altMin(),
+              skyGrid->altMax(), skyGrid->maxCorrection());
+    if (skyGridEnabled && !pointingModelEnabled)
+        LOG_WARN("The sky grid only applies while the pointing model is enabled.");
+    SkyGridTP.setState(IPS_OK);
+    SkyGridTP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Drops the current grid. Unmapping and closing it is left to a worker so it doesn't hold up
+/// the tick. startSkyGridLoad() turns requests away until the last release is done, so
+/// replacing skyGridRelease here never waits on one.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::releaseSkyGrid()
+{
+    if (!skyGrid)
+        return;
+    skyGridRelease = std::async(std::launch::async, [old = std::move(skyGrid)]() mutable { old.reset(); });
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Keeps a sync as a pointing observation instead of moving the encoder zero. The point is also
+/// appended to the point log, if one is set, for pointing_fit.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::recordPointingObservation(const PointingObservation &obs)
+{
+    if (isParked())
+    {
+        LOG_WARN("Pointing points can't be recorded while parked.");
+        return false;
+    }
+    pointingObservations.push_back(obs);
+    LOGF_INFO("Pointing point %u: sky [ALT: %.4f, AZ: %.4f], mount [ALT: %.4f, AZ: %.4f]",
+              (unsigned)pointingObservations.size(), obs.skyAlt, obs.skyAz, obs.mountAlt, obs.mountAz);
+
+    const char *path = PointingFileTP[0].getText();
+    if (path != nullptr && path[0] != '\0')
+    {
+        std::ofstream log(path, std::ios::app);
+        if (log)
+            log << PointingFitter::formatObservation(obs) << std::endl;
+        else
+            LOGF_WARN("Can't append to the pointing log %s.", path);
+    }
+
+    PointingFitNP[PM_FIT_POINTS].setValue(pointingObservations.size());
+    PointingFitNP.apply();
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fits the recorded points. Small sets only get the basic geometric terms.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::fitPointingModel()
+{
+    unsigned numPoints = pointingObservations.size();
+    if (numPoints < LFAST_CONSTANTS::POINTING_BASIC_MIN_POINTS)
+    {
+        LOGF_ERROR("Pointing fit needs at least %u points (have %u).", LFAST_CONSTANTS::POINTING_BASIC_MIN_POINTS, numPoints);
+        return false;
+    }
+
+    PointingFitter fitter;
+    for (const PointingObservation &obs : pointingObservations)
+        fitter.add(obs);
+    unsigned mask = numPoints < LFAST_CONSTANTS::POINTING_FULL_MIN_POINTS ? PM_BASIC_TERMS : PM_ALL_TERMS;
+    PointingModel fitted;
+    PointingFitResult result = fitter.solve(mask, fitted);
+    if (!result.ok)
+    {
+        LOGF_ERROR("Pointing fit failed: %s", result.error.c_str());
+        return false;
+    }
+
+    pointingModel = fitted;
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+    {
+        PointingTermsNP[k].setValue(pointingModel.getCoefficient(k));
+        if (mask & PM_TERM_BIT(k))
+            LOGF_INFO("  %-4s %9.2f +/- %.2f arcsec", PointingModel::termName(k), pointingModel.getCoefficient(k),
+                      result.sigma_arcsec[k]);
+    }
+    PointingTermsNP.setState(IPS_OK);
+    PointingTermsNP.apply();
+    PointingFitNP[PM_FIT_RMS].setValue(result.rms_arcsec);
+    PointingFitNP.setState(IPS_OK);
+    PointingFitNP.apply();
+    LOGF_INFO("Pointing model fitted to %u points, RMS %.2f arcsec.", numPoints, result.rms_arcsec);
+    return true;
+}
+
+void LFAST_Mount::clearPointingObservations()
+{
+    pointingObservations.clear();
+    PointingFitNP[PM_FIT_POINTS].setValue(0);
+    PointingFitNP[PM_FIT_RMS].setValue(0);
+    PointingFitNP.setState(IPS_IDLE);
+    PointingFitNP.apply();
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
 INDI::IHorizontalCoordinates LFAST_Mount::getTrackingTargetAltAzPosition()
 {
-    if (TraceThisTick)
+    if (TraceThisTick && !telemetryWriter)
         LOGF_TM("getTrackingTargetAltAzPosition: [Target RA: %.6f], [Target DEC: %.6f]", m_SkyTrackingTarget.rightascension, m_SkyTrackingTarget.declination);
 
     if (guideManeuverActive)
     {
-        if (TraceThisTick)
+        if (TraceThisTick && !telemetryWriter)
             LOGF_TM("getTrackingTargetAltAzPosition: [Guide dRA: %.6f], [Guide dDEC: %.6f]", m_SkyGuideOffset.rightascension, m_SkyGuideOffset.declination);
         m_SkyGuideOffset.rightascension += m_EqSkyGuideDelta.rightascension;
         m_SkyGuideOffset.declination += m_EqSkyGuideDelta.declination;
     }
-    double ra = m_SkyTrackingTarget.rightascension + m_SkyGuideOffset.rightascension;
-    double dec = m_SkyTrackingTarget.declination + m_SkyGuideOffset.declination;
+    INDI::IEquatorialCoordinates target = getTrackingTargetRADec();
+    double ra = target.rightascension + m_SkyGuideOffset.rightascension;
+    double dec = target.declination + m_SkyGuideOffset.declination;
     ALIGNMENT::TelescopeDirectionVector TDVCommand;
 
     INDI::IHorizontalCoordinates horizCoords{0, 0};
-    if (TransformCelestialToTelescope(ra, dec, 0.0, TDVCommand))
+    if (!pointingModelEnabled && TransformCelestialToTelescope(ra, dec, 0.0, TDVCommand))
     {
         // The alignment subsystem has successfully transformed my coordinate
         AltitudeAzimuthFromTelescopeDirectionVector(TDVCommand, horizCoords);
@@ -496,10 +1302,7 @@ INDI::IHorizontalCoordinates LFAST_Mount::getTrackingTargetAltAzPosition()
         // The alignment subsystem cannot transform the coordinate.
         // Try some simple rotations using the stored observatory position if any
 
-        INDI::IEquatorialCoordinates EquatorialCoordinates{0, 0};
-        EquatorialCoordinates.rightascension = ra;
-        EquatorialCoordinates.declination = dec;
-        INDI::EquatorialToHorizontal(&EquatorialCoordinates, &m_Location, ln_get_julian_from_sys(), &horizCoords);
+        apparentPlace.ofDateToObserved(astroClock.now().jd, ra, dec, &horizCoords.altitude, &horizCoords.azimuth);
         TDVCommand = TelescopeDirectionVectorFromAltitudeAzimuth(horizCoords);
         switch (GetApproximateMountAlignment())
         {
@@ -549,7 +1352,7 @@ INDI::IHorizontalCoordinates LFAST_Mount::getTrackingTargetAltAzPosition()
         horizCoords.azimuth = 360.0 + horizCoords.azimuth;
     }
 
-    if (TraceThisTick)
+    if (TraceThisTick && !telemetryWriter)
         LOGF_TM("getTrackingTargetAltAzPosition: [Target ALT: %.6f], [Target AZ: %.6f]", horizCoords.altitude, horizCoords.azimuth);
 
     return horizCoords;
@@ -567,82 +1370,486 @@ bool LFAST_Mount::SetSlewRate(int index)
     double mult = 1;
 
     mult = LFAST_CONSTANTS::slewspeeds[index];
+    if (loopMonitor.isDegraded())
+        mult = std::min(mult, SLEWDRIVE::DEGRADED_MAX_SLEW_MULT);
     slewRateTmp = mult * LFAST_CONSTANTS::SiderealRate_degpersec;
     azVal = slewRateTmp;
     altVal = slewRateTmp;
 
     LOGF_TM("SetSlewRate: %.3fx Sidereal (%6.4f deg/s).", mult, slewRateTmp);
 
-    AzimuthAxis->updateSlewRate(azVal);
-    AltitudeAxis->updateSlewRate(altVal);
-    return true;
+    AzimuthAxis->updateSlewRate(azVal);
+    AltitudeAxis->updateSlewRate(altVal);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Feedforward rates and accelerations for the tracking target, computed from its hour angle
+/// rather than the mount position. Only the sidereal motion is included; the target's own motion
+/// comes through the tracking ephemeris.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::getHorizontalRates(INDI::IHorizontalCoordinates &rate, INDI::IHorizontalCoordinates &accel)
+{
+    INDI::IEquatorialCoordinates target = getTrackingTargetRADec();
+    double ra = target.rightascension + m_SkyGuideOffset.rightascension;
+    double dec = target.declination + m_SkyGuideOffset.declination;
+    double lst = astroClock.now().lst_hrs;
+
+    HorizontalKinematics hk = computeHorizontalKinematics(hrs2rad(lst - ra),
+                                                          deg2rad(dec),
+                                                          deg2rad(LocationN[LOCATION_LATITUDE].value),
+                                                          LFAST_CONSTANTS::SiderealRate_radpersec);
+    rate.altitude = rad2deg(hk.altRate);
+    rate.azimuth = rad2deg(hk.azRate);
+    accel.altitude = rad2deg(hk.altAccel);
+    accel.azimuth = rad2deg(hk.azAccel);
+    if (TraceThisTick && !telemetryWriter)
+    {
+        LOGF_TM("ALT_RATE: %6.4f, AZ_RATE: %6.4f", rate.altitude, rate.azimuth);
+        LOGF_TM("ALT_ACCEL: %.4e, AZ_ACCEL: %.4e%s", accel.altitude, accel.azimuth,
+                hk.nearZenith ? " (near zenith, azimuth limited)" : "");
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Position, rate and acceleration commands for SCOPE_TRACKING. Once the ephemeris covers the
+/// current time its derivatives are used as the feedforward, and its position too unless a guide
+/// offset or alignment model applies (the ephemeris is fitted to the apparent place transform
+/// alone). Through a zenith keyhole the azimuth comes from the keyhole plan instead.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::getTrackingTargetCommands(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates &rate,
+                                            INDI::IHorizontalCoordinates &accel)
+{
+    EphemerisState ephem;
+    bool ephemReady = trackingEphemeris->evaluate(astroClock.now().jd, ephem);
+    bool guideOffsetActive = guideManeuverActive ||
+                             m_SkyGuideOffset.rightascension != 0.0 ||
+                             m_SkyGuideOffset.declination != 0.0;
+
+    if (ephemReady && !guideOffsetActive && (pointingModelEnabled || GetAlignmentDatabase().empty()))
+    {
+        posn.altitude = ephem.position[EPHEM_ALT];
+        posn.azimuth = ephem.position[EPHEM_AZ];
+        if (TraceThisTick && !telemetryWriter)
+            LOGF_TM("getTrackingTargetCommands: [Ephemeris ALT: %.6f], [Ephemeris AZ: %.6f]", posn.altitude, posn.azimuth);
+    }
+    else
+        posn = getTrackingTargetAltAzPosition();
+
+    if (ephemReady)
+    {
+        rate.altitude = ephem.rate[EPHEM_ALT];
+        rate.azimuth = ephem.rate[EPHEM_AZ];
+        accel.altitude = ephem.accel[EPHEM_ALT];
+        accel.azimuth = ephem.accel[EPHEM_AZ];
+        if (TraceThisTick && !telemetryWriter)
+            LOGF_TM("ALT_RATE: %6.4f, AZ_RATE: %6.4f (ephemeris)", rate.altitude, rate.azimuth);
+    }
+    else
+        getHorizontalRates(rate, accel);
+
+    double keyholeAz, keyholeAzRate;
+    if (keyholePlan.evaluate(astroClock.now().jd, keyholeAz, keyholeAzRate))
+    {
+        if (TraceThisTick && !telemetryWriter)
+            LOGF_TM("getTrackingTargetCommands: [Keyhole AZ: %.6f], [Target AZ: %.6f]", keyholeAz, posn.azimuth);
+        posn.azimuth = keyholeAz;
+        rate.azimuth = keyholeAzRate;
+        accel.azimuth = 0.0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static void formatJulianDateUTC(double jd, char *buf, size_t len)
+{
+    struct ln_date date;
+    ln_get_date(jd, &date);
+    snprintf(buf, len, "%04d-%02d-%02dT%02d:%02d:%04.1f", date.years, date.months, date.days,
+             date.hours, date.minutes, date.seconds);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Validates the TLE and builds its propagator. Old element sets are accepted with a warning.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::loadSatelliteTLE()
+{
+    try
+    {
+        TwoLineElement tle = SGP4Propagator::parseTLE(SatelliteTLETP[SAT_TLE_LINE1].getText(),
+                                                      SatelliteTLETP[SAT_TLE_LINE2].getText());
+        satellitePropagator = std::unique_ptr<SGP4Propagator>(new SGP4Propagator(tle));
+    }
+    catch (const std::exception &e)
+    {
+        satellitePropagator.reset();
+        LOGF_ERROR("TLE Error: %s", e.what());
+        return false;
+    }
+
+    double age_days = refreshAstroTime().jd - satellitePropagator->getEpochJD();
+    if (std::fabs(age_days) > SLEWDRIVE::SATELLITE_TLE_MAX_AGE_DAYS)
+        LOGF_WARN("TLE for satellite %s is %.1f days from its epoch. The predictions may be off by tens of km.",
+                  satellitePropagator->getSatnum().c_str(), age_days);
+    else
+        LOGF_INFO("Loaded TLE for satellite %s.", satellitePropagator->getSatnum().c_str());
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Starts planning the next pass on a worker thread. serviceSatellitePlanning() picks up the
+/// result and starts the mount moving once the pass has been checked.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::startSatelliteTracking()
+{
+    if (!satellitePropagator || TrackState == SCOPE_PARKED || TrackState == SCOPE_PARKING)
+    {
+        if (!satellitePropagator)
+            LOG_ERROR("Satellite tracking needs a valid TLE.");
+        else
+            LOG_ERROR("Satellite tracking isn't available while parked.");
+        stopSatelliteTracking("Idle", IPS_ALERT);
+        return false;
+    }
+
+    // Replacing a search that's still running would block here until it finished
+    if (satellitePassPlan.valid() && satellitePassPlan.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (satTrackPhase == SAT_TRACK_PLANNING)
+        {
+            LOG_INFO("A satellite pass is already being planned.");
+            SatelliteTrackSP.apply();
+            return true;
+        }
+        LOG_WARN("The last satellite pass search is still running; try again when it's done.");
+        stopSatelliteTracking("Idle", IPS_ALERT);
+        return false;
+    }
+
+    const SGP4Propagator sgp4 = *satellitePropagator;
+    const INDI::IGeographicCoordinates site = m_Location;
+    const SatellitePassLimits limits{SLEWDRIVE::SATELLITE_MIN_ALT_DEG, SLEWDRIVE::SATELLITE_MAX_ALT_DEG,
+                                     SLEWDRIVE::SATELLITE_RATE_MARGIN * SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS};
+    const double jdStart = refreshAstroTime().jd;
+    satellitePassPlan = std::async(std::launch::async,
+                                   [sgp4, site, limits, jdStart]()
+                                   {
+                                       return SatellitePass::plan(sgp4, jdStart, site.latitude, site.longitude,
+                                                                  site.elevation, limits);
+                                   });
+    satTrackPhase = SAT_TRACK_PLANNING;
+
+    SatelliteTrackSP.setState(IPS_BUSY);
+    SatelliteTrackSP.apply();
+    setSatellitePassStatus("Planning", IPS_BUSY);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::stopSatelliteTracking(const char *status, IPState state)
+{
+    bool mountFollowing = satTrackPhase == SAT_TRACK_WAITING || satTrackPhase == SAT_TRACK_ACTIVE;
+    satTrackPhase = SAT_TRACK_OFF;
+    if (mountFollowing && TrackState == SCOPE_TRACKING)
+        TrackState = SCOPE_IDLE;
+
+    SatelliteTrackSP.reset();
+    SatelliteTrackSP[SAT_HALT].setState(ISS_ON);
+    SatelliteTrackSP.setState(state);
+    SatelliteTrackSP.apply();
+    setSatellitePassStatus(status, state);
+}
+
+void LFAST_Mount::setSatellitePassStatus(const char *status, IPState state)
+{
+    SatellitePassTP[SAT_PASS_STATUS].setText(status);
+    SatellitePassTP.setState(state);
+    SatellitePassTP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// While tracking a sky target, looks for zenith transits the azimuth drive can't follow,
+/// replanning every KEYHOLE_REPLAN_PERIOD_SEC on a worker thread. The plan in use stays in use
+/// until a new one for the same target comes back.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::serviceKeyholePlanning()
+{
+    if (keyholePlanning.valid())
+    {
+        if (keyholePlanning.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+        KeyholePlan plan;
+        try
+        {
+            plan = keyholePlanning.get();
+        }
+        catch (const std::exception &e)
+        {
+            LOGF_ERROR("Keyhole Planning Error: %s", e.what());
+            return;
+        }
+        if (keyholePlanningGeneration != keyholeGeneration)
+            return;
+        if (!plan.getError().empty())
+            LOGF_WARN("Keyhole planning failed: %s", plan.getError().c_str());
+        bool isNew = plan.isValid() && (!keyholePlan.isValid() || plan.getTransit() != keyholePlan.getTransit());
+        keyholePlan = plan;
+        publishKeyholePlan(isNew);
+        return;
+    }
+
+    if (TrackState != SCOPE_TRACKING || satTrackPhase != SAT_TRACK_OFF || !trackingSampler)
+        return;
+    double jd = astroClock.now().jd;
+    if (jd < keyholeReplanJd)
+        return;
+    keyholeReplanJd = jd + SLEWDRIVE::KEYHOLE_REPLAN_PERIOD_SEC / KEYHOLE::SEC_PER_DAY;
+
+    const TrackingEphemeris::Sampler sampler = trackingSampler;
+    const KeyholeLimits limits{SLEWDRIVE::KEYHOLE_RATE_MARGIN * SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS,
+                               KeyholeToleranceNP[0].getValue()};
+    keyholePlanningGeneration = keyholeGeneration;
+    keyholePlanning = std::async(std::launch::async,
+                                 [sampler, jd, limits]()
+                                 {
+                                     return KeyholePlan::plan(sampler, jd, limits);
+                                 });
+}
+
+void LFAST_Mount::publishKeyholePlan(bool announce)
+{
+    if (!keyholePlan.isValid())
+    {
+        KeyholeTP[KEYHOLE_START].setText("");
+        KeyholeTP[KEYHOLE_END].setText("");
+        KeyholeTP[KEYHOLE_MIN_ZD].setText("");
+        KeyholeTP[KEYHOLE_PREDICTION].setText("None");
+        KeyholeTP.setState(IPS_IDLE);
+        KeyholeTP.apply();
+        return;
+    }
+
+    char startStr[32], endStr[32], zdStr[16], predictionStr[96];
+    formatJulianDateUTC(keyholePlan.getStart(), startStr, sizeof(startStr));
+    formatJulianDateUTC(keyholePlan.getEnd(), endStr, sizeof(endStr));
+    snprintf(zdStr, sizeof(zdStr), "%.3f", keyholePlan.getMinZenithDistance());
+    snprintf(predictionStr, sizeof(predictionStr), "%.0f s outside %.1f arcsec, max %.1f arcsec",
+             keyholePlan.getTimeOutsideTolerance(), KeyholeToleranceNP[0].getValue(), keyholePlan.getMaxError());
+    KeyholeTP[KEYHOLE_START].setText(startStr);
+    KeyholeTP[KEYHOLE_END].setText(endStr);
+    KeyholeTP[KEYHOLE_MIN_ZD].setText(zdStr);
+    KeyholeTP[KEYHOLE_PREDICTION].setText(predictionStr);
+    KeyholeTP.setState(keyholePlan.getTimeOutsideTolerance() > 0.0 ? IPS_ALERT : IPS_OK);
+    KeyholeTP.apply();
+
+    if (announce)
+        LOGF_WARN("Zenith keyhole %s to %s: the target passes %.3f deg from the zenith at up to %.2f deg/s in azimuth. "
+                  "The azimuth will pre-rotate at %.2f deg/s; %s.",
+                  startStr, endStr, keyholePlan.getMinZenithDistance(), std::fabs(keyholePlan.getPeakTargetAzRate()),
+                  std::fabs(keyholePlan.getAzRate()), predictionStr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Maps an azimuth command onto the unwrapped axis: the copy nearest the previous command, so
+/// tracking through north carries on past 360 instead of turning back. Throws at the soft limits.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double LFAST_Mount::unwrapAzimuthCommand(double az)
+{
+    if (!azWrapEnabled)
+        return az;
+
+    if (!azCommandUnwrappedValid)
+    {
+        azCommandUnwrapped = AzimuthAxis->getPositionState();
+        azCommandUnwrappedValid = true;
+    }
+    double unwrapped = CableWrap::unwrapNear(az, azCommandUnwrapped);
+    if (!cableWrap.isInside(unwrapped))
+    {
+        char errBuff[128];
+        snprintf(errBuff, sizeof(errBuff), "Azimuth cable wrap limit reached (command %.2f deg, limits %.1f to %.1f deg).",
+                 unwrapped, cableWrap.getMin(), cableWrap.getMax());
+        throw std::runtime_error(errBuff);
+    }
+    azCommandUnwrapped = unwrapped;
+    return unwrapped;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Chooses the turn to slew to for a goto. The target's azimuth travel over the requested track
+/// time (or until it sets) comes from the tracking sampler; the slew time is estimated at the top
+/// speed, with the altitude slew as the floor.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double LFAST_Mount::planAzimuthGoto(const INDI::IHorizontalCoordinates &target)
+{
+    if (!azWrapEnabled)
+        return target.azimuth;
+
+    std::vector<double> travel{0.0};
+    if (trackingSampler)
+    {
+        const double jd0 = astroClock.now().jd;
+        const double duration_s = AzWrapNP[AZ_WRAP_TRACK_HOURS].getValue() * 3600.0;
+        double values[NUM_EPHEM_CHANNELS];
+        if (trackingSampler(jd0, values))
+        {
+            double prevAz = values[EPHEM_AZ];
+            for (double t_s = CABLE_WRAP::PATH_STEP_SEC; t_s <= duration_s; t_s += CABLE_WRAP::PATH_STEP_SEC)
+            {
+                if (!trackingSampler(jd0 + t_s / SECONDS_PER_DAY, values) || values[EPHEM_ALT] < 0.0)
+                    break;
+                double az = CableWrap::unwrapNear(values[EPHEM_AZ], prevAz);
+                travel.push_back(travel.back() + az - prevAz);
+                prevAz = az;
+            }
+        }
+    }
+
+    const double altSlewTime_s = std::fabs(target.altitude - AltitudeAxis->getPositionState()) /
+                                 SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS;
+    CableWrapChoice choice = cableWrap.chooseGoto(AzimuthAxis->getPositionState(), target.azimuth, travel,
+                                                  SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS, altSlewTime_s);
+    LOGF_INFO("Cable wrap: slewing to azimuth %.2f deg (%.0f s), room to track for %.1f h.", choice.az_deg,
+              choice.slewTime_s, choice.trackTime_s / 3600.0);
+    if (!choice.fullTrack)
+        LOGF_WARN("Cable wrap: the target reaches the azimuth limit %.1f h after the goto.",
+                  choice.trackTime_s / 3600.0);
+    azCommandUnwrapped = choice.az_deg;
+    azCommandUnwrappedValid = true;
+    return choice.az_deg;
 }
 
-// Calculate the feedforward rates for tracking whatever
-// Currently only works for sidereal targets (nothing in the solar system)
-// TODO: Update to accept an INDI::TelescopeTrackMode argument and calculate rates accordingly
-INDI::IHorizontalCoordinates LFAST_Mount::getHorizontalRates()
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::publishCableWrapStatus()
 {
-    // Assumes sidereal target.
-    double ra = m_SkyTrackingTarget.rightascension;
-    double dec = m_SkyTrackingTarget.declination;
-
-    double lst = get_local_sidereal_time(LocationN[LOCATION_LONGITUDE].value);
-    double ha = hrs2rad(lst - ra);
-    // LOGF_DEBUG("HA: %6.5f", rad2deg(ha));
-
-    // double cHA = std::cos(ha);
-    double sHA = std::sin(ha);
-
-    double cDEC = std::cos(deg2rad(dec));
-    // double sDEC = std::sin(deg2rad(dec));
-
-    double lat = deg2rad(LocationN[LOCATION_LATITUDE].value);
-    double cLAT = std::cos(lat);
-    // double sLAT = std::sin(lat);
+    const double az = AzimuthAxis->getPositionState();
+    AzWrapStatusNP[AZ_WRAP_POSN].setValue(az);
+    AzWrapStatusNP[AZ_WRAP_ROOM_CW].setValue(std::max(0.0, cableWrap.getMax() - az));
+    AzWrapStatusNP[AZ_WRAP_ROOM_CCW].setValue(std::max(0.0, az - cableWrap.getMin()));
+    AzWrapStatusNP.setState(cableWrap.isInside(az) ? IPS_OK : IPS_ALERT);
+    publisher.update(PUB_AZ_WRAP, &az, 1, AzWrapStatusNP.getState());
+}
 
-    double alt = deg2rad(m_MountAltAz.altitude);
-    // LOGF_DEBUG("ALT: %6.5f", rad2deg(alt));
-    // double sALT = std::sin(alt);
-    double cALT = std::cos(alt);
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Polled every tick. Once the planner finishes, publishes the pass and, if the mount can follow
+/// it, switches to tracking (pre-positioned at the AOS point until the pass starts).
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::serviceSatellitePlanning()
+{
+    if (satTrackPhase != SAT_TRACK_PLANNING || !satellitePassPlan.valid() ||
+        satellitePassPlan.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
 
-    double az = deg2rad(m_MountAltAz.azimuth);
-    // LOGF_DEBUG("AZ: %6.5f", rad2deg(az));
-    double sAZ = std::sin(az);
-    // double cAZ = std::cos(az);
+    try
+    {
+        satellitePass = satellitePassPlan.get();
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Satellite Pass Error: %s", e.what());
+        stopSatelliteTracking("Propagation failed", IPS_ALERT);
+        return;
+    }
 
-    double sPAR = sHA * cLAT / cALT;
-    double PAR = std::asin(sPAR);
-    // LOGF_DEBUG("PAR: %6.5f", rad2deg(PAR));
-    double cPAR = std::cos(PAR);
+    const char *satnum = satellitePropagator ? satellitePropagator->getSatnum().c_str() : "";
+    if (!satellitePass.isValid())
+    {
+        LOGF_WARN("Satellite %s doesn't rise above %.0f deg in the next %.0f hours.", satnum,
+                  SLEWDRIVE::SATELLITE_MIN_ALT_DEG, SATELLITE::PASS_SEARCH_WINDOW_SEC / 3600.0);
+        stopSatelliteTracking("No pass found", IPS_ALERT);
+        return;
+    }
 
-    // double sum = PAR + ha + M_PI_2 - az;
-    // LOGF_DEBUG("ANGLE SUM (deg): %6.4f", rad2deg(sum));
-    // LOGF_DEBUG("ANGLE SUM (rad): %6.4f",(sum));
+    char aosStr[32], losStr[32], maxAltStr[16];
+    formatJulianDateUTC(satellitePass.getAOS(), aosStr, sizeof(aosStr));
+    formatJulianDateUTC(satellitePass.getLOS(), losStr, sizeof(losStr));
+    snprintf(maxAltStr, sizeof(maxAltStr), "%.1f", satellitePass.getMaxAltitude());
+    SatellitePassTP[SAT_PASS_AOS].setText(aosStr);
+    SatellitePassTP[SAT_PASS_LOS].setText(losStr);
+    SatellitePassTP[SAT_PASS_MAX_ALT].setText(maxAltStr);
 
-    double azRate_dps = LFAST_CONSTANTS::SiderealRate_degpersec * (cLAT * sAZ + 0.0);
-    double altRate_dps = LFAST_CONSTANTS::SiderealRate_degpersec * (cDEC * cPAR / cALT + 0.0);
+    if (!satellitePass.isFeasible())
+    {
+        LOGF_WARN("Satellite %s pass at %s can't be tracked: %s.", satnum, aosStr,
+                  satellitePass.getInfeasibleReason().c_str());
+        stopSatelliteTracking("Not trackable", IPS_ALERT);
+        return;
+    }
+    LOGF_INFO("Satellite %s pass: AOS %s, LOS %s, peak altitude %.1f deg, peak rates alt %.3f / az %.3f deg/s.",
+              satnum, aosStr, losStr, satellitePass.getMaxAltitude(), satellitePass.getPeakAltRate(),
+              satellitePass.getPeakAzRate());
 
-    INDI::IHorizontalCoordinates vHz{0, 0};
-    vHz.altitude = altRate_dps;
-    vHz.azimuth = azRate_dps;
-    if (TraceThisTick)
-        LOGF_TM("ALT_RATE: %6.4f, AZ_RATE: %6.4f", altRate_dps, azRate_dps);
-    return vHz;
+    try
+    {
+        AltitudeAxis->enable();
+        AzimuthAxis->enable();
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Satellite Tracking Error: %s", e.what());
+        stopSatelliteTracking("Drive error", IPS_ALERT);
+        return;
+    }
+    m_SkyGuideOffset = {0, 0};
+    satTrackPhase = SAT_TRACK_WAITING;
+    TrackState = SCOPE_TRACKING;
+    setSatellitePassStatus("Waiting for AOS", IPS_BUSY);
 }
-// //////////////////////////////////////////////////////////////////////////////////////////////////
-// /// Tracking Rates V0
-// //////////////////////////////////////////////////////////////////////////////////////////////////
-INDI::IHorizontalCoordinates LFAST_Mount::getSiderealTargetAltAzRates()
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Commands for following the planned pass. Before AOS the mount holds the rise point in
+/// position mode. During the pass the table supplies position, rate and acceleration, so the
+/// feedforward leads the satellite through the tick instead of waiting on the position error.
+/// Guide offsets and the alignment model aren't applied to the pass.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+ControlMode_t LFAST_Mount::getSatelliteCommands(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates &rate,
+                                                INDI::IHorizontalCoordinates &accel)
 {
+    double jd = astroClock.now().jd;
+    SatelliteTrackPoint pt;
+    ControlMode_t mode = SLEWING_TO_POSN;
 
-    ALIGNMENT::TelescopeDirectionVector TDVCommand;
-    INDI::IHorizontalCoordinates hzTrackRates{0, 0};
+    if (jd < satellitePass.getAOS())
+        satellitePass.evaluate(satellitePass.getAOS(), pt);
+    else if (satellitePass.evaluate(jd, pt))
+    {
+        mode = TRACKING_COMMAND;
+        if (satTrackPhase == SAT_TRACK_WAITING)
+        {
+            LOG_INFO("Satellite pass started (AOS).");
+            satTrackPhase = SAT_TRACK_ACTIVE;
+            setSatellitePassStatus("Tracking", IPS_BUSY);
+        }
+    }
+    else
+    {
+        // Past LOS: hold the set point for this tick and go idle
+        satellitePass.evaluate(satellitePass.getLOS(), pt);
+        LOG_INFO("Satellite pass complete (LOS).");
+        stopSatelliteTracking("Pass complete", IPS_OK);
+    }
 
-    hzTrackRates = getHorizontalRates();
-    // LOGF_INFO("Rate Commands: dAlt = %6.4f, dAz = %6.4f", hzTrackRates.altitude, hzTrackRates.azimuth);
+    posn.altitude = pt.alt + apparentPlace.refraction(pt.alt);
+    posn.azimuth = pt.az;
+    if (mode == TRACKING_COMMAND)
+    {
+        rate.altitude = pt.altRate;
+        rate.azimuth = pt.azRate;
+        accel.altitude = pt.altAccel;
+        accel.azimuth = pt.azAccel;
+    }
+    else
+        rate = accel = {0, 0};
 
-    return hzTrackRates;
+    if (TraceThisTick && !telemetryWriter)
+        LOGF_TM("getSatelliteCommands: [ALT: %.6f], [AZ: %.6f], [ALT_RATE: %.6f], [AZ_RATE: %.6f]",
+                posn.altitude, posn.azimuth, rate.altitude, rate.azimuth);
+    return mode;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -652,8 +1859,11 @@ bool LFAST_Mount::Abort()
 {
     // gotoPending = false;
     LOG_WARN("Abort()");
+    triggerFlightRecorder("Abort");
     AltitudeAxis->abortSlew();
     AzimuthAxis->abortSlew();
+    if (satTrackPhase != SAT_TRACK_OFF)
+        stopSatelliteTracking("Aborted");
     m_SkyGuideOffset = {0, 0};
     m_EqSkyGuideDelta = {0, 0};
 
@@ -752,6 +1962,92 @@ bool LFAST_Mount::ISNewNumber(const char *dev, const char *name, double values[]
             TraceThisTickCount = 0;
             return true;
         }
+        if (TelemetryLiveNP.isNameMatch(name))
+        {
+            TelemetryLiveNP.update(values, names, n);
+            TelemetryLiveNP.setState(IPS_OK);
+            // Resize a running feed; readers see it close and attach again
+            if (telemetryFeed && !startTelemetryFeed())
+                TelemetryLiveNP.setState(IPS_ALERT);
+            TelemetryLiveNP.apply();
+            return true;
+        }
+        if (PublishLimitsNP.isNameMatch(name))
+        {
+            PublishLimitsNP.update(values, names, n);
+            applyPublishLimits();
+            PublishLimitsNP.setState(IPS_OK);
+            PublishLimitsNP.apply();
+            return true;
+        }
+        if (KeyholeToleranceNP.isNameMatch(name))
+        {
+            KeyholeToleranceNP.update(values, names, n);
+            KeyholeToleranceNP.setState(IPS_OK);
+            KeyholeToleranceNP.apply();
+            keyholeReplanJd = 0;
+            return true;
+        }
+        if (AzWrapNP.isNameMatch(name))
+        {
+            const double prevMin = cableWrap.getMin(), prevMax = cableWrap.getMax();
+            AzWrapNP.update(values, names, n);
+            try
+            {
+                cableWrap.setLimits(AzWrapNP[AZ_WRAP_MIN].getValue(), AzWrapNP[AZ_WRAP_MAX].getValue());
+                AzWrapNP.setState(IPS_OK);
+            }
+            catch (const std::exception &e)
+            {
+                LOGF_ERROR("Cable wrap: %s", e.what());
+                AzWrapNP[AZ_WRAP_MIN].setValue(prevMin);
+                AzWrapNP[AZ_WRAP_MAX].setValue(prevMax);
+                AzWrapNP.setState(IPS_ALERT);
+            }
+            AzWrapNP.apply();
+            return AzWrapNP.getState() == IPS_OK;
+        }
+        if (PointingTermsNP.isNameMatch(name))
+        {
+            PointingTermsNP.update(values, names, n);
+            for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+                pointingModel.setCoefficient(k, PointingTermsNP[k].getValue());
+            PointingTermsNP.setState(IPS_OK);
+            PointingTermsNP.apply();
+            return true;
+        }
+        if (ApparentPlaceNP.isNameMatch(name))
+        {
+            ApparentPlaceNP.update(values, names, n);
+            applyApparentPlaceSettings();
+            ApparentPlaceNP.setState(IPS_OK);
+            ApparentPlaceNP.apply();
+            return true;
+        }
+        if (AltRateFilterNP.isNameMatch(name))
+        {
+            AltRateFilterNP.update(values, names, n);
+            bool ok = applyRateFilterSettings(AltitudeAxis.get(), AltRateFilterNP);
+            AltRateFilterNP.setState(ok ? IPS_OK : IPS_ALERT);
+            AltRateFilterNP.apply();
+            return true;
+        }
+        if (AzRateFilterNP.isNameMatch(name))
+        {
+            AzRateFilterNP.update(values, names, n);
+            bool ok = applyRateFilterSettings(AzimuthAxis.get(), AzRateFilterNP);
+            AzRateFilterNP.setState(ok ? IPS_OK : IPS_ALERT);
+            AzRateFilterNP.apply();
+            return true;
+        }
+        if (DisturbanceObserverNP.isNameMatch(name))
+        {
+            DisturbanceObserverNP.update(values, names, n);
+            bool ok = applyDisturbanceObserverSettings();
+            DisturbanceObserverNP.setState(ok ? IPS_OK : IPS_ALERT);
+            DisturbanceObserverNP.apply();
+            return true;
+        }
         // Process alignment properties
         AlignmentSubsystemForDrivers::ProcessAlignmentNumberProperties(this, name, values, names, n);
     }
@@ -775,6 +2071,101 @@ bool LFAST_Mount::ISNewSwitch(const char *dev, const char *name, ISState *states
             HomeSP.apply();
             return startHomingRoutine();
         }
+        if (SatelliteTrackSP.isNameMatch(name))
+        {
+            SatelliteTrackSP.update(states, names, n);
+            if (SatelliteTrackSP.findOnSwitchIndex() == SAT_TRACK)
+                return startSatelliteTracking();
+            stopSatelliteTracking("Halted");
+            return true;
+        }
+        if (PointingModelSP.isNameMatch(name))
+        {
+            PointingModelSP.update(states, names, n);
+            pointingModelEnabled = PointingModelSP.findOnSwitchIndex() == PM_MODEL_ENABLE;
+            LOGF_INFO("Pointing model %s.", pointingModelEnabled ? "enabled" : "disabled");
+            PointingModelSP.setState(IPS_OK);
+            PointingModelSP.apply();
+            return true;
+        }
+        if (SkyGridSP.isNameMatch(name))
+        {
+            SkyGridSP.update(states, names, n);
+            skyGridEnabled = SkyGridSP.findOnSwitchIndex() == SKY_GRID_ENABLE;
+            if (skyGridEnabled && !skyGrid)
+                LOG_WARN("No sky grid is loaded yet.");
+            SkyGridSP.setState(IPS_OK);
+            SkyGridSP.apply();
+            return true;
+        }
+        if (TelemetryRecordSP.isNameMatch(name))
+        {
+            TelemetryRecordSP.update(states, names, n);
+            if (TelemetryRecordSP.findOnSwitchIndex() == TELEMETRY_RECORD_ON)
+                startTelemetryRecording();
+            else
+                stopTelemetryRecording();
+            return true;
+        }
+        if (BusRecordSP.isNameMatch(name))
+        {
+            BusRecordSP.update(states, names, n);
+            // Until connected, this only says whether to record from the next connection
+            if (BusRecordSP.findOnSwitchIndex() == BUS_RECORD_OFF)
+                stopBusRecording();
+            else if (KincoDriver::rtuIsActive())
+                startBusRecording();
+            else
+                BusRecordSP.apply();
+            return true;
+        }
+        if (FlightRecorderSP.isNameMatch(name))
+        {
+            FlightRecorderSP.reset();
+            triggerFlightRecorder("Operator request");
+            return true;
+        }
+        if (TelemetryLiveSP.isNameMatch(name))
+        {
+            TelemetryLiveSP.update(states, names, n);
+            if (TelemetryLiveSP.findOnSwitchIndex() == TELEMETRY_LIVE_ON)
+                startTelemetryFeed();
+            else
+                stopTelemetryFeed();
+            return true;
+        }
+        if (AzWrapSP.isNameMatch(name))
+        {
+            AzWrapSP.update(states, names, n);
+            azWrapEnabled = AzWrapSP.findOnSwitchIndex() == AZ_WRAP_ENABLE;
+            // Unwrapped commands are already on the right turn; the shortcut would cross the wrap
+            AzimuthAxis->setPositionErrorWrapping(!azWrapEnabled);
+            azCommandUnwrappedValid = false;
+            AzWrapSP.setState(IPS_OK);
+            AzWrapSP.apply();
+            return true;
+        }
+        if (PointingSyncSP.isNameMatch(name))
+        {
+            PointingSyncSP.update(states, names, n);
+            PointingSyncSP.setState(IPS_OK);
+            PointingSyncSP.apply();
+            return true;
+        }
+        if (PointingActionSP.isNameMatch(name))
+        {
+            PointingActionSP.update(states, names, n);
+            int action = PointingActionSP.findOnSwitchIndex();
+            bool ok = true;
+            if (action == PM_ACTION_FIT)
+                ok = fitPointingModel();
+            else if (action == PM_ACTION_CLEAR)
+                clearPointingObservations();
+            PointingActionSP.reset();
+            PointingActionSP.setState(ok ? IPS_OK : IPS_ALERT);
+            PointingActionSP.apply();
+            return true;
+        }
         // Process alignment properties
         AlignmentSubsystemForDrivers::ProcessAlignmentSwitchProperties(this, name, states, names, n);
     }
@@ -798,6 +2189,48 @@ bool LFAST_Mount::ISNewText(const char *dev, const char *name, char *texts[], ch
             ModbusCommPortTP.apply();
             return true;
         }
+        if (BusReplayTP.isNameMatch(name))
+        {
+            // Taken up on the next connection
+            BusReplayTP.update(texts, names, n);
+            BusReplayTP.setState(IPS_OK);
+            BusReplayTP.apply();
+            return true;
+        }
+        if (SatelliteTLETP.isNameMatch(name))
+        {
+            if (satTrackPhase != SAT_TRACK_OFF)
+                stopSatelliteTracking("Halted (new TLE)");
+            SatelliteTLETP.update(texts, names, n);
+            SatelliteTLETP.setState(loadSatelliteTLE() ? IPS_OK : IPS_ALERT);
+            SatelliteTLETP.apply();
+            return true;
+        }
+        if (PointingFileTP.isNameMatch(name))
+        {
+            PointingFileTP.update(texts, names, n);
+            PointingFileTP.setState(IPS_OK);
+            PointingFileTP.apply();
+            return true;
+        }
+        if (TelemetryDirTP.isNameMatch(name))
+        {
+            TelemetryDirTP.update(texts, names, n);
+            TelemetryDirTP.setState(IPS_OK);
+            // Carry on in the new directory
+            if (telemetryWriter && !startTelemetryRecording())
+                TelemetryDirTP.setState(IPS_ALERT);
+            TelemetryDirTP.apply();
+            return true;
+        }
+        if (SkyGridTP.isNameMatch(name))
+        {
+            SkyGridTP.update(texts, names, n);
+            if (!startSkyGridLoad())
+                SkyGridTP.setState(IPS_ALERT);
+            SkyGridTP.apply();
+            return true;
+        }
         // Process alignment properties
         AlignmentSubsystemForDrivers::ProcessAlignmentTextProperties(this, name, texts, names, n);
     }
@@ -815,7 +2248,27 @@ bool LFAST_Mount::saveConfigItems(FILE *fp)
     // IUSaveConfigNumber(fp, &TelemetryDownsampleNP);
     // IUSaveConfigText(fp, &ModbusCommPortTP);
     TelemetryDownsampleNP.save(fp);
+    TelemetryDirTP.save(fp);
+    TelemetryRecordSP.save(fp);
+    BusRecordSP.save(fp);
+    TelemetryLiveNP.save(fp);
+    TelemetryLiveSP.save(fp);
+    PublishLimitsNP.save(fp);
+    ApparentPlaceNP.save(fp);
     ModbusCommPortTP.save(fp);
+    AltRateFilterNP.save(fp);
+    AzRateFilterNP.save(fp);
+    DisturbanceObserverNP.save(fp);
+    SatelliteTLETP.save(fp);
+    PointingModelSP.save(fp);
+    PointingSyncSP.save(fp);
+    PointingTermsNP.save(fp);
+    PointingFileTP.save(fp);
+    KeyholeToleranceNP.save(fp);
+    AzWrapSP.save(fp);
+    AzWrapNP.save(fp);
+    SkyGridSP.save(fp);
+    SkyGridTP.save(fp);
     return true;
 }
 
@@ -825,7 +2278,27 @@ void LFAST_Mount::ISGetProperties(const char *dev)
 
     // This would simulate a client sending a new value using the value stored in the config file.
     loadConfig(true, TelemetryDownsampleNP.getName());
+    loadConfig(true, TelemetryDirTP.getName());
+    loadConfig(true, TelemetryRecordSP.getName());
+    loadConfig(true, BusRecordSP.getName());
+    loadConfig(true, TelemetryLiveNP.getName());
+    loadConfig(true, TelemetryLiveSP.getName());
+    loadConfig(true, PublishLimitsNP.getName());
+    loadConfig(true, ApparentPlaceNP.getName());
     loadConfig(true, ModbusCommPortTP.getName());
+    loadConfig(true, AltRateFilterNP.getName());
+    loadConfig(true, AzRateFilterNP.getName());
+    loadConfig(true, DisturbanceObserverNP.getName());
+    loadConfig(true, SatelliteTLETP.getName());
+    loadConfig(true, PointingModelSP.getName());
+    loadConfig(true, PointingSyncSP.getName());
+    loadConfig(true, PointingTermsNP.getName());
+    loadConfig(true, PointingFileTP.getName());
+    loadConfig(true, KeyholeToleranceNP.getName());
+    loadConfig(true, AzWrapSP.getName());
+    loadConfig(true, AzWrapNP.getName());
+    loadConfig(true, SkyGridSP.getName());
+    loadConfig(true, SkyGridTP.getName());
 }
 
 void LFAST_Mount::simulationTriggered(bool enable)
@@ -1004,6 +2477,7 @@ bool LFAST_Mount::Sync(double ra, double dec)
     bool success = true;
     double azFb, altFb;
     LOGF_TM("Sync: [RA: %.6f], [DEC: %.6f]", ra, dec);
+    const double jd = refreshAstroTime().jd;
     if (!isSimulation())
     {
         try
@@ -1025,12 +2499,27 @@ bool LFAST_Mount::Sync(double ra, double dec)
         m_MountAltAz.altitude = altFb;
     }
     INDI::IHorizontalCoordinates newAltAz{0, 0};
-    INDI::IEquatorialCoordinates syncRaDec{0, 0};
-    syncRaDec.rightascension = ra;
-    syncRaDec.declination = dec;
-    INDI::EquatorialToHorizontal(&syncRaDec, &m_Location, ln_get_julian_from_sys(), &newAltAz);
+    apparentPlace.ofDateToObserved(jd, ra, dec, &newAltAz.altitude, &newAltAz.azimuth);
+    if (PointingSyncSP[PM_SYNC_RECORD].getState() == ISS_ON)
+    {
+        PointingObservation obs{newAltAz.altitude, newAltAz.azimuth, m_MountAltAz.altitude, m_MountAltAz.azimuth};
+        return recordPointingObservation(obs);
+    }
+    // Moving the encoder zero invalidates the recorded points
+    if (!pointingObservations.empty())
+    {
+        LOGF_WARN("Axis sync moves the encoder zero; clearing %u pointing points.", (unsigned)pointingObservations.size());
+        clearPointingObservations();
+    }
+    double syncAz = newAltAz.azimuth;
+    if (azWrapEnabled)
+    {
+        // Keep the turn the axis is on
+        syncAz = CableWrap::unwrapNear(syncAz, AzimuthAxis->getPositionState());
+        azCommandUnwrappedValid = false;
+    }
     AltitudeAxis->syncPosition(newAltAz.altitude);
-    AzimuthAxis->syncPosition(newAltAz.azimuth);
+    AzimuthAxis->syncPosition(syncAz);
     LOGF_TM("Sync: [ALT: %.6f], [AZ: %.6f]", newAltAz.altitude, newAltAz.azimuth);
     
     ReadScopeStatus();
@@ -1043,7 +2532,7 @@ bool LFAST_Mount::Sync(double ra, double dec)
     }
 
     ALIGNMENT::AlignmentDatabaseEntry NewEntry;
-    NewEntry.ObservationJulianDate = ln_get_julian_from_sys();
+    NewEntry.ObservationJulianDate = jd;
     NewEntry.RightAscension = ra;
     NewEntry.Declination = dec;
     NewEntry.TelescopeDirection = TelescopeDirectionVectorFromAltitudeAzimuth(m_MountAltAz);
@@ -1083,10 +2572,20 @@ bool LFAST_Mount::Park()
     // gotoPending = true;
     if (TrackState != SCOPE_PARKED && TrackState != SCOPE_PARKING)
     {
+        if (satTrackPhase != SAT_TRACK_OFF)
+            stopSatelliteTracking("Halted (park)");
         m_SkyGuideOffset = {0, 0};
         m_EqSkyGuideDelta = {0, 0};
+        double parkAz = ParkPositionN[AXIS_AZ].value;
+        if (azWrapEnabled)
+        {
+            // Park on the turn nearest the middle of the wrap, which unwinds the cables
+            parkAz = CableWrap::unwrapNear(parkAz, cableWrap.getCentre());
+            azCommandUnwrapped = parkAz;
+            azCommandUnwrappedValid = true;
+        }
         AltitudeAxis->updateTrackCommands(ParkPositionN[AXIS_ALT].value);
-        AzimuthAxis->updateTrackCommands(ParkPositionN[AXIS_AZ].value);
+        AzimuthAxis->updateTrackCommands(parkAz);
         // NewRaDec(EquatorialCoordinates.rightascension, EquatorialCoordinates.declination);
         TrackState = SCOPE_PARKING;
     }
@@ -1144,37 +2643,55 @@ bool LFAST_Mount::UnPark()
 bool LFAST_Mount::updateLocation(double latitude, double longitude, double elevation)
 {
     LOGF_TM("updateLocation: %.4f, %.4f, %.2f", latitude, longitude, elevation);
+    // m_Location (which refreshAstroTime() reads) is only updated after this returns
+    astroClock.update(longitude);
+    apparentPlace.setSite(latitude, longitude);
     UpdateLocation(latitude, longitude, elevation);
+    if (TrackState == SCOPE_TRACKING || TrackState == SCOPE_SLEWING)
+    {
+        INDI::IGeographicCoordinates newLocation{0, 0, 0};
+        newLocation.longitude = longitude;
+        newLocation.latitude = latitude;
+        newLocation.elevation = elevation;
+        restartTrackingEphemeris(newLocation);
+    }
     return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
-bool LFAST_Mount::updatePointingCoordinates()
+bool LFAST_Mount::readAxisFeedback()
 {
-    bool successFlag = true;
-    double azPosnFb, altPosnFb, azRateFb, altRateFb;
     try
     {
-        azPosnFb = AzimuthAxis->getPositionFeedback();
-        altPosnFb = AltitudeAxis->getPositionFeedback();
-        azRateFb = AzimuthAxis->getVelocityFeedback();
-        altRateFb = AltitudeAxis->getVelocityFeedback();
+        LFAST_PROFILE_SCOPE(TICK_PHASE_axis_feedback);
+        m_AxisPosnFb.azimuth = AzimuthAxis->getPositionFeedback();
+        m_AxisPosnFb.altitude = AltitudeAxis->getPositionFeedback();
+        m_AxisRateFb.azimuth = AzimuthAxis->getVelocityFeedback();
+        m_AxisRateFb.altitude = AltitudeAxis->getVelocityFeedback();
     }
     catch (const std::exception &e)
     {
-        LOGF_ERROR("updatePointingCoordinates Error:%s", e.what());
+        LOGF_ERROR("readAxisFeedback Error:%s", e.what());
+        triggerFlightRecorder(e.what());
         TrackState = SCOPE_IDLE;
         AzAltCoordsNP.setState(IPS_ALERT);
         AzAltCoordsNP.apply();
-        successFlag = false;
+        return false;
     }
-    if (!successFlag)
-        return successFlag;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// From the feedback readAxisFeedback() got this tick
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::updatePointingCoordinates()
+{
+    bool successFlag = true;
+    LFAST_PROFILE_SCOPE(TICK_PHASE_coord_transform);
 
-    m_MountAltAz.altitude = altPosnFb;
-    m_MountAltAz.azimuth = azPosnFb;
+    m_MountAltAz = m_AxisPosnFb;
 
     // LOGF_INFO("updateEquatorialCoordinates: ALT=%6.4f, AZ=%6.4f", alt, az)
     ALIGNMENT::TelescopeDirectionVector TDV = TelescopeDirectionVectorFromAltitudeAzimuth(m_MountAltAz);
@@ -1182,7 +2699,7 @@ bool LFAST_Mount::updatePointingCoordinates()
     DEBUGF(INDI::AlignmentSubsystem::DBG_ALIGNMENT, "TDV x %lf y %lf z %lf", TDV.x, TDV.y, TDV.z);
 
     double RightAscension, Declination;
-    if (!TransformTelescopeToCelestial(TDV, RightAscension, Declination))
+    if (pointingModelEnabled || !TransformTelescopeToCelestial(TDV, RightAscension, Declination))
     {
         if (TraceThisTick)
             LOG_INFO("updatePointingCoordinates: TransformTelescopeToCelestial failed");
@@ -1215,24 +2732,25 @@ bool LFAST_Mount::updatePointingCoordinates()
             break;
         }
 
-        INDI::IEquatorialCoordinates EquatorialCoordinates{0, 0};
-        INDI::HorizontalToEquatorial(&m_MountAltAz, &m_Location, ln_get_julian_from_sys(), &EquatorialCoordinates);
-        // libnova works in decimal degrees
-        RightAscension = EquatorialCoordinates.rightascension;
-        Declination = EquatorialCoordinates.declination;
+        INDI::IHorizontalCoordinates skyAltAz = m_MountAltAz;
+        if (pointingModelEnabled)
+            removePointingModel(m_MountAltAz, skyAltAz);
+        apparentPlace.observedToOfDate(astroClock.now().jd, skyAltAz.altitude, skyAltAz.azimuth,
+                                       &RightAscension, &Declination);
     }
 
-    if (TraceThisTick)
+    if (TraceThisTick && !telemetryWriter)
         LOGF_TM("ReadScopeStatus: RA %lf hours,  DEC %lf degrees", RightAscension, Declination);
 
     m_SkyCurrentRADE.rightascension = RightAscension;
     m_SkyCurrentRADE.declination = Declination;
-    NewRaDec(m_SkyCurrentRADE.rightascension, m_SkyCurrentRADE.declination);
+    const double raDec_deg[2] = {15.0 * RightAscension, Declination};
+    publisher.update(PUB_EQ, raDec_deg, 2, TrackState);
 
     AzAltCoordsNP[AXIS_AZ].setValue(m_MountAltAz.azimuth);
     AzAltCoordsNP[AXIS_ALT].setValue(m_MountAltAz.altitude);
-    AzAltCoordsNP[AXIS_AZ_VEL].setValue(azRateFb);
-    AzAltCoordsNP[AXIS_ALT_VEL].setValue(altRateFb);
+    AzAltCoordsNP[AXIS_AZ_VEL].setValue(m_AxisRateFb.azimuth);
+    AzAltCoordsNP[AXIS_ALT_VEL].setValue(m_AxisRateFb.altitude);
 
     return successFlag;
 }
@@ -1323,7 +2841,10 @@ double LFAST_Mount::GetSlewRate()
 {
     // LOG_DEBUG("LFAST_Mount::GetSlewRate");
     ISwitch *Switch = IUFindOnSwitch(&SlewRateSP);
-    return *(static_cast<double *>(Switch->aux));
+    double mult = *(static_cast<double *>(Switch->aux));
+    if (loopMonitor.isDegraded())
+        mult = std::min(mult, SLEWDRIVE::DEGRADED_MAX_SLEW_MULT);
+    return mult;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1331,6 +2852,7 @@ double LFAST_Mount::GetSlewRate()
 //////////////////////////////////////////////////////////////////////////////////////////////////
 bool LFAST_Mount::ReadScopeStatus()
 {
+    LFAST_PROFILE_SCOPE(TICK_PHASE_read_scope_status);
     LOG_DEBUG("ReadScopeStatus");
 
     // Update the state switch
@@ -1339,10 +2861,14 @@ bool LFAST_Mount::ReadScopeStatus()
     // TrackStateSP[TrackState].s = ISS_ON;
     // IDSetSwitch(&TrackStateSP, nullptr);
 
-    // Calculate new RA DEC
-    if (updatePointingCoordinates())
+    // The control loops run on the feedback, so it's read every tick. The new RA DEC is only
+    // calculated every few ticks in degraded mode.
+    if (readAxisFeedback() && statusPollDue && updatePointingCoordinates())
     {
-        AzAltCoordsNP.apply();
+        const double azAlt_deg[2] = {m_MountAltAz.azimuth, m_MountAltAz.altitude};
+        publisher.update(PUB_AZ_ALT, azAlt_deg, 2, AzAltCoordsNP.getState());
+        if (azWrapEnabled)
+            publishCableWrapStatus();
     }
     switch (TrackState)
     {
@@ -1370,6 +2896,7 @@ bool LFAST_Mount::ReadScopeStatus()
                 AzAltCoordsNP.apply();
                 AltitudeAxis->resetHomingRoutine();
                 AzimuthAxis->resetHomingRoutine();
+                azCommandUnwrappedValid = false;
 
                 homingRoutineActive = false;
 
@@ -1416,32 +2943,47 @@ bool LFAST_Mount::ReadScopeStatus()
 //////////////////////////////////////////////////////////////////////////////////////////////////
 void LFAST_Mount::TimerHit()
 {
-    static struct timeval prevTime
-    {
-        0, 0
-    }; // previous system time
-    struct timeval currTime
-    {
-        0, 0
-    }; // new system time
-
-    gettimeofday(&currTime, nullptr);
-
-    if (prevTime.tv_sec == 0 && prevTime.tv_usec == 0)
-        prevTime = currTime;
-
-    double dt; // Elapsed time in seconds since last tick
-    dt = currTime.tv_sec - prevTime.tv_sec + (currTime.tv_usec - prevTime.tv_usec) * 1e-6;
-    prevTime = currTime;
+    // The previous tick's phase times are complete now
+    LFAST_PROFILE_END_TICK();
+    LFAST_PROFILE_SCOPE(TICK_PHASE_timer_hit);
+
+    // One time for the whole tick. The interval is timed from the start of the previous tick on
+    // the monotonic clock, so it's immune to system clock steps and to the INDI requests that
+    // refresh the time context in between.
+    const double now_s = refreshAstroTime().monotonic_s;
+    double dt = tickStart_s > 0 ? now_s - tickStart_s : 0.0; // Elapsed time in seconds since last tick
+    tickStart_s = now_s;
+    // Marks the tick in a bus log; a replay runs at the recorded intervals
+    dt = KincoDriver::markBusTick(dt);
+    tickDt_s = dt;
+
+    // The polling period can be changed from the client
+    const double period_s = getCurrentPollingPeriod() / 1000.0;
+    if (period_s != loopMonitor.getNominalPeriod())
+        loopMonitor.setNominalPeriod(period_s);
+    const double rate_Hz = 1000.0 / getCurrentPollingPeriod();
+    if (rate_Hz != AltitudeAxis->getControlRate())
+        applyControlRate(rate_Hz);
+    LoopModeChange_t loopChange = loopMonitor.update(dt, lastTickExec_s);
+    if (loopChange != LOOP_MODE_UNCHANGED)
+        applyLoopMode(loopChange);
+    statusPollDue = !loopMonitor.isDegraded() || degradedTickCount++ % SLEWDRIVE::DEGRADED_STATUS_DIVISOR == 0;
 
     // This calls ReadScopeStatus()
     INDI::Telescope::TimerHit();
+    serviceSatellitePlanning();
+    serviceSkyGridLoad();
+    serviceKeyholePlanning();
+    serviceFlightRecorder();
 
     if (TelemetryDownsampleNP[0].value >= TraceThisTickCount++)
     {
         TraceThisTick = true;
         TraceThisTickCount = 0;
     }
+    // Property updates and trace logging are suppressed in degraded mode
+    if (!statusPollDue)
+        TraceThisTick = false;
 
     // if(TraceThisTick)
     //     LOGF_TM("TimerHit: [dt: %.6f]", dt);
@@ -1449,6 +2991,7 @@ void LFAST_Mount::TimerHit()
     std::string stateStr = {0};
     INDI::IHorizontalCoordinates altAzTgtPosn{0, 0};
     INDI::IHorizontalCoordinates altAzTgtRate{0, 0};
+    INDI::IHorizontalCoordinates altAzTgtAccel{0, 0};
 
     switch (TrackState)
     {
@@ -1465,6 +3008,7 @@ void LFAST_Mount::TimerHit()
             catch (const std::exception &e)
             {
                 LOGF_ERROR("TimerHit Error (SCOPE_IDLE):  %s", e.what());
+                triggerFlightRecorder(e.what());
             }
         }
         else
@@ -1477,6 +3021,7 @@ void LFAST_Mount::TimerHit()
             catch (const std::exception &e)
             {
                 LOGF_WARN("TimerHit Warning (SCOPE_IDLE):  %s", e.what());
+                triggerFlightRecorder(e.what());
             }
         }
         break;
@@ -1508,6 +3053,7 @@ void LFAST_Mount::TimerHit()
                 catch (const std::exception &e)
                 {
                     LOGF_ERROR("TimerHit Error (MANUAL_SLEW):  %s", e.what());
+                    triggerFlightRecorder(e.what());
                     TrackState = SCOPE_IDLE;
                 }
             }
@@ -1516,15 +3062,20 @@ void LFAST_Mount::TimerHit()
                 m_SkyGuideOffset = {0, 0};
                 try
                 {
-                    altAzTgtPosn = getTrackingTargetAltAzPosition();
+                    {
+                        LFAST_PROFILE_SCOPE(TICK_PHASE_track_target);
+                        altAzTgtPosn = getTrackingTargetAltAzPosition();
+                        applyPointingModel(altAzTgtPosn, nullptr);
+                    }
                     AltitudeAxis->updateTrackCommands(altAzTgtPosn.altitude);
-                    AzimuthAxis->updateTrackCommands(altAzTgtPosn.azimuth);
+                    AzimuthAxis->updateTrackCommands(unwrapAzimuthCommand(altAzTgtPosn.azimuth));
                     AltitudeAxis->updateControlLoops(dt, SLEWING_TO_POSN);
                     AzimuthAxis->updateControlLoops(dt, SLEWING_TO_POSN);
                 }
                 catch (const std::exception &e)
                 {
                     LOGF_ERROR("TimerHit Error (SCOPE_SLEWING):  %s", e.what());
+                    triggerFlightRecorder(e.what());
                     TrackState = SCOPE_IDLE;
                 }
             }
@@ -1538,18 +3089,27 @@ void LFAST_Mount::TimerHit()
         }
         try
         {
-            altAzTgtPosn = getTrackingTargetAltAzPosition();
-            altAzTgtRate = getSiderealTargetAltAzRates();
+            ControlMode_t trackMode = TRACKING_COMMAND;
+            {
+                LFAST_PROFILE_SCOPE(TICK_PHASE_track_target);
+                if (satTrackPhase == SAT_TRACK_WAITING || satTrackPhase == SAT_TRACK_ACTIVE)
+                    trackMode = getSatelliteCommands(altAzTgtPosn, altAzTgtRate, altAzTgtAccel);
+                else
+                    getTrackingTargetCommands(altAzTgtPosn, altAzTgtRate, altAzTgtAccel);
+                applyPointingModel(altAzTgtPosn, &altAzTgtRate);
+            }
             // AltitudeAxis->updateTrackCommands(altAzTgtPosn.altitude);
             // AzimuthAxis->updateTrackCommands(altAzTgtPosn.azimuth);
-            AltitudeAxis->updateTrackCommands(altAzTgtPosn.altitude, altAzTgtRate.altitude);
-            AzimuthAxis->updateTrackCommands(altAzTgtPosn.azimuth, altAzTgtRate.azimuth);
-            AltitudeAxis->updateControlLoops(dt, TRACKING_COMMAND);
-            AzimuthAxis->updateControlLoops(dt, TRACKING_COMMAND);
+            AltitudeAxis->updateTrackCommands(altAzTgtPosn.altitude, altAzTgtRate.altitude, altAzTgtAccel.altitude);
+            AzimuthAxis->updateTrackCommands(unwrapAzimuthCommand(altAzTgtPosn.azimuth), altAzTgtRate.azimuth,
+                                             altAzTgtAccel.azimuth);
+            AltitudeAxis->updateControlLoops(dt, trackMode);
+            AzimuthAxis->updateControlLoops(dt, trackMode);
         }
         catch (const std::exception &e)
         {
             LOGF_ERROR("TimerHit Error (SCOPE_TRACKING):  %s", e.what());
+            triggerFlightRecorder(e.what());
             TrackState = SCOPE_IDLE;
         }
         break;
@@ -1569,6 +3129,7 @@ void LFAST_Mount::TimerHit()
         catch (const std::exception &e)
         {
             LOGF_ERROR("TimerHit Error (SCOPE_PARKING:  %s", e.what());
+            triggerFlightRecorder(e.what());
             TrackState = SCOPE_IDLE;
         }
         break;
@@ -1594,12 +3155,27 @@ void LFAST_Mount::TimerHit()
         break;
     }
 
+    recordTelemetry();
+
     if (TrackState == SCOPE_SLEWING || TrackState == SCOPE_TRACKING)
     {
         if (TraceThisTick)
-            tmLogMountStates();
+        {
+            if (!telemetryWriter)
+                tmLogMountStates();
+            updateDisturbanceEstimate();
+        }
     }
+    if (TICK_PROFILER::ENABLED && TraceThisTick && isConnected())
+        publisher.request(PUB_TICK_PROFILE);
+    if (TraceThisTick && isConnected())
+        publisher.request(PUB_LOOP_TIMING);
     TraceThisTick = false;
+    {
+        LFAST_PROFILE_SCOPE(TICK_PHASE_publish);
+        publisher.flush(astroClock.now().monotonic_s);
+    }
+    lastTickExec_s = AstroClock::steadySeconds() - tickStart_s;
 }
 
 void LFAST_Mount::hexDump(char *buf, const char *data, int size)
@@ -1641,4 +3217,240 @@ void LFAST_Mount::tmLogMountStates()
     // LOGF_TM("POSN ERR: [ALT: %6.4f], [AZ: %6.4f]", altPosnErr, azPosnErr);
     LOGF_TM("RATE CMD: [ALT: %6.4f], [AZ: %6.4f]", AltitudeAxis->getVelocityCommand(), AzimuthAxis->getVelocityCommand());
     LOGF_TM("RATE FB: [ALT: %6.4f], [AZ: %6.4f]", altRateFb, azRateFb);
-}
\ No newline at end of file
+    LOGF_TM("DOB LOAD: [ALT: %8.1f], [AZ: %8.1f]", AltitudeAxis->getDisturbanceEstimate(), AzimuthAxis->getDisturbanceEstimate());
+    LOGF_TM("DOB RATE: [ALT: %6.4f], [AZ: %6.4f]", AltitudeAxis->getDisturbanceCompensation(), AzimuthAxis->getDisturbanceCompensation());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// (Re)starts the telemetry writer in the configured directory.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::startTelemetryRecording()
+{
+    const std::string dir = TelemetryDirTP[0].getText() ? TelemetryDirTP[0].getText() : "";
+    // Flush and close the current files first
+    telemetryWriter.reset();
+    telemetryDropsReported = 0;
+    try
+    {
+        telemetryWriter = std::unique_ptr<TelemetryWriter>(new TelemetryWriter(dir));
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Telemetry recording: %s", e.what());
+        TelemetryRecordSP.reset();
+        TelemetryRecordSP[TELEMETRY_RECORD_OFF].setState(ISS_ON);
+        TelemetryRecordSP.setState(IPS_ALERT);
+        TelemetryRecordSP.apply();
+        return false;
+    }
+    LOGF_INFO("Recording full-rate telemetry to %s.", dir.c_str());
+    TelemetryRecordSP.setState(IPS_OK);
+    TelemetryRecordSP.apply();
+    return true;
+}
+
+void LFAST_Mount::stopTelemetryRecording()
+{
+    if (telemetryWriter)
+    {
+        LOGF_INFO("Telemetry recording stopped: %llu records written, %llu dropped.",
+                  (unsigned long long)telemetryWriter->getWritten(), (unsigned long long)telemetryWriter->getDropped());
+        telemetryWriter.reset();
+    }
+    TelemetryRecordSP.setState(IPS_IDLE);
+    TelemetryRecordSP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::isBusReplay()
+{
+    return BusReplayTP[0].getText() != nullptr && BusReplayTP[0].getText()[0] != '\0';
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Logs the drive traffic to a new file in the telemetry directory, for bus_replay to play back.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::startBusRecording()
+{
+    if (KincoDriver::getRecorder() != nullptr)
+        return true;
+    const std::string dir = TelemetryDirTP[0].getText() ? TelemetryDirTP[0].getText() : "";
+    const std::string path = dir + "/" + BUS_LOG::FILE_PREFIX + telemetryFileStamp(astroClock.now().jd) + BUS_LOG::FILE_SUFFIX;
+    try
+    {
+        KincoDriver::startBusRecording(path);
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Bus recording: %s", e.what());
+        BusRecordSP.setState(IPS_ALERT);
+        BusRecordSP.apply();
+        return false;
+    }
+    LOGF_INFO("Recording drive bus traffic to %s.", path.c_str());
+    BusRecordSP.setState(IPS_OK);
+    BusRecordSP.apply();
+    return true;
+}
+
+void LFAST_Mount::stopBusRecording()
+{
+    const BusRecorder *recorder = KincoDriver::getRecorder();
+    if (recorder != nullptr)
+    {
+        LOGF_INFO("Bus recording stopped: %llu entries written, %llu dropped.",
+                  (unsigned long long)recorder->getWriter().getWritten(),
+                  (unsigned long long)recorder->getWriter().getDropped());
+        KincoDriver::stopBusRecording();
+    }
+    BusRecordSP.setState(IPS_IDLE);
+    BusRecordSP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// (Re)creates the shared-memory feed, sized to hold the configured number of seconds at the
+/// current polling period.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+bool LFAST_Mount::startTelemetryFeed()
+{
+    const double period_s = getCurrentPollingPeriod() / 1000.0;
+    const unsigned records = (unsigned)std::ceil(TelemetryLiveNP[0].getValue() / period_s);
+    telemetryFeed.reset();
+    try
+    {
+        telemetryFeed = std::unique_ptr<TelemetryShmPublisher>(new TelemetryShmPublisher(TELEMETRY::SHM_DEFAULT_NAME, records, period_s));
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Live telemetry: %s", e.what());
+        TelemetryLiveSP.reset();
+        TelemetryLiveSP[TELEMETRY_LIVE_OFF].setState(ISS_ON);
+        TelemetryLiveSP.setState(IPS_ALERT);
+        TelemetryLiveSP.apply();
+        return false;
+    }
+    LOGF_INFO("Publishing the last %.0f s of telemetry in shared memory %s (%u records).",
+              TelemetryLiveNP[0].getValue(), TELEMETRY::SHM_DEFAULT_NAME, records);
+    TelemetryLiveSP.setState(IPS_OK);
+    TelemetryLiveSP.apply();
+    return true;
+}
+
+void LFAST_Mount::stopTelemetryFeed()
+{
+    if (telemetryFeed)
+    {
+        LOGF_INFO("Live telemetry stopped after %llu records.", (unsigned long long)telemetryFeed->getPublished());
+        telemetryFeed.reset();
+    }
+    TelemetryLiveSP.setState(IPS_IDLE);
+    TelemetryLiveSP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Arms a flight recorder dump. The dump is written a couple of seconds later, so it shows the axes
+/// coming to rest; the same fault reported every tick only dumps once.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::triggerFlightRecorder(const std::string &reason)
+{
+    if (flightRecorder.trigger(reason, astroClock.now().monotonic_s))
+    {
+        LOG_INFO("Flight recorder triggered; dumping shortly.");
+        FlightRecorderSP.setState(IPS_BUSY);
+        FlightRecorderSP.apply();
+    }
+}
+
+void LFAST_Mount::serviceFlightRecorder()
+{
+    if (!flightRecorderWrite.valid() || flightRecorderWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    try
+    {
+        LOGF_INFO("Flight recorder: last %.0f s saved to %s.", FLIGHT_RECORDER::HISTORY_SEC,
+                  flightRecorderWrite.get().c_str());
+        FlightRecorderSP.setState(IPS_OK);
+    }
+    catch (const std::exception &e)
+    {
+        LOGF_ERROR("Flight recorder dump failed: %s", e.what());
+        FlightRecorderSP.setState(IPS_ALERT);
+    }
+    FlightRecorderSP.apply();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Keeps this tick's record in the flight recorder and queues it for the files and/or the live
+/// feed. Only reads state the tick has already computed; no bus traffic and no formatting on the
+/// control thread.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void LFAST_Mount::recordTelemetry()
+{
+    LFAST_PROFILE_SCOPE(TICK_PHASE_telemetry);
+    const AstroTimeContext &t = astroClock.now();
+    TelemetryRecord r;
+    r.jd = t.jd;
+    r.monotonic_s = t.monotonic_s;
+    r.dt_s = tickDt_s;
+    r.tick_exec_s = AstroClock::steadySeconds() - tickStart_s;
+    r.track_state = TrackState;
+    r.alt_mode = AltitudeAxis->getControlMode();
+    r.az_mode = AzimuthAxis->getControlMode();
+    r.alt_posn_cmd_deg = AltitudeAxis->getPositionCommand();
+    r.az_posn_cmd_deg = AzimuthAxis->getPositionCommand();
+    r.alt_posn_fb_deg = AltitudeAxis->getPositionState();
+    r.az_posn_fb_deg = AzimuthAxis->getPositionState();
+    r.alt_posn_err_deg = AltitudeAxis->getPositionError();
+    r.az_posn_err_deg = AzimuthAxis->getPositionError();
+    r.alt_rate_cmd_dps = AltitudeAxis->getVelocityCommand();
+    r.az_rate_cmd_dps = AzimuthAxis->getVelocityCommand();
+    r.alt_rate_fb_dps = AltitudeAxis->getVelocityState();
+    r.az_rate_fb_dps = AzimuthAxis->getVelocityState();
+    r.alt_current_a = AltitudeAxis->getCurrentState();
+    r.az_current_a = AzimuthAxis->getCurrentState();
+    r.alt_dob_load_nm = AltitudeAxis->getDisturbanceEstimate();
+    r.az_dob_load_nm = AzimuthAxis->getDisturbanceEstimate();
+    r.alt_dob_comp_dps = AltitudeAxis->getDisturbanceCompensation();
+    r.az_dob_comp_dps = AzimuthAxis->getDisturbanceCompensation();
+    r.alt_drive_a_status = AltitudeAxis->getDriveStatus(false);
+    r.alt_drive_b_status = AltitudeAxis->getDriveStatus(true);
+    r.az_drive_a_status = AzimuthAxis->getDriveStatus(false);
+    r.az_drive_b_status = AzimuthAxis->getDriveStatus(true);
+    static_assert(TM_phase_telemetry_s - TM_phase_timer_hit_s + 1 == NUM_TICK_PHASES, "one telemetry channel per tick phase");
+    for (unsigned p = 0; p < NUM_TICK_PHASES; p++)
+        (&r.phase_timer_hit_s)[p] = tickProfiler().lastTick((TickPhase_t)p);
+    r.loop_degraded = loopMonitor.isDegraded() ? 1 : 0;
+
+    // A dump that comes due while the last one is still being written waits for the next tick. The
+    // writer reads the recorder's ring in place; it isn't reused until the write has finished.
+    if (flightRecorder.record(r) && !flightRecorderWrite.valid())
+    {
+        const std::string dir = TelemetryDirTP[0].getText() ? TelemetryDirTP[0].getText() : "";
+        flightRecorderWrite = std::async(std::launch::async, FlightRecorder::writeDump, dir, std::cref(flightRecorder.takeDump()));
+    }
+    if (telemetryFeed)
+        telemetryFeed->publish(r);
+    if (!telemetryWriter)
+        return;
+    telemetryWriter->push(r);
+
+    // Problems are reported at the trace rate
+    if (TraceThisTick)
+    {
+        uint64_t dropped = telemetryWriter->getDropped();
+        std::string error = telemetryWriter->getError();
+        if (dropped > telemetryDropsReported || !error.empty())
+        {
+            if (dropped > telemetryDropsReported)
+                LOGF_WARN("Telemetry: %llu records dropped (writer behind).", (unsigned long long)(dropped - telemetryDropsReported));
+            if (!error.empty())
+                LOGF_WARN("Telemetry: %s", error.c_str());
+            telemetryDropsReported = dropped;
+            TelemetryRecordSP.setState(IPS_ALERT);
+            TelemetryRecordSP.apply();
+        }
+    }
+}
@@ -11,6 +11,22 @@
 #include "libindi/alignment/DriverCommon.h"
 #include "libindi/alignment/AlignmentSubsystemForDrivers.h"
 #include "slew_drive.h"
+#include "../00_Utils/astro_time.h"
+#include "../00_Utils/apparent_place.h"
+#include "../00_Utils/pointing_model.h"
+#include "../00_Utils/sky_grid.h"
+#include "../00_Utils/keyhole_planner.h"
+#include "../00_Utils/cable_wrap.h"
+#include "../00_Utils/telemetry.h"
+#include "../00_Utils/telemetry_shm.h"
+#include "../00_Utils/flight_recorder.h"
+#include "../00_Utils/tick_profiler.h"
+#include "../00_Utils/loop_monitor.h"
+#include "../00_Utils/publish_throttle.h"
+#include "../00_Utils/tracking_ephemeris.h"
+#include "../00_Utils/satellite_pass.h"
+#include "track_target.h"
+#include <future>
 #include <memory>
 
 #define TM_LOG telemetryLogger
@@ -32,6 +48,197 @@ enum
     AXIS_ALT_VEL = AXIS_ALT + 2
 };
 
+// Track mode added after INDI's standard sidereal/solar/lunar/custom modes
+enum
+{
+    TRACK_PLANET = INDI::Telescope::TRACK_CUSTOM + 1
+};
+
+enum
+{
+    SAT_TLE_LINE1,
+    SAT_TLE_LINE2,
+    NUM_SAT_TLE_FIELDS
+};
+
+enum
+{
+    SAT_TRACK,
+    SAT_HALT,
+    NUM_SAT_TRACK_SWITCHES
+};
+
+enum
+{
+    SAT_PASS_AOS,
+    SAT_PASS_LOS,
+    SAT_PASS_MAX_ALT,
+    SAT_PASS_STATUS,
+    NUM_SAT_PASS_FIELDS
+};
+
+enum
+{
+    KEYHOLE_START,
+    KEYHOLE_END,
+    KEYHOLE_MIN_ZD,
+    KEYHOLE_PREDICTION,
+    NUM_KEYHOLE_FIELDS
+};
+
+enum
+{
+    TELEMETRY_RECORD_ON,
+    TELEMETRY_RECORD_OFF,
+    NUM_TELEMETRY_RECORD_SWITCHES
+};
+
+enum
+{
+    BUS_RECORD_ON,
+    BUS_RECORD_OFF,
+    NUM_BUS_RECORD_SWITCHES
+};
+
+enum
+{
+    TICK_PROFILE_MIN,
+    TICK_PROFILE_MEAN,
+    TICK_PROFILE_P99,
+    NUM_TICK_PROFILE_STATS
+};
+
+enum
+{
+    LOOP_PERIOD_MEAN,
+    LOOP_PERIOD_MAX,
+    LOOP_JITTER_RMS,
+    LOOP_OVERRUNS,
+    LOOP_DEGRADED,
+    // Followed by the period histogram
+    LOOP_HIST_FIRST
+};
+
+// Properties sent through the publish throttle
+enum
+{
+    PUB_EQ,
+    PUB_AZ_ALT,
+    PUB_AZ_WRAP,
+    PUB_DISTURBANCE,
+    PUB_TICK_PROFILE,
+    PUB_LOOP_TIMING,
+    NUM_PUB_CHANNELS
+};
+
+enum
+{
+    PUBLISH_COORDS_RATE,
+    PUBLISH_COORDS_DEADBAND
+};
+
+enum
+{
+    TELEMETRY_LIVE_ON,
+    TELEMETRY_LIVE_OFF,
+    NUM_TELEMETRY_LIVE_SWITCHES
+};
+
+enum
+{
+    AZ_WRAP_ENABLE,
+    AZ_WRAP_DISABLE,
+    NUM_AZ_WRAP_SWITCHES
+};
+
+enum
+{
+    AZ_WRAP_MIN,
+    AZ_WRAP_MAX,
+    AZ_WRAP_TRACK_HOURS,
+    NUM_AZ_WRAP_FIELDS
+};
+
+enum
+{
+    AZ_WRAP_POSN,
+    AZ_WRAP_ROOM_CW,
+    AZ_WRAP_ROOM_CCW,
+    NUM_AZ_WRAP_STATUS_FIELDS
+};
+
+enum
+{
+    APPARENT_PLACE_TEMPERATURE,
+    APPARENT_PLACE_PRESSURE,
+    APPARENT_PLACE_POLAR_X,
+    APPARENT_PLACE_POLAR_Y,
+    NUM_APPARENT_PLACE_FIELDS
+};
+
+enum
+{
+    PM_MODEL_ENABLE,
+    PM_MODEL_DISABLE,
+    NUM_PM_MODEL_SWITCHES
+};
+
+enum
+{
+    PM_SYNC_AXES,
+    PM_SYNC_RECORD,
+    NUM_PM_SYNC_SWITCHES
+};
+
+enum
+{
+    PM_ACTION_FIT,
+    PM_ACTION_CLEAR,
+    NUM_PM_ACTION_SWITCHES
+};
+
+enum
+{
+    SKY_GRID_ENABLE,
+    SKY_GRID_DISABLE,
+    NUM_SKY_GRID_SWITCHES
+};
+
+enum
+{
+    PM_FIT_POINTS,
+    PM_FIT_RMS,
+    NUM_PM_FIT_FIELDS
+};
+
+enum
+{
+    RATE_FILTER_NOTCH1_FREQ,
+    RATE_FILTER_NOTCH1_DEPTH,
+    RATE_FILTER_NOTCH1_WIDTH,
+    RATE_FILTER_NOTCH2_FREQ,
+    RATE_FILTER_NOTCH2_DEPTH,
+    RATE_FILTER_NOTCH2_WIDTH,
+    RATE_FILTER_LPF_FREQ,
+    NUM_RATE_FILTER_FIELDS
+};
+
+enum
+{
+    DOB_BANDWIDTH,
+    DOB_GAIN,
+    NUM_DOB_FIELDS
+};
+
+enum
+{
+    DOB_ALT_TORQUE,
+    DOB_AZ_TORQUE,
+    DOB_ALT_COMP_RATE,
+    DOB_AZ_COMP_RATE,
+    NUM_DOB_ESTIMATE_FIELDS
+};
+
 class LFAST_Mount : public INDI::Telescope,
                     public INDI::GuiderInterface,
                     public INDI::AlignmentSubsystem::AlignmentSubsystemForDrivers
@@ -102,6 +309,12 @@ protected:
     ///////////////////////////////////////////////////////////////////////////////
     virtual bool updateLocation(double latitude, double longitude, double elevation) override;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Tracking modes and rates
+    ///////////////////////////////////////////////////////////////////////////////
+    virtual bool SetTrackMode(uint8_t mode) override;
+    virtual bool SetTrackRate(double raRate, double deRate) override;
+
     ///////////////////////////////////////////////////////////////////////////////
     /// Parking commands
     ///////////////////////////////////////////////////////////////////////////////
@@ -128,6 +341,20 @@ protected:
     void hexDump(char *buf, const char *data, int size);
     // void logfTelemetry(const char* format, ...);
     void tmLogMountStates();
+    bool startTelemetryRecording();
+    void stopTelemetryRecording();
+    bool isBusReplay();
+    bool startBusRecording();
+    void stopBusRecording();
+    bool startTelemetryFeed();
+    void stopTelemetryFeed();
+    void recordTelemetry();
+    void triggerFlightRecorder(const std::string &reason);
+    void serviceFlightRecorder();
+    void publishTickProfile();
+    void applyLoopMode(LoopModeChange_t change);
+    void publishLoopTiming();
+    void applyPublishLimits();
     virtual bool saveConfigItems(FILE *fp) override;
     virtual void ISGetProperties(const char *dev) override;
 
@@ -135,9 +362,17 @@ private:
     unsigned int TM_LOG{0};
 
     TelescopeStatus PrevTrackState{SCOPE_IDLE};
+
+    // Time base for the tick. Everything in a tick reads astroClock.now(); TimerHit and the INDI
+    // entry points (goto, sync, ...) call refreshAstroTime() first.
+    AstroClock astroClock;
+    // Equinox-of-date RA/Dec <-> observed alt/az for the control thread. The ephemeris sampler
+    // works on its own copy.
+    ApparentPlace apparentPlace;
     
     std::unique_ptr<SlewDrive> AltitudeAxis;
     std::unique_ptr<SlewDrive> AzimuthAxis;
+    std::unique_ptr<TrackingEphemeris> trackingEphemeris;
 
     // Tracking
     INDI::IEquatorialCoordinates m_SkyTrackingTarget{0, 0};
@@ -145,9 +380,87 @@ private:
     INDI::IEquatorialCoordinates m_EqSkyGuideDelta{0, 0};
     INDI::IEquatorialCoordinates m_SkyCurrentRADE{0, 0};
     INDI::IHorizontalCoordinates m_MountAltAz{0, 0};
+    // Axis feedback as read this tick, before any alignment rotation
+    INDI::IHorizontalCoordinates m_AxisPosnFb{0, 0};
+    INDI::IHorizontalCoordinates m_AxisRateFb{0, 0};
+    TrackTarget m_TrackTarget;
+    // Last position taken from the ephemeris, or where the target was when tracking (re)started
+    // until the ephemeris has been filled
+    INDI::IEquatorialCoordinates m_TrackTargetRADec{0, 0};
+    uint8_t m_TrackMode{TRACK_SIDEREAL};
+    double m_CustomRaRate_arcsecps{TRACKRATE_SIDEREAL};
+    double m_CustomDecRate_arcsecps{0.0};
+
+    // Satellite tracking. The pass is planned on a worker thread (satellitePassPlan) and then
+    // followed from the table, pre-positioned at the AOS point until the pass starts.
+    typedef enum
+    {
+        SAT_TRACK_OFF,
+        SAT_TRACK_PLANNING,
+        SAT_TRACK_WAITING,
+        SAT_TRACK_ACTIVE
+    } SatTrackPhase_t;
+    std::unique_ptr<SGP4Propagator> satellitePropagator;
+    std::future<SatellitePass> satellitePassPlan;
+    SatellitePass satellitePass;
+    SatTrackPhase_t satTrackPhase{SAT_TRACK_OFF};
+
+    // Zenith keyhole. Planned on a worker from a copy of the ephemeris sampler (trackingSampler),
+    // then the azimuth follows the plan's bounded-rate transit in place of the target. Plans made
+    // for an earlier target (keyholeGeneration) are dropped.
+    TrackingEphemeris::Sampler trackingSampler;
+    KeyholePlan keyholePlan;
+    std::future<KeyholePlan> keyholePlanning;
+    unsigned keyholeGeneration{0};
+    unsigned keyholePlanningGeneration{0};
+    double keyholeReplanJd{0};
+
+    // Azimuth cable wrap. When enabled the azimuth axis is commanded in unwrapped (multi-turn)
+    // position: a goto picks the turn, then each command is the copy of the target azimuth nearest
+    // the previous one (azCommandUnwrapped). The reference is dropped when the encoder zero moves.
+    CableWrap cableWrap;
+    bool azWrapEnabled{false};
+    double azCommandUnwrapped{0};
+    bool azCommandUnwrappedValid{false};
+
+    // Pointing model. When enabled it replaces the alignment subsystem: sky alt/az commands go
+    // through it to the axes, and the encoder positions come back through its inverse.
+    PointingModel pointingModel;
+    std::vector<PointingObservation> pointingObservations;
+    bool pointingModelEnabled{false};
+    // Optional correction grid on top of the model. Grids are mapped and checked on a worker
+    // (skyGridLoad) and swapped in between ticks by serviceSkyGridLoad(). The grid it replaces is
+    // unmapped and closed on another worker (skyGridRelease).
+    std::unique_ptr<SkyGrid> skyGrid;
+    std::future<std::unique_ptr<SkyGrid>> skyGridLoad;
+    std::future<void> skyGridRelease;
+    bool skyGridEnabled{false};
 
     // INDI::IHorizontalCoordinates m_HzSkyGuideRate{0, 0};
 
+    // Full-rate binary telemetry, one record per tick. Replaces the text trace while recording.
+    std::unique_ptr<TelemetryWriter> telemetryWriter;
+    uint64_t telemetryDropsReported{0};
+    // The newest records in shared memory, for local plotters
+    std::unique_ptr<TelemetryShmPublisher> telemetryFeed;
+    // Always on; dumped to the telemetry directory on faults and aborts
+    FlightRecorder flightRecorder;
+    std::future<std::string> flightRecorderWrite;
+    // Tick period and overrun monitoring. In degraded mode only every
+    // DEGRADED_STATUS_DIVISOR'th tick transforms and publishes the mount coordinates
+    // (statusPollDue). The axis feedback is still read every tick for the control loops.
+    LoopMonitor loopMonitor;
+    unsigned degradedTickCount{0};
+    bool statusPollDue{true};
+    double lastTickExec_s{0};
+    // Steady clock at the start of the last tick, and the interval the tick ran with. Only
+    // TimerHit sets these; INDI requests rebuild the time context between ticks.
+    double tickStart_s{0};
+    double tickDt_s{0};
+    // Rate limits and deadbands for the frequently updated properties, flushed at the end of each
+    // tick after the drive commands have gone out
+    PublishThrottle publisher;
+
     // Tracing in timer tick
     int TraceThisTickCount{0};
     bool TraceThisTick{false};
@@ -161,6 +474,8 @@ private:
     // static constexpr const char *DetailedMountInfoPage { "Detailed Mount Information" };
 
     INDI::PropertyText ModbusCommPortTP{1};
+    // A bus log to replay in place of the drives; empty for the real bus
+    INDI::PropertyText BusReplayTP{1};
     // INDI::PropertyText NtpServerTP{1};
     INDI::PropertyNumber AzAltCoordsNP{4};
     // INDI::PropertySwitch MountSlewRateSP{LFAST::NUM_SLEW_SPEEDS};
@@ -176,6 +491,45 @@ private:
     bool azHomingComplete;
 
     INDI::PropertyNumber TelemetryDownsampleNP{1};
+    INDI::PropertySwitch TelemetryRecordSP{NUM_TELEMETRY_RECORD_SWITCHES};
+    INDI::PropertyText TelemetryDirTP{1};
+    INDI::PropertySwitch TelemetryLiveSP{NUM_TELEMETRY_LIVE_SWITCHES};
+    INDI::PropertyNumber TelemetryLiveNP{1};
+    INDI::PropertySwitch FlightRecorderSP{1};
+    INDI::PropertySwitch BusRecordSP{NUM_BUS_RECORD_SWITCHES};
+    INDI::PropertyNumber PublishLimitsNP{2};
+    // Min, mean and p99 of each tick phase; only defined when built with LFAST_PROFILING
+    INDI::PropertyNumber TickProfileNP{NUM_TICK_PHASES * NUM_TICK_PROFILE_STATS};
+    INDI::PropertyNumber LoopTimingNP{LOOP_HIST_FIRST + LOOP_MONITOR::NUM_BINS};
+    INDI::PropertyNumber ApparentPlaceNP{NUM_APPARENT_PLACE_FIELDS};
+
+    static constexpr const char *CONTROL_LOOP_TAB{"Control Loop"};
+    INDI::PropertyNumber AltRateFilterNP{NUM_RATE_FILTER_FIELDS};
+    INDI::PropertyNumber AzRateFilterNP{NUM_RATE_FILTER_FIELDS};
+    INDI::PropertyNumber DisturbanceObserverNP{NUM_DOB_FIELDS};
+    INDI::PropertyNumber DisturbanceEstimateNP{NUM_DOB_ESTIMATE_FIELDS};
+
+    static constexpr const char *SATELLITE_TAB{"Satellite"};
+    INDI::PropertyText SatelliteTLETP{NUM_SAT_TLE_FIELDS};
+    INDI::PropertySwitch SatelliteTrackSP{NUM_SAT_TRACK_SWITCHES};
+    INDI::PropertyText SatellitePassTP{NUM_SAT_PASS_FIELDS};
+
+    INDI::PropertyNumber KeyholeToleranceNP{1};
+    INDI::PropertyText KeyholeTP{NUM_KEYHOLE_FIELDS};
+
+    INDI::PropertySwitch AzWrapSP{NUM_AZ_WRAP_SWITCHES};
+    INDI::PropertyNumber AzWrapNP{NUM_AZ_WRAP_FIELDS};
+    INDI::PropertyNumber AzWrapStatusNP{NUM_AZ_WRAP_STATUS_FIELDS};
+
+    static constexpr const char *POINTING_TAB{"Pointing Model"};
+    INDI::PropertySwitch PointingModelSP{NUM_PM_MODEL_SWITCHES};
+    INDI::PropertySwitch PointingSyncSP{NUM_PM_SYNC_SWITCHES};
+    INDI::PropertySwitch PointingActionSP{NUM_PM_ACTION_SWITCHES};
+    INDI::PropertyNumber PointingTermsNP{NUM_POINTING_TERMS};
+    INDI::PropertyNumber PointingFitNP{NUM_PM_FIT_FIELDS};
+    INDI::PropertyText PointingFileTP{1};
+    INDI::PropertySwitch SkyGridSP{NUM_SKY_GRID_SWITCHES};
+    INDI::PropertyText SkyGridTP{1};
 
     enum
     {
@@ -205,12 +559,46 @@ private:
     ///////////////////////////////////////////////////////////////////////////////
     /// Helper Functions
     ///////////////////////////////////////////////////////////////////////////////
+    const AstroTimeContext &refreshAstroTime();
+    void applyApparentPlaceSettings();
+    void applyPointingModel(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates *rate);
+    bool recordPointingObservation(const PointingObservation &obs);
+    bool fitPointingModel();
+    void clearPointingObservations();
+    void removePointingModel(const INDI::IHorizontalCoordinates &mount, INDI::IHorizontalCoordinates &sky);
+    bool startSkyGridLoad();
+    void serviceSkyGridLoad();
+    void releaseSkyGrid();
     INDI::IHorizontalCoordinates getTrackingTargetAltAzPosition();
-    INDI::IHorizontalCoordinates getSiderealTargetAltAzRates();
+    bool readAxisFeedback();
     bool updatePointingCoordinates();
-    INDI::IHorizontalCoordinates getHorizontalRates();
+    void getHorizontalRates(INDI::IHorizontalCoordinates &rate, INDI::IHorizontalCoordinates &accel);
+    void restartTrackingEphemeris(const INDI::IGeographicCoordinates &location);
+    TrackTarget makeTrackTarget(double jd0);
+    void retargetCurrentPosition();
+    INDI::IEquatorialCoordinates getTrackingTargetRADec();
+    void getTrackingTargetCommands(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates &rate,
+                                   INDI::IHorizontalCoordinates &accel);
     double GetSlewRate();
     bool startHomingRoutine();
+    void initRateFilterProperty(INDI::PropertyNumber &filterNP, const char *propName, const char *propLabel);
+    void limitRateFilterProperty(INDI::PropertyNumber &filterNP, double nyquist_Hz);
+    void applyControlRate(double rate_Hz);
+    bool applyRateFilterSettings(SlewDrive *axis, INDI::PropertyNumber &filterNP);
+    bool applyDisturbanceObserverSettings();
+    void updateDisturbanceEstimate();
+    bool loadSatelliteTLE();
+    bool startSatelliteTracking();
+    void stopSatelliteTracking(const char *status, IPState state = IPS_IDLE);
+    void serviceSatellitePlanning();
+    ControlMode_t getSatelliteCommands(INDI::IHorizontalCoordinates &posn, INDI::IHorizontalCoordinates &rate,
+                                       INDI::IHorizontalCoordinates &accel);
+    void setSatellitePassStatus(const char *status, IPState state);
+    void serviceKeyholePlanning();
+    void publishKeyholePlan(bool announce);
+    double unwrapAzimuthCommand(double az);
+    double planAzimuthGoto(const INDI::IHorizontalCoordinates &target);
+    void publishCableWrapStatus();
 };
 
 const std::string getDirString(INDI_DIR_NS dir)
@@ -14,6 +14,29 @@ namespace LFAST_CONSTANTS
     constexpr double SiderealRate_degpersec = (360.0 / SECONDS_PER_DAY) * EARTH_ROTATIONS_PER_UT1_DAY;
     // const double SiderealRate_radpersec = (0.000072921); //(15.041067 / 3600.0 * M_PI / 180.0)
     // #define SIDEREAL_RATE_DPS 0.004166667
+    constexpr double SiderealRate_arcsecpersec = SiderealRate_degpersec * 3600.0;
+
+    // Planetary tracking locks onto the nearest planet within this distance of the goto position
+    constexpr double PLANET_MATCH_RADIUS_DEG = 2.0;
+    constexpr double KM_PER_AU = 149597870.7;
+
+    // Pointing model fits: the basic geometric terms need at least this many points, and the
+    // full model (flexure and encoder centering too) this many
+    constexpr unsigned POINTING_BASIC_MIN_POINTS = 4;
+    constexpr unsigned POINTING_FULL_MIN_POINTS = 20;
+
+    // Full-rate binary telemetry goes here unless configured otherwise
+    constexpr const char *TELEMETRY_DEFAULT_DIR = "/tmp/lfast_telemetry";
+    // Length of the shared-memory live feed
+    constexpr double TELEMETRY_LIVE_DEFAULT_SEC = 60.0;
+
+    // Client updates (see PublishThrottle): the pointing coordinates go out at most this often,
+    // once they've moved by the deadband, and the statistics properties once a second. At most
+    // PUBLISH_MAX_PER_TICK properties are sent per tick, apart from state changes.
+    constexpr double PUBLISH_COORDS_DEFAULT_RATE_HZ = 5.0;
+    constexpr double PUBLISH_COORDS_DEFAULT_DEADBAND_ARCSEC = 0.1;
+    constexpr double PUBLISH_STATS_RATE_HZ = 1.0;
+    constexpr unsigned PUBLISH_MAX_PER_TICK = 2;
 
     const double slewspeeds[] = {1.0, 10.0, 25.0, 50.0, 100.0, 200.0, 300, 400.0};
     constexpr unsigned int NUM_SLEW_SPEEDS = sizeof(slewspeeds) / sizeof(double);
@@ -37,7 +60,21 @@ namespace SLEWDRIVE
     const double SLEW_POSN_KP = 0.6;
     const double SLEW_POSN_KI = 0.01;
     const double SLEW_POSN_KD = 0.0;
+    // Back-calculation anti-windup gain (1/s). Tracking time constant equal to the integral time
+    // (Kb = Ki/Kp) holds the integrator at the rate limit while the rate command is clamped.
+    const double SLEW_POSN_KB = SLEW_POSN_KI / SLEW_POSN_KP;
 
+    // Control loop timing (TimerHit polling period)
+    const unsigned int CONTROL_LOOP_PERIOD_MS = 20;
+    constexpr double CONTROL_LOOP_RATE_HZ = 1000.0 / CONTROL_LOOP_PERIOD_MS;
+    // Degraded mode, when ticks keep overrunning (see LoopMonitor): the mount coordinates are
+    // transformed and published every Nth tick, and slews are capped at this multiple of sidereal
+    const unsigned DEGRADED_STATUS_DIVISOR = 5;
+    constexpr double DEGRADED_MAX_SLEW_MULT = 100.0;
+
+    // Rate command shaping filter defaults (a frequency of zero bypasses the stage)
+    const double RATE_NOTCH_DEFAULT_DEPTH_DB = 20.0;
+    const double RATE_NOTCH_DEFAULT_WIDTH_HZ = 1.0;
 
 
     const unsigned int GEAR_BOX_RATIO = 60;
@@ -59,6 +96,52 @@ namespace SLEWDRIVE
 
     constexpr double max_slew_multiplier = SLEW_DRIVE_MAX_SPEED_DPS / LFAST_CONSTANTS::SiderealRate_degpersec;
 
+    ///////////////////////////////////////////////////////////
+    /// AXIS PLANT MODEL (DISTURBANCE OBSERVER)
+    /// Placeholder values until the axes have been identified.
+    ///////////////////////////////////////////////////////////
+    constexpr double MOTOR_TORQUE_CONSTANT_NM_PER_A = 0.64;
+    constexpr double GEAR_TRAIN_EFFICIENCY = 0.6;
+    constexpr double AXIS_TORQUE_PER_AMP_NM = MOTOR_TORQUE_CONSTANT_NM_PER_A * TOTAL_GEAR_RATIO * GEAR_TRAIN_EFFICIENCY;
+    constexpr double AXIS_INERTIA_NM_PER_DPS2 = 10.0;
+    constexpr double AXIS_DAMPING_NM_PER_DPS = 50.0;
+    constexpr double RATE_LOOP_STIFFNESS_NM_PER_DPS = 2.0e5;
+
+    // Observer defaults (zero bandwidth disables it) and the most rate it's allowed to add
+    constexpr double DOB_DEFAULT_BANDWIDTH_HZ = 0.0;
+    constexpr double DOB_DEFAULT_GAIN = 1.0;
+    constexpr double DOB_MAX_COMPENSATION_DPS = 20.0 * LFAST_CONSTANTS::SiderealRate_degpersec;
+
+    ///////////////////////////////////////////////////////////
+    /// SATELLITE TRACKING
+    ///////////////////////////////////////////////////////////
+    // Passes are followed between these altitudes (the upper one matches the goto check)
+    constexpr double SATELLITE_MIN_ALT_DEG = 10.0;
+    constexpr double SATELLITE_MAX_ALT_DEG = 90.0;
+    // Fraction of the top speed a pass may need, leaving the rest for the position loop
+    constexpr double SATELLITE_RATE_MARGIN = 0.9;
+    // SGP4 predictions drift by a few km per day from the element set epoch
+    constexpr double SATELLITE_TLE_MAX_AGE_DAYS = 7.0;
+
+    ///////////////////////////////////////////////////////////
+    /// ZENITH KEYHOLE
+    ///////////////////////////////////////////////////////////
+    // Fraction of the top speed the azimuth may turn at through a keyhole transit
+    constexpr double KEYHOLE_RATE_MARGIN = 0.9;
+    constexpr double KEYHOLE_DEFAULT_TOLERANCE_ARCSEC = 5.0;
+    // The keyhole planner looks ahead KEYHOLE::LOOKAHEAD_SEC, so replanning this often while
+    // tracking always finds a transit well before it starts
+    constexpr double KEYHOLE_REPLAN_PERIOD_SEC = 600.0;
+
+    ///////////////////////////////////////////////////////////
+    /// AZIMUTH CABLE WRAP
+    ///////////////////////////////////////////////////////////
+    // Soft limits on the unwrapped azimuth, measured from the synced/homed zero
+    constexpr double AZ_WRAP_DEFAULT_MIN_DEG = -270.0;
+    constexpr double AZ_WRAP_DEFAULT_MAX_DEG = 270.0;
+    // How long a goto should leave room to track the target for
+    constexpr double AZ_WRAP_DEFAULT_TRACK_HOURS = 2.0;
+
     ///////////////////////////////////////////////////////////
     /// SLEW ALIGNMENT ROUTINE STEP DEFINITIONS 
     ///////////////////////////////////////////////////////////
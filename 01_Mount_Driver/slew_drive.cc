@@ -8,6 +8,7 @@
 #include "../00_Utils/math_util.h"
 #include "../00_Utils/PID_Controller.h"
 #include "../00_Utils/KincoDriver.h"
+#include "../00_Utils/tick_profiler.h"
 
 /////////////////////////////////////////////////////////////////////////
 ////////////////////// PUBLIC MEMBER FUNCTIONS //////////////////////////
@@ -28,14 +29,26 @@ SlewDrive::SlewDrive(const char *label, unsigned DriveA_ID, unsigned DriveB_ID,
     // Initialize state variables
     isEnabled = false;
     simModeEnabled = simMode;
+    busMarkId = (uint8_t)DriveA_ID;
 
     positionFeedback_deg = 0.0;
     positionCommand_deg = 0.0;
     positionOffset_deg = 0.0;
     rateCommandFeedforward_dps = 0.0;
+    accelCommandFeedforward_dps2 = 0.0;
     rateFeedback_dps = 0.0;
     rateRef_dps = 0.0;
     combinedRateCmdSaturated_dps = 0.0;
+    filteredRateCmd_dps = 0.0;
+    motorCurrent_A = 0.0;
+    disturbanceCompensation_dps = 0.0;
+    disturbanceGain = SLEWDRIVE::DOB_DEFAULT_GAIN;
+    simDisturbance_Nm = 0.0;
+    simPrevRateCmd_dps = 0.0;
+    controlRate_Hz = SLEWDRIVE::CONTROL_LOOP_RATE_HZ;
+    prevMode = SLEWING_TO_POSN;
+    controlLoopsActive = false;
+    wrapPositionError = true;
     homingRoutineStatus = HOMING_IDLE;
     // if (simModeEnabled)
     // {
@@ -44,13 +57,23 @@ SlewDrive::SlewDrive(const char *label, unsigned DriveA_ID, unsigned DriveB_ID,
             SLEWDRIVE::SLEW_POSN_KP,
             SLEWDRIVE::SLEW_POSN_KI,
             SLEWDRIVE::SLEW_POSN_KD));
+    pid->configureAntiWindup(SLEWDRIVE::SLEW_POSN_KB);
     // }
 
-    driveModelPtr = std::unique_ptr<DF2_IIR<double>>(
-        new DF2_IIR<double>(
+    driveModelPtr = std::unique_ptr<DF2_IIR<double, 2>>(
+        new DF2_IIR<double, 2>(
             DIGITAL_CONTROL::lpf_3_b,
-            DIGITAL_CONTROL::lpf_3_a,
-            2));
+            DIGITAL_CONTROL::lpf_3_a));
+
+    rateCmdFilterPtr = std::unique_ptr<BiquadCascade>(
+        new BiquadCascade(NUM_RATE_FILTER_STAGES));
+
+    DIGITAL_CONTROL::AxisPlantModel plant{SLEWDRIVE::AXIS_TORQUE_PER_AMP_NM,
+                                          SLEWDRIVE::AXIS_INERTIA_NM_PER_DPS2,
+                                          SLEWDRIVE::AXIS_DAMPING_NM_PER_DPS,
+                                          SLEWDRIVE::RATE_LOOP_STIFFNESS_NM_PER_DPS};
+    dobPtr = std::unique_ptr<DisturbanceObserver>(new DisturbanceObserver(plant));
+    dobPtr->setBandwidth(SLEWDRIVE::DOB_DEFAULT_BANDWIDTH_HZ);
 
     pDriveA = std::unique_ptr<KincoDriver>(new KincoDriver(DriveA_ID));
     pDriveB = std::unique_ptr<KincoDriver>(new KincoDriver(DriveB_ID));    
@@ -67,6 +90,12 @@ bool SlewDrive::initializeDriverBus(const char *devPath)
     return KincoDriver::rtuIsActive();
 }
 
+bool SlewDrive::initializeDriverReplay(const char *logPath)
+{
+    KincoDriver::initializeReplay(logPath);
+    return KincoDriver::rtuIsActive();
+}
+
 bool SlewDrive::connectToDrivers()
 {
     bool result;
@@ -116,19 +145,26 @@ void SlewDrive::initializeStates()
     positionFeedback_deg = 0.0;
     positionCommand_deg = 0.0;
     rateCommandFeedforward_dps = 0.0;
+    accelCommandFeedforward_dps2 = 0.0;
     rateFeedback_dps = 0.0;
     rateRef_dps = 0.0;
     combinedRateCmdSaturated_dps = 0.0;
+    filteredRateCmd_dps = 0.0;
     posnError = 0.0;
     rateError = 0.0;
+    rateCmdFilterPtr->reset();
+    dobPtr->reset();
+    disturbanceCompensation_dps = 0.0;
+    controlLoopsActive = false;
 }
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
-void SlewDrive::updateTrackCommands(double pcmd, double rcmd)
+void SlewDrive::updateTrackCommands(double pcmd, double rcmd, double acmd)
 {
     positionCommand_deg = pcmd;
     rateCommandFeedforward_dps = rcmd;
+    accelCommandFeedforward_dps2 = acmd;
     // delete pid;
 }
 
@@ -139,12 +175,18 @@ void SlewDrive::abortSlew()
 {
     positionCommand_deg = positionFeedback_deg;
     rateRef_dps = 0.0;
+    controlLoopsActive = false;
     rateCommandFeedforward_dps = 0.0;
+    accelCommandFeedforward_dps2 = 0.0;
     if(simModeEnabled)
     {
         positionCommand_deg = positionFeedback_deg;
         posnError = 0;
         combinedRateCmdSaturated_dps = 0.0;
+        filteredRateCmd_dps = 0.0;
+        rateCmdFilterPtr->reset();
+        dobPtr->reset();
+        disturbanceCompensation_dps = 0.0;
         rateError = 0;
         return;
     }
@@ -170,8 +212,14 @@ void SlewDrive::slowStop()
 {
     manualRateCommand_dps = 0.0;
     combinedRateCmdSaturated_dps = 0.0;
+    filteredRateCmd_dps = 0.0;
+    rateCmdFilterPtr->reset();
+    dobPtr->reset();
+    disturbanceCompensation_dps = 0.0;
     rateCommandFeedforward_dps = 0.0;
+    accelCommandFeedforward_dps2 = 0.0;
     rateRef_dps = 0.0;
+    controlLoopsActive = false;
     if (!drvAConnected || !drvBConnected)
         return;
 
@@ -222,7 +270,9 @@ void SlewDrive::checkDriveStatus()
 void SlewDrive::syncPosition(double sync_posn)
 {
     pid->reset();
+    controlLoopsActive = false;
     rateCommandFeedforward_dps = 0.0;
+    accelCommandFeedforward_dps2 = 0.0;
     positionOffset_deg = 0.0;
     if (!simModeEnabled)
     {
@@ -255,7 +305,7 @@ bool SlewDrive::isSlewComplete()
 void SlewDrive::updateSlewRate(double slewRate)
 {
     rateLim = slewRate;
-    pid->configureOutputSaturation(-1 * rateLim, rateLim);
+    pid->configureOutputSaturation(rateLim, -1 * rateLim);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -264,6 +314,7 @@ void SlewDrive::updateSlewRate(double slewRate)
 void SlewDrive::updateRateOffset(double rate)
 {
     rateCommandFeedforward_dps = rate;
+    accelCommandFeedforward_dps2 = 0.0;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -339,6 +390,8 @@ void SlewDrive::updatePositionError()
 {
 
     posnError = positionCommand_deg - positionFeedback_deg;
+    if (!wrapPositionError)
+        return;
     int errSign = sign(posnError);
     while (std::abs(posnError) > 180.0)
     {
@@ -350,12 +403,28 @@ void SlewDrive::updatePositionError()
 //////////////////////////////////////////////////////////////////////////////////////////////////
 void SlewDrive::updateControlLoops(double dt, ControlMode_t mode)
 {
+    LFAST_PROFILE_SCOPE(TICK_PHASE_control_loops);
     if (homingRoutineStatus != HOMING_IDLE)
     {
         throw std::runtime_error("updateControlLoops called while homing");
     }
+    if (!simModeEnabled && KincoDriver::isReplayingBus())
+        replayBusInputs(dt, mode);
+    else if (!simModeEnabled && KincoDriver::getRecorder() != nullptr)
+        recordBusInputs(dt, mode);
     updatePositionError();
 
+    // Handle mode changes before the PID runs so it starts this tick from the right state
+    if (!controlLoopsActive)
+    {
+        pid->reset();
+    }
+    else if (mode != prevMode)
+    {
+        transferControlMode(mode);
+    }
+    prevMode = mode;
+    controlLoopsActive = true;
 
     if (std::abs(posnError) < SLEWDRIVE::POSN_PID_ENABLE_THRESH_DEG)
     {
@@ -367,11 +436,7 @@ void SlewDrive::updateControlLoops(double dt, ControlMode_t mode)
     }
 
     double combinedRateCmd_dps{0};
-    static ControlMode_t prevMode = SLEWING_TO_POSN;
-    if (mode != prevMode)
-    {
-        pid->reset();
-    }
+    updateDisturbanceCompensation(dt, mode);
 
     if (mode == SLEWING_TO_POSN)
     {
@@ -383,14 +448,23 @@ void SlewDrive::updateControlLoops(double dt, ControlMode_t mode)
     }
     else if (mode == TRACKING_COMMAND)
     {
-        combinedRateCmd_dps = saturate(rateRef_dps, -1 * rateLim, rateLim) + rateCommandFeedforward_dps;
+        // The drive holds this rate until the next tick, so feed forward the rate at the middle of
+        // the interval rather than at its start
+        double feedforward_dps = rateCommandFeedforward_dps + 0.5 * dt * accelCommandFeedforward_dps2;
+        combinedRateCmd_dps = saturate(rateRef_dps, -1 * rateLim, rateLim) + feedforward_dps +
+                              disturbanceCompensation_dps;
     }
 
     combinedRateCmdSaturated_dps = saturate(combinedRateCmd_dps,
                                             -1 * SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS,
                                             SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS);
 
-    double motorVelCommand_RPM = mapSlewDriveCommandToMotors(combinedRateCmdSaturated_dps);
+    // Shape the command to keep it from exciting structural resonances
+    filteredRateCmd_dps = saturate(rateCmdFilterPtr->update(combinedRateCmdSaturated_dps),
+                                   -1 * SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS,
+                                   SLEWDRIVE::SLEW_DRIVE_MAX_SPEED_DPS);
+
+    double motorVelCommand_RPM = mapSlewDriveCommandToMotors(filteredRateCmd_dps);
 
     if (!simModeEnabled)
     {
@@ -402,6 +476,7 @@ void SlewDrive::updateControlLoops(double dt, ControlMode_t mode)
         {
             try
             {
+                LFAST_PROFILE_SCOPE(TICK_PHASE_drive_command);
                 pDriveA->updateVelocityCommand(motorVelCommand_RPM);
                 pDriveB->updateVelocityCommand(motorVelCommand_RPM);
             }
@@ -422,6 +497,187 @@ void SlewDrive::updateControlLoops(double dt, ControlMode_t mode)
     }
 }
 
+// Inputs to a control update, kept in a bus log mark for each tick
+constexpr unsigned NUM_BUS_INPUTS = 10;
+static_assert(NUM_BUS_INPUTS <= BUS_LOG::MAX_MARK_VALUES, "Too many inputs for a mark");
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::packBusInputs(double dt, ControlMode_t mode, double *inputs) const
+{
+    inputs[0] = (double)mode;
+    inputs[1] = dt;
+    inputs[2] = positionCommand_deg;
+    inputs[3] = rateCommandFeedforward_dps;
+    inputs[4] = accelCommandFeedforward_dps2;
+    inputs[5] = manualRateCommand_dps;
+    inputs[6] = rateLim;
+    inputs[7] = positionOffset_deg;
+    inputs[8] = isEnabled ? 1.0 : 0.0;
+    inputs[9] = wrapPositionError ? 1.0 : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Put the inputs to this tick's control update in the bus log alongside the traffic, for a
+/// replay to take them from. The mark gets a copy, so recording can't change them.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::recordBusInputs(double dt, ControlMode_t mode) const
+{
+    double inputs[NUM_BUS_INPUTS];
+    packBusInputs(dt, mode, inputs);
+    KincoDriver::markBus(BUS_LOG::MARK_AXIS_INPUTS, busMarkId, inputs, NUM_BUS_INPUTS);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Only while the bus is a replay: the inputs come back as recorded, so the loops see the same
+/// commands they did on the night even though the targets here were worked out from today's
+/// clock.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::replayBusInputs(double &dt, ControlMode_t &mode)
+{
+    double inputs[NUM_BUS_INPUTS];
+    packBusInputs(dt, mode, inputs);
+    KincoDriver::markBus(BUS_LOG::MARK_AXIS_INPUTS, busMarkId, inputs, NUM_BUS_INPUTS);
+
+    mode = (ControlMode_t)(int)inputs[0];
+    dt = inputs[1];
+    positionCommand_deg = inputs[2];
+    rateCommandFeedforward_dps = inputs[3];
+    accelCommandFeedforward_dps2 = inputs[4];
+    manualRateCommand_dps = inputs[5];
+    if (inputs[6] != rateLim)
+        updateSlewRate(inputs[6]);
+    positionOffset_deg = inputs[7];
+    isEnabled = inputs[8] != 0.0;
+    wrapPositionError = inputs[9] != 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Set up the PID for a change of control mode.
+/// - Slew to track: the integrator only holds windup from the approach, and the feedforward now
+///   carries the target rate, so the integrator starts from zero. The proportional path is
+///   continuous, so the only change in command is the feedforward itself.
+/// - Track to slew: the feedforward drops out, so the integrator is preloaded with the rate that
+///   was being commanded (bumpless) and anti-windup bleeds it off if the new target is far away.
+/// - Anything else (manual slew, or outside the PID's range) starts the PID from scratch.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::transferControlMode(ControlMode_t newMode)
+{
+    bool pidInRange = std::abs(posnError) < SLEWDRIVE::POSN_PID_ENABLE_THRESH_DEG;
+    if (pidInRange && prevMode == TRACKING_COMMAND && newMode == SLEWING_TO_POSN)
+    {
+        double pidCmd_dps = saturate(combinedRateCmdSaturated_dps, -1 * rateLim, rateLim);
+        pid->initializeIntegrator(pidCmd_dps, posnError);
+    }
+    else
+    {
+        pid->reset();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Run the disturbance observer against the rate command that was sent on the previous tick
+/// (that's what the measured current is responding to). The compensating rate is only applied
+/// while tracking. In the other modes the observer is held in reset so it doesn't carry slew
+/// transients into tracking.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::updateDisturbanceCompensation(double dt, ControlMode_t mode)
+{
+    if (mode != TRACKING_COMMAND || !dobPtr->isEnabled())
+    {
+        dobPtr->reset();
+        disturbanceCompensation_dps = 0.0;
+        return;
+    }
+
+    motorCurrent_A = getCurrentFeedback();
+    dobPtr->update(motorCurrent_A, filteredRateCmd_dps, dt);
+    disturbanceCompensation_dps = saturate(disturbanceGain * dobPtr->getCompensatingRate(),
+                                           -1 * SLEWDRIVE::DOB_MAX_COMPENSATION_DPS,
+                                           SLEWDRIVE::DOB_MAX_COMPENSATION_DPS);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Rate the control loops are ticked at [Hz]. The rate filter stages are designed at this rate,
+/// so configure them again after changing it.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::setControlRate(double rate_Hz)
+{
+    if (rate_Hz <= 0.0)
+    {
+        throw std::runtime_error("setControlRate:: Rate must be positive.");
+    }
+    controlRate_Hz = rate_Hz;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::configureDisturbanceObserver(double bandwidth_Hz, double gain)
+{
+    if (bandwidth_Hz >= 0.5 * controlRate_Hz)
+    {
+        throw std::runtime_error("configureDisturbanceObserver:: Bandwidth must be below Nyquist.");
+    }
+    dobPtr->setBandwidth(bandwidth_Hz);
+    disturbanceGain = saturate(gain, 0.0, 1.0);
+    if (!dobPtr->isEnabled())
+    {
+        disturbanceCompensation_dps = 0.0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::configureRateNotch(RateFilterStage_t stage, double fc_Hz, double depth_dB, double width_Hz)
+{
+    if (stage == RATE_LOW_PASS || stage >= NUM_RATE_FILTER_STAGES)
+    {
+        throw std::runtime_error("configureRateNotch:: Invalid notch stage.");
+    }
+    if (fc_Hz <= 0.0)
+    {
+        rateCmdFilterPtr->bypassStage(stage);
+        return;
+    }
+    try
+    {
+        rateCmdFilterPtr->setStage(stage, DIGITAL_CONTROL::designNotch(fc_Hz, depth_dB, width_Hz, controlRate_Hz));
+    }
+    catch (const std::exception &e)
+    {
+        std::stringstream ss;
+        ss << "SlewDrive::configureRateNotch() Error [" << axisLabel << "]\n"
+           << e.what();
+        throw std::runtime_error(ss.str().c_str());
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void SlewDrive::configureRateLowPass(double fc_Hz)
+{
+    if (fc_Hz <= 0.0)
+    {
+        rateCmdFilterPtr->bypassStage(RATE_LOW_PASS);
+        return;
+    }
+    try
+    {
+        rateCmdFilterPtr->setStage(RATE_LOW_PASS, DIGITAL_CONTROL::designLowPass(fc_Hz, controlRate_Hz));
+    }
+    catch (const std::exception &e)
+    {
+        std::stringstream ss;
+        ss << "SlewDrive::configureRateLowPass() Error [" << axisLabel << "]\n"
+           << e.what();
+        throw std::runtime_error(ss.str().c_str());
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -552,7 +808,9 @@ double SlewDrive::getVelocityFeedback()
 {
     if (simModeEnabled)
     {
-        rateFeedback_dps = driveModelPtr->update(combinedRateCmdSaturated_dps);
+        // A simulated load makes the axis lag the way a finite stiffness velocity loop would
+        rateFeedback_dps = driveModelPtr->update(filteredRateCmd_dps) -
+                           simDisturbance_Nm / SLEWDRIVE::RATE_LOOP_STIFFNESS_NM_PER_DPS;
     }
     else
     {
@@ -594,6 +852,46 @@ double SlewDrive::getVelocityState()
 {
     return rateFeedback_dps;
 }
+
+uint32_t SlewDrive::getDriveStatus(bool driveB) const
+{
+    const KincoDriver *drive = driveB ? pDriveB.get() : pDriveA.get();
+    return drive->getStatusWord() | ((uint32_t)drive->getErrorWord() << 16);
+}
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Sum of the currents of the two motors driving the axis [A]
+//////////////////////////////////////////////////////////////////////////////////////////////////
+double SlewDrive::getCurrentFeedback()
+{
+    LFAST_PROFILE_SCOPE(TICK_PHASE_current_feedback);
+    if (simModeEnabled)
+    {
+        double dt = 1.0 / controlRate_Hz;
+        double accel_dps2 = (filteredRateCmd_dps - simPrevRateCmd_dps) / dt;
+        simPrevRateCmd_dps = filteredRateCmd_dps;
+        return dobPtr->modelCurrent(accel_dps2, filteredRateCmd_dps, simDisturbance_Nm);
+    }
+
+    if (!KincoDriver::rtuIsActive())
+    {
+        throw std::runtime_error("getCurrentFeedback:: Drivers not connected.");
+    }
+    double drvACurrent_A, drvBCurrent_A;
+    try
+    {
+        drvACurrent_A = pDriveA->getCurrentFeedback();
+        drvBCurrent_A = pDriveB->getCurrentFeedback();
+    }
+    catch (const std::exception &e)
+    {
+        std::stringstream ss;
+        ss << "SlewDrive::getCurrentFeedback() Error [" << axisLabel << "]\n"
+           << e.what();
+        throw std::runtime_error(ss.str().c_str());
+    }
+    return drvACurrent_A + drvBCurrent_A;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////////////////////////
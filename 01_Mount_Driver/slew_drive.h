@@ -6,6 +6,8 @@
 #include <memory>
 #include "../00_Utils/PID_Controller.h"
 #include "../00_Utils/df2_filter.h"
+#include "../00_Utils/biquad_filter.h"
+#include "../00_Utils/disturbance_observer.h"
 #include "../00_Utils/KincoDriver.h"
 
 #define SLEW_COMPLETE_THRESH_POSN 5.0 //0.08
@@ -21,6 +23,14 @@ typedef enum
     HOMING_IN_PROGRESS
 } ControlMode_t;
 
+typedef enum
+{
+    RATE_NOTCH_1,
+    RATE_NOTCH_2,
+    RATE_LOW_PASS,
+    NUM_RATE_FILTER_STAGES
+} RateFilterStage_t;
+
 class SlewDrive
 {
 
@@ -33,22 +43,42 @@ private:
     double posnError;
     double rateFeedback_dps;
     double rateCommandFeedforward_dps;
+    double accelCommandFeedforward_dps2;
     double manualRateCommand_dps;
     double rateRef_dps;
     double rateError;
     double combinedRateCmdSaturated_dps;
+    double filteredRateCmd_dps;
+    double motorCurrent_A;
+    double disturbanceCompensation_dps;
+    double disturbanceGain;
+    double simDisturbance_Nm;
+    double simPrevRateCmd_dps;
+    double controlRate_Hz;
     bool isEnabled;
     double rateLim;
     bool drvAConnected;
     bool drvBConnected;
     // const PID_Controller *pid;
     std::unique_ptr<PID_Controller> pid;
-    std::unique_ptr<DF2_IIR<double>> driveModelPtr;
+    std::unique_ptr<DF2_IIR<double, 2>> driveModelPtr;
+    std::unique_ptr<BiquadCascade> rateCmdFilterPtr;
+    std::unique_ptr<DisturbanceObserver> dobPtr;
 
     std::unique_ptr<KincoDriver> pDriveA;
     std::unique_ptr<KincoDriver> pDriveB;
 
+    // Mode used on the previous control loop update. Cleared (controlLoopsActive = false) when the
+    // axis is stopped so the next update starts from a fresh PID state.
+    ControlMode_t prevMode;
+    bool controlLoopsActive;
+    // Take the shorter way round to the command. Cleared for an axis whose command is already in
+    // unwrapped (multi-turn) position, e.g. azimuth under cable wrap management.
+    bool wrapPositionError;
+
     bool simModeEnabled;
+    // Tags this axis's marks in a bus log
+    uint8_t busMarkId;
     typedef enum
     {
         HOMING_IDLE,
@@ -67,9 +97,16 @@ private:
     bool updateAlignment();
     bool prepForHoming();
     void updatePositionError();
+    void transferControlMode(ControlMode_t newMode);
+    void updateDisturbanceCompensation(double dt, ControlMode_t mode);
+    void packBusInputs(double dt, ControlMode_t mode, double *inputs) const;
+    void recordBusInputs(double dt, ControlMode_t mode) const;
+    void replayBusInputs(double &dt, ControlMode_t &mode);
 public:
     SlewDrive(const char *label, unsigned DriveA_ID, unsigned DriveB_ID, bool simMode = false);
     static bool initializeDriverBus(const char *devPath);
+    // Drive traffic comes from a bus log instead (see KincoDriver::initializeReplay)
+    static bool initializeDriverReplay(const char *logPath);
     bool connectToDrivers();
     void enable();
     void disable();
@@ -78,16 +115,24 @@ public:
     double getPositionCommand() { return std::fmod(positionCommand_deg, 360.0); }
     double getPositionFeedback();
     double getPositionState();
+    double getPositionError() { return posnError; }
     double processPositionFeedback(double currPosn);
 
     double getVelocityCommand() { return rateCommandFeedforward_dps + rateRef_dps; }
     double getVelocityFeedback();
     double getVelocityState();
+    double getCurrentFeedback();
+    // Last current read by the disturbance observer, without going to the bus
+    double getCurrentState() { return motorCurrent_A; }
+    ControlMode_t getControlMode() { return prevMode; }
+    // Last status word of drive A or B, with its error word in the upper 16 bits
+    uint32_t getDriveStatus(bool driveB) const;
 
-    void updateTrackCommands(double pcmd, double rcmd = 0.0);
+    void updateTrackCommands(double pcmd, double rcmd = 0.0, double acmd = 0.0);
 
     void abortSlew();
     void syncPosition(double sync_posn);
+    void setPositionErrorWrapping(bool wrap) { wrapPositionError = wrap; }
     bool isSlewComplete();
     void slowStop();
     // SlewDriveMode_t poll();
@@ -96,6 +141,13 @@ public:
     void updateSlewRate(double slewRate);
     const char *getModeString();
     void updateControlLoops(double dt, ControlMode_t mode);
+    void setControlRate(double rate_Hz);
+    double getControlRate() { return controlRate_Hz; }
+    void configureRateNotch(RateFilterStage_t stage, double fc_Hz, double depth_dB, double width_Hz);
+    void configureRateLowPass(double fc_Hz);
+    void configureDisturbanceObserver(double bandwidth_Hz, double gain);
+    double getDisturbanceEstimate() { return dobPtr->getDisturbanceEstimate(); }
+    double getDisturbanceCompensation() { return disturbanceCompensation_dps; }
     static double mapSlewDriveCommandToMotors(double);
     double mapMotorPositionToSlewDrive(double motorPosn_deg);
 
@@ -109,6 +161,7 @@ public:
     void setSimulationMode(bool);
     bool getSimulationMode(){return simModeEnabled;}
     void simulate(double dt);
+    void setSimulatedDisturbance(double torque_Nm) { simDisturbance_Nm = torque_Nm; }
 
     std::vector<std::string> debugStrings;
 };
@@ -0,0 +1,215 @@
+#include "track_target.h"
+
+#include <cmath>
+#include <libnova/angular_separation.h>
+#include <libnova/earth.h>
+#include <libnova/jupiter.h>
+#include <libnova/lunar.h>
+#include <libnova/mars.h>
+#include <libnova/mercury.h>
+#include <libnova/neptune.h>
+#include <libnova/parallax.h>
+#include <libnova/saturn.h>
+#include <libnova/solar.h>
+#include <libnova/uranus.h>
+#include <libnova/venus.h>
+
+#include "../00_Utils/math_util.h"
+#include "lfast_constants.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TrackTarget::TrackTarget()
+    : trackBody(TRACK_BODY_NONE), reference{0, 0}, jdReference(0.0), raRate_hrsps(0.0), decRate_dps(0.0),
+      raOffset_hrs(0.0), decOffset_deg(0.0)
+{
+}
+
+TrackTarget TrackTarget::sidereal(const INDI::IEquatorialCoordinates &radec)
+{
+    TrackTarget tgt;
+    tgt.reference = radec;
+    return tgt;
+}
+
+TrackTarget TrackTarget::customRate(const INDI::IEquatorialCoordinates &radec, double jd0,
+                                    double raRate_arcsecps, double decRate_arcsecps)
+{
+    TrackTarget tgt;
+    tgt.reference = radec;
+    tgt.jdReference = jd0;
+    // Turning slower than sidereal in hour angle means the target's RA is increasing
+    tgt.raRate_hrsps = (LFAST_CONSTANTS::SiderealRate_arcsecpersec - raRate_arcsecps) * INV_3600 / 15.0;
+    tgt.decRate_dps = decRate_arcsecps * INV_3600;
+    return tgt;
+}
+
+TrackTarget TrackTarget::body(TrackBody_t body, const INDI::IEquatorialCoordinates &radec, double jd0)
+{
+    TrackTarget tgt;
+    tgt.trackBody = body;
+    tgt.reference = radec;
+    tgt.jdReference = jd0;
+    if (body != TRACK_BODY_NONE)
+    {
+        double ra_deg, dec_deg, dist_au;
+        bodyPosition(body, jd0, &ra_deg, &dec_deg, &dist_au);
+        tgt.raOffset_hrs = std::remainder(radec.rightascension - ra_deg / 15.0, 24.0);
+        tgt.decOffset_deg = radec.declination - dec_deg;
+    }
+    return tgt;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TrackBody_t TrackTarget::nearestPlanet(const INDI::IEquatorialCoordinates &radec, double jd, double *separation_deg)
+{
+    struct ln_equ_posn target{radec.rightascension * 15.0, radec.declination};
+    TrackBody_t nearest = TRACK_BODY_NONE;
+    double minSep = 360.0;
+    for (int body = TRACK_BODY_MERCURY; body < NUM_TRACK_BODIES; body++)
+    {
+        double dist_au;
+        struct ln_equ_posn posn{0, 0};
+        bodyPosition((TrackBody_t)body, jd, &posn.ra, &posn.dec, &dist_au);
+        double sep = ln_get_angular_separation(&target, &posn);
+        if (sep < minSep)
+        {
+            minSep = sep;
+            nearest = (TrackBody_t)body;
+        }
+    }
+    if (separation_deg != nullptr)
+        *separation_deg = minSep;
+    return nearest;
+}
+
+const char *TrackTarget::bodyName(TrackBody_t body)
+{
+    switch (body)
+    {
+    case TRACK_BODY_SUN:
+        return "Sun";
+    case TRACK_BODY_MOON:
+        return "Moon";
+    case TRACK_BODY_MERCURY:
+        return "Mercury";
+    case TRACK_BODY_VENUS:
+        return "Venus";
+    case TRACK_BODY_MARS:
+        return "Mars";
+    case TRACK_BODY_JUPITER:
+        return "Jupiter";
+    case TRACK_BODY_SATURN:
+        return "Saturn";
+    case TRACK_BODY_URANUS:
+        return "Uranus";
+    case TRACK_BODY_NEPTUNE:
+        return "Neptune";
+    default:
+        return "None";
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+INDI::IEquatorialCoordinates TrackTarget::geocentricAt(double jd, double *dist_au) const
+{
+    INDI::IEquatorialCoordinates radec = reference;
+    if (dist_au != nullptr)
+        *dist_au = 0.0;
+    if (trackBody == TRACK_BODY_NONE)
+    {
+        double dt_s = (jd - jdReference) * SECONDS_PER_DAY;
+        radec.rightascension += raRate_hrsps * dt_s;
+        radec.declination = saturate(radec.declination + decRate_dps * dt_s, -90.0, 90.0);
+    }
+    else
+    {
+        double ra_deg, dec_deg, dist;
+        bodyPosition(trackBody, jd, &ra_deg, &dec_deg, &dist);
+        if (dist_au != nullptr)
+            *dist_au = dist;
+        radec.rightascension = ra_deg / 15.0 + raOffset_hrs;
+        radec.declination = dec_deg + decOffset_deg;
+    }
+    radec.rightascension = std::fmod(radec.rightascension, 24.0);
+    if (radec.rightascension < 0.0)
+        radec.rightascension += 24.0;
+    return radec;
+}
+
+INDI::IEquatorialCoordinates TrackTarget::equatorialAt(double jd, const INDI::IGeographicCoordinates &site) const
+{
+    double dist_au;
+    INDI::IEquatorialCoordinates radec = geocentricAt(jd, &dist_au);
+    // Stars are far enough away that only solar-system bodies need parallax
+    if (trackBody == TRACK_BODY_NONE)
+        return radec;
+
+    struct ln_equ_posn posn{radec.rightascension * 15.0, radec.declination};
+    struct ln_lnlat_posn observer{site.longitude, site.latitude};
+    struct ln_equ_posn parallax{0, 0};
+    ln_get_parallax(&posn, dist_au, &observer, site.elevation, jd, &parallax);
+
+    radec.rightascension = std::fmod(radec.rightascension + parallax.ra / 15.0, 24.0);
+    if (radec.rightascension < 0.0)
+        radec.rightascension += 24.0;
+    radec.declination += parallax.dec;
+    return radec;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+void TrackTarget::bodyPosition(TrackBody_t body, double jd, double *ra_deg, double *dec_deg, double *dist_au)
+{
+    struct ln_equ_posn posn{0, 0};
+    switch (body)
+    {
+    case TRACK_BODY_SUN:
+        ln_get_solar_equ_coords(jd, &posn);
+        *dist_au = ln_get_earth_solar_dist(jd);
+        break;
+    case TRACK_BODY_MOON:
+        ln_get_lunar_equ_coords(jd, &posn);
+        *dist_au = ln_get_lunar_earth_dist(jd) / LFAST_CONSTANTS::KM_PER_AU;
+        break;
+    case TRACK_BODY_MERCURY:
+        ln_get_mercury_equ_coords(jd, &posn);
+        *dist_au = ln_get_mercury_earth_dist(jd);
+        break;
+    case TRACK_BODY_VENUS:
+        ln_get_venus_equ_coords(jd, &posn);
+        *dist_au = ln_get_venus_earth_dist(jd);
+        break;
+    case TRACK_BODY_MARS:
+        ln_get_mars_equ_coords(jd, &posn);
+        *dist_au = ln_get_mars_earth_dist(jd);
+        break;
+    case TRACK_BODY_JUPITER:
+        ln_get_jupiter_equ_coords(jd, &posn);
+        *dist_au = ln_get_jupiter_earth_dist(jd);
+        break;
+    case TRACK_BODY_SATURN:
+        ln_get_saturn_equ_coords(jd, &posn);
+        *dist_au = ln_get_saturn_earth_dist(jd);
+        break;
+    case TRACK_BODY_URANUS:
+        ln_get_uranus_equ_coords(jd, &posn);
+        *dist_au = ln_get_uranus_earth_dist(jd);
+        break;
+    case TRACK_BODY_NEPTUNE:
+        ln_get_neptune_equ_coords(jd, &posn);
+        *dist_au = ln_get_neptune_earth_dist(jd);
+        break;
+    default:
+        *dist_au = 0.0;
+        break;
+    }
+    *ra_deg = posn.ra;
+    *dec_deg = posn.dec;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "libindi/libastro.h"
+
+typedef enum
+{
+    TRACK_BODY_NONE,
+    TRACK_BODY_SUN,
+    TRACK_BODY_MOON,
+    TRACK_BODY_MERCURY,
+    TRACK_BODY_VENUS,
+    TRACK_BODY_MARS,
+    TRACK_BODY_JUPITER,
+    TRACK_BODY_SATURN,
+    TRACK_BODY_URANUS,
+    TRACK_BODY_NEPTUNE,
+    NUM_TRACK_BODIES
+} TrackBody_t;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Where the tracking target is on the sky as a function of time. The target is either fixed
+/// (sidereal), drifting at a constant RA/Dec rate, or following a solar-system body from libnova.
+/// A body target keeps the offset between the goto position and the body at goto time, so an
+/// off-center feature (a lunar crater, say) stays centered. Goto positions are taken as
+/// geocentric apparent coordinates. Topocentric parallax is added for bodies, which matters
+/// for the Moon (up to ~1 deg).
+///
+/// This is too slow to run every control tick. It's meant to be sampled by the tracking
+/// ephemeris worker.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+class TrackTarget
+{
+public:
+    TrackTarget();
+
+    static TrackTarget sidereal(const INDI::IEquatorialCoordinates &radec);
+    // Rates in the TELESCOPE_TRACK_RATE convention [arcsec/s]: the RA rate is the rate the mount
+    // turns in hour angle (sidereal for a fixed star), the Dec rate is the target's Dec drift
+    static TrackTarget customRate(const INDI::IEquatorialCoordinates &radec, double jd0,
+                                  double raRate_arcsecps, double decRate_arcsecps);
+    static TrackTarget body(TrackBody_t body, const INDI::IEquatorialCoordinates &radec, double jd0);
+
+    // Planet (not Sun or Moon) nearest to radec at jd, and its separation [deg]
+    static TrackBody_t nearestPlanet(const INDI::IEquatorialCoordinates &radec, double jd, double *separation_deg);
+    static const char *bodyName(TrackBody_t body);
+
+    // Geocentric RA [hours] / Dec [deg] at jd (the same frame as the goto position), and the
+    // distance [AU] for body targets
+    INDI::IEquatorialCoordinates geocentricAt(double jd, double *dist_au = nullptr) const;
+    // Topocentric RA [hours] / Dec [deg] at jd
+    INDI::IEquatorialCoordinates equatorialAt(double jd, const INDI::IGeographicCoordinates &site) const;
+    TrackBody_t getBody() const { return trackBody; }
+
+    // Geocentric RA/Dec [deg] and distance [AU] of a body
+    static void bodyPosition(TrackBody_t body, double jd, double *ra_deg, double *dec_deg, double *dist_au);
+
+private:
+    TrackBody_t trackBody;
+    INDI::IEquatorialCoordinates reference;
+    double jdReference;
+    double raRate_hrsps;
+    double decRate_dps;
+    // Goto position minus the body's position at jdReference
+    double raOffset_hrs;
+    double decOffset_deg;
+};
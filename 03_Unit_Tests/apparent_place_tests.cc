@@ -0,0 +1,110 @@
+#include "../00_Utils/apparent_place.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define ARCSEC_TOL 0.05
+#define HMS(h, m, s) ((h) + (m) / 60.0 + (s) / 3600.0)
+#define DMS(d, m, s) ((d) + (m) / 60.0 + (s) / 3600.0)
+
+static double raErrorArcsec(double ra1_hrs, double ra2_hrs, double dec_deg)
+{
+    return (ra1_hrs - ra2_hrs) * 15.0 * 3600.0 * std::cos(dec_deg * M_PI / 180.0);
+}
+
+TEST(apparent_place_tests, nutationMatchesMeeus)
+{
+    // Meeus example 22.a, 1987 April 10 0h TD
+    double dpsi, deps;
+    ApparentPlace::nutation(2446895.5, &dpsi, &deps);
+    EXPECT_NEAR(dpsi, -3.788, 0.002);
+    EXPECT_NEAR(deps, 9.443, 0.002);
+    EXPECT_NEAR(ApparentPlace::meanObliquity(2446895.5), DMS(23, 26, 27.407), 0.001 / 3600.0);
+
+    // Meeus example 12.a: apparent 13h10m46.1351s, mean 13h10m46.3668s
+    EXPECT_NEAR(ApparentPlace::equationOfEquinoxes(2446895.5) * 3600.0, -0.2317, 0.0005);
+}
+
+TEST(apparent_place_tests, catalogToApparentMatchesMeeus)
+{
+    // Meeus example 23.a: theta Persei on 2028 November 13.19 TD, with the proper motion to that
+    // date already applied to the J2000 place
+    const double jd = 2462088.69;
+    double ra0 = HMS(2, 44, 11.986 + 0.03425 * 28.86705);
+    double dec0 = DMS(49, 13, 42.48 - 0.0895 * 28.86705);
+
+    ApparentPlace place;
+    double ra, dec, raApp, decApp;
+    place.catalogToOfDate(jd, ra0, dec0, &ra, &dec);
+    place.ofDateToApparent(jd, ra, dec, &raApp, &decApp);
+
+    EXPECT_NEAR(raErrorArcsec(raApp, HMS(2, 46, 14.390), decApp), 0.0, 0.1);
+    EXPECT_NEAR((decApp - DMS(49, 21, 7.45)) * 3600.0, 0.0, 0.1);
+    // Aberration alone: +30.045" in RA, +6.697" in Dec
+    EXPECT_NEAR((raApp - ra) * 15.0 * 3600.0, 30.045, 0.05);
+    EXPECT_NEAR((decApp - dec) * 3600.0, 6.697, 0.05);
+}
+
+TEST(apparent_place_tests, horizontalMatchesMeeus)
+{
+    // Meeus example 13.b: Venus from Washington at 1987 April 10 19:21 UT is at altitude
+    // 15.1249 deg and azimuth 68.0337 deg west of south, for the apparent place
+    // 23h09m16.641s, -6d43m11.61s. Refraction off; diurnal aberration adds up to 0.3".
+    const double jd = 2446896.30625;
+    ApparentPlace place;
+    place.setConditions({10.0, 0.0, 0.0, 0.0});
+    place.setSite(DMS(38, 55, 17), -DMS(77, 3, 56));
+
+    double ra, dec, raApp, decApp;
+    place.observedToOfDate(jd, 15.1249, 68.0337 + 180.0, &ra, &dec);
+    place.ofDateToApparent(jd, ra, dec, &raApp, &decApp);
+    EXPECT_NEAR(raErrorArcsec(raApp, HMS(23, 9, 16.641), decApp), 0.0, 1.0);
+    EXPECT_NEAR((decApp - -DMS(6, 43, 11.61)) * 3600.0, 0.0, 1.0);
+}
+
+TEST(apparent_place_tests, refractionScalesWithWeather)
+{
+    ApparentPlace place;
+    EXPECT_NEAR(place.refraction(90.0) * 3600.0, 0.0, 0.01);
+    // Saemundsson at 45 deg, 1010 hPa and 10 C
+    double r45 = place.refraction(45.0) * 3600.0;
+    EXPECT_NEAR(r45, 60.0 * (1.02 / std::tan((45.0 + 10.3 / 50.11) * M_PI / 180.0) + 0.0019279), 1e-6);
+
+    place.setConditions({10.0, 505.0, 0.0, 0.0});
+    EXPECT_NEAR(place.refraction(45.0) * 3600.0, r45 / 2.0, 1e-6);
+    place.setConditions({-10.0, 1010.0, 0.0, 0.0});
+    EXPECT_NEAR(place.refraction(45.0) * 3600.0, r45 * 283.0 / 263.0, 1e-6);
+    place.setConditions({10.0, 0.0, 0.0, 0.0});
+    EXPECT_EQ(place.refraction(45.0), 0.0);
+
+    place.setConditions({10.0, 1010.0, 0.0, 0.0});
+    for (double alt : {0.0, 5.0, 20.0, 60.0, 89.0})
+        EXPECT_NEAR(place.removeRefraction(alt + place.refraction(alt)), alt, 1e-6);
+}
+
+TEST(apparent_place_tests, observedRoundTrip)
+{
+    const double jd = 2460000.25;
+    ApparentPlace place;
+    place.setConditions({5.0, 750.0, 0.15, 0.35});
+    place.setSite(32.4, -110.8);
+
+    for (double dec : {-30.0, 0.0, 45.0, 80.0})
+    {
+        for (double ra = 0.5; ra < 24.0; ra += 2.0)
+        {
+            double alt, az, ra2, dec2;
+            place.ofDateToObserved(jd, ra, dec, &alt, &az);
+            if (alt < 5.0)
+                continue;
+            place.observedToOfDate(jd, alt, az, &ra2, &dec2);
+            EXPECT_NEAR(raErrorArcsec(ra2, ra, dec), 0.0, ARCSEC_TOL);
+            EXPECT_NEAR((dec2 - dec) * 3600.0, 0.0, ARCSEC_TOL);
+        }
+    }
+
+    // The apparent place is cached per target; a new target gets its own
+    double alt1, az1, alt2, az2;
+    place.ofDateToObserved(jd, 3.0, 20.0, &alt1, &az1);
+    place.ofDateToObserved(jd, 3.0, 21.0, &alt2, &az2);
+    EXPECT_GT(std::fabs(alt2 - alt1) + std::fabs(az2 - az1), 0.5);
+}
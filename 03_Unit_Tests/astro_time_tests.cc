@@ -0,0 +1,98 @@
+#include "../00_Utils/astro_time.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+// JD resolution is ~40 us at current dates
+#define JD_TOL_SEC 1e-4
+#define SEC_TO_DAY (1.0 / 86400.0)
+
+// 1987 April 10, 19:21:00 UT (Meeus example 12.b), as Unix time
+#define MEEUS_12B_UNIX_SEC 545080860.0
+
+struct FakeClocks
+{
+    double monotonic_s = 1000.0;
+    double utc_s = MEEUS_12B_UNIX_SEC;
+    void advance(double sec)
+    {
+        monotonic_s += sec;
+        utc_s += sec;
+    }
+    AstroClock::Clock monotonic()
+    {
+        return [this]()
+        { return monotonic_s; };
+    }
+    AstroClock::Clock utc()
+    {
+        return [this]()
+        { return utc_s; };
+    }
+};
+
+TEST(astro_time_tests, meanSiderealTimeMatchesMeeus)
+{
+    // Meeus examples 12.a and 12.b
+    EXPECT_NEAR(AstroClock::meanSiderealTime(2446895.5), 13.0 + 10.0 / 60.0 + 46.3668 / 3600.0, 1e-7);
+    EXPECT_NEAR(AstroClock::meanSiderealTime(2446896.30625), 8.0 + 34.0 / 60.0 + 57.0896 / 3600.0, 1e-6);
+}
+
+TEST(astro_time_tests, contextFromAnchoredClock)
+{
+    FakeClocks clocks;
+    AstroClock clk(clocks.monotonic(), clocks.utc());
+    const AstroTimeContext &ctx = clk.update(-110.0);
+    ASSERT_TRUE(ctx.valid);
+    EXPECT_NEAR(ctx.jd, 2446896.30625, JD_TOL_SEC * SEC_TO_DAY);
+    EXPECT_NEAR(ctx.gmst_hrs, 8.58252489, 1e-6);
+    EXPECT_NEAR(ctx.lst_hrs, std::fmod(ctx.gmst_hrs - 110.0 / 15.0 + 24.0, 24.0), 1e-12);
+    EXPECT_NEAR(ctx.lst_rad, ctx.lst_hrs * M_PI / 12.0, 1e-12);
+
+    // The context doesn't move until the next update
+    double jd0 = ctx.jd;
+    clocks.advance(0.02);
+    EXPECT_DOUBLE_EQ(clk.now().jd, jd0);
+    EXPECT_NEAR((clk.julianDate() - jd0) / SEC_TO_DAY, 0.02, JD_TOL_SEC);
+
+    clk.update(-110.0);
+    EXPECT_NEAR((clk.now().jd - jd0) / SEC_TO_DAY, 0.02, JD_TOL_SEC);
+}
+
+TEST(astro_time_tests, intervalsIgnoreSystemClockSteps)
+{
+    FakeClocks clocks;
+    AstroClock clk(clocks.monotonic(), clocks.utc());
+    double jd0 = clk.update(0.0).jd;
+
+    // The system clock is stepped forward an hour between anchors: nothing changes until the
+    // next re-anchor
+    clocks.utc_s += 3600.0;
+    clocks.monotonic_s += 1.0;
+    clk.update(0.0);
+    EXPECT_NEAR((clk.now().jd - jd0) / SEC_TO_DAY, 1.0, JD_TOL_SEC);
+
+    clocks.monotonic_s += ASTRO_TIME::REANCHOR_PERIOD_SEC;
+    clk.update(0.0);
+    EXPECT_NEAR((clk.now().jd - jd0) / SEC_TO_DAY, 3600.0, JD_TOL_SEC);
+}
+
+TEST(astro_time_tests, smallCorrectionsNeverRunBackwards)
+{
+    FakeClocks clocks;
+    AstroClock clk(clocks.monotonic(), clocks.utc());
+    clk.update(0.0);
+
+    // The monotonic clock has run 5 ms fast over the anchor period, so the re-anchor lands 3 ms
+    // before the previous tick. That tick's time is held instead.
+    clocks.monotonic_s += ASTRO_TIME::REANCHOR_PERIOD_SEC - 0.001;
+    clocks.utc_s += ASTRO_TIME::REANCHOR_PERIOD_SEC - 0.006;
+    double jdBefore = clk.update(0.0).jd;
+    clocks.monotonic_s += 0.002;
+    clocks.utc_s += 0.002;
+    double jdAfter = clk.update(0.0).jd;
+    EXPECT_DOUBLE_EQ(jdAfter, jdBefore);
+
+    // ...and the time carries on from the corrected anchor
+    clocks.advance(0.1);
+    EXPECT_NEAR((clk.update(0.0).jd - jdBefore) / SEC_TO_DAY, 0.097, JD_TOL_SEC);
+}
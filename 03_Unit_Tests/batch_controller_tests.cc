@@ -0,0 +1,111 @@
+#include "../00_Utils/batch_controller.h"
+#include "../00_Utils/PID_Controller.h"
+#include "../00_Utils/biquad_filter.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+constexpr std::size_t NUM_LANES = 7;
+constexpr double TEST_DT = 0.02;
+
+static double testSignal(std::size_t lane, unsigned k)
+{
+    return std::sin(0.05 * k * (lane + 1)) + 0.25 * std::cos(0.31 * k + lane);
+}
+
+TEST(batch_controller_tests, pidMatchesScalar)
+{
+    BatchPID_Controller batch(NUM_LANES);
+    std::vector<PID_Controller> scalar(NUM_LANES);
+
+    for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+    {
+        // Mix of compensation modes, some lanes with integrator limits
+        double kp = (ii % 2) ? 1.5 + ii : 0.0;
+        double ki = (ii % 3) ? 0.25 * ii : 0.0;
+        double kd = (ii % 4) ? 0.01 * ii : 0.0;
+        batch.configureGains(ii, kp, ki, kd);
+        scalar[ii].configureGains(kp, ki, kd);
+        if (ii > 3)
+        {
+            batch.configureIntegratorSaturation(ii, 0.1, -0.2);
+            scalar[ii].configureIntegratorSaturation(0.1, -0.2);
+        }
+        if (ii % 2)
+        {
+            batch.configureOutputSaturation(ii, 0.8, -0.6);
+            scalar[ii].configureOutputSaturation(0.8, -0.6);
+            batch.configureAntiWindup(ii, 0.5 * ii);
+            scalar[ii].configureAntiWindup(0.5 * ii);
+        }
+        scalar[ii].reset();
+    }
+
+    std::vector<double> e(NUM_LANES), u(NUM_LANES);
+    for (unsigned k = 0; k < 500; k++)
+    {
+        for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+            e[ii] = testSignal(ii, k);
+        if (k == 250)
+        {
+            for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+            {
+                batch.initializeIntegrator(ii, 0.3, e[ii]);
+                scalar[ii].initializeIntegrator(0.3, e[ii]);
+            }
+        }
+        batch.update(e.data(), TEST_DT, u.data());
+        for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+        {
+            double uScalar;
+            scalar[ii].update(e[ii], TEST_DT, &uScalar);
+            EXPECT_EQ(u[ii], uScalar) << "lane " << ii << ", step " << k;
+        }
+    }
+}
+
+TEST(batch_controller_tests, pidResetOneLane)
+{
+    BatchPID_Controller batch(2);
+    batch.configureGains(0, 1.0, 1.0, 0.1);
+    batch.configureGains(1, 1.0, 1.0, 0.1);
+    double e[2] = {1.0, 1.0};
+    double u[2];
+    batch.update(e, TEST_DT, u);
+    batch.update(e, TEST_DT, u);
+    batch.reset(0);
+    batch.update(e, TEST_DT, u);
+
+    PID_Controller fresh(1.0, 1.0, 0.1);
+    fresh.reset();
+    double uFresh;
+    fresh.update(1.0, TEST_DT, &uFresh);
+    EXPECT_EQ(u[0], uFresh);
+    EXPECT_NE(u[1], uFresh);
+}
+
+TEST(batch_controller_tests, biquadMatchesScalar)
+{
+    BatchBiquadFilter batch(NUM_LANES);
+    std::vector<BiquadFilter> scalar(NUM_LANES);
+    constexpr double fs = 50.0;
+
+    for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+    {
+        DIGITAL_CONTROL::BiquadCoeffs c = (ii % 2)
+                                              ? DIGITAL_CONTROL::designNotch(2.0 + ii, 20.0, 1.0, fs)
+                                              : DIGITAL_CONTROL::designLowPass(5.0 + ii, fs);
+        batch.setCoefficients(ii, c);
+        scalar[ii].setCoefficients(c);
+    }
+
+    std::vector<double> x(NUM_LANES), y(NUM_LANES);
+    for (unsigned k = 0; k < 500; k++)
+    {
+        for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+            x[ii] = testSignal(ii, k);
+        batch.update(x.data(), y.data());
+        for (std::size_t ii = 0; ii < NUM_LANES; ii++)
+            EXPECT_EQ(y[ii], scalar[ii].update(x[ii])) << "lane " << ii << ", step " << k;
+    }
+}
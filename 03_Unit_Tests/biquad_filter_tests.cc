@@ -0,0 +1,59 @@
+#include "../00_Utils/biquad_filter.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define FS_HZ 50.0
+#define GAIN_THRESH 1e-9
+
+TEST(biquad_filter_tests, notchHasUnityDcGain)
+{
+    BiquadFilter notch(DIGITAL_CONTROL::designNotch(8.0, 20.0, 2.0, FS_HZ));
+    EXPECT_NEAR(notch.gainAt(0.0, FS_HZ), 1.0, GAIN_THRESH);
+}
+
+TEST(biquad_filter_tests, notchDepthAtCenterFrequency)
+{
+    double depth_dB = 20.0;
+    BiquadFilter notch(DIGITAL_CONTROL::designNotch(8.0, depth_dB, 2.0, FS_HZ));
+    double gain_dB = 20.0 * std::log10(notch.gainAt(8.0, FS_HZ));
+    EXPECT_NEAR(gain_dB, -depth_dB, 1e-6);
+}
+
+TEST(biquad_filter_tests, fullDepthNotchRejectsSinusoid)
+{
+    BiquadFilter notch(DIGITAL_CONTROL::designNotch(5.0, DIGITAL_CONTROL::NOTCH_MAX_DEPTH_DB, 1.0, FS_HZ));
+    double y = 0;
+    double maxTail = 0;
+    for (int ii = 0; ii < 2000; ii++)
+    {
+        y = notch.update(std::sin(2.0 * M_PI * 5.0 * ii / FS_HZ));
+        if (ii > 1500)
+            maxTail = std::max(maxTail, std::abs(y));
+    }
+    EXPECT_LT(maxTail, 1e-3);
+}
+
+TEST(biquad_filter_tests, lowPassStepSettlesToInput)
+{
+    BiquadFilter lpf(DIGITAL_CONTROL::designLowPass(5.0, FS_HZ));
+    double y = 0;
+    for (int ii = 0; ii < 500; ii++)
+        y = lpf.update(1.0);
+    EXPECT_NEAR(y, 1.0, GAIN_THRESH);
+    EXPECT_NEAR(lpf.gainAt(5.0, FS_HZ), M_SQRT1_2, 1e-6);
+}
+
+TEST(biquad_filter_tests, cascadePassesThroughWhenUnconfigured)
+{
+    BiquadCascade cascade(3);
+    EXPECT_DOUBLE_EQ(cascade.update(1.234), 1.234);
+    cascade.setStage(1, DIGITAL_CONTROL::designNotch(8.0, 20.0, 2.0, FS_HZ));
+    cascade.bypassStage(1);
+    EXPECT_DOUBLE_EQ(cascade.update(-4.5), -4.5);
+}
+
+TEST(biquad_filter_tests, invalidFrequencyThrows)
+{
+    EXPECT_THROW(DIGITAL_CONTROL::designNotch(30.0, 20.0, 1.0, FS_HZ), std::runtime_error);
+    EXPECT_THROW(DIGITAL_CONTROL::designLowPass(0.0, FS_HZ), std::runtime_error);
+}
@@ -0,0 +1,148 @@
+#include "../00_Utils/bus_log.h"
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <map>
+#include <string>
+
+// Registers in memory; node 9 times out
+class FakeBus : public BusTransport
+{
+public:
+    std::map<uint32_t, uint16_t> regs;
+    int readRegisters(uint8_t devId, uint16_t addr, int n, uint16_t *dest) override
+    {
+        if (devId == 9)
+        {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        for (int k = 0; k < n; k++)
+            dest[k] = regs[(devId << 16) + addr + k];
+        return n;
+    }
+    int writeRegisters(uint8_t devId, uint16_t addr, int n, const uint16_t *src) override
+    {
+        for (int k = 0; k < n; k++)
+            regs[(devId << 16) + addr + k] = src[k];
+        return n;
+    }
+};
+
+static std::string logPath(const char *name)
+{
+    return testing::TempDir() + name + BUS_LOG::FILE_SUFFIX;
+}
+
+// A short session: two ticks, each writing a command, reading it back and polling node 9
+static void recordSession(const std::string &path)
+{
+    BusRecorder recorder(std::unique_ptr<BusTransport>(new FakeBus), path);
+    uint16_t words[2];
+    for (unsigned tick = 0; tick < 2; tick++)
+    {
+        double dt = 0.02 + 0.001 * tick;
+        recorder.mark(BUS_LOG::MARK_TICK, 0, &dt, 1);
+        const uint16_t cmd[2] = {(uint16_t)(100 + tick), 7};
+        recorder.writeRegisters(1, 0x6FF0, 2, cmd);
+        recorder.readRegisters(1, 0x6FF0, 2, words);
+        EXPECT_EQ(recorder.readRegisters(9, 0x6041, 1, words), -1);
+        double inputs[2] = {1.5, -2.0 * tick};
+        recorder.mark(BUS_LOG::MARK_AXIS_INPUTS, 1, inputs, 2);
+    }
+}
+
+TEST(bus_log_tests, recordsEveryTransaction)
+{
+    const std::string path = logPath("bus_record");
+    recordSession(path);
+
+    BusLogReader reader(path);
+    std::vector<BusLogEntry> entries;
+    BusLogEntry e;
+    while (reader.next(e))
+        entries.push_back(e);
+    ASSERT_EQ(entries.size(), 10u);
+    for (size_t k = 1; k < entries.size(); k++)
+        EXPECT_GE(entries[k].t_s, entries[k - 1].t_s);
+
+    EXPECT_EQ(entries[1].op, BUS_OP_WRITE);
+    EXPECT_EQ(entries[1].addr, 0x6FF0);
+    EXPECT_EQ(entries[1].words[0], 100);
+    EXPECT_EQ(entries[2].op, BUS_OP_READ);
+    EXPECT_EQ(entries[2].result, 2);
+    EXPECT_EQ(entries[2].words[1], 7);
+    EXPECT_EQ(entries[3].devId, 9);
+    EXPECT_EQ(entries[3].result, -1);
+    EXPECT_EQ(entries[3].errnum, ETIMEDOUT);
+
+    double inputs[2];
+    busMarkUnpack(entries[9].words, 2, inputs);
+    EXPECT_EQ(entries[9].addr, BUS_LOG::MARK_AXIS_INPUTS);
+    EXPECT_EQ(inputs[1], -2.0);
+    EXPECT_GT(reader.getStartUnix(), 1.6e9);
+}
+
+TEST(bus_log_tests, replayIsDeterministic)
+{
+    const std::string path = logPath("bus_replay");
+    recordSession(path);
+
+    BusReplay replay(path);
+    uint16_t words[2];
+    for (unsigned tick = 0; tick < 2; tick++)
+    {
+        double dt = 1.0;
+        replay.mark(BUS_LOG::MARK_TICK, 0, &dt, 1);
+        EXPECT_DOUBLE_EQ(dt, 0.02 + 0.001 * tick);
+        EXPECT_EQ(replay.pendingMarks(BUS_LOG::MARK_AXIS_INPUTS).size(), 1u);
+
+        const uint16_t cmd[2] = {(uint16_t)(100 + tick), 7};
+        EXPECT_EQ(replay.writeRegisters(1, 0x6FF0, 2, cmd), 2);
+        EXPECT_EQ(replay.readRegisters(1, 0x6FF0, 2, words), 2);
+        EXPECT_EQ(words[0], 100 + tick);
+        // The timeout comes back as a timeout
+        errno = 0;
+        EXPECT_EQ(replay.readRegisters(9, 0x6041, 1, words), -1);
+        EXPECT_EQ(errno, ETIMEDOUT);
+        double inputs[2] = {1.5, -2.0 * tick};
+        replay.mark(BUS_LOG::MARK_AXIS_INPUTS, 1, inputs, 2);
+    }
+    double dt = 0.0;
+    replay.mark(BUS_LOG::MARK_TICK, 0, &dt, 1);
+    EXPECT_TRUE(replay.isFinished());
+
+    const BusReplayStats &s = replay.getStats();
+    EXPECT_EQ(s.ticks, 2u);
+    EXPECT_EQ(s.served, 6u);
+    EXPECT_EQ(s.failures, 2u);
+    EXPECT_EQ(s.missing + s.skipped + s.writeMismatches + s.markMismatches, 0u);
+}
+
+TEST(bus_log_tests, replayToleratesDifferentCode)
+{
+    const std::string path = logPath("bus_replay_diff");
+    recordSession(path);
+
+    BusReplay replay(path);
+    uint16_t words[2];
+    double dt = 0.0;
+    replay.mark(BUS_LOG::MARK_TICK, 0, &dt, 1);
+    // Out of order, a different command and an extra request
+    EXPECT_EQ(replay.readRegisters(1, 0x6FF0, 2, words), 2);
+    EXPECT_EQ(words[0], 100);
+    const uint16_t cmd[2] = {123, 7};
+    EXPECT_EQ(replay.writeRegisters(1, 0x6FF0, 2, cmd), 2);
+    EXPECT_EQ(replay.readRegisters(1, 0x1234, 1, words), -1);
+    EXPECT_EQ(errno, EIO);
+    double inputs[2] = {1.5, 3.0};
+    replay.mark(BUS_LOG::MARK_AXIS_INPUTS, 1, inputs, 2);
+    EXPECT_EQ(inputs[1], 0.0);
+
+    // The node 9 poll is never made
+    replay.mark(BUS_LOG::MARK_TICK, 0, &dt, 1);
+    const BusReplayStats &s = replay.getStats();
+    EXPECT_EQ(s.missing, 1u);
+    EXPECT_EQ(s.skipped, 1u);
+    EXPECT_EQ(s.writeMismatches, 1u);
+    EXPECT_EQ(s.markMismatches, 1u);
+}
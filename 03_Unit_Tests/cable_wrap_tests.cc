@@ -0,0 +1,71 @@
+#include "../00_Utils/cable_wrap.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#define AZ_RATE_DPS 2.0
+
+// Target azimuth moving steadily for the given time
+static std::vector<double> steadyPath(double rate_dps, double duration_s)
+{
+    std::vector<double> path;
+    for (double t = 0.0; t <= duration_s; t += CABLE_WRAP::PATH_STEP_SEC)
+        path.push_back(rate_dps * t);
+    return path;
+}
+
+TEST(cable_wrap_tests, unwrapNear)
+{
+    EXPECT_DOUBLE_EQ(CableWrap::unwrapNear(10.0, 350.0), 370.0);
+    EXPECT_DOUBLE_EQ(CableWrap::unwrapNear(350.0, 10.0), -10.0);
+    EXPECT_DOUBLE_EQ(CableWrap::unwrapNear(90.0, 445.0), 450.0);
+    EXPECT_DOUBLE_EQ(CableWrap::unwrapNear(-90.0, 0.0), -90.0);
+    EXPECT_THROW(CableWrap(0.0, 300.0), std::runtime_error);
+}
+
+TEST(cable_wrap_tests, shortestPathWhenThereIsRoom)
+{
+    CableWrap wrap(-270.0, 270.0);
+    // Target just across north from the current position: go through north, not the long way
+    CableWrapChoice c = wrap.chooseGoto(-10.0, 340.0, steadyPath(0.002, 3600.0), AZ_RATE_DPS);
+    EXPECT_TRUE(c.fullTrack);
+    EXPECT_DOUBLE_EQ(c.az_deg, -20.0);
+    EXPECT_DOUBLE_EQ(c.slewTime_s, 5.0);
+    EXPECT_DOUBLE_EQ(c.trackTime_s, 3600.0);
+}
+
+TEST(cable_wrap_tests, avoidsCopyThatRunsIntoLimit)
+{
+    CableWrap wrap(-270.0, 270.0);
+    // Nearest copy of 260 is 260 itself, but the target moves +20 deg in the next hour
+    std::vector<double> path = steadyPath(20.0 / 3600.0, 3600.0);
+    CableWrapChoice c = wrap.chooseGoto(200.0, 260.0, path, AZ_RATE_DPS);
+    EXPECT_TRUE(c.fullTrack);
+    EXPECT_DOUBLE_EQ(c.az_deg, -100.0);
+
+    // A short enough track fits the near copy
+    c = wrap.chooseGoto(200.0, 260.0, steadyPath(20.0 / 3600.0, 1200.0), AZ_RATE_DPS);
+    EXPECT_TRUE(c.fullTrack);
+    EXPECT_DOUBLE_EQ(c.az_deg, 260.0);
+}
+
+TEST(cable_wrap_tests, altitudeSlewBreaksTiesByRoom)
+{
+    CableWrap wrap(-270.0, 270.0);
+    // Both copies of 100 are reachable within the altitude slew time; take the one nearer the centre
+    CableWrapChoice c = wrap.chooseGoto(-90.0, 100.0, steadyPath(0.001, 600.0), AZ_RATE_DPS, 200.0);
+    EXPECT_DOUBLE_EQ(c.az_deg, 100.0);
+    c = wrap.chooseGoto(-90.0, 100.0, steadyPath(0.001, 600.0), AZ_RATE_DPS, 50.0);
+    EXPECT_DOUBLE_EQ(c.az_deg, -260.0);
+}
+
+TEST(cable_wrap_tests, longestTrackWhenNothingFits)
+{
+    CableWrap wrap(-200.0, 200.0);
+    // The target turns 500 deg in the hour, more than the whole range. Starting from the lowest
+    // copy of 190 leaves the most room.
+    std::vector<double> path = steadyPath(500.0 / 3600.0, 3600.0);
+    CableWrapChoice c = wrap.chooseGoto(180.0, 190.0, path, AZ_RATE_DPS);
+    EXPECT_FALSE(c.fullTrack);
+    EXPECT_DOUBLE_EQ(c.az_deg, -170.0);
+    EXPECT_DOUBLE_EQ(c.trackTime_s, 44 * CABLE_WRAP::PATH_STEP_SEC);
+}
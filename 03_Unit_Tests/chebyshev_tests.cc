@@ -0,0 +1,49 @@
+#include "../00_Utils/chebyshev.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+static ChebyshevSeries fitFunction(double (*f)(double), unsigned n)
+{
+    std::vector<double> x = ChebyshevSeries::nodes(n);
+    std::vector<double> vals;
+    for (auto xk : x)
+        vals.push_back(f(xk));
+    ChebyshevSeries series;
+    series.fit(vals);
+    return series;
+}
+
+static double cubic(double x) { return 2.0 - 3.0 * x + 0.5 * x * x + 4.0 * x * x * x; }
+
+TEST(chebyshev_tests, cubicIsExact)
+{
+    ChebyshevSeries series = fitFunction(cubic, 6);
+    EXPECT_EQ(series.order(), 5u);
+    for (double x = -1.0; x <= 1.0; x += 0.125)
+    {
+        EXPECT_NEAR(series.value(x), cubic(x), 1e-12);
+        EXPECT_NEAR(series.derivative(x), -3.0 + x + 12.0 * x * x, 1e-12);
+        EXPECT_NEAR(series.secondDerivative(x), 1.0 + 24.0 * x, 1e-11);
+    }
+}
+
+static double sine(double x) { return std::sin(2.0 * x); }
+
+TEST(chebyshev_tests, smoothFunctionAndDerivatives)
+{
+    ChebyshevSeries series = fitFunction(sine, 16);
+    for (double x = -1.0; x <= 1.0; x += 0.01)
+    {
+        EXPECT_NEAR(series.value(x), std::sin(2.0 * x), 1e-13);
+        EXPECT_NEAR(series.derivative(x), 2.0 * std::cos(2.0 * x), 1e-11);
+        EXPECT_NEAR(series.secondDerivative(x), -4.0 * std::sin(2.0 * x), 1e-9);
+    }
+}
+
+TEST(chebyshev_tests, unfitSeriesIsZero)
+{
+    ChebyshevSeries series;
+    EXPECT_FALSE(series.isFit());
+    EXPECT_EQ(series.value(0.3), 0.0);
+    EXPECT_EQ(series.derivative(0.3), 0.0);
+}
@@ -0,0 +1,336 @@
+#include "../01_Mount_Driver/slew_drive.h"
+#include "../01_Mount_Driver/lfast_constants.h"
+#include "../00_Utils/horizontal_kinematics.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Scripted scenarios run through the simulated axes the way TimerHit drives them, compared
+/// with the traces in golden_traces/ and timed. After an intended change in behaviour, rerun
+/// with LFAST_UPDATE_GOLDEN=1 to rewrite the traces and commit them with the change.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define TEST_DT (SLEWDRIVE::CONTROL_LOOP_PERIOD_MS / 1000.0)
+// One trace row per second
+#define TICKS_PER_SAMPLE 50
+#define POSN_TOL_DEG 1e-6
+#define RATE_TOL_DPS 1e-7
+// Both axes, including the feedback reads. Well under a microsecond on a desktop in a debug
+// build, so this leaves room for slower machines and still catches a loop that has got several
+// times more expensive. LFAST_MAX_TICK_US overrides it.
+#define MAX_MEAN_TICK_US 25.0
+// Time given to settle after the driver would call a slew complete
+#define SETTLE_SEC 20
+#define SETTLE_TOL_DEG 1e-3
+// Ticks to settle within SETTLE_TOL_DEG after slew to track (about 1700-1900)
+#define MAX_SETTLE_TICKS 2500u
+
+static const double SITE_LAT_RAD = 32.4 * M_PI / 180.0;
+
+struct TraceRow
+{
+    double t_s;
+    double alt_deg, az_deg;
+    double altRate_dps, azRate_dps;
+    double altErr_deg, azErr_deg;
+};
+
+class SimMount
+{
+public:
+    SlewDrive alt{"Altitude", LFAST_CONSTANTS::ALTITUDE_MOTOR_A_ID, LFAST_CONSTANTS::ALTITUDE_MOTOR_B_ID, true};
+    SlewDrive az{"Azimuth", LFAST_CONSTANTS::AZIMUTH_MOTOR_A_ID, LFAST_CONSTANTS::AZIMUTH_MOTOR_B_ID, true};
+    std::vector<TraceRow> trace;
+    double t_s{0.0};
+    double tickTime_s{0.0};
+    unsigned ticks{0};
+
+    SimMount(double alt_deg, double az_deg)
+    {
+        alt.initializeStates();
+        az.initializeStates();
+        alt.syncPosition(alt_deg);
+        az.syncPosition(az_deg);
+        alt.enable();
+        az.enable();
+    }
+
+    // ReadScopeStatus, then the control loops
+    void tick(ControlMode_t mode)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        alt.getPositionFeedback();
+        az.getPositionFeedback();
+        alt.getVelocityFeedback();
+        az.getVelocityFeedback();
+        alt.updateControlLoops(TEST_DT, mode);
+        az.updateControlLoops(TEST_DT, mode);
+        tickTime_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (ticks++ % TICKS_PER_SAMPLE == 0)
+            trace.push_back({t_s, alt.getPositionState(), az.getPositionState(), alt.getVelocityCommand(),
+                             az.getVelocityCommand(), alt.getPositionError(), az.getPositionError()});
+        t_s = ticks * TEST_DT;
+    }
+
+    // A goto or park: slew until the driver would call it complete, then let it settle
+    void slewTo(double alt_deg, double az_deg, double timeout_s)
+    {
+        alt.updateTrackCommands(alt_deg);
+        az.updateTrackCommands(az_deg);
+        const double end_s = t_s + timeout_s;
+        while (t_s < end_s && !(alt.isSlewComplete() && az.isSlewComplete()))
+            tick(SLEWING_TO_POSN);
+        EXPECT_LT(t_s, end_s) << "slew didn't complete";
+        for (int k = 0; k < SETTLE_SEC * TICKS_PER_SAMPLE; k++)
+            tick(SLEWING_TO_POSN);
+    }
+
+    // A fixed star, with the hour angle starting at ha0 when the scenario started
+    void trackCommands(double ha0_rad, double dec_rad, double t_s)
+    {
+        const double w = LFAST_CONSTANTS::SiderealRate_radpersec;
+        HorizontalKinematics hk = computeHorizontalKinematics(ha0_rad + w * t_s, dec_rad, SITE_LAT_RAD, w);
+        alt.updateTrackCommands(rad2deg(hk.alt), rad2deg(hk.altRate), rad2deg(hk.altAccel));
+        az.updateTrackCommands(rad2deg(hk.az), rad2deg(hk.azRate), rad2deg(hk.azAccel));
+    }
+
+    // A goto onto that star: slew after its current position, as TimerHit does, until the driver
+    // would call the slew complete, then keep slewing for settle_s
+    void gotoStar(double ha0_rad, double dec_rad, double timeout_s, double settle_s)
+    {
+        const double end_s = t_s + timeout_s;
+        do
+            followCommand(ha0_rad, dec_rad);
+        while (t_s < end_s && !(alt.isSlewComplete() && az.isSlewComplete()));
+        EXPECT_LT(t_s, end_s) << "slew didn't complete";
+        const double settleEnd_s = t_s + settle_s;
+        while (t_s < settleEnd_s)
+            followCommand(ha0_rad, dec_rad);
+    }
+
+    void followCommand(double ha0_rad, double dec_rad)
+    {
+        const double w = LFAST_CONSTANTS::SiderealRate_radpersec;
+        HorizontalKinematics hk = computeHorizontalKinematics(ha0_rad + w * t_s, dec_rad, SITE_LAT_RAD, 0.0);
+        alt.updateTrackCommands(rad2deg(hk.alt));
+        az.updateTrackCommands(rad2deg(hk.az));
+        tick(SLEWING_TO_POSN);
+    }
+
+    // Tracks the star for a while and returns the ticks until both axes stayed within
+    // SETTLE_TOL_DEG of it
+    unsigned trackUntilSettled(double ha0_rad, double dec_rad, double duration_s)
+    {
+        const double end_s = t_s + duration_s;
+        unsigned k = 0, settled = 0;
+        while (t_s < end_s)
+        {
+            trackCommands(ha0_rad, dec_rad, t_s);
+            tick(TRACKING_COMMAND);
+            k++;
+            if (std::abs(alt.getPositionError()) >= SETTLE_TOL_DEG || std::abs(az.getPositionError()) >= SETTLE_TOL_DEG)
+                settled = k;
+        }
+        return settled;
+    }
+
+    double meanTick_us() const { return ticks > 0 ? 1e6 * tickTime_s / ticks : 0.0; }
+};
+
+static std::string goldenPath(const std::string &name)
+{
+    return std::string(GOLDEN_TRACE_DIR) + "/" + name + ".csv";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static void checkAgainstGolden(const std::string &name, const SimMount &mount)
+{
+    const std::string path = goldenPath(name);
+    const char *update = std::getenv("LFAST_UPDATE_GOLDEN");
+    if (update != nullptr && update[0] == '1')
+    {
+        FILE *fp = std::fopen(path.c_str(), "w");
+        ASSERT_NE(fp, nullptr) << "can't write " << path;
+        std::fprintf(fp, "t_s,alt_deg,az_deg,alt_rate_dps,az_rate_dps,alt_err_deg,az_err_deg\n");
+        for (const TraceRow &r : mount.trace)
+            std::fprintf(fp, "%.2f,%.12f,%.12f,%.12e,%.12e,%.12e,%.12e\n", r.t_s, r.alt_deg, r.az_deg, r.altRate_dps,
+                         r.azRate_dps, r.altErr_deg, r.azErr_deg);
+        std::fclose(fp);
+        return;
+    }
+
+    std::ifstream in(path);
+    ASSERT_TRUE(in.good()) << "no golden trace at " << path << " (run with LFAST_UPDATE_GOLDEN=1 to create it)";
+    std::string line;
+    std::getline(in, line);
+    size_t row = 0;
+    while (std::getline(in, line))
+    {
+        ASSERT_LT(row, mount.trace.size()) << name << ": the golden trace is longer";
+        TraceRow g;
+        ASSERT_EQ(std::sscanf(line.c_str(), "%lf,%lf,%lf,%lf,%lf,%lf,%lf", &g.t_s, &g.alt_deg, &g.az_deg,
+                              &g.altRate_dps, &g.azRate_dps, &g.altErr_deg, &g.azErr_deg),
+                  7);
+        const TraceRow &r = mount.trace[row++];
+        // Stop at the first row that's off; the rest usually only repeat it
+        ASSERT_NEAR(r.t_s, g.t_s, 1e-6);
+        ASSERT_NEAR(r.alt_deg, g.alt_deg, POSN_TOL_DEG) << name << " at " << g.t_s << " s";
+        ASSERT_NEAR(r.az_deg, g.az_deg, POSN_TOL_DEG) << name << " at " << g.t_s << " s";
+        ASSERT_NEAR(r.altRate_dps, g.altRate_dps, RATE_TOL_DPS) << name << " at " << g.t_s << " s";
+        ASSERT_NEAR(r.azRate_dps, g.azRate_dps, RATE_TOL_DPS) << name << " at " << g.t_s << " s";
+        ASSERT_NEAR(r.altErr_deg, g.altErr_deg, POSN_TOL_DEG) << name << " at " << g.t_s << " s";
+        ASSERT_NEAR(r.azErr_deg, g.azErr_deg, POSN_TOL_DEG) << name << " at " << g.t_s << " s";
+    }
+    EXPECT_EQ(row, mount.trace.size()) << name << ": the golden trace is shorter";
+}
+
+static void checkTickCost(const SimMount &mount)
+{
+    const double us = mount.meanTick_us();
+    const char *limit = std::getenv("LFAST_MAX_TICK_US");
+    const double max_us = limit != nullptr ? std::atof(limit) : MAX_MEAN_TICK_US;
+    testing::Test::RecordProperty("ticks", (int)mount.ticks);
+    testing::Test::RecordProperty("us_per_tick", std::to_string(us));
+    std::printf("[          ] %u ticks, %.2f us per tick\n", mount.ticks, us);
+    EXPECT_LT(us, max_us);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// A goto onto a star, handed over to tracking as soon as the driver calls the slew complete,
+/// then tracking it for 5 minutes
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(control_golden_trace_tests, gotoSlew)
+{
+    const double ha0 = -3.0 * M_PI / 12.0, dec = deg2rad(25.0);
+    HorizontalKinematics hk0 = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, 0.0);
+    SimMount mount(rad2deg(hk0.alt) - 15.0, rad2deg(hk0.az) + 20.0);
+    mount.gotoStar(ha0, dec, 300.0, 0.0);
+    const double end_s = mount.t_s + 300.0;
+    while (mount.t_s < end_s)
+    {
+        mount.trackCommands(ha0, dec, mount.t_s);
+        mount.tick(TRACKING_COMMAND);
+    }
+    checkAgainstGolden("goto", mount);
+    checkTickCost(mount);
+}
+
+TEST(control_golden_trace_tests, track10Minutes)
+{
+    const double ha0 = -1.0 * M_PI / 12.0, dec = deg2rad(20.0);
+    HorizontalKinematics hk0 = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, 0.0);
+    SimMount mount(rad2deg(hk0.alt), rad2deg(hk0.az));
+    while (mount.t_s < 600.0)
+    {
+        mount.trackCommands(ha0, dec, mount.t_s);
+        mount.tick(TRACKING_COMMAND);
+    }
+    checkAgainstGolden("track", mount);
+    checkTickCost(mount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Tracking with a 500 ms pulse every 10 s, cycling through N, E, S and W at the default guide
+/// rate. Like the driver, a pulse moves the target a step each tick for its length.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(control_golden_trace_tests, guidePulses)
+{
+    const double ha0 = 0.5 * M_PI / 12.0, dec = deg2rad(-10.0);
+    const double guideStep_rad = 0.5 * LFAST_CONSTANTS::SiderealRate_radpersec * TEST_DT;
+    const unsigned pulseTicks = 25, periodTicks = 500;
+    HorizontalKinematics hk0 = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, 0.0);
+    SimMount mount(rad2deg(hk0.alt), rad2deg(hk0.az));
+
+    double haOffset = 0.0, decOffset = 0.0;
+    for (unsigned k = 0; k < 120 * periodTicks / 10; k++)
+    {
+        const unsigned phase = k % periodTicks, pulse = (k / periodTicks) % 4;
+        if (k >= periodTicks && phase < pulseTicks)
+        {
+            if (pulse == 0)
+                decOffset += guideStep_rad;
+            else if (pulse == 1)
+                haOffset -= guideStep_rad;
+            else if (pulse == 2)
+                decOffset -= guideStep_rad;
+            else
+                haOffset += guideStep_rad;
+        }
+        mount.trackCommands(ha0 + haOffset, dec + decOffset, mount.t_s);
+        mount.tick(TRACKING_COMMAND);
+    }
+    checkAgainstGolden("guide", mount);
+    checkTickCost(mount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Slew to track. The PID's integrator starts again from zero (the proportional path carries on)
+/// and the feedforward takes over the target rate. Carrying the slew's integrator over instead
+/// avoids that step in the command, but then neither handoff here settles within 120 s.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(control_golden_trace_tests, slewToTrackHandoff)
+{
+    // Away from the zenith, where the rates let the driver call the slew complete
+    const double ha0 = -2.0 * M_PI / 12.0, dec = deg2rad(10.0);
+    HorizontalKinematics hk0 = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, 0.0);
+
+    // To where the star was, then after it
+    SimMount fixed(rad2deg(hk0.alt) - 10.0, rad2deg(hk0.az) + 15.0);
+    fixed.slewTo(rad2deg(hk0.alt), rad2deg(hk0.az), 300.0);
+    const double w = LFAST_CONSTANTS::SiderealRate_radpersec;
+    const double haHandoff = ha0 - w * fixed.t_s;
+    HorizontalKinematics hk = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, w);
+    const double trackRate_dps[] = {rad2deg(hk.altRate), rad2deg(hk.azRate)};
+    fixed.trackCommands(haHandoff, dec, fixed.t_s);
+    fixed.tick(TRACKING_COMMAND);
+    SlewDrive *axes[] = {&fixed.alt, &fixed.az};
+    for (int k = 0; k < 2; k++)
+    {
+        ASSERT_EQ(axes[k]->getControlMode(), TRACKING_COMMAND);
+        const double e = axes[k]->getPositionError();
+        EXPECT_NEAR(axes[k]->getVelocityCommand() - trackRate_dps[k], SLEWDRIVE::SLEW_POSN_KP * e,
+                    std::abs(SLEWDRIVE::SLEW_POSN_KI * e * TEST_DT) + 1e-12);
+    }
+    const unsigned fixedSettle = fixed.trackUntilSettled(haHandoff, dec, 120.0);
+    EXPECT_LT(fixedSettle, MAX_SETTLE_TICKS);
+
+    // Slewing after the star, as the driver does
+    SimMount moving(rad2deg(hk0.alt) - 10.0, rad2deg(hk0.az) + 15.0);
+    moving.gotoStar(ha0, dec, 300.0, SETTLE_SEC);
+    const unsigned movingSettle = moving.trackUntilSettled(ha0, dec, 120.0);
+    EXPECT_LT(movingSettle, MAX_SETTLE_TICKS);
+    std::printf("[          ] settled in %u ticks after a fixed slew, %u following the target\n", fixedSettle,
+                movingSettle);
+}
+
+TEST(control_golden_trace_tests, park)
+{
+    const double ha0 = 2.0 * M_PI / 12.0, dec = deg2rad(35.0);
+    HorizontalKinematics hk0 = computeHorizontalKinematics(ha0, dec, SITE_LAT_RAD, 0.0);
+    SimMount mount(rad2deg(hk0.alt), rad2deg(hk0.az));
+    while (mount.t_s < 30.0)
+    {
+        mount.trackCommands(ha0, dec, mount.t_s);
+        mount.tick(TRACKING_COMMAND);
+    }
+    // The driver's default park position
+    mount.slewTo(-10.0, 0.0, 900.0);
+    mount.alt.slowStop();
+    mount.az.slowStop();
+    mount.alt.disable();
+    mount.az.disable();
+    checkAgainstGolden("park", mount);
+    checkTickCost(mount);
+}
@@ -0,0 +1,40 @@
+#include "../00_Utils/df2_filter.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+// Must be buildable at compile time from the coefficient tables
+constexpr DF2_IIR<double, 2> lpf_3_model(DIGITAL_CONTROL::lpf_3_b, DIGITAL_CONTROL::lpf_3_a);
+static_assert(lpf_3_model.order() == 2, "fixed order DF2_IIR should be constexpr constructible");
+
+TEST(df2_filter_tests, fixedOrderMatchesDynamicOrder)
+{
+    DF2_IIR<double> dynFilt(DIGITAL_CONTROL::lpf_10_b, DIGITAL_CONTROL::lpf_10_a, 2);
+    DF2_IIR<double, 2> fixedFilt(DIGITAL_CONTROL::lpf_10_b, DIGITAL_CONTROL::lpf_10_a);
+
+    for (int ii = 0; ii < 1000; ii++)
+    {
+        double x = std::sin(0.05 * ii) + ((ii % 37) == 0 ? 1.0 : 0.0);
+        // Same operation order, so results should be bit-identical
+        EXPECT_EQ(dynFilt.update(x), fixedFilt.update(x));
+    }
+}
+
+TEST(df2_filter_tests, constexprModelStepResponse)
+{
+    DF2_IIR<double, 2> model = lpf_3_model;
+    double y = 0;
+    for (int ii = 0; ii < 1000; ii++)
+        y = model.update(1.0);
+    EXPECT_NEAR(y, 1.0, 1e-4);
+
+    model.reset();
+    EXPECT_NEAR(model.update(1.0), DIGITAL_CONTROL::lpf_3_b[0], 1e-15);
+}
+
+TEST(df2_filter_tests, invalidPolesThrow)
+{
+    const double b[] = {1.0, 0.0, 0.0};
+    const double a[] = {2.0, 0.0, 0.0};
+    EXPECT_THROW((DF2_IIR<double, 2>(b, a)), std::runtime_error);
+    EXPECT_THROW((DF2_IIR<double>(b, a, 2)), std::runtime_error);
+}
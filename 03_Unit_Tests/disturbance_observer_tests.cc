@@ -0,0 +1,62 @@
+#include "../00_Utils/disturbance_observer.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define TEST_DT 0.02
+
+static const DIGITAL_CONTROL::AxisPlantModel testPlant{500.0, 10.0, 50.0, 2.0e5};
+
+TEST(disturbance_observer_tests, disabledByDefault)
+{
+    DisturbanceObserver dob(testPlant);
+    EXPECT_FALSE(dob.isEnabled());
+    EXPECT_EQ(dob.update(10.0, 0.1, TEST_DT), 0.0);
+    EXPECT_EQ(dob.getCompensatingRate(), 0.0);
+}
+
+TEST(disturbance_observer_tests, noLoadGivesZeroEstimate)
+{
+    DisturbanceObserver dob(testPlant);
+    dob.setBandwidth(2.0);
+    double prevRate = 0.0;
+    for (int ii = 0; ii < 500; ii++)
+    {
+        // Accelerating sinusoidal rate command, current exactly what the model needs
+        double rate = 0.01 * std::sin(0.5 * ii * TEST_DT);
+        double accel = ii == 0 ? 0.0 : (rate - prevRate) / TEST_DT;
+        prevRate = rate;
+        dob.update(dob.modelCurrent(accel, rate, 0.0), rate, TEST_DT);
+        EXPECT_NEAR(dob.getDisturbanceEstimate(), 0.0, 1e-9);
+    }
+}
+
+TEST(disturbance_observer_tests, stepLoadConverges)
+{
+    const double bw_Hz = 1.0;
+    const double load_Nm = 300.0;
+    DisturbanceObserver dob(testPlant);
+    dob.setBandwidth(bw_Hz);
+    dob.update(dob.modelCurrent(0.0, 0.004, 0.0), 0.004, TEST_DT);
+
+    // One time constant after the step the estimate should be ~63% of the way there
+    int tauSteps = (int)std::round(1.0 / (2.0 * M_PI * bw_Hz * TEST_DT));
+    for (int ii = 0; ii < tauSteps; ii++)
+        dob.update(dob.modelCurrent(0.0, 0.004, load_Nm), 0.004, TEST_DT);
+    EXPECT_NEAR(dob.getDisturbanceEstimate() / load_Nm, 1.0 - std::exp(-1.0), 0.02);
+
+    for (int ii = 0; ii < 50 * tauSteps; ii++)
+        dob.update(dob.modelCurrent(0.0, 0.004, load_Nm), 0.004, TEST_DT);
+    EXPECT_NEAR(dob.getDisturbanceEstimate(), load_Nm, 1e-6);
+    EXPECT_NEAR(dob.getCompensatingRate(), load_Nm / testPlant.rateLoopStiffness_NmPerDps, 1e-12);
+}
+
+TEST(disturbance_observer_tests, disablingResetsEstimate)
+{
+    DisturbanceObserver dob(testPlant);
+    dob.setBandwidth(5.0);
+    for (int ii = 0; ii < 100; ii++)
+        dob.update(dob.modelCurrent(0.0, 0.0, 100.0), 0.0, TEST_DT);
+    EXPECT_GT(dob.getDisturbanceEstimate(), 0.0);
+    dob.setBandwidth(0.0);
+    EXPECT_EQ(dob.getDisturbanceEstimate(), 0.0);
+}
@@ -0,0 +1,130 @@
+#include "../00_Utils/flight_recorder.h"
+#include "../00_Utils/telemetry_reader.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#define JD_START 2460000.5
+
+static TelemetryRecord makeRecord(unsigned k)
+{
+    TelemetryRecord r;
+    std::memset(&r, 0, sizeof(r));
+    r.jd = JD_START + k / 86400.0;
+    r.alt_posn_err_deg = k;
+    r.az_drive_a_status = 0x0008;
+    return r;
+}
+
+static std::string freshDir(const char *name)
+{
+    std::string dir = testing::TempDir() + name;
+    ::mkdir(dir.c_str(), 0755);
+    DIR *d = opendir(dir.c_str());
+    while (struct dirent *e = readdir(d))
+    {
+        if (e->d_name[0] != '.')
+            std::remove((dir + "/" + e->d_name).c_str());
+    }
+    closedir(d);
+    return dir;
+}
+
+TEST(flight_recorder_tests, keepsHistoryAndPostTrigger)
+{
+    // 1 s records: 10 s of history, 2 s after the trigger
+    FlightRecorder recorder(1.0, 10.0, 2.0);
+    EXPECT_EQ(recorder.getCapacity(), 10u);
+    for (unsigned k = 0; k < 20; k++)
+        EXPECT_FALSE(recorder.record(makeRecord(k)));
+
+    EXPECT_TRUE(recorder.trigger("Drive reporting FAULT", 0.0));
+    EXPECT_TRUE(recorder.isArmed());
+    EXPECT_FALSE(recorder.record(makeRecord(20)));
+    EXPECT_TRUE(recorder.record(makeRecord(21)));
+
+    const FlightRecorderDump &dump = recorder.takeDump();
+    EXPECT_FALSE(recorder.isArmed());
+    EXPECT_EQ(dump.reason, "Drive reporting FAULT");
+    EXPECT_DOUBLE_EQ(dump.triggerJd, makeRecord(19).jd);
+    ASSERT_EQ(dump.size(), 10u);
+    for (unsigned k = 0; k < 10; k++)
+        EXPECT_DOUBLE_EQ(dump[k].alt_posn_err_deg, 12.0 + k);
+}
+
+TEST(flight_recorder_tests, dumpsSwapRingsInsteadOfCopying)
+{
+    FlightRecorder recorder(1.0, 10.0, 0.0);
+    for (unsigned k = 0; k < 4; k++)
+        recorder.record(makeRecord(k));
+    recorder.trigger("Abort", 0.0);
+    recorder.record(makeRecord(4));
+    const TelemetryRecord *first = recorder.takeDump().records.data();
+
+    // Recording starts over in the other ring, and the next dump hands the first one back
+    recorder.record(makeRecord(5));
+    recorder.trigger("Operator request", 1.0);
+    recorder.record(makeRecord(6));
+    const FlightRecorderDump &dump = recorder.takeDump();
+    EXPECT_NE(dump.records.data(), first);
+    ASSERT_EQ(dump.size(), 2u);
+    EXPECT_DOUBLE_EQ(dump[0].alt_posn_err_deg, 5.0);
+    EXPECT_EQ(dump.reason, "Operator request");
+
+    recorder.trigger("Abort", 100.0);
+    recorder.record(makeRecord(7));
+    EXPECT_EQ(recorder.takeDump().records.data(), first);
+}
+
+TEST(flight_recorder_tests, coalescesAndHoldsOffRepeats)
+{
+    FlightRecorder recorder(1.0, 10.0, 0.0);
+    recorder.record(makeRecord(0));
+    EXPECT_TRUE(recorder.trigger("Abort", 0.0));
+    EXPECT_FALSE(recorder.trigger("E-Stop pushed", 0.5));
+    EXPECT_TRUE(recorder.record(makeRecord(1)));
+    EXPECT_EQ(recorder.takeDump().reason, "Abort; E-Stop pushed");
+
+    // A fault reported every tick only dumps once, until it has been quiet for the holdoff
+    const double t = 0.8 * FLIGHT_RECORDER::REPEAT_HOLDOFF_SEC;
+    EXPECT_FALSE(recorder.trigger("E-Stop pushed", 1.0));
+    EXPECT_FALSE(recorder.trigger("E-Stop pushed", 1.0 + t));
+    EXPECT_FALSE(recorder.trigger("E-Stop pushed", 1.0 + 2 * t));
+    EXPECT_FALSE(recorder.isArmed());
+    EXPECT_TRUE(recorder.trigger("E-Stop pushed", 1.0 + 2 * t + FLIGHT_RECORDER::REPEAT_HOLDOFF_SEC));
+}
+
+TEST(flight_recorder_tests, dumpIsATelemetryFile)
+{
+    const std::string dir = freshDir("flight_recorder");
+    FlightRecorder recorder(1.0, 50.0, 0.0);
+    for (unsigned k = 0; k < 80; k++)
+        recorder.record(makeRecord(k));
+    recorder.trigger("velocities out of range", 0.0);
+    recorder.record(makeRecord(80));
+    const FlightRecorderDump &dump = recorder.takeDump();
+
+    const std::string path = FlightRecorder::writeDump(dir, dump);
+    EXPECT_NE(path.find("/flight_20230225T000119Z.lftm"), std::string::npos) << path;
+    TelemetryReader reader(path);
+    EXPECT_EQ(reader.numRecords(), 50u);
+    EXPECT_DOUBLE_EQ(reader.firstJd(), makeRecord(31).jd);
+    EXPECT_DOUBLE_EQ(reader.lastJd(), makeRecord(80).jd);
+    EXPECT_EQ(reader.summarize(TM_az_drive_a_status, 0, 1e9).max, 8.0);
+
+    std::ifstream note(path.substr(0, path.size() - std::strlen(TELEMETRY::FILE_SUFFIX)) + FLIGHT_RECORDER::NOTE_SUFFIX);
+    std::string line;
+    std::getline(note, line);
+    EXPECT_EQ(line, "reason: velocities out of range");
+
+    // A second dump in the same second doesn't replace the first, and no temporary is left over
+    const std::string second = FlightRecorder::writeDump(dir, dump);
+    EXPECT_NE(second, path);
+    struct stat st;
+    EXPECT_NE(stat((path + ".tmp").c_str(), &st), 0);
+    EXPECT_NE(stat((second + ".tmp").c_str(), &st), 0);
+}
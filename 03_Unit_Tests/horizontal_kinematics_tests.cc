@@ -0,0 +1,90 @@
+#include "../00_Utils/horizontal_kinematics.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define SIDEREAL_RATE_RADPS 7.2921158553e-5
+#define DEG2RAD (M_PI / 180.0)
+#define FD_STEP_SEC 0.5
+
+static double wrapPi(double a) { return std::remainder(a, 2.0 * M_PI); }
+
+// Central differences of position (and of rate) across +/- FD_STEP_SEC
+static void checkAgainstFiniteDifferences(double ha, double dec, double lat)
+{
+    const double w = SIDEREAL_RATE_RADPS;
+    const double dH = w * FD_STEP_SEC;
+    HorizontalKinematics hk = computeHorizontalKinematics(ha, dec, lat, w);
+    HorizontalKinematics hkm = computeHorizontalKinematics(ha - dH, dec, lat, w);
+    HorizontalKinematics hkp = computeHorizontalKinematics(ha + dH, dec, lat, w);
+    ASSERT_FALSE(hk.nearZenith);
+
+    double altRateFD = (hkp.alt - hkm.alt) / (2.0 * FD_STEP_SEC);
+    double azRateFD = wrapPi(hkp.az - hkm.az) / (2.0 * FD_STEP_SEC);
+    double altAccelFD = (hkp.altRate - hkm.altRate) / (2.0 * FD_STEP_SEC);
+    double azAccelFD = (hkp.azRate - hkm.azRate) / (2.0 * FD_STEP_SEC);
+    double altAccelFD2 = (hkp.alt - 2.0 * hk.alt + hkm.alt) / (FD_STEP_SEC * FD_STEP_SEC);
+
+    // Scale the tolerance with the size of the rate (it grows near the zenith)
+    double rateTol = 1e-9 * (1.0 + std::fabs(hk.azRate) / w);
+    EXPECT_NEAR(hk.altRate, altRateFD, rateTol) << "ha " << ha << " dec " << dec << " lat " << lat;
+    EXPECT_NEAR(hk.azRate, azRateFD, rateTol) << "ha " << ha << " dec " << dec << " lat " << lat;
+    double accelTol = 1e-11 * (1.0 + std::fabs(hk.azAccel) / (w * w));
+    EXPECT_NEAR(hk.altAccel, altAccelFD, accelTol) << "ha " << ha << " dec " << dec << " lat " << lat;
+    EXPECT_NEAR(hk.azAccel, azAccelFD, accelTol) << "ha " << ha << " dec " << dec << " lat " << lat;
+    EXPECT_NEAR(hk.altAccel, altAccelFD2, 1e-6 * w * w + accelTol);
+}
+
+TEST(horizontal_kinematics_tests, matchesFiniteDifferences)
+{
+    for (double lat = -60.0; lat <= 60.0; lat += 30.0)
+        for (double dec = -75.0; dec <= 85.0; dec += 20.0)
+            for (double ha = -180.0; ha < 180.0; ha += 22.5)
+                checkAgainstFiniteDifferences(ha * DEG2RAD, dec * DEG2RAD, lat * DEG2RAD);
+}
+
+TEST(horizontal_kinematics_tests, closeToZenithStillExact)
+{
+    // 0.5 deg from the zenith at transit: azimuth is moving quickly but the derivatives still hold
+    const double lat = 32.0 * DEG2RAD;
+    for (double ha = -0.2; ha <= 0.2; ha += 0.05)
+        checkAgainstFiniteDifferences(ha * DEG2RAD, lat + 0.5 * DEG2RAD, lat);
+}
+
+TEST(horizontal_kinematics_tests, positionMatchesSphericalTrig)
+{
+    const double lat = 32.4 * DEG2RAD, dec = 10.0 * DEG2RAD, ha = 30.0 * DEG2RAD;
+    HorizontalKinematics hk = computeHorizontalKinematics(ha, dec, lat, SIDEREAL_RATE_RADPS);
+    double sinAlt = std::sin(lat) * std::sin(dec) + std::cos(lat) * std::cos(dec) * std::cos(ha);
+    EXPECT_NEAR(hk.alt, std::asin(sinAlt), 1e-12);
+    // West of the meridian in the northern hemisphere: azimuth between south and north via west
+    EXPECT_GT(hk.az, M_PI);
+    EXPECT_LT(hk.az, 2.0 * M_PI);
+    // Setting
+    EXPECT_LT(hk.altRate, 0.0);
+}
+
+TEST(horizontal_kinematics_tests, meridianTransit)
+{
+    // At transit altitude peaks (zero rate, negative acceleration), and azimuth rate is
+    // omega * cos(dec) / cos(alt)
+    const double lat = 32.4 * DEG2RAD, dec = 10.0 * DEG2RAD;
+    const double w = SIDEREAL_RATE_RADPS;
+    HorizontalKinematics hk = computeHorizontalKinematics(0.0, dec, lat, w);
+    EXPECT_NEAR(hk.altRate, 0.0, 1e-15);
+    EXPECT_LT(hk.altAccel, 0.0);
+    EXPECT_NEAR(hk.azRate, w * std::cos(dec) / std::cos(hk.alt), 1e-15);
+    EXPECT_NEAR(hk.az, M_PI, 1e-12);
+}
+
+TEST(horizontal_kinematics_tests, zenithIsFinite)
+{
+    const double lat = 32.4 * DEG2RAD;
+    HorizontalKinematics hk = computeHorizontalKinematics(0.0, lat, lat, SIDEREAL_RATE_RADPS);
+    EXPECT_TRUE(hk.nearZenith);
+    EXPECT_NEAR(hk.alt, M_PI_2, 1e-12);
+    EXPECT_TRUE(std::isfinite(hk.azRate));
+    EXPECT_TRUE(std::isfinite(hk.azAccel));
+    // Capped at roughly omega / sin(min zenith distance)
+    EXPECT_LE(std::fabs(hk.azRate),
+              1.01 * SIDEREAL_RATE_RADPS / std::sin(KINEMATICS::DEFAULT_MIN_ZENITH_DIST_RAD));
+}
@@ -0,0 +1,121 @@
+#include "../00_Utils/keyhole_planner.h"
+#include "../00_Utils/horizontal_kinematics.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define SITE_LAT 32.4
+#define JD_TRANSIT 2460000.25
+#define SIDEREAL_RATE_RADPS 7.2921150e-5
+#define MAX_AZ_RATE_DPS 1.0
+
+static const double DEG2RAD = M_PI / 180.0;
+
+// Fixed star that transits at JD_TRANSIT, zenithDist_deg south of the zenith (negative for north)
+static TrackingEphemeris::Sampler starSampler(double zenithDist_deg)
+{
+    double dec = SITE_LAT - zenithDist_deg;
+    return [dec](double jd, double *values)
+    {
+        double ha = (jd - JD_TRANSIT) * 86400.0 * SIDEREAL_RATE_RADPS;
+        HorizontalKinematics hk = computeHorizontalKinematics(ha, dec * DEG2RAD, SITE_LAT * DEG2RAD, SIDEREAL_RATE_RADPS, 0.0);
+        values[EPHEM_ALT] = hk.alt / DEG2RAD;
+        values[EPHEM_AZ] = hk.az / DEG2RAD;
+        values[EPHEM_RA] = 0.0;
+        values[EPHEM_DEC] = dec;
+        return true;
+    };
+}
+
+static double targetAz(const TrackingEphemeris::Sampler &s, double jd)
+{
+    double values[NUM_EPHEM_CHANNELS];
+    s(jd, values);
+    return values[EPHEM_AZ];
+}
+
+static double azDiff(double a, double b)
+{
+    double d = a - b;
+    return d - 360.0 * std::floor((d + 180.0) / 360.0);
+}
+
+TEST(keyhole_planner_tests, noKeyholeAwayFromZenith)
+{
+    KeyholeLimits limits{MAX_AZ_RATE_DPS, 5.0};
+    KeyholePlan p = KeyholePlan::plan(starSampler(20.0), JD_TRANSIT - 600.0 / 86400.0, limits);
+    EXPECT_FALSE(p.isValid());
+    EXPECT_TRUE(p.getError().empty());
+
+    // Close to the zenith, but slow enough for the drive
+    p = KeyholePlan::plan(starSampler(1.0), JD_TRANSIT - 600.0 / 86400.0, limits);
+    EXPECT_FALSE(p.isValid());
+}
+
+TEST(keyhole_planner_tests, plansBoundedRateTransit)
+{
+    TrackingEphemeris::Sampler s = starSampler(0.05);
+    KeyholeLimits limits{MAX_AZ_RATE_DPS, 5.0};
+    KeyholePlan p = KeyholePlan::plan(s, JD_TRANSIT - 600.0 / 86400.0, limits);
+    ASSERT_TRUE(p.isValid()) << p.getError();
+
+    EXPECT_NEAR((p.getTransit() - JD_TRANSIT) * 86400.0, 0.0, 0.01);
+    EXPECT_NEAR(p.getMinZenithDistance(), 0.05, 1e-4);
+    // A star south of the zenith turns east to west through south: azimuth increasing
+    EXPECT_GT(p.getPeakTargetAzRate(), MAX_AZ_RATE_DPS);
+    EXPECT_DOUBLE_EQ(p.getAzRate(), MAX_AZ_RATE_DPS);
+    EXPECT_NEAR(p.getTransit() - p.getStart(), p.getEnd() - p.getTransit(), 1e-9);
+
+    // Joins the target at both ends and turns through the same angle
+    double az, rate;
+    ASSERT_TRUE(p.evaluate(p.getStart(), az, rate));
+    EXPECT_NEAR(azDiff(az, targetAz(s, p.getStart())), 0.0, 1e-6);
+    ASSERT_TRUE(p.evaluate(p.getEnd(), az, rate));
+    EXPECT_NEAR(azDiff(az, targetAz(s, p.getEnd())), 0.0, 1e-2);
+    EXPECT_FALSE(p.evaluate(p.getStart() - 1e-6, az, rate));
+    EXPECT_FALSE(p.evaluate(p.getEnd() + 1e-6, az, rate));
+
+    // Ahead of the target before the transit, behind it after
+    p.evaluate(p.getTransit() - 2.0 / 86400.0, az, rate);
+    EXPECT_GT(azDiff(az, targetAz(s, p.getTransit() - 2.0 / 86400.0)), 0.0);
+    p.evaluate(p.getTransit() + 2.0 / 86400.0, az, rate);
+    EXPECT_LT(azDiff(az, targetAz(s, p.getTransit() + 2.0 / 86400.0)), 0.0);
+
+    // The error is bounded by the azimuth lag scaled by the zenith distance
+    EXPECT_GT(p.getMaxError(), 0.0);
+    EXPECT_LT(p.getMaxError(), 0.05 * 3600.0 * 2.0);
+}
+
+TEST(keyhole_planner_tests, toleranceReport)
+{
+    TrackingEphemeris::Sampler s = starSampler(-0.03);
+    KeyholePlan tight = KeyholePlan::plan(s, JD_TRANSIT - 600.0 / 86400.0, KeyholeLimits{MAX_AZ_RATE_DPS, 1.0});
+    KeyholePlan loose = KeyholePlan::plan(s, JD_TRANSIT - 600.0 / 86400.0, KeyholeLimits{MAX_AZ_RATE_DPS, 1.0e4});
+    ASSERT_TRUE(tight.isValid());
+    ASSERT_TRUE(loose.isValid());
+    // North of the zenith the azimuth turns the other way
+    EXPECT_DOUBLE_EQ(tight.getAzRate(), -MAX_AZ_RATE_DPS);
+    EXPECT_GT(tight.getTimeOutsideTolerance(), 0.0);
+    EXPECT_LE(tight.getTimeOutsideTolerance(), (tight.getEnd() - tight.getStart()) * 86400.0 + 0.1);
+    EXPECT_EQ(loose.getTimeOutsideTolerance(), 0.0);
+    EXPECT_DOUBLE_EQ(tight.getMaxError(), loose.getMaxError());
+
+    // A faster drive has a shorter transit
+    KeyholePlan fast = KeyholePlan::plan(s, JD_TRANSIT - 600.0 / 86400.0, KeyholeLimits{4.0 * MAX_AZ_RATE_DPS, 1.0});
+    ASSERT_TRUE(fast.isValid());
+    EXPECT_LT(fast.getEnd() - fast.getStart(), tight.getEnd() - tight.getStart());
+    EXPECT_LT(fast.getMaxError(), tight.getMaxError());
+}
+
+TEST(keyhole_planner_tests, findsTransitInProgress)
+{
+    TrackingEphemeris::Sampler s = starSampler(0.02);
+    KeyholeLimits limits{MAX_AZ_RATE_DPS, 5.0};
+    KeyholePlan ahead = KeyholePlan::plan(s, JD_TRANSIT - 600.0 / 86400.0, limits);
+    ASSERT_TRUE(ahead.isValid());
+    KeyholePlan during = KeyholePlan::plan(s, JD_TRANSIT + 1.0 / 86400.0, limits);
+    ASSERT_TRUE(during.isValid());
+    EXPECT_NEAR((during.getStart() - ahead.getStart()) * 86400.0, 0.0, 0.01);
+
+    KeyholePlan after = KeyholePlan::plan(s, ahead.getEnd() + 1.0 / 86400.0, limits);
+    EXPECT_FALSE(after.isValid());
+}
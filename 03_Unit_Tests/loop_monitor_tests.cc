@@ -0,0 +1,74 @@
+#include "../00_Utils/loop_monitor.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define PERIOD 0.02
+
+TEST(loop_monitor_tests, histogramAndStats)
+{
+    LoopMonitor monitor(PERIOD);
+    // The first tick has no period
+    EXPECT_EQ(monitor.update(0.0, 0.001), LOOP_MODE_UNCHANGED);
+    for (unsigned k = 0; k < 8; k++)
+        monitor.update(PERIOD, 0.001);
+    monitor.update(1.3 * PERIOD, 0.001);
+    monitor.update(4.0 * PERIOD, 0.001);
+
+    LoopPeriodStats s = monitor.getStats();
+    EXPECT_EQ(s.ticks, 10u);
+    EXPECT_EQ(s.overruns, 1u);
+    EXPECT_DOUBLE_EQ(s.max_s, 4.0 * PERIOD);
+    EXPECT_NEAR(s.mean_s, 1.33 * PERIOD, 1e-12);
+    EXPECT_NEAR(s.jitterRms_s, PERIOD * std::sqrt((0.09 + 9.0) / 10.0), 1e-12);
+
+    const uint64_t *hist = monitor.getHistogram();
+    uint64_t total = 0;
+    for (unsigned k = 0; k < LOOP_MONITOR::NUM_BINS; k++)
+        total += hist[k];
+    EXPECT_EQ(total, 10u);
+    // [0.95, 1.05), [1.2, 1.5) and the open top bin
+    EXPECT_EQ(hist[4], 8u);
+    EXPECT_EQ(hist[7], 1u);
+    EXPECT_EQ(hist[LOOP_MONITOR::NUM_BINS - 1], 1u);
+    EXPECT_DOUBLE_EQ(monitor.getBinEdge(4), 1.05 * PERIOD);
+}
+
+TEST(loop_monitor_tests, persistentOverrunsDegrade)
+{
+    LoopMonitor monitor(PERIOD);
+    // Occasional long ticks are tolerated
+    for (unsigned k = 0; k < 10 * LOOP_MONITOR::WINDOW_TICKS; k++)
+        EXPECT_EQ(monitor.update(k % 20 ? PERIOD : 2.0 * PERIOD, 0.001), LOOP_MODE_UNCHANGED);
+    EXPECT_FALSE(monitor.isDegraded());
+
+    unsigned k = 0;
+    while (monitor.update(2.0 * PERIOD, 0.03) != LOOP_MODE_DEGRADED)
+        ASSERT_LT(++k, LOOP_MONITOR::WINDOW_TICKS);
+    EXPECT_TRUE(monitor.isDegraded());
+    EXPECT_GE(monitor.getRecentOverruns(), LOOP_MONITOR::DEGRADE_OVERRUNS);
+}
+
+TEST(loop_monitor_tests, recoversAfterQuietPeriod)
+{
+    LoopMonitor monitor(PERIOD);
+    for (unsigned k = 0; k < LOOP_MONITOR::DEGRADE_OVERRUNS; k++)
+        monitor.update(2.0 * PERIOD, 0.03);
+    ASSERT_TRUE(monitor.isDegraded());
+
+    // On time, but still busy: no recovery
+    const unsigned quietTicks = (unsigned)std::ceil(LOOP_MONITOR::RECOVER_SEC / PERIOD);
+    for (unsigned k = 0; k < 2 * quietTicks; k++)
+        EXPECT_EQ(monitor.update(PERIOD, 0.8 * PERIOD), LOOP_MODE_UNCHANGED);
+    EXPECT_TRUE(monitor.isDegraded());
+
+    // A single overrun restarts the quiet period
+    for (unsigned k = 0; k < quietTicks - 10; k++)
+        monitor.update(PERIOD, 0.001);
+    monitor.update(2.0 * PERIOD, 0.001);
+    unsigned k = 0;
+    while (monitor.update(PERIOD, 0.001) != LOOP_MODE_RECOVERED)
+        ASSERT_LT(++k, quietTicks + 1);
+    EXPECT_GE(k + 1, quietTicks - 1);
+    EXPECT_FALSE(monitor.isDegraded());
+    EXPECT_EQ(monitor.getRecentOverruns(), 0u);
+}
@@ -0,0 +1,96 @@
+#include "../00_Utils/PID_Controller.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+constexpr double TEST_DT = 0.02;
+
+TEST(pid_controller_tests, outputSaturation)
+{
+    PID_Controller pid(2.0, 0.0, 0.0);
+    pid.configureOutputSaturation(1.0, -0.5);
+    pid.reset();
+    double u;
+    pid.update(10.0, TEST_DT, &u);
+    EXPECT_DOUBLE_EQ(u, 1.0);
+    EXPECT_TRUE(pid.outputIsSaturated());
+    pid.update(-10.0, TEST_DT, &u);
+    EXPECT_DOUBLE_EQ(u, -0.5);
+    pid.update(0.1, TEST_DT, &u);
+    EXPECT_DOUBLE_EQ(u, 0.2);
+    EXPECT_FALSE(pid.outputIsSaturated());
+}
+
+// Hold a large error for a while (output pinned at the limit), then reverse it.
+// Returns the number of steps until the output comes off the upper limit.
+static unsigned stepsToRecover(PID_Controller &pid)
+{
+    double u;
+    for (unsigned k = 0; k < 500; k++)
+        pid.update(1.0, TEST_DT, &u);
+    unsigned steps = 0;
+    do
+    {
+        pid.update(-0.1, TEST_DT, &u);
+        steps++;
+    } while (u >= 1.0 && steps < 10000);
+    return steps;
+}
+
+TEST(pid_controller_tests, backCalculationAntiWindup)
+{
+    PID_Controller windup(0.5, 2.0, 0.0);
+    windup.configureOutputSaturation(1.0, -1.0);
+    windup.reset();
+
+    PID_Controller antiWindup(0.5, 2.0, 0.0);
+    antiWindup.configureOutputSaturation(1.0, -1.0);
+    antiWindup.configureAntiWindup(10.0);
+    antiWindup.reset();
+
+    unsigned windupSteps = stepsToRecover(windup);
+    unsigned antiWindupSteps = stepsToRecover(antiWindup);
+    EXPECT_GT(windupSteps, 100u);
+    EXPECT_LT(antiWindupSteps, 10u);
+}
+
+TEST(pid_controller_tests, antiWindupInactiveWhenUnsaturated)
+{
+    PID_Controller plain(0.6, 0.01, 0.0);
+    PID_Controller antiWindup(0.6, 0.01, 0.0);
+    antiWindup.configureOutputSaturation(10.0, -10.0);
+    antiWindup.configureAntiWindup(5.0);
+    plain.reset();
+    antiWindup.reset();
+    for (unsigned k = 0; k < 200; k++)
+    {
+        double e = std::sin(0.05 * k);
+        double u1, u2;
+        plain.update(e, TEST_DT, &u1);
+        antiWindup.update(e, TEST_DT, &u2);
+        EXPECT_EQ(u1, u2);
+    }
+}
+
+TEST(pid_controller_tests, bumplessInitialization)
+{
+    PID_Controller pid(0.6, 0.01, 0.2);
+    pid.reset();
+    double u;
+    const double uPrev = 0.35;
+    const double e = 0.05;
+    pid.initializeIntegrator(uPrev, e);
+    pid.update(e, TEST_DT, &u);
+    // Only this tick's integration separates the output from the previous command
+    EXPECT_NEAR(u, uPrev, std::abs(e * 0.01 * TEST_DT) + 1e-12);
+}
+
+TEST(pid_controller_tests, bumplessInitializationRespectsIntegratorLimits)
+{
+    PID_Controller pid(1.0, 1.0, 0.0);
+    pid.configureIntegratorSaturation(0.1, -0.1);
+    pid.reset();
+    double u;
+    pid.initializeIntegrator(5.0, 0.0);
+    pid.update(0.0, TEST_DT, &u);
+    EXPECT_DOUBLE_EQ(u, 0.1);
+}
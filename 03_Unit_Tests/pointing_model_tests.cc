@@ -0,0 +1,148 @@
+#include "../00_Utils/pointing_model.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+static PointingModel makeTruthModel()
+{
+    const double values[NUM_POINTING_TERMS] = {120.0, -45.0, 30.0, -12.0, 8.0, -15.0, 25.0, 6.0, -4.0, -5.0};
+    PointingModel truth;
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        truth.setCoefficient(k, values[k]);
+    return truth;
+}
+
+static std::vector<PointingObservation> makeObservations(const PointingModel &truth, double noise_arcsec)
+{
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> noise(0.0, noise_arcsec);
+    std::vector<PointingObservation> points;
+    for (double alt = 15.0; alt <= 85.0; alt += 10.0)
+    {
+        for (double az = 5.0; az < 360.0; az += 30.0)
+        {
+            PointingObservation obs{alt, az, 0, 0};
+            truth.skyToMount(alt, az, &obs.mountAlt, &obs.mountAz);
+            if (noise_arcsec > 0.0)
+            {
+                obs.mountAlt += noise(rng) / 3600.0;
+                obs.mountAz += noise(rng) / 3600.0 / std::cos(alt * M_PI / 180.0);
+            }
+            points.push_back(obs);
+        }
+    }
+    return points;
+}
+
+TEST(pointing_model_tests, fitRecoversModel)
+{
+    PointingModel truth = makeTruthModel();
+    PointingFitter fitter;
+    for (const PointingObservation &obs : makeObservations(truth, 0.0))
+        fitter.add(obs);
+
+    PointingModel fitted;
+    PointingFitResult result = fitter.solve(PM_ALL_TERMS, fitted);
+    ASSERT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(result.numPoints, 96u);
+    EXPECT_LT(result.rms_arcsec, 1e-3);
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        EXPECT_NEAR(fitted.getCoefficient(k), truth.getCoefficient(k), 1e-4) << PointingModel::termName(k);
+}
+
+TEST(pointing_model_tests, noisyFitIsWithinErrors)
+{
+    PointingModel truth = makeTruthModel();
+    std::vector<PointingObservation> points = makeObservations(truth, 2.0);
+    PointingFitter fitter;
+    for (const PointingObservation &obs : points)
+        fitter.add(obs);
+
+    PointingModel fitted;
+    PointingFitResult result = fitter.solve(PM_ALL_TERMS, fitted);
+    ASSERT_TRUE(result.ok) << result.error;
+    // Two 2" components per point
+    EXPECT_NEAR(result.rms_arcsec, 2.0 * std::sqrt(2.0), 0.5);
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+    {
+        EXPECT_GT(result.sigma_arcsec[k], 0.0);
+        EXPECT_NEAR(fitted.getCoefficient(k), truth.getCoefficient(k), 4.0 * result.sigma_arcsec[k])
+            << PointingModel::termName(k);
+    }
+
+    // The residual of each point is consistent with the reported RMS
+    double ss = 0.0;
+    for (const PointingObservation &obs : points)
+        ss += std::pow(PointingFitter::residual(fitted, obs), 2);
+    EXPECT_NEAR(std::sqrt(ss / points.size()), result.rms_arcsec, 1e-6);
+}
+
+TEST(pointing_model_tests, degenerateTermIsReported)
+{
+    // At a single elevation CA (sec E) can't be told apart from IA
+    PointingModel truth = makeTruthModel();
+    PointingFitter fitter;
+    for (double az = 0.0; az < 360.0; az += 20.0)
+    {
+        PointingObservation obs{40.0, az, 0, 0};
+        truth.skyToMount(obs.skyAlt, obs.skyAz, &obs.mountAlt, &obs.mountAz);
+        fitter.add(obs);
+    }
+    PointingModel fitted = truth;
+    PointingFitResult result = fitter.solve(PM_TERM_BIT(PM_IA) | PM_TERM_BIT(PM_CA), fitted);
+    EXPECT_FALSE(result.ok);
+    EXPECT_NE(result.error.find("CA"), std::string::npos);
+    EXPECT_EQ(fitted.getCoefficient(PM_IA), truth.getCoefficient(PM_IA));
+
+    PointingFitter empty;
+    EXPECT_FALSE(empty.solve(PM_BASIC_TERMS, fitted).ok);
+}
+
+TEST(pointing_model_tests, mountToSkyInvertsModel)
+{
+    PointingModel model = makeTruthModel();
+    for (double alt = 5.0; alt < 89.0; alt += 7.0)
+    {
+        for (double az = 1.0; az < 360.0; az += 23.0)
+        {
+            double mAlt, mAz, alt2, az2;
+            model.skyToMount(alt, az, &mAlt, &mAz);
+            model.mountToSky(mAlt, mAz, &alt2, &az2);
+            EXPECT_NEAR(alt2, alt, 1e-3 / 3600.0);
+            EXPECT_NEAR(std::remainder(az2 - az, 360.0), 0.0, 1e-3 / 3600.0);
+        }
+    }
+}
+
+TEST(pointing_model_tests, rateMatchesFiniteDifference)
+{
+    PointingModel model = makeTruthModel();
+    const double altRate = 0.004, azRate = -0.011, dt = 1e-3;
+    for (double alt : {10.0, 45.0, 80.0})
+    {
+        for (double az : {30.0, 200.0})
+        {
+            double mAltRate, mAzRate, a0, z0, a1, z1;
+            model.skyRateToMount(alt, az, altRate, azRate, &mAltRate, &mAzRate);
+            model.skyToMount(alt - altRate * dt, az - azRate * dt, &a0, &z0);
+            model.skyToMount(alt + altRate * dt, az + azRate * dt, &a1, &z1);
+            EXPECT_NEAR(mAltRate, (a1 - a0) / (2 * dt), 1e-9);
+            EXPECT_NEAR(mAzRate, std::remainder(z1 - z0, 360.0) / (2 * dt), 1e-9);
+        }
+    }
+}
+
+TEST(pointing_model_tests, parseObservation)
+{
+    PointingObservation obs{12.5, 180.25, 12.501, 180.2};
+    PointingObservation parsed;
+    ASSERT_TRUE(PointingFitter::parseObservation(PointingFitter::formatObservation(obs) + "  # star 1", parsed));
+    EXPECT_DOUBLE_EQ(parsed.skyAlt, obs.skyAlt);
+    EXPECT_DOUBLE_EQ(parsed.skyAz, obs.skyAz);
+    EXPECT_DOUBLE_EQ(parsed.mountAlt, obs.mountAlt);
+    EXPECT_DOUBLE_EQ(parsed.mountAz, obs.mountAz);
+    EXPECT_FALSE(PointingFitter::parseObservation("# skyAz skyAlt mountAz mountAlt", parsed));
+    EXPECT_FALSE(PointingFitter::parseObservation("1 2 3", parsed));
+    EXPECT_EQ(PointingModel::termFromName("NPAE"), (unsigned)PM_NPAE);
+    EXPECT_EQ(PointingModel::termFromName("XX"), (unsigned)NUM_POINTING_TERMS);
+}
@@ -0,0 +1,81 @@
+#include "../00_Utils/publish_throttle.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(publish_throttle_tests, rateLimitCoalesces)
+{
+    PublishThrottle throttle(1, 4);
+    std::vector<double> sent;
+    double value = 0.0;
+    throttle.configure(0, 4.0, 0.0, [&]() { sent.push_back(value); });
+
+    // 32 Hz updates of a moving value go out at 4 Hz, each with the newest value
+    for (unsigned k = 0; k < 50; k++)
+    {
+        value = k;
+        throttle.update(0, &value, 1);
+        throttle.flush(k / 32.0);
+    }
+    ASSERT_EQ(sent.size(), 7u);
+    EXPECT_EQ(sent[0], 0.0);
+    EXPECT_EQ(sent[1], 8.0);
+    EXPECT_EQ(sent[6], 48.0);
+    EXPECT_EQ(throttle.getPublished(0), 7u);
+    EXPECT_TRUE(throttle.isPending(0));
+}
+
+TEST(publish_throttle_tests, deadbandAndStateChanges)
+{
+    PublishThrottle throttle(1, 4);
+    unsigned published = 0;
+    throttle.configure(0, 1.0, 0.5, [&]() { published++; });
+
+    double v = 10.0;
+    throttle.update(0, &v, 1);
+    EXPECT_EQ(throttle.flush(0.0), 1u);
+
+    // Small steps only go out once they add up to more than the deadband
+    double t = 0.0;
+    for (unsigned k = 1; k <= 4; k++)
+    {
+        v = 10.0 + 0.1 * k;
+        throttle.update(0, &v, 1);
+        t += 2.0;
+        throttle.flush(t);
+    }
+    EXPECT_EQ(published, 1u);
+    v = 10.6;
+    throttle.update(0, &v, 1);
+    throttle.flush(t += 2.0);
+    EXPECT_EQ(published, 2u);
+
+    // A change that returns inside the deadband before it's due is dropped
+    v = 20.0;
+    throttle.update(0, &v, 1);
+    v = 10.7;
+    throttle.update(0, &v, 1);
+    EXPECT_FALSE(throttle.isPending(0));
+
+    // A state change goes out straight away, rate limit or not
+    throttle.update(0, &v, 1, 2);
+    EXPECT_EQ(throttle.flush(t + 0.01), 1u);
+    EXPECT_EQ(published, 3u);
+}
+
+TEST(publish_throttle_tests, budgetIsRoundRobin)
+{
+    const unsigned n = 5;
+    PublishThrottle throttle(n, 2);
+    std::vector<unsigned> count(n, 0);
+    for (unsigned c = 0; c < n; c++)
+        throttle.configure(c, 0.0, 0.0, [&count, c]() { count[c]++; });
+
+    for (unsigned tick = 0; tick < 10; tick++)
+    {
+        for (unsigned c = 0; c < n; c++)
+            throttle.request(c);
+        EXPECT_EQ(throttle.flush(tick), 2u);
+    }
+    for (unsigned c = 0; c < n; c++)
+        EXPECT_EQ(count[c], 4u) << c;
+}
@@ -0,0 +1,111 @@
+#include "../00_Utils/satellite_pass.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+// ISS, 2008-09-20
+static const char *ISS_L1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+static const char *ISS_L2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+#define SITE_LAT 32.4
+#define SITE_LON 249.2
+#define SITE_HEIGHT_M 2500.0
+#define ARCSEC (1.0 / 3600.0)
+
+static SatellitePassLimits looseLimits()
+{
+    SatellitePassLimits limits{10.0, 90.0, 100.0};
+    return limits;
+}
+
+static SatellitePass planFirstPass(const SGP4Propagator &sgp4, double jdStart, const SatellitePassLimits &limits)
+{
+    return SatellitePass::plan(sgp4, jdStart, SITE_LAT, SITE_LON, SITE_HEIGHT_M, limits);
+}
+
+TEST(satellite_pass_tests, findsPassEdges)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(ISS_L1, ISS_L2));
+    SatellitePassLimits limits = looseLimits();
+    SatellitePass pass = planFirstPass(sgp4, sgp4.getEpochJD(), limits);
+    ASSERT_TRUE(pass.isValid());
+    EXPECT_TRUE(pass.isFeasible());
+    EXPECT_GT(pass.getAOS(), sgp4.getEpochJD());
+    double duration_s = (pass.getLOS() - pass.getAOS()) * SATELLITE::SEC_PER_DAY;
+    EXPECT_GT(duration_s, 10.0);
+    EXPECT_LT(duration_s, 900.0);
+
+    // The edges sit on the altitude limit (the ISS rises/sets at under 1 deg/s)
+    SatelliteLook aos = sgp4.look(pass.getAOS(), SITE_LAT, SITE_LON, SITE_HEIGHT_M);
+    SatelliteLook los = sgp4.look(pass.getLOS(), SITE_LAT, SITE_LON, SITE_HEIGHT_M);
+    EXPECT_NEAR(aos.alt, limits.minAlt_deg, 0.02);
+    EXPECT_NEAR(los.alt, limits.minAlt_deg, 0.02);
+    EXPECT_GT(aos.altRate, 0.0);
+    EXPECT_LT(los.altRate, 0.0);
+
+    SatelliteTrackPoint pt;
+    EXPECT_FALSE(pass.evaluate(pass.getAOS() - 1.0 / SATELLITE::SEC_PER_DAY, pt));
+    EXPECT_FALSE(pass.evaluate(pass.getLOS() + 1.0 / SATELLITE::SEC_PER_DAY, pt));
+    EXPECT_TRUE(pass.evaluate(pass.getAOS(), pt));
+    EXPECT_TRUE(pass.evaluate(pass.getLOS(), pt));
+}
+
+TEST(satellite_pass_tests, startsInProgressPass)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(ISS_L1, ISS_L2));
+    SatellitePass first = planFirstPass(sgp4, sgp4.getEpochJD(), looseLimits());
+    ASSERT_TRUE(first.isValid());
+    double jdMid = 0.5 * (first.getAOS() + first.getLOS());
+    SatellitePass joined = planFirstPass(sgp4, jdMid, looseLimits());
+    ASSERT_TRUE(joined.isValid());
+    EXPECT_DOUBLE_EQ(joined.getAOS(), jdMid);
+    EXPECT_NEAR(joined.getLOS(), first.getLOS(), 0.02 / SATELLITE::SEC_PER_DAY);
+}
+
+TEST(satellite_pass_tests, interpolatesBetweenSamples)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(ISS_L1, ISS_L2));
+    double jd = sgp4.getEpochJD();
+    const double dt_s = 0.5;
+    // Check several passes at different culmination heights
+    for (int passNum = 0; passNum < 4; passNum++)
+    {
+        SatellitePass pass = planFirstPass(sgp4, jd, looseLimits());
+        ASSERT_TRUE(pass.isValid());
+        for (double t = pass.getAOS(); t <= pass.getLOS(); t += 0.37 / SATELLITE::SEC_PER_DAY)
+        {
+            SatelliteTrackPoint pt;
+            ASSERT_TRUE(pass.evaluate(t, pt));
+            SatelliteLook lk = sgp4.look(t, SITE_LAT, SITE_LON, SITE_HEIGHT_M);
+            // Scale the tolerance near the zenith, where azimuth moves fast but means little
+            double azTol = ARCSEC / std::max(std::cos(lk.alt * M_PI / 180.0), 0.05);
+            EXPECT_NEAR(pt.alt, lk.alt, ARCSEC);
+            EXPECT_NEAR(std::remainder(pt.az - lk.az, 360.0), 0.0, azTol);
+            EXPECT_NEAR(pt.altRate, lk.altRate, 1e-3);
+            EXPECT_NEAR(pt.azRate, lk.azRate, 1e-3 / std::max(std::cos(lk.alt * M_PI / 180.0), 0.05));
+
+            // Acceleration against differenced SGP4 rates
+            SatelliteLook lkm = sgp4.look(t - dt_s / SATELLITE::SEC_PER_DAY, SITE_LAT, SITE_LON, SITE_HEIGHT_M);
+            SatelliteLook lkp = sgp4.look(t + dt_s / SATELLITE::SEC_PER_DAY, SITE_LAT, SITE_LON, SITE_HEIGHT_M);
+            EXPECT_NEAR(pt.altAccel, (lkp.altRate - lkm.altRate) / (2.0 * dt_s), 2e-3);
+        }
+        jd = pass.getLOS() + 60.0 / SATELLITE::SEC_PER_DAY;
+    }
+}
+
+TEST(satellite_pass_tests, flagsInfeasiblePasses)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(ISS_L1, ISS_L2));
+    SatellitePassLimits slow = looseLimits();
+    slow.maxRate_dps = 0.01;
+    SatellitePass pass = planFirstPass(sgp4, sgp4.getEpochJD(), slow);
+    ASSERT_TRUE(pass.isValid());
+    EXPECT_FALSE(pass.isFeasible());
+    EXPECT_FALSE(pass.getInfeasibleReason().empty());
+
+    SatellitePassLimits low = looseLimits();
+    low.maxAlt_deg = 10.5;
+    pass = planFirstPass(sgp4, sgp4.getEpochJD(), low);
+    ASSERT_TRUE(pass.isValid());
+    EXPECT_FALSE(pass.isFeasible());
+    EXPECT_NE(pass.getInfeasibleReason().find("altitude"), std::string::npos);
+}
@@ -0,0 +1,87 @@
+#include "../00_Utils/sgp4.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+// Vallado et al. 2006 ("Revisiting Spacetrack Report #3") verification case 00005 (Vanguard 1)
+static const char *TLE_00005_L1 = "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753";
+static const char *TLE_00005_L2 = "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667";
+
+struct Sgp4Vector
+{
+    double tsince_min;
+    double r[3];
+    double v[3];
+};
+
+static const Sgp4Vector VALLADO_00005[] = {
+    {0.0, {7022.46529266, -1400.08296755, 0.03995155}, {1.893841015, 6.405893759, 4.534807250}},
+    {360.0, {-7154.03120202, -3783.17682504, -3536.19412294}, {4.741887409, -4.151817765, -2.093935425}},
+    {720.0, {-7134.59340119, 6531.68641334, 3260.27186483}, {-4.113793027, -2.911922039, -2.557327851}},
+    {1080.0, {5568.53901181, 4492.06992591, 3863.87641983}, {-4.209106476, 5.159719888, 2.744852980}},
+    {1440.0, {-938.55923943, -6268.18748831, -4294.02924751}, {7.536105209, -0.427127707, 0.989878080}},
+};
+
+TEST(sgp4_tests, parsesTLE)
+{
+    TwoLineElement el = SGP4Propagator::parseTLE(TLE_00005_L1, TLE_00005_L2);
+    EXPECT_EQ(el.satnum, "00005");
+    // 2000 day 179.78495062
+    EXPECT_NEAR(el.epochJD, 2451722.5 + 0.78495062, 1e-8);
+    EXPECT_NEAR(el.bstar, 0.28098e-4, 1e-12);
+    EXPECT_NEAR(el.eccentricity, 0.1859667, 1e-12);
+    EXPECT_NEAR(el.inclination, 34.2682 * M_PI / 180.0, 1e-12);
+    EXPECT_NEAR(el.meanMotion, 10.82419157 * 2.0 * M_PI / 1440.0, 1e-12);
+}
+
+TEST(sgp4_tests, rejectsBadChecksum)
+{
+    std::string bad(TLE_00005_L1);
+    bad[68] = bad[68] == '9' ? '0' : bad[68] + 1;
+    EXPECT_THROW(SGP4Propagator::parseTLE(bad, TLE_00005_L2), std::runtime_error);
+    EXPECT_THROW(SGP4Propagator::parseTLE(TLE_00005_L2, TLE_00005_L1), std::runtime_error);
+}
+
+TEST(sgp4_tests, matchesValladoVectors)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(TLE_00005_L1, TLE_00005_L2));
+    for (const auto &vec : VALLADO_00005)
+    {
+        double r[3], v[3];
+        sgp4.propagate(vec.tsince_min, r, v);
+        for (int ii = 0; ii < 3; ii++)
+        {
+            // The reference output is printed to 1e-8 km and 1e-9 km/s
+            EXPECT_NEAR(r[ii], vec.r[ii], 1e-6) << "t = " << vec.tsince_min;
+            EXPECT_NEAR(v[ii], vec.v[ii], 1e-9) << "t = " << vec.tsince_min;
+        }
+    }
+}
+
+TEST(sgp4_tests, rejectsDeepSpace)
+{
+    // GPS orbit, ~718 min period
+    TwoLineElement el = SGP4Propagator::parseTLE(TLE_00005_L1, TLE_00005_L2);
+    el.meanMotion = 2.00563 * 2.0 * M_PI / 1440.0;
+    EXPECT_THROW(SGP4Propagator sgp4(el), std::runtime_error);
+}
+
+TEST(sgp4_tests, lookRatesMatchFiniteDifferences)
+{
+    SGP4Propagator sgp4(SGP4Propagator::parseTLE(TLE_00005_L1, TLE_00005_L2));
+    const double lat = 32.4, lon = -110.8, h = 2500.0;
+    // A double JD only resolves ~40 us, so the difference step can't be too short
+    const double dt_s = 1.0;
+    const double jd0 = sgp4.getEpochJD() + 0.1;
+    for (int ii = 0; ii < 20; ii++)
+    {
+        double jd = jd0 + ii * 0.013;
+        SatelliteLook lk = sgp4.look(jd, lat, lon, h);
+        SatelliteLook lkm = sgp4.look(jd - dt_s / 86400.0, lat, lon, h);
+        SatelliteLook lkp = sgp4.look(jd + dt_s / 86400.0, lat, lon, h);
+        EXPECT_NEAR(lk.altRate, (lkp.alt - lkm.alt) / (2.0 * dt_s), 1e-4);
+        EXPECT_NEAR(lk.azRate, std::remainder(lkp.az - lkm.az, 360.0) / (2.0 * dt_s), 1e-4);
+        // SGP4's velocity isn't exactly the derivative of its position (~m/s)
+        EXPECT_NEAR(lk.rangeRate, (lkp.range - lkm.range) / (2.0 * dt_s), 2e-3);
+    }
+}
@@ -0,0 +1,124 @@
+#include "../00_Utils/sky_grid.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+static const double DEG2RAD = M_PI / 180.0;
+
+// Smooth test field [arcsec]
+static double fieldAlt(double alt, double az) { return 3.0 + 0.05 * alt + 2.0 * std::cos(az * DEG2RAD); }
+static double fieldAz(double alt, double az) { return -1.5 * std::sin(az * DEG2RAD) * std::cos(alt * DEG2RAD); }
+
+static std::string writeFieldGrid(unsigned nAlt, unsigned nAz, double altMin, double altMax)
+{
+    std::vector<float> values;
+    for (unsigned i = 0; i < nAlt; i++)
+    {
+        double alt = altMin + i * (altMax - altMin) / (nAlt - 1);
+        for (unsigned j = 0; j < nAz; j++)
+        {
+            double az = j * 360.0 / nAz;
+            values.push_back(fieldAlt(alt, az));
+            values.push_back(fieldAz(alt, az));
+        }
+    }
+    std::string path = testing::TempDir() + "sky_grid_tests.grid";
+    SkyGrid::write(path, nAlt, nAz, altMin, altMax, values);
+    return path;
+}
+
+TEST(sky_grid_tests, nodesAreExact)
+{
+    SkyGrid grid(writeFieldGrid(15, 72, 10.0, 80.0));
+    EXPECT_EQ(grid.numAlt(), 15u);
+    EXPECT_EQ(grid.numAz(), 72u);
+    SkyGridSample s;
+    for (double alt = 10.0; alt <= 80.0; alt += 5.0)
+    {
+        for (double az = 0.0; az < 360.0; az += 45.0)
+        {
+            grid.evaluate(alt, az, s);
+            EXPECT_NEAR(s.dAlt, fieldAlt(alt, az), 1e-5);
+            EXPECT_NEAR(s.dAz, fieldAz(alt, az), 1e-5);
+        }
+    }
+}
+
+TEST(sky_grid_tests, interpolatesBetweenNodes)
+{
+    SkyGrid grid(writeFieldGrid(15, 72, 10.0, 80.0));
+    SkyGridSample s;
+    for (double alt = 11.3; alt < 80.0; alt += 6.1)
+    {
+        for (double az = 1.7; az < 360.0; az += 13.9)
+        {
+            grid.evaluate(alt, az, s);
+            EXPECT_NEAR(s.dAlt, fieldAlt(alt, az), 2e-3);
+            EXPECT_NEAR(s.dAz, fieldAz(alt, az), 2e-3);
+        }
+    }
+}
+
+TEST(sky_grid_tests, wrapsInAzimuthAndClampsInAltitude)
+{
+    SkyGrid grid(writeFieldGrid(8, 36, 20.0, 75.0));
+    SkyGridSample a, b;
+    grid.evaluate(45.0, 359.999999, a);
+    grid.evaluate(45.0, -0.000001, b);
+    EXPECT_NEAR(a.dAlt, b.dAlt, 1e-6);
+    EXPECT_NEAR(a.dAz, b.dAz, 1e-6);
+    grid.evaluate(45.0, 720.0 + 12.0, a);
+    grid.evaluate(45.0, 12.0, b);
+    EXPECT_NEAR(a.dAlt, b.dAlt, 1e-9);
+
+    grid.evaluate(88.0, 100.0, a);
+    grid.evaluate(75.0, 100.0, b);
+    EXPECT_NEAR(a.dAlt, b.dAlt, 1e-9);
+    EXPECT_NEAR(a.dAz, b.dAz, 1e-9);
+    EXPECT_EQ(a.dAlt_dAlt, 0.0);
+}
+
+TEST(sky_grid_tests, gradientMatchesFiniteDifference)
+{
+    SkyGrid grid(writeFieldGrid(15, 72, 10.0, 80.0));
+    const double h = 1e-4;
+    for (double alt : {12.0, 41.7, 77.0})
+    {
+        for (double az : {3.0, 181.2, 358.0})
+        {
+            SkyGridSample s, a0, a1, z0, z1;
+            grid.evaluate(alt, az, s);
+            grid.evaluate(alt - h, az, a0);
+            grid.evaluate(alt + h, az, a1);
+            grid.evaluate(alt, az - h, z0);
+            grid.evaluate(alt, az + h, z1);
+            EXPECT_NEAR(s.dAlt_dAlt, (a1.dAlt - a0.dAlt) / (2 * h), 1e-5);
+            EXPECT_NEAR(s.dAz_dAlt, (a1.dAz - a0.dAz) / (2 * h), 1e-5);
+            EXPECT_NEAR(s.dAlt_dAz, (z1.dAlt - z0.dAlt) / (2 * h), 1e-5);
+            EXPECT_NEAR(s.dAz_dAz, (z1.dAz - z0.dAz) / (2 * h), 1e-5);
+        }
+    }
+}
+
+TEST(sky_grid_tests, badFilesAreRejected)
+{
+    std::string path = writeFieldGrid(4, 8, 10.0, 80.0);
+    {
+        // Truncated
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size() - 4);
+    }
+    EXPECT_THROW(SkyGrid grid(path), std::runtime_error);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a grid file, but long enough for a header";
+    }
+    EXPECT_THROW(SkyGrid grid(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(SkyGrid grid(path), std::runtime_error);
+    EXPECT_THROW(SkyGrid::write(path, 4, 8, 10.0, 80.0, std::vector<float>(10)), std::runtime_error);
+}
@@ -0,0 +1,345 @@
+#include "../00_Utils/telemetry.h"
+#include "../00_Utils/telemetry_reader.h"
+#include "../00_Utils/telemetry_shm.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define JD_START 2460000.5
+
+static std::string freshDir(const char *name)
+{
+    std::string dir = testing::TempDir() + name;
+    ::mkdir(dir.c_str(), 0755);
+    DIR *d = opendir(dir.c_str());
+    while (struct dirent *e = readdir(d))
+    {
+        if (e->d_name[0] != '.')
+            std::remove((dir + "/" + e->d_name).c_str());
+    }
+    closedir(d);
+    return dir;
+}
+
+static std::vector<std::string> telemetryFiles(const std::string &dir)
+{
+    std::vector<std::string> names;
+    DIR *d = opendir(dir.c_str());
+    while (struct dirent *e = readdir(d))
+    {
+        if (std::strstr(e->d_name, TELEMETRY::FILE_SUFFIX))
+            names.push_back(dir + "/" + e->d_name);
+    }
+    closedir(d);
+    return names;
+}
+
+static TelemetryRecord makeRecord(unsigned k)
+{
+    TelemetryRecord r;
+    std::memset(&r, 0, sizeof(r));
+    r.jd = JD_START + k / 86400.0;
+    r.monotonic_s = k * 0.02;
+    r.alt_posn_err_deg = 1.0e-4 * k;
+    r.az_dob_comp_dps = -2.0 * k;
+    return r;
+}
+
+static std::vector<TelemetryRecord> readRecords(const std::string &path, double jdFrom = 0.0, double jdTo = 1e9)
+{
+    std::vector<TelemetryRecord> records;
+    TelemetryReader reader(path);
+    EXPECT_EQ(reader.numChannels(), (unsigned)NUM_TELEMETRY_CHANNELS);
+    EXPECT_STREQ(reader.channel(TM_alt_posn_err_deg).name, "alt_posn_err_deg");
+    EXPECT_STREQ(reader.channel(TM_alt_posn_err_deg).units, "deg");
+    reader.forEachRecord(jdFrom, jdTo, [&](unsigned chunk, unsigned row)
+                         {
+        TelemetryRecord r;
+        double *values = &r.jd;
+        for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+            values[c] = reader.column(chunk, c)[row];
+        records.push_back(r); });
+    return records;
+}
+
+TEST(telemetry_tests, ringOrderAndOverflow)
+{
+    SpscRing<int, 8> ring;
+    for (int k = 0; k < 8; k++)
+        EXPECT_TRUE(ring.push(k));
+    EXPECT_FALSE(ring.push(8));
+    EXPECT_EQ(ring.getDropped(), 1u);
+    EXPECT_EQ(ring.size(), 8u);
+
+    int v;
+    for (int k = 0; k < 8; k++)
+    {
+        ASSERT_TRUE(ring.pop(v));
+        EXPECT_EQ(v, k);
+    }
+    EXPECT_FALSE(ring.pop(v));
+    // Indices carry on past the end of the buffer
+    EXPECT_TRUE(ring.push(9));
+    ASSERT_TRUE(ring.pop(v));
+    EXPECT_EQ(v, 9);
+}
+
+TEST(telemetry_tests, ringAcrossThreads)
+{
+    static SpscRing<unsigned, 1024> ring;
+    const unsigned N = 50000;
+    std::thread producer([N]()
+                         {
+        for (unsigned k = 0; k < N; k++)
+            while (!ring.push(k))
+                std::this_thread::yield(); });
+
+    unsigned expected = 0, v;
+    while (expected < N)
+    {
+        if (ring.pop(v))
+        {
+            ASSERT_EQ(v, expected);
+            expected++;
+        }
+    }
+    producer.join();
+}
+
+TEST(telemetry_tests, writerRoundTrip)
+{
+    std::string dir = freshDir("telemetry_round_trip");
+    {
+        TelemetryWriter writer(dir);
+        for (unsigned k = 0; k < 500; k++)
+            EXPECT_TRUE(writer.push(makeRecord(k)));
+    }
+    std::vector<std::string> files = telemetryFiles(dir);
+    ASSERT_EQ(files.size(), 1u);
+    std::vector<TelemetryRecord> records = readRecords(files[0]);
+    ASSERT_EQ(records.size(), 500u);
+    for (unsigned k = 0; k < records.size(); k++)
+    {
+        TelemetryRecord expected = makeRecord(k);
+        EXPECT_EQ(std::memcmp(&records[k], &expected, sizeof(TelemetryRecord)), 0) << k;
+    }
+}
+
+TEST(telemetry_tests, writerRotatesFiles)
+{
+    std::string dir = freshDir("telemetry_rotate");
+    {
+        // One 10 record chunk per file, at most 3 files kept
+        TelemetryWriter writer(dir, TelemetryFile::headerBytes() + TelemetryFile::chunkBytesFor(10), 3, 10);
+        for (unsigned k = 0; k < 95; k++)
+            writer.push(makeRecord(k));
+    }
+    std::vector<std::string> files = telemetryFiles(dir);
+    ASSERT_EQ(files.size(), 3u);
+    size_t total = 0;
+    double lastJd = 0;
+    for (const std::string &f : files)
+    {
+        std::vector<TelemetryRecord> records = readRecords(f);
+        EXPECT_LE(records.size(), 10u);
+        total += records.size();
+        lastJd = std::max(lastJd, records.back().jd);
+    }
+    // The newest 25 records survive
+    EXPECT_EQ(total, 25u);
+    EXPECT_DOUBLE_EQ(lastJd, makeRecord(94).jd);
+}
+
+TEST(telemetry_tests, timeRangeAcrossChunks)
+{
+    std::string path = freshDir("telemetry_range") + "/range.lftm";
+    {
+        TelemetryFile file(path, 64);
+        for (unsigned k = 0; k < 1000; k++)
+            file.append(makeRecord(k));
+    }
+    TelemetryReader reader(path);
+    EXPECT_EQ(reader.numRecords(), 1000u);
+    EXPECT_EQ(reader.numChunks(), 16u);
+    EXPECT_DOUBLE_EQ(reader.firstJd(), makeRecord(0).jd);
+    EXPECT_DOUBLE_EQ(reader.lastJd(), makeRecord(999).jd);
+    EXPECT_EQ(reader.findChannel("az_dob_comp_dps"), (int)TM_az_dob_comp_dps);
+    EXPECT_EQ(reader.findChannel("no_such_channel"), -1);
+
+    // Ends between records, spanning several chunks
+    std::vector<TelemetryRecord> records = readRecords(path, makeRecord(100).jd - 0.1 / 86400.0, makeRecord(700).jd + 0.1 / 86400.0);
+    ASSERT_EQ(records.size(), 601u);
+    for (unsigned k = 0; k < records.size(); k++)
+        EXPECT_DOUBLE_EQ(records[k].alt_posn_err_deg, makeRecord(100 + k).alt_posn_err_deg);
+
+    EXPECT_TRUE(readRecords(path, makeRecord(999).jd + 1.0, 1e9).empty());
+}
+
+TEST(telemetry_tests, summaryMatchesScan)
+{
+    std::string path = freshDir("telemetry_summary") + "/summary.lftm";
+    {
+        TelemetryFile file(path, 50);
+        for (unsigned k = 0; k < 777; k++)
+        {
+            TelemetryRecord r = makeRecord(k);
+            r.alt_rate_fb_dps = std::sin(0.01 * k);
+            file.append(r);
+        }
+    }
+    TelemetryReader reader(path);
+    const double jdFrom = makeRecord(123).jd, jdTo = makeRecord(654).jd;
+    TelemetryStats s = reader.summarize(TM_alt_rate_fb_dps, jdFrom, jdTo);
+
+    double sum = 0, sumSq = 0, mn = 1e9, mx = -1e9;
+    for (unsigned k = 123; k <= 654; k++)
+    {
+        double v = std::sin(0.01 * k);
+        sum += v;
+        sumSq += v * v;
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+    }
+    EXPECT_EQ(s.count, 532u);
+    EXPECT_DOUBLE_EQ(s.min, mn);
+    EXPECT_DOUBLE_EQ(s.max, mx);
+    EXPECT_NEAR(s.mean(), sum / 532, 1e-12);
+    EXPECT_NEAR(s.rms(), std::sqrt(sumSq / 532), 1e-12);
+}
+
+TEST(telemetry_tests, cutOffFileReadsToLastFlush)
+{
+    std::string dir = freshDir("telemetry_cut_off");
+    std::string path = dir + "/cut.lftm";
+    {
+        TelemetryFile file(path, 100);
+        for (unsigned k = 0; k < 250; k++)
+            file.append(makeRecord(k));
+        file.flush();
+
+        // A reader opened while the file is being written sees what has been flushed
+        TelemetryReader live(path);
+        EXPECT_EQ(live.numRecords(), 250u);
+    }
+    // Chop the file part way through the third chunk's last column
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    ASSERT_EQ(truncate(path.c_str(), st.st_size - 8), 0);
+    TelemetryReader reader(path);
+    EXPECT_EQ(reader.numChunks(), 2u);
+    EXPECT_EQ(reader.numRecords(), 200u);
+
+    std::FILE *fp = std::fopen((dir + "/junk.lftm").c_str(), "wb");
+    std::fputs("not telemetry, just some text that is long enough", fp);
+    std::fclose(fp);
+    EXPECT_THROW(TelemetryReader(dir + "/junk.lftm"), std::runtime_error);
+}
+
+static std::string shmName(const char *name)
+{
+    return std::string("/lfast_test_") + name + "_" + std::to_string(getpid());
+}
+
+TEST(telemetry_tests, shmFeedRoundTrip)
+{
+    TelemetryShmPublisher feed(shmName("round_trip"), 16, 0.02);
+    for (unsigned k = 0; k < 10; k++)
+        feed.publish(makeRecord(k));
+
+    TelemetryShmReader reader(feed.getName());
+    EXPECT_EQ(reader.getCapacity(), 16u);
+    EXPECT_DOUBLE_EQ(reader.getPeriod(), 0.02);
+    std::vector<TelemetryRecord> records;
+    ASSERT_EQ(reader.poll(records), 10u);
+    for (unsigned k = 0; k < 10; k++)
+    {
+        TelemetryRecord expected = makeRecord(k);
+        EXPECT_EQ(std::memcmp(&records[k], &expected, sizeof(TelemetryRecord)), 0) << k;
+    }
+    EXPECT_EQ(reader.poll(records), 0u);
+
+    for (unsigned k = 10; k < 15; k++)
+        feed.publish(makeRecord(k));
+    records.clear();
+    ASSERT_EQ(reader.poll(records), 5u);
+    EXPECT_DOUBLE_EQ(records[0].jd, makeRecord(10).jd);
+    EXPECT_EQ(reader.getMissed(), 0u);
+    EXPECT_FALSE(reader.isClosed());
+}
+
+TEST(telemetry_tests, shmFeedOverrunAndClose)
+{
+    std::vector<TelemetryRecord> records;
+    std::unique_ptr<TelemetryShmPublisher> feed(new TelemetryShmPublisher(shmName("overrun"), 16, 0.02));
+    TelemetryShmReader reader(feed->getName());
+    for (unsigned k = 0; k < 3; k++)
+        feed->publish(makeRecord(k));
+    EXPECT_EQ(reader.poll(records), 3u);
+
+    // A slow reader gets the newest ring's worth and a count of what it missed
+    for (unsigned k = 3; k < 43; k++)
+        feed->publish(makeRecord(k));
+    records.clear();
+    ASSERT_EQ(reader.poll(records), 16u);
+    EXPECT_DOUBLE_EQ(records.front().jd, makeRecord(27).jd);
+    EXPECT_DOUBLE_EQ(records.back().jd, makeRecord(42).jd);
+    EXPECT_EQ(reader.getMissed(), 24u);
+
+    const std::string name = feed->getName();
+    feed.reset();
+    EXPECT_TRUE(reader.isClosed());
+    EXPECT_THROW(TelemetryShmReader gone(name), std::runtime_error);
+}
+
+TEST(telemetry_tests, shmFeedNeverTears)
+{
+    // Every field of record k holds k, so a torn copy shows up as a mixed record
+    TelemetryShmPublisher feed(shmName("tear"), 8, 0.0);
+    TelemetryShmReader reader(feed.getName());
+    const unsigned N = 200000;
+    std::atomic<bool> done(false);
+    std::thread publisher([&]()
+                          {
+        TelemetryRecord r;
+        double *values = &r.jd;
+        for (unsigned k = 1; k <= N; k++)
+        {
+            for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+                values[c] = k;
+            feed.publish(r);
+        }
+        done = true; });
+
+    std::vector<TelemetryRecord> records;
+    double last = 0;
+    uint64_t seen = 0;
+    bool finished = false;
+    while (!finished)
+    {
+        finished = done;
+        records.clear();
+        seen += reader.poll(records);
+        for (const TelemetryRecord &r : records)
+        {
+            const double *values = &r.jd;
+            for (unsigned c = 1; c < NUM_TELEMETRY_CHANNELS; c++)
+                ASSERT_EQ(values[c], r.jd);
+            ASSERT_GT(r.jd, last);
+            last = r.jd;
+        }
+    }
+    publisher.join();
+    EXPECT_EQ(last, (double)N);
+    EXPECT_EQ(seen + reader.getMissed(), N);
+}
@@ -0,0 +1,61 @@
+#include "../00_Utils/tick_profiler.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+TEST(tick_profiler_tests, rollingMinMeanP99)
+{
+    TickProfiler profiler(100);
+    for (unsigned k = 1; k <= 100; k++)
+    {
+        profiler.add(TICK_PHASE_timer_hit, k * 1e-3);
+        profiler.endTick();
+    }
+    TickPhaseStats s = profiler.getStats(TICK_PHASE_timer_hit);
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_DOUBLE_EQ(s.min, 1e-3);
+    EXPECT_NEAR(s.mean, 50.5e-3, 1e-12);
+    EXPECT_DOUBLE_EQ(s.p99, 99e-3);
+
+    // Older ticks roll out of the window
+    for (unsigned k = 0; k < 50; k++)
+    {
+        profiler.add(TICK_PHASE_timer_hit, 1.0);
+        profiler.endTick();
+    }
+    s = profiler.getStats(TICK_PHASE_timer_hit);
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_DOUBLE_EQ(s.min, 51e-3);
+    EXPECT_DOUBLE_EQ(s.p99, 1.0);
+}
+
+TEST(tick_profiler_tests, phasesSumWithinATick)
+{
+    TickProfiler profiler(10);
+    // Once per axis
+    profiler.add(TICK_PHASE_control_loops, 1e-3);
+    profiler.add(TICK_PHASE_control_loops, 2e-3);
+    profiler.endTick();
+    EXPECT_DOUBLE_EQ(profiler.lastTick(TICK_PHASE_control_loops), 3e-3);
+
+    // A tick that doesn't run the phase reads zero but isn't a sample
+    profiler.endTick();
+    EXPECT_EQ(profiler.lastTick(TICK_PHASE_control_loops), 0.0);
+    TickPhaseStats s = profiler.getStats(TICK_PHASE_control_loops);
+    EXPECT_EQ(s.count, 1u);
+    EXPECT_DOUBLE_EQ(s.mean, 3e-3);
+    EXPECT_EQ(profiler.getStats(TICK_PHASE_publish).count, 0u);
+}
+
+TEST(tick_profiler_tests, scopeTimesItsLifetime)
+{
+    tickProfiler().reset();
+    {
+        TickProfileScope scope(TICK_PHASE_publish);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    tickProfiler().endTick();
+    EXPECT_GE(tickProfiler().lastTick(TICK_PHASE_publish), 0.005);
+    EXPECT_LT(tickProfiler().lastTick(TICK_PHASE_publish), 0.5);
+    EXPECT_STREQ(TickProfiler::phaseName(TICK_PHASE_drive_command), "drive_command");
+}
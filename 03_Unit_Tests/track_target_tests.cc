@@ -0,0 +1,84 @@
+#include "../01_Mount_Driver/track_target.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+#define TEST_JD0 2460000.5
+#define SEC_PER_DAY 86400.0
+#define SIDEREAL_ARCSECPS ((360.0 * 3600.0) / 86164.090530833)
+
+static const INDI::IGeographicCoordinates testSite{360.0 - 110.95, 32.42, 2500.0};
+
+static double raDiffHours(double a, double b) { return std::remainder(a - b, 24.0); }
+
+static INDI::IEquatorialCoordinates bodyCenter(TrackBody_t body, double jd)
+{
+    double ra_deg, dec_deg, dist_au;
+    TrackTarget::bodyPosition(body, jd, &ra_deg, &dec_deg, &dist_au);
+    return INDI::IEquatorialCoordinates{ra_deg / 15.0, dec_deg};
+}
+
+TEST(track_target_tests, siderealIsFixed)
+{
+    INDI::IEquatorialCoordinates radec{5.5, -20.0};
+    TrackTarget tgt = TrackTarget::sidereal(radec);
+    INDI::IEquatorialCoordinates later = tgt.equatorialAt(TEST_JD0 + 0.3, testSite);
+    EXPECT_DOUBLE_EQ(later.rightascension, 5.5);
+    EXPECT_DOUBLE_EQ(later.declination, -20.0);
+    EXPECT_EQ(tgt.getBody(), TRACK_BODY_NONE);
+}
+
+TEST(track_target_tests, customRateDrifts)
+{
+    INDI::IEquatorialCoordinates radec{23.5, 10.0};
+    // Sidereal RA rate holds RA fixed
+    TrackTarget fixed = TrackTarget::customRate(radec, TEST_JD0, SIDEREAL_ARCSECPS, 0.0);
+    EXPECT_NEAR(raDiffHours(fixed.geocentricAt(TEST_JD0 + 0.25).rightascension, 23.5), 0.0, 1e-6);
+
+    // 15 arcsec/s slower than sidereal is one hour of RA per hour; 1 arcsec/s is 1 deg per hour
+    TrackTarget drifting = TrackTarget::customRate(radec, TEST_JD0, SIDEREAL_ARCSECPS - 15.0, 1.0);
+    INDI::IEquatorialCoordinates later = drifting.geocentricAt(TEST_JD0 + 3600.0 / SEC_PER_DAY);
+    EXPECT_NEAR(later.rightascension, 0.5, 1e-6);
+    EXPECT_NEAR(later.declination, 11.0, 1e-6);
+    // Custom rates don't get parallax
+    INDI::IEquatorialCoordinates topo = drifting.equatorialAt(TEST_JD0 + 3600.0 / SEC_PER_DAY, testSite);
+    EXPECT_DOUBLE_EQ(topo.rightascension, later.rightascension);
+    EXPECT_DOUBLE_EQ(topo.declination, later.declination);
+}
+
+TEST(track_target_tests, bodyPassesThroughGotoPosition)
+{
+    // Goto slightly off the Moon's center; the offset is kept as the Moon moves
+    INDI::IEquatorialCoordinates center = bodyCenter(TRACK_BODY_MOON, TEST_JD0);
+    INDI::IEquatorialCoordinates gotoPosn{center.rightascension + 0.001, center.declination - 0.1};
+    TrackTarget crater = TrackTarget::body(TRACK_BODY_MOON, gotoPosn, TEST_JD0);
+    INDI::IEquatorialCoordinates now = crater.geocentricAt(TEST_JD0);
+    EXPECT_NEAR(raDiffHours(now.rightascension, gotoPosn.rightascension), 0.0, 1e-9);
+    EXPECT_NEAR(now.declination, gotoPosn.declination, 1e-9);
+
+    // The Moon moves east about 0.5 deg/hour against the stars
+    INDI::IEquatorialCoordinates later = crater.geocentricAt(TEST_JD0 + 1.0 / 24.0);
+    double dRA_hrs = raDiffHours(later.rightascension, now.rightascension);
+    EXPECT_GT(dRA_hrs, 0.02);
+    EXPECT_LT(dRA_hrs, 0.08);
+}
+
+TEST(track_target_tests, lunarParallaxIsBounded)
+{
+    INDI::IEquatorialCoordinates gotoPosn = bodyCenter(TRACK_BODY_MOON, TEST_JD0);
+    TrackTarget moon = TrackTarget::body(TRACK_BODY_MOON, gotoPosn, TEST_JD0);
+    INDI::IEquatorialCoordinates geo = moon.geocentricAt(TEST_JD0);
+    INDI::IEquatorialCoordinates topo = moon.equatorialAt(TEST_JD0, testSite);
+    double dRA_deg = 15.0 * raDiffHours(topo.rightascension, geo.rightascension) * std::cos(geo.declination * M_PI / 180.0);
+    double dDec_deg = topo.declination - geo.declination;
+    // Horizontal parallax of the Moon is at most about 1.02 deg
+    EXPECT_LT(std::hypot(dRA_deg, dDec_deg), 1.03);
+}
+
+TEST(track_target_tests, nearestPlanetFindsPlanet)
+{
+    INDI::IEquatorialCoordinates jupiter = bodyCenter(TRACK_BODY_JUPITER, TEST_JD0);
+    double sep = 999.0;
+    EXPECT_EQ(TrackTarget::nearestPlanet(jupiter, TEST_JD0, &sep), TRACK_BODY_JUPITER);
+    EXPECT_LT(sep, 1e-6);
+    EXPECT_STREQ(TrackTarget::bodyName(TRACK_BODY_JUPITER), "Jupiter");
+}
@@ -0,0 +1,159 @@
+#include "../00_Utils/tracking_ephemeris.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#define TEST_JD0 2460000.5
+
+static double testClockJd = TEST_JD0;
+static double testClock() { return testClockJd; }
+static double secondsSince(double jd) { return (jd - TEST_JD0) * EPHEMERIS::SEC_PER_DAY; }
+
+// Slowly curving altitude, azimuth and RA crossing their wrap points a few seconds in. Tolerances allow for the
+// ~40 us resolution of a double Julian date.
+static bool testSampler(double jd, double *values)
+{
+    double t = secondsSince(jd);
+    values[EPHEM_ALT] = 30.0 + 0.004 * t + 1.0e-5 * t * t;
+    values[EPHEM_AZ] = std::fmod(359.95 + 0.01 * t, 360.0);
+    values[EPHEM_RA] = std::fmod(23.9999 + 1.0e-5 * t, 24.0);
+    values[EPHEM_DEC] = -10.0 - 2.0e-4 * t;
+    return true;
+}
+
+TEST(tracking_ephemeris_tests, notReadyWithoutTarget)
+{
+    testClockJd = TEST_JD0;
+    TrackingEphemeris ephem(testClock);
+    EphemerisState state;
+    ephem.refill();
+    EXPECT_FALSE(ephem.evaluate(TEST_JD0, state));
+    EXPECT_EQ(ephem.coveredUntil(), 0.0);
+}
+
+TEST(tracking_ephemeris_tests, matchesTargetAndDerivatives)
+{
+    testClockJd = TEST_JD0;
+    TrackingEphemeris ephem(testClock);
+    ephem.setTarget(testSampler, TEST_JD0);
+    ephem.refill();
+    EXPECT_GE(secondsSince(ephem.coveredUntil()), EPHEMERIS::REFILL_LEAD_SEC);
+
+    EphemerisState state;
+    for (double t = 0.0; t < EPHEMERIS::REFILL_LEAD_SEC; t += 0.37)
+    {
+        ASSERT_TRUE(ephem.evaluate(TEST_JD0 + t / EPHEMERIS::SEC_PER_DAY, state));
+        double values[NUM_EPHEM_CHANNELS];
+        testSampler(TEST_JD0 + t / EPHEMERIS::SEC_PER_DAY, values);
+        EXPECT_NEAR(state.position[EPHEM_ALT], values[EPHEM_ALT], 1e-6);
+        EXPECT_NEAR(state.rate[EPHEM_ALT], 0.004 + 2.0e-5 * t, 1e-6);
+        EXPECT_NEAR(state.accel[EPHEM_ALT], 2.0e-5, 1e-6);
+        EXPECT_NEAR(std::remainder(state.position[EPHEM_AZ] - values[EPHEM_AZ], 360.0), 0.0, 1e-6);
+        EXPECT_GE(state.position[EPHEM_AZ], 0.0);
+        EXPECT_LT(state.position[EPHEM_AZ], 360.0);
+        EXPECT_NEAR(state.rate[EPHEM_AZ], 0.01, 1e-6);
+        EXPECT_NEAR(std::remainder(state.position[EPHEM_RA] - values[EPHEM_RA], 24.0), 0.0, 1e-7);
+        EXPECT_LT(state.position[EPHEM_RA], 24.0);
+        EXPECT_NEAR(state.rate[EPHEM_RA], 1.0e-5, 1e-7);
+        EXPECT_NEAR(state.position[EPHEM_DEC], values[EPHEM_DEC], 1e-6);
+        EXPECT_NEAR(state.rate[EPHEM_DEC], -2.0e-4, 1e-6);
+    }
+}
+
+TEST(tracking_ephemeris_tests, refillsAheadOfClock)
+{
+    testClockJd = TEST_JD0;
+    TrackingEphemeris ephem(testClock);
+    ephem.setTarget(testSampler, TEST_JD0);
+    ephem.refill();
+
+    EphemerisState state;
+    for (int ii = 1; ii <= 20; ii++)
+    {
+        testClockJd = TEST_JD0 + 15.0 * ii / EPHEMERIS::SEC_PER_DAY;
+        ephem.refill();
+        EXPECT_GE(secondsSince(ephem.coveredUntil()) - 15.0 * ii, EPHEMERIS::REFILL_LEAD_SEC);
+        EXPECT_TRUE(ephem.evaluate(testClockJd, state));
+    }
+    // Expired segments are dropped
+    EXPECT_FALSE(ephem.evaluate(TEST_JD0, state));
+}
+
+TEST(tracking_ephemeris_tests, newTargetDropsSegments)
+{
+    testClockJd = TEST_JD0;
+    TrackingEphemeris ephem(testClock);
+    ephem.setTarget(testSampler, TEST_JD0);
+    ephem.refill();
+
+    ephem.setTarget([](double /*jd*/, double *values)
+                    {
+                        values[EPHEM_ALT] = 45.0;
+                        values[EPHEM_AZ] = 180.0;
+                        values[EPHEM_RA] = 6.0;
+                        values[EPHEM_DEC] = 20.0;
+                        return true; },
+                    TEST_JD0);
+    EphemerisState state;
+    EXPECT_FALSE(ephem.evaluate(TEST_JD0, state));
+    ephem.refill();
+    ASSERT_TRUE(ephem.evaluate(TEST_JD0 + 1.0 / EPHEMERIS::SEC_PER_DAY, state));
+    EXPECT_NEAR(state.position[EPHEM_ALT], 45.0, 1e-9);
+    EXPECT_NEAR(state.rate[EPHEM_ALT], 0.0, 1e-9);
+}
+
+TEST(tracking_ephemeris_tests, fastMotionShortensSegments)
+{
+    testClockJd = TEST_JD0;
+    TrackingEphemeris ephem(testClock);
+    // Azimuth swinging through a near-zenith pass (peaks at 5.7 deg/s, where the Julian date
+    // resolution alone is worth 1e-4 deg)
+    auto zenithPass = [](double jd, double *values)
+    {
+        double t = secondsSince(jd) - 20.0;
+        values[EPHEM_ALT] = 89.9;
+        values[EPHEM_AZ] = 90.0 + 180.0 / M_PI * std::atan(t / 10.0);
+        values[EPHEM_RA] = 12.0;
+        values[EPHEM_DEC] = 32.0;
+        return true;
+    };
+    ephem.setTarget(zenithPass, TEST_JD0);
+    ephem.refill();
+
+    EphemerisState state;
+    for (double t = 0.0; t < EPHEMERIS::REFILL_LEAD_SEC; t += 0.25)
+    {
+        double jd = TEST_JD0 + t / EPHEMERIS::SEC_PER_DAY;
+        double values[NUM_EPHEM_CHANNELS];
+        zenithPass(jd, values);
+        ASSERT_TRUE(ephem.evaluate(jd, state));
+        EXPECT_NEAR(state.position[EPHEM_AZ], values[EPHEM_AZ], 2e-4);
+    }
+}
+
+TEST(tracking_ephemeris_tests, workerThreadFills)
+{
+    TrackingEphemeris ephem;
+    ephem.start();
+    double jd0 = TrackingEphemeris::systemJulianDate();
+    ephem.setTarget([](double /*jd*/, double *values)
+                    {
+                        values[EPHEM_ALT] = 20.0;
+                        values[EPHEM_AZ] = 10.0;
+                        values[EPHEM_RA] = 1.0;
+                        values[EPHEM_DEC] = 0.0;
+                        return true; },
+                    jd0);
+
+    EphemerisState state;
+    bool ready = false;
+    for (int ii = 0; ii < 200 && !ready; ii++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ready = ephem.evaluate(TrackingEphemeris::systemJulianDate(), state);
+    }
+    EXPECT_TRUE(ready);
+    ephem.stop();
+    EXPECT_FALSE(ephem.isRunning());
+}
@@ -0,0 +1,105 @@
+#include "../00_Utils/batch_controller.h"
+#include "../00_Utils/PID_Controller.h"
+#include "../00_Utils/biquad_filter.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+// To execute benchmarks:
+// cd build && ./06_Benchmarks/batch_controller_bench
+///
+/// Support functions ///
+///
+static std::vector<double> makeLaneInputs(size_t n)
+{
+    std::vector<double> x(n);
+    for (size_t ii = 0; ii < n; ii++)
+        x[ii] = 0.1 * std::sin(0.7 * ii);
+    return x;
+}
+
+///
+/// PID benchmarks (one PID per lane, all lanes updated per iteration) ///
+///
+
+static void BM_PID_Scalar(benchmark::State &state)
+{
+    size_t n = state.range(0);
+    std::vector<PID_Controller> pids(n, PID_Controller(2.0, 0.5, 0.01));
+    for (auto &pid : pids)
+    {
+        pid.configureIntegratorSaturation(1.0, -1.0);
+        pid.reset();
+    }
+    auto e = makeLaneInputs(n);
+    std::vector<double> u(n);
+    for (auto _ : state)
+    {
+        for (size_t ii = 0; ii < n; ii++)
+            pids[ii].update(e[ii], 0.02, &u[ii]);
+        benchmark::DoNotOptimize(u.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PID_Scalar)->RangeMultiplier(4)->Range(2, 128);
+
+static void BM_PID_Batch(benchmark::State &state)
+{
+    size_t n = state.range(0);
+    BatchPID_Controller pids(n);
+    for (size_t ii = 0; ii < n; ii++)
+    {
+        pids.configureGains(ii, 2.0, 0.5, 0.01);
+        pids.configureIntegratorSaturation(ii, 1.0, -1.0);
+    }
+    auto e = makeLaneInputs(n);
+    std::vector<double> u(n);
+    for (auto _ : state)
+    {
+        pids.update(e.data(), 0.02, u.data());
+        benchmark::DoNotOptimize(u.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_PID_Batch)->RangeMultiplier(4)->Range(2, 128);
+
+///
+/// Biquad benchmarks ///
+///
+
+static void BM_Biquad_Scalar(benchmark::State &state)
+{
+    size_t n = state.range(0);
+    std::vector<BiquadFilter> filts(n, BiquadFilter(DIGITAL_CONTROL::designLowPass(5.0, 50.0)));
+    auto x = makeLaneInputs(n);
+    std::vector<double> y(n);
+    for (auto _ : state)
+    {
+        for (size_t ii = 0; ii < n; ii++)
+            y[ii] = filts[ii].update(x[ii]);
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Biquad_Scalar)->RangeMultiplier(4)->Range(2, 128);
+
+static void BM_Biquad_Batch(benchmark::State &state)
+{
+    size_t n = state.range(0);
+    BatchBiquadFilter filts(n);
+    for (size_t ii = 0; ii < n; ii++)
+        filts.setCoefficients(ii, DIGITAL_CONTROL::designLowPass(5.0, 50.0));
+    auto x = makeLaneInputs(n);
+    std::vector<double> y(n);
+    for (auto _ : state)
+    {
+        filts.update(x.data(), y.data());
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Biquad_Batch)->RangeMultiplier(4)->Range(2, 128);
@@ -0,0 +1,47 @@
+#include "../00_Utils/df2_filter.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+// To execute benchmarks:
+// cd build && ./06_Benchmarks/df2_filter_bench
+///
+/// Support functions ///
+///
+static std::vector<double> makeInputSignal(size_t n)
+{
+    std::vector<double> x(n);
+    for (size_t ii = 0; ii < n; ii++)
+        x[ii] = std::sin(0.01 * ii) + 0.1 * std::sin(0.37 * ii);
+    return x;
+}
+
+///
+/// DF2_IIR benchmarks ///
+///
+
+static void BM_DF2_IIR_DynamicOrder(benchmark::State &state)
+{
+    DF2_IIR<double> filt(DIGITAL_CONTROL::lpf_3_b, DIGITAL_CONTROL::lpf_3_a, 2);
+    auto x = makeInputSignal(1024);
+    size_t idx = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(filt.update(x[idx++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DF2_IIR_DynamicOrder);
+
+static void BM_DF2_IIR_FixedOrder(benchmark::State &state)
+{
+    DF2_IIR<double, 2> filt(DIGITAL_CONTROL::lpf_3_b, DIGITAL_CONTROL::lpf_3_a);
+    auto x = makeInputSignal(1024);
+    size_t idx = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(filt.update(x[idx++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DF2_IIR_FixedOrder);
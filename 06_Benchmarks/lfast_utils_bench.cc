@@ -0,0 +1,244 @@
+#include "../00_Utils/PID_Controller.h"
+#include "../00_Utils/df2_filter.h"
+#include "../00_Utils/math_util.h"
+#include "../00_Utils/lfast_comms.h"
+#include "../00_Utils/apparent_place.h"
+#include "../01_Mount_Driver/lfast_constants.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// To execute benchmarks:
+// cd build && ./06_Benchmarks/lfast_utils_bench
+// For a JSON file to compare against later runs (benchmark's tools/compare.py reads these):
+// cd build && make lfast_utils_bench_json
+///
+/// Support functions ///
+///
+#define NUM_SAMPLES 1024
+#define TICK_SEC (SLEWDRIVE::CONTROL_LOOP_PERIOD_MS / 1000.0)
+// 2025-03-01 04:30 UTC
+#define BENCH_JD 2460735.6875
+
+// Tracking error as the position loop sees it: an offset that settles, plus a little noise
+static std::vector<double> makePositionError(size_t n)
+{
+    std::vector<double> e(n);
+    for (size_t ii = 0; ii < n; ii++)
+        e[ii] = 0.05 * std::exp(-0.01 * ii) + 1e-4 * std::sin(0.37 * ii);
+    return e;
+}
+
+// Angles spread over a full turn, in degrees
+static std::vector<double> makeAngles(size_t n)
+{
+    std::vector<double> x(n);
+    for (size_t ii = 0; ii < n; ii++)
+        x[ii] = -180.0 + 360.0 * ii / n;
+    return x;
+}
+
+// A mount status report the way a client would see it
+static std::string makeStatusMessage()
+{
+    LFAST::MessageGenerator axis("");
+    axis.addArgument("AltPosn", 45.123456);
+    axis.addArgument("AzPosn", 181.654321);
+    axis.addArgument("Tracking", true);
+    LFAST::MessageGenerator msg("MountStatus");
+    msg.addArgument("Axes", axis);
+    msg.addArgument("TickCount", 123456);
+    return msg.getMessageStr();
+}
+
+///
+/// PID_Controller benchmarks ///
+///
+
+// The slew drive position loop, with its gains and limits
+static void BM_PID_Update(benchmark::State &state)
+{
+    PID_Controller pid(SLEWDRIVE::SLEW_POSN_KP, SLEWDRIVE::SLEW_POSN_KI, SLEWDRIVE::SLEW_POSN_KD);
+    pid.configureAntiWindup(SLEWDRIVE::SLEW_POSN_KB);
+    pid.configureOutputSaturation(0.25, -0.25);
+    pid.reset();
+    auto e = makePositionError(NUM_SAMPLES);
+    size_t idx = 0;
+    double u = 0.0;
+    for (auto _ : state)
+    {
+        pid.update(e[idx++ & (NUM_SAMPLES - 1)], TICK_SEC, &u);
+        benchmark::DoNotOptimize(u);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PID_Update);
+
+///
+/// DF2_IIR benchmarks ///
+///
+
+// The slew drive model, fed with a rate command stepping between slew and tracking rates
+static void BM_DF2_IIR_DriveModel(benchmark::State &state)
+{
+    DF2_IIR<double, 2> filt(DIGITAL_CONTROL::lpf_3_b, DIGITAL_CONTROL::lpf_3_a);
+    std::vector<double> rateCmd(NUM_SAMPLES);
+    for (size_t ii = 0; ii < NUM_SAMPLES; ii++)
+        rateCmd[ii] = (ii / 128) % 2 ? 0.25 : LFAST_CONSTANTS::SiderealRate_degpersec;
+    size_t idx = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(filt.update(rateCmd[idx++ & (NUM_SAMPLES - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DF2_IIR_DriveModel);
+
+///
+/// math_util benchmarks (one pass over NUM_SAMPLES angles per iteration) ///
+///
+
+static void BM_MathUtil_AngleConversions(benchmark::State &state)
+{
+    auto x = makeAngles(NUM_SAMPLES);
+    for (auto _ : state)
+    {
+        double acc = 0.0;
+        for (double v : x)
+            acc += rad2deg(deg2rad(v)) + deg2hrs(v) + hrs2rad(deg2hrs(v)) + arcsec2deg(deg2arcsec(v));
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_SAMPLES);
+}
+BENCHMARK(BM_MathUtil_AngleConversions);
+
+static void BM_MathUtil_RateConversions(benchmark::State &state)
+{
+    auto x = makeAngles(NUM_SAMPLES);
+    for (auto _ : state)
+    {
+        double acc = 0.0;
+        for (double v : x)
+            acc += RPM2degpersec(degpersec2RPM(v)) + RPM2radpersec(radpersec2RPM(v));
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_SAMPLES);
+}
+BENCHMARK(BM_MathUtil_RateConversions);
+
+static void BM_MathUtil_DegreeTrig(benchmark::State &state)
+{
+    auto x = makeAngles(NUM_SAMPLES);
+    for (auto _ : state)
+    {
+        double acc = 0.0;
+        for (double v : x)
+            acc += atan2d(sind(v), cosd(v)) + asind(0.5 * sind(v)) + acosd(0.5 * cosd(v));
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_SAMPLES);
+}
+BENCHMARK(BM_MathUtil_DegreeTrig);
+
+static void BM_MathUtil_Saturate(benchmark::State &state)
+{
+    auto x = makeAngles(NUM_SAMPLES);
+    for (auto _ : state)
+    {
+        double acc = 0.0;
+        for (double v : x)
+            acc += saturate(v, -90.0, 90.0) * sign(v);
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_SAMPLES);
+}
+BENCHMARK(BM_MathUtil_Saturate);
+
+///
+/// lfast_comms benchmarks ///
+///
+
+static void BM_MessageGenerator_Status(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(makeStatusMessage());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageGenerator_Status);
+
+// The parser logs its progress to stdout (OUTPUT_DEBUG_INFO), which is part of what it costs, so
+// it's timed with stdout going nowhere rather than turned off
+static void BM_MessageParser_Status(benchmark::State &state)
+{
+    const std::string msg = makeStatusMessage();
+    std::ostringstream sink;
+    std::streambuf *stdoutBuf = std::cout.rdbuf(sink.rdbuf());
+    for (auto _ : state)
+    {
+        LFAST::MessageParser parser(msg);
+        benchmark::DoNotOptimize(parser.data);
+        sink.str("");
+    }
+    std::cout.rdbuf(stdoutBuf);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MessageParser_Status);
+
+///
+/// Equatorial to horizontal benchmarks ///
+///
+
+// Once a tick, as ReadScopeStatus() does, so the slow terms are mostly cached
+static void BM_EquatorialToHorizontal_Tick(benchmark::State &state)
+{
+    ApparentPlace place;
+    place.setSite(31.6, -110.9);
+    double jd = BENCH_JD, alt, az;
+    for (auto _ : state)
+    {
+        place.ofDateToObserved(jd, 5.5, 20.0, &alt, &az);
+        benchmark::DoNotOptimize(alt);
+        benchmark::DoNotOptimize(az);
+        jd += TICK_SEC / 86400.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EquatorialToHorizontal_Tick);
+
+// Far enough apart that every call recomputes precession, nutation and aberration
+static void BM_EquatorialToHorizontal_Cold(benchmark::State &state)
+{
+    ApparentPlace place;
+    place.setSite(31.6, -110.9);
+    double jd = BENCH_JD, alt, az;
+    for (auto _ : state)
+    {
+        place.ofDateToObserved(jd, 5.5, 20.0, &alt, &az);
+        benchmark::DoNotOptimize(alt);
+        benchmark::DoNotOptimize(az);
+        jd += 2.0 * APPARENT_PLACE::SLOW_TERMS_PERIOD_SEC / 86400.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EquatorialToHorizontal_Cold);
+
+static void BM_HorizontalToEquatorial_Tick(benchmark::State &state)
+{
+    ApparentPlace place;
+    place.setSite(31.6, -110.9);
+    double jd = BENCH_JD, ra, dec;
+    for (auto _ : state)
+    {
+        place.observedToOfDate(jd, 45.0, 120.0, &ra, &dec);
+        benchmark::DoNotOptimize(ra);
+        benchmark::DoNotOptimize(dec);
+        jd += TICK_SEC / 86400.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HorizontalToEquatorial_Tick);
@@ -0,0 +1,275 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Summarizes, lists or replays a drive bus log recorded by the mount driver (BUS_RECORD).
+///
+///   bus_replay [--list | --run] FILE
+///
+/// By default prints the span of the recording, the number of ticks and the traffic per drive,
+/// with its failures. --list writes every entry to stdout as CSV. --run feeds the recording
+/// through the altitude and azimuth SlewDrives as fast as it can: each tick reads the feedback
+/// and runs the control loops with the inputs recorded for that tick, just as the driver did on
+/// the night, and the drive commands are checked against the ones that were sent. It reports how
+/// closely the replay followed the recording and the wall-clock cost per tick. Only a recording
+/// that was switched on before connecting has the drive handshake that --run starts from.
+///
+///   bus_replay --run /var/log/lfast/telemetry/bus_20250301T043000Z.lfbus
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../00_Utils/bus_log.h"
+#include "../01_Mount_Driver/slew_drive.h"
+#include "../01_Mount_Driver/lfast_constants.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void usage()
+{
+    std::cerr << "usage: bus_replay [--list | --run] FILE" << std::endl;
+}
+
+static std::string formatUnix(double unix_s)
+{
+    std::time_t whole = (std::time_t)unix_s;
+    std::tm utc;
+    gmtime_r(&whole, &utc);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buf;
+}
+
+static const char *opName(uint8_t op)
+{
+    switch (op)
+    {
+    case BUS_OP_READ:
+        return "read";
+    case BUS_OP_WRITE:
+        return "write";
+    case BUS_OP_MARK:
+        return "mark";
+    default:
+        return "?";
+    }
+}
+
+static int summarize(const std::string &path)
+{
+    struct NodeCounts
+    {
+        uint64_t reads{0};
+        uint64_t writes{0};
+        uint64_t failures{0};
+        std::map<int, uint64_t> errors;
+    };
+    BusLogReader reader(path);
+    std::map<unsigned, NodeCounts> nodes;
+    uint64_t entries = 0, ticks = 0, marks = 0;
+    double last_s = 0.0;
+    BusLogEntry e;
+    while (reader.next(e))
+    {
+        entries++;
+        last_s = e.t_s;
+        if (e.op == BUS_OP_MARK)
+        {
+            if (e.addr == BUS_LOG::MARK_TICK)
+                ticks++;
+            else
+                marks++;
+            continue;
+        }
+        NodeCounts &c = nodes[e.devId];
+        if (e.op == BUS_OP_READ)
+            c.reads++;
+        else
+            c.writes++;
+        if (e.result < 0)
+        {
+            c.failures++;
+            c.errors[e.errnum]++;
+        }
+    }
+
+    std::cout << path << std::endl
+              << "  " << formatUnix(reader.getStartUnix()) << ", " << last_s << " s, " << entries << " entries, "
+              << ticks << " ticks, " << marks << " input marks" << std::endl;
+    for (const auto &n : nodes)
+    {
+        std::cout << "  node " << n.first << ": " << n.second.reads << " reads, " << n.second.writes << " writes, "
+                  << n.second.failures << " failed";
+        for (const auto &err : n.second.errors)
+            std::cout << " (" << err.second << "x " << std::strerror(err.first) << ")";
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+static int list(const std::string &path)
+{
+    BusLogReader reader(path);
+    std::printf("t_s,op,node,addr,words,result,errno,values\n");
+    BusLogEntry e;
+    while (reader.next(e))
+    {
+        std::printf("%.6f,%s,%u,0x%04X,%u,%d,%d,", e.t_s, opName(e.op), e.devId, e.addr, e.numWords, e.result, e.errnum);
+        if (e.op == BUS_OP_MARK)
+        {
+            double values[BUS_LOG::MAX_MARK_VALUES];
+            const unsigned n = std::min<unsigned>(e.numWords / 4, BUS_LOG::MAX_MARK_VALUES);
+            busMarkUnpack(e.words, n, values);
+            for (unsigned k = 0; k < n; k++)
+                std::printf("%s%.10g", k ? " " : "", values[k]);
+        }
+        else if (e.result >= 0)
+        {
+            for (unsigned k = 0; k < e.numWords; k++)
+                std::printf("%s%04X", k ? " " : "", e.words[k]);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Runs the axes the way TimerHit does while it's driving them. Ticks where the driver did
+/// something else with an axis (stopping, homing, status checks while idle) only read its
+/// feedback; the rest of that tick's traffic is counted as skipped. The feedback read comes first
+/// as in ReadScopeStatus(), though the order within a tick doesn't matter to the replay.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static int run(const std::string &path)
+{
+    SlewDrive::initializeDriverReplay(path.c_str());
+    BusReplay *replay = KincoDriver::getReplay();
+
+    struct Axis
+    {
+        std::unique_ptr<SlewDrive> drive;
+        uint8_t markId;
+        uint64_t updates{0};
+        uint64_t errors{0};
+    };
+    Axis axes[2];
+    axes[0].drive = std::unique_ptr<SlewDrive>(new SlewDrive("Altitude", LFAST_CONSTANTS::ALTITUDE_MOTOR_A_ID,
+                                                             LFAST_CONSTANTS::ALTITUDE_MOTOR_B_ID));
+    axes[0].markId = LFAST_CONSTANTS::ALTITUDE_MOTOR_A_ID;
+    axes[1].drive = std::unique_ptr<SlewDrive>(new SlewDrive("Azimuth", LFAST_CONSTANTS::AZIMUTH_MOTOR_A_ID,
+                                                             LFAST_CONSTANTS::AZIMUTH_MOTOR_B_ID));
+    axes[1].markId = LFAST_CONSTANTS::AZIMUTH_MOTOR_A_ID;
+
+    // The handshake's traffic comes before the first tick mark
+    for (Axis &a : axes)
+    {
+        try
+        {
+            a.drive->connectToDrivers();
+        }
+        catch (const std::exception &e)
+        {
+            throw std::runtime_error("No drive handshake at the start of the recording.\n" + std::string(e.what()));
+        }
+        a.drive->initializeStates();
+    }
+
+    double maxTick_s = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    while (!replay->isFinished())
+    {
+        const auto tickStart = std::chrono::steady_clock::now();
+        const double dt = KincoDriver::markBusTick(0.0);
+        if (replay->isFinished())
+            break;
+        const std::vector<BusLogEntry> inputs = replay->pendingMarks(BUS_LOG::MARK_AXIS_INPUTS);
+        for (Axis &a : axes)
+        {
+            // Skipped in the driver's degraded mode, in which case these reads go unmatched
+            try
+            {
+                a.drive->getPositionFeedback();
+                a.drive->getVelocityFeedback();
+            }
+            catch (const std::exception &)
+            {
+            }
+            try
+            {
+                for (const BusLogEntry &m : inputs)
+                {
+                    if (m.devId != a.markId)
+                        continue;
+                    double mode;
+                    busMarkUnpack(m.words, 1, &mode);
+                    a.drive->updateControlLoops(dt, (ControlMode_t)(int)mode);
+                    a.updates++;
+                    break;
+                }
+            }
+            catch (const std::exception &)
+            {
+                a.errors++;
+            }
+        }
+        maxTick_s = std::max(maxTick_s, std::chrono::duration<double>(std::chrono::steady_clock::now() - tickStart).count());
+    }
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const BusReplayStats &s = replay->getStats();
+    std::cout << path << std::endl
+              << "  " << s.ticks << " ticks (" << replay->getTime() << " s recorded) in " << wall_s << " s, "
+              << (s.ticks > 0 ? 1e6 * wall_s / s.ticks : 0.0) << " us/tick mean, " << 1e6 * maxTick_s << " us max"
+              << std::endl
+              << "  " << s.served << " requests served (" << s.failures << " recorded failures), " << s.missing
+              << " unmatched, " << s.skipped << " skipped" << std::endl
+              << "  " << s.writeMismatches << " drive commands differ, " << s.markMismatches << " input marks differ"
+              << std::endl;
+    for (const Axis &a : axes)
+        std::cout << "  node " << (unsigned)a.markId << " axis: " << a.updates << " control updates, " << a.errors
+                  << " ticks with bus errors" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bool listMode = false, runMode = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--list")
+            listMode = true;
+        else if (arg == "--run")
+            runMode = true;
+        else if (arg == "-h" || arg == "--help" || arg[0] == '-')
+        {
+            usage();
+            return arg[0] == '-' && arg != "-h" && arg != "--help" ? 1 : 0;
+        }
+        else
+            paths.push_back(arg);
+    }
+    if (paths.size() != 1 || (listMode && runMode))
+    {
+        usage();
+        return 1;
+    }
+
+    try
+    {
+        if (listMode)
+            return list(paths[0]);
+        if (runMode)
+            return run(paths[0]);
+        return summarize(paths[0]);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,155 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Batch pointing model fit.
+///
+///   pointing_fit [--terms IA,IE,...] [--clip SIGMA] [--device NAME] [FILE ...]
+///
+/// Reads pointing observations ("skyAz skyAlt mountAz mountAlt" in degrees per line, as
+/// recorded by the mount driver's POINTING_FILE) from the files, or stdin if there are none,
+/// fits the model and prints the terms. With --clip, points further than SIGMA times the RMS
+/// from the first fit are dropped and the model is refitted. The last line is an indi_setprop
+/// command that loads the model into the driver.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../00_Utils/pointing_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static void usage()
+{
+    std::cerr << "usage: pointing_fit [--terms IA,IE,...] [--clip SIGMA] [--device NAME] [FILE ...]" << std::endl;
+    std::cerr << "terms:";
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        std::cerr << " " << PointingModel::termName(k);
+    std::cerr << " (default: all)" << std::endl;
+}
+
+static bool parseTerms(const std::string &list, unsigned &mask)
+{
+    mask = 0;
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ','))
+    {
+        unsigned term = PointingModel::termFromName(name);
+        if (term == NUM_POINTING_TERMS)
+        {
+            std::cerr << "unknown term: " << name << std::endl;
+            return false;
+        }
+        mask |= PM_TERM_BIT(term);
+    }
+    return mask != 0;
+}
+
+static void readObservations(std::istream &in, const std::string &source, std::vector<PointingObservation> &points)
+{
+    std::string line;
+    unsigned lineNum = 0;
+    while (std::getline(in, line))
+    {
+        lineNum++;
+        PointingObservation obs;
+        if (PointingFitter::parseObservation(line, obs))
+            points.push_back(obs);
+        else if (line.find_first_not_of(" \t\r") != std::string::npos && line[line.find_first_not_of(" \t\r")] != '#')
+            std::cerr << source << ":" << lineNum << ": skipped unreadable line" << std::endl;
+    }
+}
+
+static PointingFitResult fit(const std::vector<PointingObservation> &points, unsigned mask, PointingModel &model)
+{
+    PointingFitter fitter;
+    for (const PointingObservation &obs : points)
+        fitter.add(obs);
+    return fitter.solve(mask, model);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned mask = PM_ALL_TERMS;
+    double clip = 0.0;
+    std::string device = "LFAST Mount Control";
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--terms" && i + 1 < argc)
+        {
+            if (!parseTerms(argv[++i], mask))
+                return 2;
+        }
+        else if (arg == "--clip" && i + 1 < argc)
+            clip = std::atof(argv[++i]);
+        else if (arg == "--device" && i + 1 < argc)
+            device = argv[++i];
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage();
+            return 0;
+        }
+        else if (arg.size() > 1 && arg[0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else
+            files.push_back(arg);
+    }
+
+    std::vector<PointingObservation> points;
+    if (files.empty())
+        readObservations(std::cin, "stdin", points);
+    for (const std::string &path : files)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::cerr << "can't open " << path << std::endl;
+            return 1;
+        }
+        readObservations(in, path, points);
+    }
+
+    PointingModel model;
+    PointingFitResult result = fit(points, mask, model);
+    if (result.ok && clip > 0.0)
+    {
+        std::vector<PointingObservation> kept;
+        for (const PointingObservation &obs : points)
+            if (PointingFitter::residual(model, obs) <= clip * result.rms_arcsec)
+                kept.push_back(obs);
+        std::cout << "clipped " << points.size() - kept.size() << " of " << points.size()
+                  << " points beyond " << clip << " x RMS" << std::endl;
+        points.swap(kept);
+        result = fit(points, mask, model);
+    }
+    if (!result.ok)
+    {
+        std::cerr << "fit failed: " << result.error << std::endl;
+        return 1;
+    }
+
+    std::printf("%u points, RMS %.2f arcsec\n\n", result.numPoints, result.rms_arcsec);
+    std::printf("  term      value [\"]   sigma [\"]\n");
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+    {
+        if (result.termMask & PM_TERM_BIT(k))
+            std::printf("  %-6s %11.2f %11.2f\n", PointingModel::termName(k), model.getCoefficient(k),
+                        result.sigma_arcsec[k]);
+    }
+
+    std::printf("\nindi_setprop \"%s.POINTING_MODEL_TERMS.", device.c_str());
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        std::printf("%s%s", k ? ";" : "", PointingModel::termName(k));
+    std::printf("=");
+    for (unsigned k = 0; k < NUM_POINTING_TERMS; k++)
+        std::printf("%s%.3f", k ? ";" : "", model.getCoefficient(k));
+    std::printf("\"\n");
+    return 0;
+}
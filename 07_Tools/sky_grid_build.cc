@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Builds a sky correction grid from pointing observations.
+///
+///   sky_grid_build -o FILE [--terms IA,IE,...|none] [--alt-nodes N] [--az-nodes N]
+///                  [--alt-min DEG] [--alt-max DEG] [--smooth DEG] [POINTS ...]
+///
+/// Reads the same point logs as pointing_fit, fits the pointing model with the given terms (use
+/// the same terms as for the model loaded in the driver), and grids what's left over. Each node is
+/// a Gaussian-weighted mean of the residuals within a few SMOOTH degrees of it, pulled towards
+/// zero where there are few points. The grid is written atomically, so it can be rebuilt in place
+/// while the driver has it loaded; re-send SKY_GRID_FILE to pick it up.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../00_Utils/pointing_model.h"
+#include "../00_Utils/sky_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const double DEG2RAD = M_PI / 180.0;
+// Weight of the zero prior at each node, in points
+static const double PRIOR_WEIGHT = 1.0;
+
+static void usage()
+{
+    std::cerr << "usage: sky_grid_build -o FILE [--terms IA,IE,...|none] [--alt-nodes N] [--az-nodes N]" << std::endl
+              << "                      [--alt-min DEG] [--alt-max DEG] [--smooth DEG] [POINTS ...]" << std::endl;
+}
+
+static bool parseTerms(const std::string &list, unsigned &mask)
+{
+    mask = 0;
+    if (list == "none")
+        return true;
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ','))
+    {
+        unsigned term = PointingModel::termFromName(name);
+        if (term == NUM_POINTING_TERMS)
+        {
+            std::cerr << "unknown term: " << name << std::endl;
+            return false;
+        }
+        mask |= PM_TERM_BIT(term);
+    }
+    return mask != 0;
+}
+
+static double wrapDelta(double dAz)
+{
+    return dAz - 360.0 * std::floor((dAz + 180.0) / 360.0);
+}
+
+static double separation(double alt1, double az1, double alt2, double az2)
+{
+    double c = std::sin(alt1 * DEG2RAD) * std::sin(alt2 * DEG2RAD) +
+               std::cos(alt1 * DEG2RAD) * std::cos(alt2 * DEG2RAD) * std::cos((az1 - az2) * DEG2RAD);
+    return std::acos(std::max(-1.0, std::min(1.0, c))) / DEG2RAD;
+}
+
+// Residual after the model [arcsec], azimuth as a coordinate difference (what the grid adds)
+struct Residual
+{
+    double alt;
+    double az;
+    double rAlt;
+    double rAz;
+};
+
+static double rms(const std::vector<Residual> &res, const SkyGrid *grid)
+{
+    if (res.empty())
+        return 0.0;
+    double ss = 0.0;
+    for (const Residual &r : res)
+    {
+        double rAlt = r.rAlt, rAz = r.rAz;
+        if (grid != nullptr)
+        {
+            SkyGridSample s;
+            grid->evaluate(r.alt, r.az, s);
+            rAlt -= s.dAlt;
+            rAz -= s.dAz;
+        }
+        ss += rAlt * rAlt + std::pow(rAz * std::cos(r.alt * DEG2RAD), 2);
+    }
+    return std::sqrt(ss / res.size());
+}
+
+int main(int argc, char **argv)
+{
+    unsigned mask = PM_ALL_TERMS;
+    unsigned nAlt = 15, nAz = 72;
+    double altMin = 10.0, altMax = 85.0, smooth = 5.0;
+    std::string outPath;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-o" && hasValue)
+            outPath = argv[++i];
+        else if (arg == "--terms" && hasValue)
+        {
+            if (!parseTerms(argv[++i], mask))
+                return 2;
+        }
+        else if (arg == "--alt-nodes" && hasValue)
+            nAlt = std::atoi(argv[++i]);
+        else if (arg == "--az-nodes" && hasValue)
+            nAz = std::atoi(argv[++i]);
+        else if (arg == "--alt-min" && hasValue)
+            altMin = std::atof(argv[++i]);
+        else if (arg == "--alt-max" && hasValue)
+            altMax = std::atof(argv[++i]);
+        else if (arg == "--smooth" && hasValue)
+            smooth = std::atof(argv[++i]);
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage();
+            return 0;
+        }
+        else if (arg.size() > 1 && arg[0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else
+            files.push_back(arg);
+    }
+    if (outPath.empty() || nAlt < SKY_GRID::MIN_ALT_NODES || nAz < SKY_GRID::MIN_AZ_NODES ||
+        !(altMax > altMin) || !(smooth > 0.0))
+    {
+        usage();
+        return 2;
+    }
+
+    std::vector<PointingObservation> points;
+    std::vector<std::istream *> inputs;
+    std::vector<std::ifstream> streams(files.size());
+    for (size_t k = 0; k < files.size(); k++)
+    {
+        streams[k].open(files[k]);
+        if (!streams[k])
+        {
+            std::cerr << "can't open " << files[k] << std::endl;
+            return 1;
+        }
+        inputs.push_back(&streams[k]);
+    }
+    if (inputs.empty())
+        inputs.push_back(&std::cin);
+    for (std::istream *in : inputs)
+    {
+        std::string line;
+        PointingObservation obs;
+        while (std::getline(*in, line))
+            if (PointingFitter::parseObservation(line, obs))
+                points.push_back(obs);
+    }
+
+    PointingModel model;
+    if (mask != 0)
+    {
+        PointingFitter fitter;
+        for (const PointingObservation &obs : points)
+            fitter.add(obs);
+        PointingFitResult result = fitter.solve(mask, model);
+        if (!result.ok)
+        {
+            std::cerr << "model fit failed: " << result.error << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Residual> residuals;
+    for (const PointingObservation &obs : points)
+    {
+        double dAlt, dAz;
+        model.offsets(obs.skyAlt, obs.skyAz, &dAlt, &dAz);
+        residuals.push_back({obs.skyAlt, obs.skyAz,
+                             (obs.mountAlt - obs.skyAlt) * 3600.0 - dAlt,
+                             wrapDelta(obs.mountAz - obs.skyAz) * 3600.0 - dAz});
+    }
+
+    std::vector<float> values;
+    values.reserve((size_t)nAlt * nAz * 2);
+    unsigned sparseNodes = 0;
+    for (unsigned i = 0; i < nAlt; i++)
+    {
+        double alt = altMin + i * (altMax - altMin) / (nAlt - 1);
+        for (unsigned j = 0; j < nAz; j++)
+        {
+            double az = j * 360.0 / nAz;
+            double sw = 0.0, sAlt = 0.0, sAz = 0.0;
+            for (const Residual &r : residuals)
+            {
+                double d = separation(alt, az, r.alt, r.az) / smooth;
+                if (d > 4.0)
+                    continue;
+                double w = std::exp(-0.5 * d * d);
+                sw += w;
+                sAlt += w * r.rAlt;
+                sAz += w * r.rAz;
+            }
+            if (sw < PRIOR_WEIGHT)
+                sparseNodes++;
+            values.push_back(sAlt / (sw + PRIOR_WEIGHT));
+            values.push_back(sAz / (sw + PRIOR_WEIGHT));
+        }
+    }
+
+    try
+    {
+        SkyGrid::write(outPath, nAlt, nAz, altMin, altMax, values);
+        SkyGrid grid(outPath);
+        std::printf("%zu points, %u x %u grid, %.0f..%.0f deg altitude, max correction %.2f arcsec\n",
+                    points.size(), nAlt, nAz, altMin, altMax, grid.maxCorrection());
+        std::printf("RMS after the model %.2f arcsec, after the grid %.2f arcsec\n",
+                    rms(residuals, nullptr), rms(residuals, &grid));
+        if (sparseNodes > 0)
+            std::printf("%u of %u nodes have less than one point within %.1f deg\n", sparseNodes, nAlt * nAz, smooth);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
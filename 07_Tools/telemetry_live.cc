@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Streams the mount driver's live telemetry feed (shared memory, see TelemetryShmPublisher) to
+/// stdout as CSV at the full loop rate, for piping into a plotter or script.
+///
+///   telemetry_live [--name SHM_NAME] [--channels NAME,...] [--poll-ms N] [--history]
+///
+/// Only new records are printed unless --history is given, in which case the feed's current
+/// contents come first. The tool never writes to the segment, so it can't slow the driver; if it
+/// falls more than a feed length behind, the skipped records are reported on stderr. When the
+/// driver restarts the feed the tool attaches to the new one.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../00_Utils/telemetry_shm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void usage()
+{
+    std::cerr << "usage: telemetry_live [--name SHM_NAME] [--channels NAME,...] [--poll-ms N] [--history]" << std::endl;
+}
+
+static std::unique_ptr<TelemetryShmReader> attach(const std::string &name, bool quiet)
+{
+    try
+    {
+        return std::unique_ptr<TelemetryShmReader>(new TelemetryShmReader(name));
+    }
+    catch (const std::exception &e)
+    {
+        if (!quiet)
+            std::cerr << e.what() << "; waiting for the driver" << std::endl;
+        return nullptr;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string name = TELEMETRY::SHM_DEFAULT_NAME;
+    std::vector<std::string> channelNames;
+    int pollMs = 20;
+    bool history = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--name" && hasValue)
+            name = argv[++i];
+        else if (arg == "--channels" && hasValue)
+        {
+            std::stringstream ss(argv[++i]);
+            std::string channel;
+            while (std::getline(ss, channel, ','))
+                channelNames.push_back(channel);
+        }
+        else if (arg == "--poll-ms" && hasValue)
+            pollMs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--history")
+            history = true;
+        else
+        {
+            usage();
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const TelemetryChannelInfo *info = telemetryChannels();
+    std::vector<unsigned> cols;
+    if (channelNames.empty())
+    {
+        for (unsigned c = 0; c < NUM_TELEMETRY_CHANNELS; c++)
+            cols.push_back(c);
+    }
+    for (const std::string &channel : channelNames)
+    {
+        unsigned c = 0;
+        while (c < NUM_TELEMETRY_CHANNELS && channel != info[c].name)
+            c++;
+        if (c == NUM_TELEMETRY_CHANNELS)
+        {
+            std::cerr << "unknown channel: " << channel << std::endl;
+            return 1;
+        }
+        cols.push_back(c);
+    }
+
+    for (size_t k = 0; k < cols.size(); k++)
+        std::printf("%s%s", k ? "," : "", info[cols[k]].name);
+    std::printf("\n");
+
+    std::unique_ptr<TelemetryShmReader> reader;
+    bool waiting = false;
+    uint64_t missedReported = 0;
+    std::vector<TelemetryRecord> records;
+    while (true)
+    {
+        if (!reader || reader->isClosed())
+        {
+            reader = attach(name, waiting);
+            waiting = !reader;
+            missedReported = 0;
+            // A restarted feed holds nothing we've printed, so only the first one is skipped
+            if (reader && !history)
+                reader->poll(records);
+            if (reader)
+                history = true;
+        }
+        if (reader)
+        {
+            records.clear();
+            reader->poll(records);
+            for (const TelemetryRecord &r : records)
+            {
+                const double *values = &r.jd;
+                for (size_t k = 0; k < cols.size(); k++)
+                    std::printf(k ? ",%.10g" : "%.10g", values[cols[k]]);
+                std::printf("\n");
+            }
+            std::fflush(stdout);
+            if (reader->getMissed() > missedReported)
+            {
+                std::cerr << "skipped " << reader->getMissed() - missedReported << " records" << std::endl;
+                missedReported = reader->getMissed();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(reader ? pollMs : 1000));
+    }
+    return 0;
+}
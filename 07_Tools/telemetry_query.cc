@@ -0,0 +1,223 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Extracts time ranges and channels from columnar telemetry files, or summarizes them.
+///
+///   telemetry_query [--from TIME] [--to TIME] [--channels NAME,...] [--every N] [--stats | --info] FILE...
+///
+/// TIME is a Julian date or a UTC time such as 2025-03-01T04:30:00.5. By default the selected
+/// channels (all of them if --channels isn't given) are written to stdout as CSV, one row per
+/// record (every Nth with --every), with the UTC time first. --stats prints count, min, max, mean,
+/// rms and standard deviation per channel instead; whole chunks inside the range come from the
+/// stored chunk statistics, so only the ends of the range are scanned. --info lists each file's
+/// channels, time span and size. Files may be given in any order and overlap the range or not.
+///
+///   telemetry_query --from 2025-03-01T04:30:00 --to 2025-03-01T04:31:00
+///       --channels alt_posn_err_deg,alt_rate_fb_dps /var/log/lfast/telemetry/*.lftm
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../00_Utils/telemetry_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void usage()
+{
+    std::cerr << "usage: telemetry_query [--from TIME] [--to TIME] [--channels NAME,...] [--every N]" << std::endl
+              << "                       [--stats | --info] FILE..." << std::endl
+              << "       TIME is a Julian date or UTC YYYY-MM-DDTHH:MM:SS[.sss]" << std::endl;
+}
+
+static bool parseTime(const std::string &s, double &jd)
+{
+    int year, month, day, hour = 0, minute = 0;
+    double second = 0.0;
+    if (std::sscanf(s.c_str(), "%d-%d-%dT%d:%d:%lf", &year, &month, &day, &hour, &minute, &second) >= 3)
+    {
+        std::tm t = {};
+        t.tm_year = year - 1900;
+        t.tm_mon = month - 1;
+        t.tm_mday = day;
+        t.tm_hour = hour;
+        t.tm_min = minute;
+        double unix_s = (double)timegm(&t) + second;
+        jd = TELEMETRY::UNIX_EPOCH_JD + unix_s / TELEMETRY::SEC_PER_DAY;
+        return true;
+    }
+    char *end;
+    jd = std::strtod(s.c_str(), &end);
+    return *end == '\0' && end != s.c_str();
+}
+
+static std::string formatTime(double jd)
+{
+    // Round to the printed precision first so 59.9999 doesn't come out as 60.000
+    double unix_s = std::round((jd - TELEMETRY::UNIX_EPOCH_JD) * TELEMETRY::SEC_PER_DAY * 1000.0) / 1000.0;
+    std::time_t whole = (std::time_t)std::floor(unix_s);
+    std::tm utc;
+    gmtime_r(&whole, &utc);
+    char buf[48];
+    size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:", &utc);
+    std::snprintf(buf + n, sizeof(buf) - n, "%06.3f", utc.tm_sec + (unix_s - whole));
+    return buf;
+}
+
+static void printInfo(const TelemetryReader &r)
+{
+    std::cout << r.getPath() << std::endl;
+    if (r.numRecords() > 0)
+        std::cout << "  " << formatTime(r.firstJd()) << " to " << formatTime(r.lastJd()) << ", ";
+    else
+        std::cout << "  ";
+    std::cout << r.numRecords() << " records in " << r.numChunks() << " chunks" << std::endl;
+    for (unsigned c = 0; c < r.numChannels(); c++)
+        std::cout << "  " << r.channel(c).name << " [" << r.channel(c).units << "]" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    double jdFrom = 0.0, jdTo = 1.0e9;
+    std::vector<std::string> channelNames;
+    unsigned every = 1;
+    bool stats = false, info = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--from" && hasValue)
+        {
+            if (!parseTime(argv[++i], jdFrom))
+            {
+                std::cerr << "bad time: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--to" && hasValue)
+        {
+            if (!parseTime(argv[++i], jdTo))
+            {
+                std::cerr << "bad time: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--channels" && hasValue)
+        {
+            std::stringstream ss(argv[++i]);
+            std::string name;
+            while (std::getline(ss, name, ','))
+                channelNames.push_back(name);
+        }
+        else if (arg == "--every" && hasValue)
+            every = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--stats")
+            stats = true;
+        else if (arg == "--info")
+            info = true;
+        else if (arg == "-h" || arg == "--help" || arg[0] == '-')
+        {
+            usage();
+            return arg[0] == '-' && arg != "-h" && arg != "--help" ? 1 : 0;
+        }
+        else
+            paths.push_back(arg);
+    }
+    if (paths.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<TelemetryReader>> readers;
+    for (const std::string &p : paths)
+    {
+        try
+        {
+            readers.emplace_back(new TelemetryReader(p));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    std::sort(readers.begin(), readers.end(), [](const std::unique_ptr<TelemetryReader> &a, const std::unique_ptr<TelemetryReader> &b)
+              { return a->firstJd() < b->firstJd(); });
+
+    if (info)
+    {
+        for (const auto &r : readers)
+            printInfo(*r);
+        return 0;
+    }
+
+    if (channelNames.empty())
+    {
+        for (unsigned c = 0; c < readers[0]->numChannels(); c++)
+            channelNames.push_back(readers[0]->channel(c).name);
+    }
+    for (const std::string &name : channelNames)
+    {
+        bool found = false;
+        for (const auto &r : readers)
+            found = found || r->findChannel(name) >= 0;
+        if (!found)
+        {
+            std::cerr << "unknown channel: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    if (stats)
+    {
+        std::printf("channel,count,min,max,mean,rms,std\n");
+        for (const std::string &name : channelNames)
+        {
+            TelemetryStats s;
+            for (const auto &r : readers)
+            {
+                int c = r->findChannel(name);
+                if (c >= 0)
+                    s.merge(r->summarize(c, jdFrom, jdTo));
+            }
+            std::printf("%s,%llu,%.10g,%.10g,%.10g,%.10g,%.10g\n", name.c_str(), (unsigned long long)s.count, s.min, s.max,
+                        s.mean(), s.rms(), s.stdDev());
+        }
+        return 0;
+    }
+
+    std::cout << "utc";
+    for (const std::string &name : channelNames)
+        std::cout << "," << name;
+    std::cout << std::endl;
+
+    unsigned long long n = 0;
+    for (const auto &r : readers)
+    {
+        std::vector<int> cols;
+        for (const std::string &name : channelNames)
+            cols.push_back(r->findChannel(name));
+        const int jdCol = r->findChannel("jd");
+        r->forEachRecord(jdFrom, jdTo, [&](unsigned chunk, unsigned row)
+                         {
+            if (n++ % every != 0)
+                return;
+            std::printf("%s", formatTime(r->column(chunk, jdCol)[row]).c_str());
+            for (int c : cols)
+            {
+                if (c >= 0)
+                    std::printf(",%.10g", r->column(chunk, c)[row]);
+                else
+                    std::printf(",");
+            }
+            std::printf("\n"); });
+    }
+    return 0;
+}